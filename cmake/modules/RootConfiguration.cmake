@@ -365,8 +365,11 @@ set(haspthread ${has${CMAKE_USE_PTHREADS_INIT}})
 set(hasxft ${has${xft}})
 set(hascling ${has${cling}})
 set(haslzmacompression ${has${lzma}})
+set(haslz4 ${has${lz4}})
+set(haszstd ${has${zstd}})
 set(hascocoa ${has${cocoa}})
 set(hasvc ${has${vc}})
+set(hasvdt ${has${vdt}})
 set(usec++11 ${has${cxx11}})
 set(uselibc++ ${has${libcxx}})
 set(hasllvm undef)
@@ -111,6 +111,34 @@ if(builtin_lzma)
 endif()
 
 
+#---Check for LZ4-------------------------------------------------------------------
+if(lz4)
+  message(STATUS "Looking for LZ4")
+  find_package(LZ4)
+  if(NOT LZ4_FOUND)
+    if(fail-on-missing)
+      message(FATAL_ERROR "LZ4 library not found and it is required (lz4 option enabled)")
+    else()
+      message(STATUS "LZ4 not found. Switching off lz4 option")
+      set(lz4 OFF CACHE BOOL "" FORCE)
+    endif()
+  endif()
+endif()
+
+#---Check for ZSTD------------------------------------------------------------------
+if(zstd)
+  message(STATUS "Looking for ZSTD")
+  find_package(ZSTD)
+  if(NOT ZSTD_FOUND)
+    if(fail-on-missing)
+      message(FATAL_ERROR "ZSTD library not found and it is required (zstd option enabled)")
+    else()
+      message(STATUS "ZSTD not found. Switching off zstd option")
+      set(zstd OFF CACHE BOOL "" FORCE)
+    endif()
+  endif()
+endif()
+
 #---Check for X11 which is mandatory lib on Unix--------------------------------------
 if(x11)
   message(STATUS "Looking for X11")
@@ -47,6 +47,13 @@ public:
       kNumEventType  //number of entries, must be last
    };
 
+   enum EBasketRead {
+      kBasketFromCache, //basket found in the read cache of the file
+      kBasketCacheMiss, //basket not found in the read cache, read from the file
+      kBasketNoCache,   //basket read from the file, without read cache
+      kBasketMapped     //basket accessed in the memory mapped file, without read cache
+   };
+
    virtual void SimpleEvent(EEventType type) = 0;
 
    virtual void PacketEvent(const char *slave, const char *slavename, const char *filename,
@@ -63,6 +70,10 @@ public:
 
    virtual void UnzipEvent(TObject *tree, Long64_t pos, Double_t start, Int_t complen, Int_t objlen) = 0;
 
+   virtual void BasketReadEvent(TObject * /*branch*/, Long64_t /*pos*/, Int_t /*len*/, EBasketRead /*source*/) {}
+
+   virtual void BasketUnzipEvent(TObject * /*branch*/, Long64_t /*pos*/, Double_t /*start*/, Int_t /*complen*/, Int_t /*objlen*/) {}
+
    virtual void RateEvent(Double_t proctime, Double_t deltatime,
                           Long64_t eventsprocessed, Long64_t bytesRead) = 0;
 
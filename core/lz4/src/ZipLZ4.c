@@ -0,0 +1,104 @@
+// @(#)root/lz4:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/* The LZ4 algorithm trades compression factor for speed: decompression
+   runs at several hundred MB/s per core, which makes it a good choice for
+   data that is read many times. Levels 1 to 3 use the fast LZ4 compressor,
+   levels 4 to 9 use the slower LZ4-HC compressor, which produces smaller
+   output that decompresses just as fast.
+   The algorithm requires the external LZ4 package when linking; if ROOT
+   is built without it, R__zipLZ4 leaves the buffer uncompressed and
+   R__unzipLZ4 reports an error. */
+
+#include "RConfigure.h"
+#include "ZipLZ4.h"
+#include <stdio.h>
+
+#ifdef R__HAS_LZ4
+#include "lz4.h"
+#include "lz4hc.h"
+#endif
+
+static const int kHeaderSize = 9;
+
+void R__zipLZ4(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep)
+{
+#ifdef R__HAS_LZ4
+   int out_size;                  /* compressed size */
+   unsigned in_size = (unsigned) (*srcsize);
+
+   *irep = 0;
+
+   if (*tgtsize <= kHeaderSize) {
+      return;
+   }
+
+   if (*srcsize > 0xffffff || *srcsize < 0) {
+      return;
+   }
+
+   if (cxlevel > 9) cxlevel = 9;
+   if (cxlevel < 4) {
+      out_size = LZ4_compress_default(src, &tgt[kHeaderSize], *srcsize,
+                                      *tgtsize - kHeaderSize);
+   } else {
+      out_size = LZ4_compress_HC(src, &tgt[kHeaderSize], *srcsize,
+                                 *tgtsize - kHeaderSize, cxlevel);
+   }
+   if (out_size <= 0) {
+      /* No need to print an error message. We simply abandon the compression
+         the buffer cannot be compressed or compressed buffer would be larger than original buffer
+      */
+      return;
+   }
+
+   tgt[0] = 'L';  /* Signature of LZ4 */
+   tgt[1] = '4';
+   tgt[2] = 1;    /* Version of the LZ4 block format in ROOT */
+
+   tgt[3] = (char)(out_size & 0xff);
+   tgt[4] = (char)((out_size >> 8) & 0xff);
+   tgt[5] = (char)((out_size >> 16) & 0xff);
+
+   tgt[6] = (char)(in_size & 0xff);         /* decompressed size */
+   tgt[7] = (char)((in_size >> 8) & 0xff);
+   tgt[8] = (char)((in_size >> 16) & 0xff);
+
+   *irep = out_size + kHeaderSize;
+#else
+   (void)cxlevel; (void)srcsize; (void)src; (void)tgtsize; (void)tgt;
+   *irep = 0;
+#endif
+}
+
+void R__unzipLZ4(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep)
+{
+#ifdef R__HAS_LZ4
+   int out_size;
+
+   *irep = 0;
+
+   out_size = LZ4_decompress_safe((const char *)(&src[kHeaderSize]), (char *)tgt,
+                                  *srcsize - kHeaderSize, *tgtsize);
+   if (out_size < 0) {
+      fprintf(stderr,
+              "R__unzipLZ4: error %d in LZ4_decompress_safe\n",
+              out_size);
+      return;
+   }
+
+   *irep = out_size;
+#else
+   (void)srcsize; (void)src; (void)tgtsize; (void)tgt;
+   *irep = 0;
+   fprintf(stderr,
+           "R__unzipLZ4: ROOT was built without LZ4 support, cannot decompress buffer\n");
+#endif
+}
@@ -25,6 +25,12 @@ namespace ROOT {
    // in greater compression factors, but takes more CPU time
    // and memory when compressing.  LZMA memory usage is particularly
    // high for compression levels 8 and 9.
+   // The LZ4 algorithm gives lower compression factors than ZLIB
+   // but decompresses several times faster. The ZSTD algorithm
+   // (Zstandard) gives compression factors similar to ZLIB while
+   // compressing and decompressing faster. Both require the
+   // corresponding external package when ROOT is built, otherwise
+   // buffers are written uncompressed.
    //
    // The current algorithms support level 1 to 9. The higher
    // the level the greater the compression and more CPU time
@@ -34,6 +40,8 @@ namespace ROOT {
                                 kZLIB,
                                 kLZMA,
                                 kOldCompressionAlgo,
+                                kLZ4,
+                                kZSTD,
                                 // if adding new algorithm types,
                                 // keep this enum value last
                                 kUndefinedCompressionAlgorithm
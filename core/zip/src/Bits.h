@@ -15,6 +15,8 @@
 #include "zlib.h"
 #include "RConfigure.h"
 #include "ZipLZMA.h"
+#include "ZipLZ4.h"
+#include "ZipZSTD.h"
 
 #include <stdio.h>
 #include <assert.h>
@@ -287,9 +289,14 @@ struct bits_internal_state {
    R__ZipMode = 2 : LZMA compression algorithm is used
    R__ZipMode = 0 or 3 : a very old compression algorithm is used
    (the very old algorithm is supported for backward compatibility)
+   R__ZipMode = 4 : LZ4 compression algorithm is used
+   R__ZipMode = 5 : ZSTD compression algorithm is used
    The LZMA algorithm requires the external XZ package be installed when linking
    is done. LZMA typically has significantly higher compression factors, but takes
    more CPU time and memory resources while compressing.
+   LZ4 and ZSTD require the external LZ4 and ZSTD packages. LZ4 decompresses
+   much faster than ZLIB at the cost of larger output, ZSTD is faster than ZLIB
+   for similar compression factors.
 */
 int R__ZipMode = 1;
 
@@ -563,6 +570,8 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
      /*                      1 = zlib */
      /*                      2 = lzma */
      /*                      3 = old */
+     /*                      4 = lz4 */
+     /*                      5 = zstd */
 {
   int err;
   int method   = Z_DEFLATED;
@@ -582,6 +591,18 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
     return;
   }
 
+  // The LZ4 compression algorithm
+  if (compressionAlgorithm == 4) {
+    R__zipLZ4(cxlevel, srcsize, src, tgtsize, tgt, irep);
+    return;
+  }
+
+  // The ZSTD (Zstandard) compression algorithm
+  if (compressionAlgorithm == 5) {
+    R__zipZSTD(cxlevel, srcsize, src, tgtsize, tgt, irep);
+    return;
+  }
+
   // The very old algorithm for backward compatibility
   // 0 for selecting with R__ZipMode in a backward compatible way
   // 3 for selecting in other cases
@@ -0,0 +1,47 @@
+# Module.mk for zstd module
+# Copyright (c) 2014 Rene Brun and Fons Rademakers
+
+MODNAME      := zstd
+MODDIR       := $(ROOT_SRCDIR)/core/$(MODNAME)
+MODDIRS      := $(MODDIR)/src
+MODDIRI      := $(MODDIR)/inc
+
+ZSTDDIR       := $(MODDIR)
+ZSTDDIRS      := $(ZSTDDIR)/src
+ZSTDDIRI      := $(ZSTDDIR)/inc
+
+ZSTDLIBDIRI   := $(ZSTDINCDIR:%=-I%)
+
+##### ZipZSTD, part of libCore #####
+ZSTDH         := $(MODDIRI)/ZipZSTD.h
+ZSTDS         := $(MODDIRS)/ZipZSTD.c
+ZSTDO         := $(call stripsrc,$(ZSTDS:.c=.o))
+
+ZSTDDEP       := $(ZSTDO:.o=.d)
+
+# used in the main Makefile
+ALLHDRS      += $(patsubst $(MODDIRI)/%.h,include/%.h,$(ZSTDH))
+
+# include all dependency files
+INCLUDEFILES += $(ZSTDDEP)
+
+##### local rules #####
+.PHONY:         all-$(MODNAME) clean-$(MODNAME) distclean-$(MODNAME)
+
+include/%.h:    $(ZSTDDIRI)/%.h
+		cp $< $@
+
+all-$(MODNAME): $(ZSTDO)
+
+clean-$(MODNAME):
+		@rm -f $(ZSTDO)
+
+clean::         clean-$(MODNAME)
+
+distclean-$(MODNAME): clean-$(MODNAME)
+		@rm -f $(ZSTDDEP)
+
+distclean::     distclean-$(MODNAME)
+
+##### extra rules ######
+$(ZSTDO): CFLAGS += $(ZSTDLIBDIRI)
@@ -0,0 +1,96 @@
+// @(#)root/zstd:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/* The Zstandard algorithm gives compression factors close to ZLIB at
+   high levels while both compressing and decompressing significantly
+   faster. The ROOT compression level is passed unchanged to ZSTD.
+   The algorithm requires the external ZSTD package when linking; if ROOT
+   is built without it, R__zipZSTD leaves the buffer uncompressed and
+   R__unzipZSTD reports an error. */
+
+#include "RConfigure.h"
+#include "ZipZSTD.h"
+#include <stdio.h>
+
+#ifdef R__HAS_ZSTD
+#include "zstd.h"
+#endif
+
+static const int kHeaderSize = 9;
+
+void R__zipZSTD(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep)
+{
+#ifdef R__HAS_ZSTD
+   size_t out_size;               /* compressed size */
+   unsigned in_size = (unsigned) (*srcsize);
+
+   *irep = 0;
+
+   if (*tgtsize <= kHeaderSize) {
+      return;
+   }
+
+   if (*srcsize > 0xffffff || *srcsize < 0) {
+      return;
+   }
+
+   if (cxlevel > ZSTD_maxCLevel()) cxlevel = ZSTD_maxCLevel();
+   out_size = ZSTD_compress(&tgt[kHeaderSize], (size_t)(*tgtsize - kHeaderSize),
+                            src, (size_t)(*srcsize), cxlevel);
+   if (ZSTD_isError(out_size) || out_size > 0xffffff) {
+      /* No need to print an error message. We simply abandon the compression
+         the buffer cannot be compressed or compressed buffer would be larger than original buffer
+      */
+      return;
+   }
+
+   tgt[0] = 'Z';  /* Signature of ZSTD */
+   tgt[1] = 'S';
+   tgt[2] = 1;    /* Version of the ZSTD block format in ROOT */
+
+   tgt[3] = (char)(out_size & 0xff);
+   tgt[4] = (char)((out_size >> 8) & 0xff);
+   tgt[5] = (char)((out_size >> 16) & 0xff);
+
+   tgt[6] = (char)(in_size & 0xff);         /* decompressed size */
+   tgt[7] = (char)((in_size >> 8) & 0xff);
+   tgt[8] = (char)((in_size >> 16) & 0xff);
+
+   *irep = (int)out_size + kHeaderSize;
+#else
+   (void)cxlevel; (void)srcsize; (void)src; (void)tgtsize; (void)tgt;
+   *irep = 0;
+#endif
+}
+
+void R__unzipZSTD(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep)
+{
+#ifdef R__HAS_ZSTD
+   size_t out_size;
+
+   *irep = 0;
+
+   out_size = ZSTD_decompress(tgt, (size_t)(*tgtsize),
+                              &src[kHeaderSize], (size_t)(*srcsize - kHeaderSize));
+   if (ZSTD_isError(out_size)) {
+      fprintf(stderr,
+              "R__unzipZSTD: error in ZSTD_decompress: %s\n",
+              ZSTD_getErrorName(out_size));
+      return;
+   }
+
+   *irep = (int)out_size;
+#else
+   (void)srcsize; (void)src; (void)tgtsize; (void)tgt;
+   *irep = 0;
+   fprintf(stderr,
+           "R__unzipZSTD: ROOT was built without ZSTD support, cannot decompress buffer\n");
+#endif
+}
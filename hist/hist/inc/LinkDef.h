@@ -44,6 +44,7 @@
 #pragma link C++ class TH1S+;
 #pragma link C++ class TH1I+;
 #pragma link C++ class TH1K+;
+#pragma link C++ class TH1ConcurrentFiller;
 #pragma link C++ class TH2-;
 #pragma link C++ class TH2C-;
 #pragma link C++ class TH2D-;
@@ -127,6 +127,8 @@ private:
    /// evaluate the partial derivative with respect to the parameter
    double DoParameterDerivative(const double * x, const double * p, unsigned int ipar) const;
 
+   void DoEvalBatch(unsigned int n, const double * x, const double * p, double * f) const;
+
 
    bool fLinear;                 // flag for linear functions
    bool fPolynomial;             // flag for polynomial functions
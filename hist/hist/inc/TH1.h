@@ -80,6 +80,7 @@ class TVirtualHistPainter;
 class TH1 : public TNamed, public TAttLine, public TAttFill, public TAttMarker {
 
 public:
+   friend class TH1ConcurrentFiller;
 
    // enumeration specifying type of statistics for bin errors
    enum  EBinErrorOpt {
@@ -302,6 +303,7 @@ public:
    virtual Int_t    GetQuantiles(Int_t nprobSum, Double_t *q, const Double_t *probSum=0);
    virtual Double_t GetRandom() const;
    virtual void     GetStats(Double_t *stats) const;
+   static  Bool_t   GetStatOverflows();
            Double_t GetStdDev(Int_t axis=1) const { return GetRMS(axis); }
            Double_t GetStdDevError(Int_t axis=1) const { return GetRMSError(axis); }
    virtual Double_t GetSumOfWeights() const;
@@ -0,0 +1,71 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TH1ConcurrentFiller
+#define ROOT_TH1ConcurrentFiller
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TH1ConcurrentFiller                                                  //
+//                                                                      //
+// Per-thread filler of a histogram shared by several threads.          //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_TH1
+#include "TH1.h"
+#endif
+
+#include <unordered_map>
+#include <vector>
+
+class TH1ConcurrentFiller {
+
+private:
+   struct BinSums_t {
+      Double_t fSumw;    // sum of the weights
+      Double_t fSumw2;   // sum of the squares of the weights
+      BinSums_t() : fSumw(0), fSumw2(0) { }
+   };
+
+   TH1      *fHist;                 // histogram receiving the fills
+   Int_t     fMaxBins;              // number of buffered bins (or fills) triggering a Flush
+   Bool_t    fDirect;               // kTRUE if the bins are found by the filler, kFALSE if the fills are replayed
+   Int_t     fDimension;            // dimension of fHist
+   Int_t     fNx2;                  // number of bins of the x axis + 2
+   Int_t     fNy2;                  // number of bins of the y axis + 2
+   Bool_t    fWeighted;             // kTRUE if a weight different from 1 was used
+   Double_t  fEntries;              // number of fills since the last Flush
+   Double_t  fStats[TH1::kNstat];   // statistics of the fills since the last Flush (see TH1::GetStats)
+   std::unordered_map<Int_t,BinSums_t> fBins;  // sums per global bin, for the touched bins only
+   std::vector<Double_t> fFills;    // fills to replay (number of arguments and 4 values per fill)
+
+   TH1ConcurrentFiller(const TH1ConcurrentFiller &);            // not implemented
+   TH1ConcurrentFiller &operator=(const TH1ConcurrentFiller &); // not implemented
+
+   Int_t    AddFill(Int_t nargs, Double_t a, Double_t b, Double_t c, Double_t d);
+   Int_t    DoFill(Double_t x, Double_t y, Double_t z, Double_t w);
+
+public:
+   TH1ConcurrentFiller(TH1 *h, Int_t maxbins = 65536);
+   virtual ~TH1ConcurrentFiller();
+
+   Int_t    Fill(Double_t x);
+   Int_t    Fill(Double_t x, Double_t y);
+   Int_t    Fill(Double_t x, Double_t y, Double_t z);
+   Int_t    Fill(Double_t x, Double_t y, Double_t z, Double_t w);
+   void     Flush();
+   TH1     *GetHistogram() const { return fHist; }
+   Int_t    GetNbinsBuffered() const { return fDirect ? (Int_t)fBins.size() : (Int_t)fFills.size()/5; }
+   Bool_t   IsDirect() const { return fDirect; }
+};
+
+#endif
@@ -35,6 +35,9 @@ class TProfile;
 
 class TH2 : public TH1 {
 
+public:
+   friend class TH1ConcurrentFiller;
+
 protected:
    Double_t     fScalefactor;     //Scale factor
    Double_t     fTsumwy;          //Total Sum of weight*Y
@@ -38,6 +38,7 @@
 #include "TVirtualHistPainter.h"
 #include "TVirtualFFT.h"
 #include "TSystem.h"
+#include "THFillHelper.h"
 
 #include "HFitInterface.h"
 #include "Fit/DataRange.h"
@@ -3116,18 +3117,32 @@ void TH1::FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride
    //    weights is automatically triggered and the sum of the squares of weights is incremented
    //    by w^2 in the bin corresponding to x.
    //    if w is NULL each entry is assumed a weight=1
+   //
+   //    Unless the axis can be extended, the entries are filled by chunks:
+   //    the bins are computed for all the entries of a chunk at once (see
+   //    TAxis::FindFixBins) and the statistics are accumulated in local sums.
 
    Int_t bin,i;
-   //If a buffer is activated, go via standard Fill (sorry)
-   //if (fBuffer) {
-   //   for (i=0;i<ntimes;i+=stride) {
-   //      if (w) Fill(x[i],w[i]);
-   //      else   Fill(x[i],0);
-   //   }
-   //   return;
-   //}
+   //If a buffer is activated, fill the buffer (it is deleted by
+   //BufferFill when it is full and the remaining entries are filled directly)
+   if (fBuffer) {
+      for (i=0;i<ntimes && fBuffer;i++) {
+         BufferFill(x[i*stride], w ? w[i*stride] : 1.);
+      }
+      if (i < ntimes) FillN(ntimes-i, x+i*stride, w ? w+i*stride : 0, stride);
+      return;
+   }
 
    fEntries += ntimes;
+   if (!fXaxis.CanExtend()) {
+      Double_t stats[kNstat] = {0};
+      THFillHelper::FillN<1>(this, ntimes, &x, w, stride, stats);
+      fTsumw   += stats[0];
+      fTsumw2  += stats[1];
+      fTsumwx  += stats[2];
+      fTsumwx2 += stats[3];
+      return;
+   }
    Double_t ww = 1;
    Int_t nbins   = fXaxis.GetNbins();
    ntimes *= stride;
@@ -3868,6 +3883,16 @@ Int_t TH1::GetDefaultBufferSize()
 }
 
 
+//______________________________________________________________________________
+Bool_t TH1::GetStatOverflows()
+{
+   // static function
+   // return kTRUE if the underflows and overflows are used in the statistics.
+   // see TH1::StatOverflows.
+
+   return fgStatOverflows;
+}
+
 //______________________________________________________________________________
 Bool_t TH1::GetDefaultSumw2()
 {
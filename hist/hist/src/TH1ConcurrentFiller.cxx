@@ -0,0 +1,320 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "TH1ConcurrentFiller.h"
+#include "TH2.h"
+#include "TH3.h"
+#include "TProfile.h"
+#include "TVirtualMutex.h"
+#include "TError.h"
+
+//______________________________________________________________________________
+//
+// TH1ConcurrentFiller
+//
+// Fills a histogram shared by several threads without keeping a full copy
+// of the histogram per thread. Each thread creates its own filler on the
+// shared histogram and fills via the filler:
+//
+//    TH2D *h = new TH2D("h", "h", 1000, 0, 1, 1000, 0, 1);  // shared
+//    ...
+//    // in each thread
+//    TH1ConcurrentFiller filler(h);
+//    for (...) filler.Fill(x, y);
+//    filler.Flush();   // or when filler goes out of scope
+//
+// The filler finds the bins itself and accumulates the sums of the weights
+// (and of their squares) only for the bins it touched, together with the
+// statistics (see TH1::GetStats), so the filling of the different threads
+// runs in parallel. These sums are added to the histogram, under a lock,
+// by Flush, which is called automatically when the number of touched bins
+// reaches maxbins and when the filler is deleted. The result is identical
+// to filling the histogram directly (up to the rounding of the sums).
+// The lock taken by Flush is chosen by the address of the histogram among
+// a set of mutexes: the fillers of a histogram are serialized only with
+// each other and, rarely, with those of a histogram sharing the mutex.
+//
+// For the histograms whose Fill does more than incrementing a bin
+// (profiles, TH2Poly, TH1K, axes which can be extended, alphanumeric
+// labels, histograms in buffer mode, ...) the filler only buffers the
+// fills and replays them with the histogram Fill in Flush; this is
+// correct but not faster than a lock around each Fill. IsDirect tells
+// which mode is used.
+//
+// Note that reading the shared histogram while fillers are in use only
+// sees the content of the flushed fillers, and that, as for any
+// multithreaded use of ROOT, TThread::Initialize() must have been called.
+//______________________________________________________________________________
+
+const Int_t kNConcurrentFillMutexes = 64;
+static TVirtualMutex *gConcurrentFillMutexes[kNConcurrentFillMutexes];
+
+//______________________________________________________________________________
+static TVirtualMutex *&R__ConcurrentFillMutex(const TH1 *h)
+{
+   // Return the mutex protecting the flushes into h.
+
+   ULong_t addr = (ULong_t)h;
+   return gConcurrentFillMutexes[(addr ^ (addr >> 9)) / sizeof(TH1) % kNConcurrentFillMutexes];
+}
+
+//______________________________________________________________________________
+static Bool_t R__CanFillDirect(const TH1 *h)
+{
+   // Return kTRUE if the Fill of h only increments the content of one bin
+   // and the statistics, i.e. if a TH1ConcurrentFiller can find the bins.
+
+   TClass *cl = h->IsA();
+   if (cl != TH1C::Class() && cl != TH1S::Class() && cl != TH1I::Class() &&
+       cl != TH1F::Class() && cl != TH1D::Class() &&
+       cl != TH2C::Class() && cl != TH2S::Class() && cl != TH2I::Class() &&
+       cl != TH2F::Class() && cl != TH2D::Class() &&
+       cl != TH3C::Class() && cl != TH3S::Class() && cl != TH3I::Class() &&
+       cl != TH3F::Class() && cl != TH3D::Class())
+      return kFALSE;
+   if (h->GetBuffer()) return kFALSE;
+   const TAxis *axes[3] = { h->GetXaxis(), h->GetYaxis(), h->GetZaxis() };
+   for (Int_t i = 0; i < h->GetDimension(); i++) {
+      if (axes[i]->CanExtend() || axes[i]->GetLabels()) return kFALSE;
+   }
+   return kTRUE;
+}
+
+//______________________________________________________________________________
+TH1ConcurrentFiller::TH1ConcurrentFiller(TH1 *h, Int_t maxbins) :
+   fHist(h), fMaxBins(maxbins > 0 ? maxbins : 1), fDirect(kFALSE), fDimension(0),
+   fNx2(0), fNy2(0), fWeighted(kFALSE), fEntries(0)
+{
+   // Create a filler of the histogram h. The content is added to h
+   // when maxbins bins (or maxbins fills for the histograms which can
+   // not be filled directly) are buffered, by Flush and by the destructor.
+
+   for (Int_t i = 0; i < TH1::kNstat; i++) fStats[i] = 0;
+   if (!fHist) {
+      ::Error("TH1ConcurrentFiller::TH1ConcurrentFiller", "no histogram to fill");
+      return;
+   }
+   fDimension = fHist->GetDimension();
+   fNx2 = fHist->GetXaxis()->GetNbins() + 2;
+   fNy2 = fHist->GetYaxis()->GetNbins() + 2;
+   fDirect = R__CanFillDirect(fHist);
+}
+
+//______________________________________________________________________________
+TH1ConcurrentFiller::~TH1ConcurrentFiller()
+{
+   // Destructor, add the buffered content to the histogram.
+
+   Flush();
+}
+
+//______________________________________________________________________________
+Int_t TH1ConcurrentFiller::AddFill(Int_t nargs, Double_t a, Double_t b, Double_t c, Double_t d)
+{
+   // Buffer a fill with nargs arguments, to be replayed by Flush.
+
+   fFills.push_back(nargs);
+   fFills.push_back(a);
+   fFills.push_back(b);
+   fFills.push_back(c);
+   fFills.push_back(d);
+   if ((Int_t)fFills.size() >= 5*fMaxBins) Flush();
+   return 0;
+}
+
+//______________________________________________________________________________
+Int_t TH1ConcurrentFiller::DoFill(Double_t x, Double_t y, Double_t z, Double_t w)
+{
+   // Increment the local sums of the bin containing (x,y,z) by w.
+   // Returns the global bin number, or -1 if the point is in an underflow or
+   // overflow bin not used in the statistics (see TH1::Fill).
+
+   fEntries++;
+   Int_t binx = fHist->GetXaxis()->FindFixBin(x);
+   Int_t biny = 0, binz = 0;
+   if (fDimension > 1) biny = fHist->GetYaxis()->FindFixBin(y);
+   if (fDimension > 2) binz = fHist->GetZaxis()->FindFixBin(z);
+   Int_t bin = binx + fNx2*(biny + fNy2*binz);
+
+   BinSums_t &sums = fBins[bin];
+   sums.fSumw  += w;
+   sums.fSumw2 += w*w;
+   if (w != 1.0) fWeighted = kTRUE;
+
+   Bool_t inrange = (binx > 0 && binx < fNx2-1);
+   if (fDimension > 1) inrange = inrange && biny > 0 && biny < fNy2-1;
+   if (fDimension > 2) inrange = inrange && binz > 0 && binz <= fHist->GetZaxis()->GetNbins();
+   if (!inrange && !TH1::GetStatOverflows()) bin = -1;
+   else {
+      fStats[0] += w;
+      fStats[1] += w*w;
+      fStats[2] += w*x;
+      fStats[3] += w*x*x;
+      if (fDimension > 1) {
+         fStats[4] += w*y;
+         fStats[5] += w*y*y;
+         fStats[6] += w*x*y;
+      }
+      if (fDimension > 2) {
+         fStats[7]  += w*z;
+         fStats[8]  += w*z*z;
+         fStats[9]  += w*x*z;
+         fStats[10] += w*y*z;
+      }
+   }
+   if ((Int_t)fBins.size() >= fMaxBins) Flush();
+   return bin;
+}
+
+//______________________________________________________________________________
+Int_t TH1ConcurrentFiller::Fill(Double_t x)
+{
+   // Fill a 1-D histogram at x with weight 1, see TH1::Fill(Double_t).
+   // Returns the bin number, or -1 (see TH1::Fill), and 0 if the fill
+   // is buffered to be replayed.
+
+   if (!fHist) return -1;
+   if (!fDirect) return AddFill(1, x, 0, 0, 0);
+   if (fDimension != 1) {
+      ::Error("TH1ConcurrentFiller::Fill", "histogram %s is not 1-D", fHist->GetName());
+      return -1;
+   }
+   return DoFill(x, 0, 0, 1);
+}
+
+//______________________________________________________________________________
+Int_t TH1ConcurrentFiller::Fill(Double_t x, Double_t y)
+{
+   // Fill a 1-D histogram at x with weight y, or a 2-D histogram at (x,y)
+   // with weight 1, like TH1::Fill(Double_t, Double_t).
+
+   if (!fHist) return -1;
+   if (!fDirect) return AddFill(2, x, y, 0, 0);
+   if (fDimension == 1) return DoFill(x, 0, 0, y);
+   if (fDimension != 2) {
+      ::Error("TH1ConcurrentFiller::Fill", "histogram %s is not 1-D or 2-D", fHist->GetName());
+      return -1;
+   }
+   return DoFill(x, y, 0, 1);
+}
+
+//______________________________________________________________________________
+Int_t TH1ConcurrentFiller::Fill(Double_t x, Double_t y, Double_t z)
+{
+   // Fill a 2-D histogram at (x,y) with weight z, or a 3-D histogram at
+   // (x,y,z) with weight 1, like TH2::Fill(Double_t, Double_t, Double_t)
+   // and TH3::Fill(Double_t, Double_t, Double_t).
+
+   if (!fHist) return -1;
+   if (!fDirect) return AddFill(3, x, y, z, 0);
+   if (fDimension == 2) return DoFill(x, y, 0, z);
+   if (fDimension != 3) {
+      ::Error("TH1ConcurrentFiller::Fill", "histogram %s is not 2-D or 3-D", fHist->GetName());
+      return -1;
+   }
+   return DoFill(x, y, z, 1);
+}
+
+//______________________________________________________________________________
+Int_t TH1ConcurrentFiller::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
+{
+   // Fill a 3-D histogram at (x,y,z) with weight w, like
+   // TH3::Fill(Double_t, Double_t, Double_t, Double_t).
+
+   if (!fHist) return -1;
+   if (!fDirect) return AddFill(4, x, y, z, w);
+   if (fDimension != 3) {
+      ::Error("TH1ConcurrentFiller::Fill", "histogram %s is not 3-D", fHist->GetName());
+      return -1;
+   }
+   return DoFill(x, y, z, w);
+}
+
+//______________________________________________________________________________
+void TH1ConcurrentFiller::Flush()
+{
+   // Add the content buffered since the last Flush to the histogram.
+   // The histogram is locked during the operation, the other fillers
+   // of the same histogram can keep filling meanwhile.
+
+   if (!fHist) return;
+   TVirtualMutex *&mutex = R__ConcurrentFillMutex(fHist);
+   if (!fDirect) {
+      if (fFills.empty()) return;
+      R__LOCKGUARD2(mutex);
+      TH2 *h2 = dynamic_cast<TH2*>(fHist);
+      TH3 *h3 = dynamic_cast<TH3*>(fHist);
+      TProfile *hp = dynamic_cast<TProfile*>(fHist);
+      Int_t nbad = 0;
+      for (size_t i = 0; i < fFills.size(); i += 5) {
+         const Double_t *f = &fFills[i];
+         switch ((Int_t)f[0]) {
+            case 1: fHist->Fill(f[1]); break;
+            case 2: fHist->Fill(f[1], f[2]); break;
+            case 3:
+               if (hp)      hp->Fill(f[1], f[2], f[3]);
+               else if (h2) h2->Fill(f[1], f[2], f[3]);
+               else if (h3) h3->Fill(f[1], f[2], f[3]);
+               else nbad++;
+               break;
+            case 4:
+               if (h3) h3->Fill(f[1], f[2], f[3], f[4]);
+               else nbad++;
+               break;
+         }
+      }
+      if (nbad)
+         ::Error("TH1ConcurrentFiller::Flush", "%d fills with too many arguments for histogram %s ignored",
+                 nbad, fHist->GetName());
+      fFills.clear();
+      return;
+   }
+   if (fEntries == 0) return;
+
+   {
+      R__LOCKGUARD2(mutex);
+      // as in TH1::Fill, a weight different from 1 triggers the storage
+      // of the sum of the squares of the weights, before adding the content
+      if (fWeighted && !fHist->GetSumw2N()) fHist->Sumw2();
+
+      TArrayD *sumw2 = fHist->GetSumw2N() ? fHist->GetSumw2() : 0;
+      std::unordered_map<Int_t,BinSums_t>::const_iterator it;
+      for (it = fBins.begin(); it != fBins.end(); ++it) {
+         fHist->AddBinContent(it->first, it->second.fSumw);
+         if (sumw2) sumw2->fArray[it->first] += it->second.fSumw2;
+      }
+      // The sums are added as TH1::Fill does: GetStats would recompute
+      // them from the bins in the range of the axes, if a range is set.
+      fHist->fEntries += fEntries;
+      fHist->fTsumw   += fStats[0];
+      fHist->fTsumw2  += fStats[1];
+      fHist->fTsumwx  += fStats[2];
+      fHist->fTsumwx2 += fStats[3];
+      if (fDimension == 2) {
+         TH2 *h2 = (TH2*)fHist;
+         h2->fTsumwy  += fStats[4];
+         h2->fTsumwy2 += fStats[5];
+         h2->fTsumwxy += fStats[6];
+      } else if (fDimension == 3) {
+         TH3 *h3 = (TH3*)fHist;
+         h3->fTsumwy  += fStats[4];
+         h3->fTsumwy2 += fStats[5];
+         h3->fTsumwxy += fStats[6];
+         h3->fTsumwz  += fStats[7];
+         h3->fTsumwz2 += fStats[8];
+         h3->fTsumwxz += fStats[9];
+         h3->fTsumwyz += fStats[10];
+      }
+   }
+
+   fBins.clear();
+   fEntries = 0;
+   for (Int_t i = 0; i < TH1::kNstat; i++) fStats[i] = 0;
+}
@@ -24,6 +24,7 @@
 #include "TMath.h"
 #include "TObjString.h"
 #include "TVirtualHistPainter.h"
+#include "THFillHelper.h"
 
 
 ClassImp(TH2)
@@ -515,9 +516,33 @@ void TH2::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double
    //  If w is NULL each entry is assumed a weight=1
    //
    // NB: function only valid for a TH2x object
+   //
+   // Unless an axis can be extended, the entries are filled by chunks
+   // (see TH1::FillN).
 
    Int_t binx, biny, bin, i;
+   //If a buffer is activated, fill the buffer (see TH1::FillN)
+   if (fBuffer) {
+      for (i=0;i<ntimes && fBuffer;i++) {
+         BufferFill(x[i*stride], y[i*stride], w ? w[i*stride] : 1.);
+      }
+      if (i < ntimes) FillN(ntimes-i, x+i*stride, y+i*stride, w ? w+i*stride : 0, stride);
+      return;
+   }
    fEntries += ntimes;
+   if (!fXaxis.CanExtend() && !fYaxis.CanExtend()) {
+      const Double_t *coord[2] = { x, y };
+      Double_t stats[kNstat] = {0};
+      THFillHelper::FillN<2>(this, ntimes, coord, w, stride, stats);
+      fTsumw   += stats[0];
+      fTsumw2  += stats[1];
+      fTsumwx  += stats[2];
+      fTsumwx2 += stats[3];
+      fTsumwy  += stats[4];
+      fTsumwy2 += stats[5];
+      fTsumwxy += stats[6];
+      return;
+   }
    Double_t ww = 1;
    ntimes *= stride;
    for (i=0;i<ntimes;i+=stride) {
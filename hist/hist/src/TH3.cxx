@@ -23,6 +23,7 @@
 #include "TError.h"
 #include "TMath.h"
 #include "TObjString.h"
+#include "THFillHelper.h"
 
 ClassImp(TH3)
 
@@ -359,6 +360,63 @@ Int_t TH3::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
 }
 
 
+//______________________________________________________________________________
+void TH3::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z,
+                const Double_t *w, Int_t stride)
+{
+   // Fill a 3-D histogram with an array of values and weights.
+   //
+   // ntimes:  number of entries in arrays x, y, z and w (array size must be ntimes*stride)
+   // x:       array of x values to be histogrammed
+   // y:       array of y values to be histogrammed
+   // z:       array of z values to be histogrammed
+   // w:       array of weights
+   // stride:  step size through arrays x, y, z and w
+   //
+   //  If the weight is not equal to 1, the storage of the sum of squares of
+   //   weights is automatically triggered and the sum of the squares of weights is incremented
+   //   by w[i]^2 in the bin corresponding to x[i],y[i],z[i].
+   //  If w is NULL each entry is assumed a weight=1
+   //
+   // Unless an axis can be extended, the entries are filled by chunks
+   // (see TH1::FillN).
+   //
+   // NB: function only valid for a TH3x object
+
+   //If a buffer is activated, fill the buffer (see TH1::FillN)
+   if (fBuffer) {
+      Int_t i;
+      for (i = 0; i < ntimes && fBuffer; i++) {
+         BufferFill(x[i*stride], y[i*stride], z[i*stride], w ? w[i*stride] : 1.);
+      }
+      if (i < ntimes) FillN(ntimes-i, x+i*stride, y+i*stride, z+i*stride, w ? w+i*stride : 0, stride);
+      return;
+   }
+   if (fXaxis.CanExtend() || fYaxis.CanExtend() || fZaxis.CanExtend()) {
+      for (Int_t i = 0; i < ntimes; i++) {
+         if (w) Fill(x[i*stride], y[i*stride], z[i*stride], w[i*stride]);
+         else   Fill(x[i*stride], y[i*stride], z[i*stride], 1.);
+      }
+      return;
+   }
+   fEntries += ntimes;
+   const Double_t *coord[3] = { x, y, z };
+   Double_t stats[kNstat] = {0};
+   THFillHelper::FillN<3>(this, ntimes, coord, w, stride, stats);
+   fTsumw   += stats[0];
+   fTsumw2  += stats[1];
+   fTsumwx  += stats[2];
+   fTsumwx2 += stats[3];
+   fTsumwy  += stats[4];
+   fTsumwy2 += stats[5];
+   fTsumwxy += stats[6];
+   fTsumwz  += stats[7];
+   fTsumwz2 += stats[8];
+   fTsumwxz += stats[9];
+   fTsumwyz += stats[10];
+}
+
+
 //______________________________________________________________________________
 Int_t TH3::Fill(const char *namex, const char *namey, const char *namez, Double_t w)
 {
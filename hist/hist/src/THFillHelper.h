@@ -0,0 +1,150 @@
+// @(#)root/hist:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_THFillHelper
+#define ROOT_THFillHelper
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// THFillHelper                                                         //
+//                                                                      //
+// Batched filling of TH1, TH2 and TH3, used by their FillN.            //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "TH1.h"
+#include "TAxis.h"
+#include "TArrayD.h"
+#include "TMath.h"
+
+class THFillHelper {
+
+public:
+   enum {
+      kChunk = 512,  // number of entries processed at a time
+      kLanes = 4     // number of partial sums of the statistics
+   };
+
+   template <Int_t NDIM>
+   static void FillN(TH1 *h, Int_t ntimes, const Double_t *const *coord, const Double_t *w,
+                     Int_t stride, Double_t *stats);
+};
+
+//______________________________________________________________________________
+template <Int_t NDIM>
+void THFillHelper::FillN(TH1 *h, Int_t ntimes, const Double_t *const *coord, const Double_t *w,
+                         Int_t stride, Double_t *stats)
+{
+   // Fill the NDIM-dimensional histogram h with the ntimes entries of
+   // coordinates coord[0][i*stride], ..., coord[NDIM-1][i*stride] and weight
+   // w[i*stride] (1 if w is null). The axes must not be extendable.
+   // The statistics of the entries (with the layout of TH1::GetStats) are
+   // added to stats, they must be added by the caller to those of h.
+   //
+   // The entries are processed by chunks: the bins of all the entries of a
+   // chunk are computed first by TAxis::FindFixBins, the bin contents are
+   // then incremented and the statistics accumulated in kLanes independent
+   // partial sums without branches, which the compiler can vectorize.
+
+   if (ntimes <= 0) return;
+
+   // as in TH1::Fill, Sumw2 must be called before AddBinContent
+   if (w && !h->GetSumw2N()) {
+      for (Int_t i = 0; i < ntimes; i++) {
+         if (w[i*stride] != 1.0) { h->Sumw2(); break; }
+      }
+   }
+   Double_t *sumw2 = h->GetSumw2N() ? h->GetSumw2()->GetArray() : 0;
+
+   const TAxis *axis[3] = { h->GetXaxis(), h->GetYaxis(), h->GetZaxis() };
+   Int_t nbins[3];
+   for (Int_t d = 0; d < 3; d++) nbins[d] = axis[d]->GetNbins();
+   const Bool_t statoverflows = TH1::GetStatOverflows();
+   const Int_t  nstats = NDIM == 1 ? 4 : (NDIM == 2 ? 7 : 11);
+
+   Int_t    bins[NDIM][kChunk];
+   Int_t    gbin[kChunk];
+   Double_t ok[kChunk];
+   Double_t s[11][kLanes];
+   for (Int_t k = 0; k < 11; k++) {
+      for (Int_t l = 0; l < kLanes; l++) s[k][l] = 0;
+   }
+
+   for (Int_t i0 = 0; i0 < ntimes; i0 += kChunk) {
+      const Int_t n = TMath::Min((Int_t)kChunk, ntimes - i0);
+      const Double_t *x[3] = { 0, 0, 0 };
+      for (Int_t d = 0; d < NDIM; d++) {
+         x[d] = coord[d] + i0*stride;
+         axis[d]->FindFixBins(n, x[d], bins[d], stride);
+      }
+      const Double_t *wc = w ? w + i0*stride : 0;
+
+      // global bins and in-range flags
+      for (Int_t j = 0; j < n; j++) {
+         Int_t b = bins[NDIM-1][j];
+         Bool_t in = statoverflows || (b > 0 && b <= nbins[NDIM-1]);
+         for (Int_t d = NDIM-2; d >= 0; d--) {
+            b = b*(nbins[d]+2) + bins[d][j];
+            in = in && (statoverflows || (bins[d][j] > 0 && bins[d][j] <= nbins[d]));
+         }
+         gbin[j] = b;
+         ok[j]   = in ? 1. : 0.;
+      }
+
+      // bin contents
+      if (wc) {
+         for (Int_t j = 0; j < n; j++) {
+            Double_t ww = wc[j*stride];
+            if (sumw2) sumw2[gbin[j]] += ww*ww;
+            h->AddBinContent(gbin[j], ww);
+         }
+      } else {
+         for (Int_t j = 0; j < n; j++) {
+            if (sumw2) sumw2[gbin[j]] += 1;
+            h->AddBinContent(gbin[j], 1.);
+         }
+      }
+
+      // statistics, the entries out of range only add zeros
+      for (Int_t j0 = 0; j0 < n; j0 += kLanes) {
+         const Int_t nl = TMath::Min((Int_t)kLanes, n - j0);
+         for (Int_t l = 0; l < nl; l++) {
+            const Int_t j = j0 + l;
+            const Bool_t in = ok[j] != 0;
+            const Double_t z  = in ? (wc ? wc[j*stride] : 1.) : 0.;
+            const Double_t xx = in ? x[0][j*stride] : 0.;
+            s[0][l] += z;
+            s[1][l] += z*z;
+            s[2][l] += z*xx;
+            s[3][l] += z*xx*xx;
+            if (NDIM > 1) {
+               const Double_t yy = in ? x[1][j*stride] : 0.;
+               s[4][l] += z*yy;
+               s[5][l] += z*yy*yy;
+               s[6][l] += z*xx*yy;
+               if (NDIM > 2) {
+                  const Double_t zz = in ? x[2][j*stride] : 0.;
+                  s[7][l]  += z*zz;
+                  s[8][l]  += z*zz*zz;
+                  s[9][l]  += z*xx*zz;
+                  s[10][l] += z*yy*zz;
+               }
+            }
+         }
+      }
+   }
+
+   for (Int_t k = 0; k < nstats; k++) {
+      for (Int_t l = 0; l < kLanes; l++) stats[k] += s[k][l];
+   }
+}
+
+#endif
@@ -12,6 +12,12 @@
 
 #include "Math/WrappedTF1.h"
 #include "Math/WrappedMultiTF1.h"
+#include "TMath.h"
+#include "RConfigure.h"
+
+#ifdef R__HAS_VDT
+#include "vdt/exp.h"
+#endif
 
 #include <cmath>
 
@@ -230,6 +236,66 @@ double WrappedMultiTF1::DoParameterDerivative(const double * x, const double * p
    }
 }
 
+// exponential used in the batch evaluation of the builtin functions
+// (the vdt one is inlined and can be vectorized by the compiler)
+static inline double BatchExp(double x) {
+#ifdef R__HAS_VDT
+   return vdt::fast_exp(x);
+#else
+   return std::exp(x);
+#endif
+}
+
+void WrappedMultiTF1::DoEvalBatch(unsigned int n, const double * x, const double * p, double * f) const {
+   // evaluate the function at n points.
+   // The one-dimensional builtin formulas (gaus, expo, polN and landau or landaun) are
+   // computed directly in simple loops, without calling TF1::EvalPar for each point.
+   // The other functions, also the normalized gaus (gausn), are evaluated point
+   // by point
+   int number = (fDim == 1) ? fFunc->GetNumber() : 0;
+   if (number == 100 && fParams.size() == 3 && !fFunc->IsNormalized()) {
+      // gaus : p[0]*TMath::Gaus(x,p[1],p[2])
+      if (p[2] == 0) {
+         for (unsigned int i = 0; i < n; ++i) f[i] = p[0] * 1.e30;
+         return;
+      }
+      for (unsigned int i = 0; i < n; ++i) {
+         double arg = (x[i] - p[1]) / p[2];
+         double val = p[0] * BatchExp(-0.5 * arg * arg);
+         f[i] = (arg < -39. || arg > 39.) ? 0. : val;
+      }
+      return;
+   }
+   if (number == 200 && fParams.size() == 2) {
+      // expo : exp(p[0]+p[1]*x)
+      for (unsigned int i = 0; i < n; ++i)
+         f[i] = BatchExp(p[0] + p[1] * x[i]);
+      return;
+   }
+   if (number >= 300 && number < 400 && fParams.size() == (unsigned int) (number - 300 + 1)) {
+      // polN : sum of p[j]*x^j, summed in the same order as TFormula
+      unsigned int npar = fParams.size();
+      for (unsigned int i = 0; i < n; ++i) {
+         double val = 0;
+         double xj = 1;
+         for (unsigned int j = 0; j < npar; ++j) {
+            val += xj * p[j];
+            xj *= x[i];
+         }
+         f[i] = val;
+      }
+      return;
+   }
+   if (number == 400 && fParams.size() == 3) {
+      // landau or landaun : p[0]*TMath::Landau(x,p[1],p[2],norm)
+      bool norm = fFunc->IsNormalized();
+      for (unsigned int i = 0; i < n; ++i)
+         f[i] = p[0] * TMath::Landau(x[i], p[1], p[2], norm);
+      return;
+   }
+   BaseParamFunc::DoEvalBatch(n, x, p, f);
+}
+
 void WrappedMultiTF1::SetDerivPrecision(double eps) { fgEps = eps; }
 
 double WrappedMultiTF1::GetDerivPrecision( ) { return fgEps; }
@@ -97,6 +97,9 @@ protected:
 
    TList           *fInfoCache;      //!Cached list of the streamer infos in this file
    TList           *fOpenPhases;     //!Time info about open phases
+   char            *fMapAddress;     //!Address of the memory mapping of the file (option MMAP)
+   Long64_t         fMapSize;        //!Size of the memory mapping of the file
+   TList           *fMappedBuffers;  //!Buffers pointing into the memory mapping (see AttachMappedBuffer)
 
    static TList    *fgAsyncOpenRequests; //List of handles for pending open requests
 
@@ -111,11 +114,16 @@ protected:
    static std::atomic<Long64_t>  fgFileCounter;           //Counter for all opened files
    static std::atomic<Int_t>     fgReadCalls;             //Number of bytes read from all TFile objects
    static Int_t     fgReadaheadSize;         //Readahead buffer size
+   static Int_t     fgReadQueueDepth;        //Max number of parallel reads in ReadBuffers (local files)
    static Bool_t    fgReadInfo;              //if true (default) ReadStreamerInfo is called when opening a file
    virtual EAsyncOpenStatus GetAsyncOpenStatus() { return fAsyncOpenStatus; }
    virtual void  Init(Bool_t create);
    Bool_t        FlushWriteCache();
    Int_t         ReadBufferViaCache(char *buf, Int_t len);
+   Bool_t        ReadBufferViaMap(char *buf, Long64_t offset, Int_t len);
+   Bool_t        ReadBuffersParallel(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf);
+   Bool_t        MapFile();
+   void          UnmapFile();
    Int_t         WriteBufferViaCache(const char *buf, Int_t len);
 
    // Creating projects
@@ -164,6 +172,7 @@ public:
    TFile();
    TFile(const char *fname, Option_t *option="", const char *ftitle="", Int_t compress=1);
    virtual ~TFile();
+   void                AttachMappedBuffer(TBuffer *buf);
    virtual void        Close(Option_t *option=""); // *MENU*
    virtual void        Copy(TObject &) const { MayNotUse("Copy(TObject &)"); }
    virtual Bool_t      Cp(const char *dst, Bool_t progressbar = kTRUE,UInt_t buffersize = 1000000);
@@ -172,6 +181,7 @@ public:
                                  const char* name, Int_t bufsize);
    static TFile      *&CurrentFile(); // Return the current file for this thread.
    virtual void        Delete(const char *namecycle="");
+   void                DetachMappedBuffer(TBuffer *buf);
    virtual void        Draw(Option_t *option="");
    virtual void        DrawMap(const char *keys="*",Option_t *option=""); // *MENU*
    virtual void        FillBuffer(char *&buffer);
@@ -194,6 +204,7 @@ public:
    virtual const TUrl *GetEndpointUrl() const { return &fUrl; }
    TObjArray          *GetListOfProcessIDs() const {return fProcessIDs;}
    TList              *GetListOfFree() const { return fFree; }
+   char               *GetMappedBuffer(Long64_t pos, Int_t len);
    virtual Int_t       GetNfree() const { return fFree->GetSize(); }
    virtual Int_t       GetNProcessIDs() const { return fNProcessIDs; }
    Option_t           *GetOption() const { return fOption.Data(); }
@@ -215,6 +226,7 @@ public:
    virtual void        IncrementProcessIDs() { fNProcessIDs++; }
    virtual Bool_t      IsArchive() const { return fIsArchive; }
            Bool_t      IsBinary() const { return TestBit(kBinaryFile); }
+           Bool_t      IsMapped() const { return fMapAddress != 0; }
            Bool_t      IsRaw() const { return !fIsRootFile; }
    virtual Bool_t      IsOpen() const;
    virtual void        ls(Option_t *option="") const;
@@ -275,11 +287,13 @@ public:
    static Long64_t     GetFileBytesWritten();
    static Int_t        GetFileReadCalls();
    static Int_t        GetReadaheadSize();
+   static Int_t        GetReadQueueDepth();
 
    static void         SetFileBytesRead(Long64_t bytes = 0);
    static void         SetFileBytesWritten(Long64_t bytes = 0);
    static void         SetFileReadCalls(Int_t readcalls = 0);
    static void         SetReadaheadSize(Int_t bufsize = 256000);
+   static void         SetReadQueueDepth(Int_t depth = 16);
    static void         SetReadStreamerInfo(Bool_t readinfo=kTRUE);
 
    static Long64_t     GetFileCounter();
@@ -65,7 +65,11 @@ protected:
    TString        fObjectNames;     // List of object names to be either merged exclusively or skipped
    TList         *fMergeList;       // list of TObjString containing the name of the files need to be merged
    TList         *fExcessFiles;     //! List of TObjString containing the name of the files not yet added to fFileList due to user or system limitiation on the max number of files opened.
+   Int_t          fNProcesses;      // Number of processes used by Merge (default 1)
+   TString        fMergeOptions;    // Options passed to the Merge functions of the objects (e.g. a basket order of TTree::CloneTree)
 
+   Bool_t         MergeGroups(const TList &groups, const TList &targets);
+   Bool_t         MergeInParallel();
    Bool_t         OpenExcessFiles();
    virtual Bool_t AddFile(TFile *source, Bool_t own, Bool_t cpProgress);
    virtual Bool_t MergeRecursive(TDirectory *target, TList *sourcelist, Int_t type = kRegular | kAll);
@@ -94,6 +98,10 @@ public:
    TFile      *GetOutputFile() const { return fOutputFile; }
    Int_t       GetMaxOpenedFies() const { return fMaxOpenedFiles; }
    void        SetMaxOpenedFiles(Int_t newmax);
+   Int_t       GetNProcesses() const { return fNProcesses; }
+   void        SetNProcesses(Int_t nproc) { fNProcesses = nproc > 1 ? nproc : 1; }
+   const char *GetMergeOptions() const { return fMergeOptions; }
+   void        SetMergeOptions(const char *options) { fMergeOptions = options; }
    const char *GetMsgPrefix() const { return fMsgPrefix; }
    void        SetMsgPrefix(const char *prefix);
    void        AddObjectNames(const char *name) {fObjectNames += name; fObjectNames += " ";}
@@ -120,7 +128,7 @@ public:
    virtual void   SetNotrees(Bool_t notrees=kFALSE) {fNoTrees = notrees;}
    virtual void        RecursiveRemove(TObject *obj);
 
-   ClassDef(TFileMerger,5)  // File copying and merging services
+   ClassDef(TFileMerger,7)  // File copying and merging services
 };
 
 #endif
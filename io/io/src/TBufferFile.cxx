@@ -48,6 +48,115 @@
 #include "Bswapcpy.h"
 #endif
 
+// The byte swapping of the arrays of fundamental types is done with the
+// SSSE3 or AVX2 byte shuffle instructions when the processor supports them
+// (checked at run time). The R__SwapArrayNN functions swap as many elements
+// as they can in blocks of 16 or 32 bytes and return their number; the
+// remaining elements are swapped one by one by the callers.
+#if defined(R__BYTESWAP) && !defined(USE_BSWAPCPY) && defined(__x86_64__) && \
+    !defined(__CINT__) && !defined(__INTEL_COMPILER) && \
+    ((defined(__clang__) && !defined(__apple_build_version__) && \
+      (__clang_major__ > 3 || (__clang_major__ == 3 && __clang_minor__ >= 8))) || \
+     (!defined(__clang__) && defined(__GNUC__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define R__SWAP_SIMD
+#include <immintrin.h>
+#endif
+
+#ifdef R__SWAP_SIMD
+
+// Shuffle masks reversing the bytes of each 2, 4 and 8 bytes element. The
+// AVX2 shuffle works within each 16 bytes lane, hence the two identical halves.
+static const char gSwapMask16[32] = { 1, 0, 3, 2, 5, 4, 7, 6, 9, 8,11,10,13,12,15,14,
+                                      1, 0, 3, 2, 5, 4, 7, 6, 9, 8,11,10,13,12,15,14 };
+static const char gSwapMask32[32] = { 3, 2, 1, 0, 7, 6, 5, 4,11,10, 9, 8,15,14,13,12,
+                                      3, 2, 1, 0, 7, 6, 5, 4,11,10, 9, 8,15,14,13,12 };
+static const char gSwapMask64[32] = { 7, 6, 5, 4, 3, 2, 1, 0,15,14,13,12,11,10, 9, 8,
+                                      7, 6, 5, 4, 3, 2, 1, 0,15,14,13,12,11,10, 9, 8 };
+
+//______________________________________________________________________________
+__attribute__((target("avx2")))
+static Long64_t R__SwapBytesAVX2(char *to, const char *from, Long64_t nbytes, const char *mask)
+{
+   // Swap nbytes (multiple of 32) from 'from' to 'to' with the AVX2 shuffle.
+
+   const __m256i m = _mm256_loadu_si256((const __m256i*)mask);
+   Long64_t i = 0;
+   for (; i + 64 <= nbytes; i += 64) {
+      __m256i a = _mm256_loadu_si256((const __m256i*)(from + i));
+      __m256i b = _mm256_loadu_si256((const __m256i*)(from + i + 32));
+      _mm256_storeu_si256((__m256i*)(to + i), _mm256_shuffle_epi8(a, m));
+      _mm256_storeu_si256((__m256i*)(to + i + 32), _mm256_shuffle_epi8(b, m));
+   }
+   for (; i + 32 <= nbytes; i += 32) {
+      __m256i a = _mm256_loadu_si256((const __m256i*)(from + i));
+      _mm256_storeu_si256((__m256i*)(to + i), _mm256_shuffle_epi8(a, m));
+   }
+   return i;
+}
+
+//______________________________________________________________________________
+__attribute__((target("ssse3")))
+static Long64_t R__SwapBytesSSSE3(char *to, const char *from, Long64_t nbytes, const char *mask)
+{
+   // Swap nbytes (multiple of 16) from 'from' to 'to' with the SSSE3 shuffle.
+
+   const __m128i m = _mm_loadu_si128((const __m128i*)mask);
+   Long64_t i = 0;
+   for (; i + 16 <= nbytes; i += 16) {
+      __m128i a = _mm_loadu_si128((const __m128i*)(from + i));
+      _mm_storeu_si128((__m128i*)(to + i), _mm_shuffle_epi8(a, m));
+   }
+   return i;
+}
+
+//______________________________________________________________________________
+static Int_t R__SwapArrayLevel()
+{
+   // Return 2 if the processor supports AVX2, 1 for SSSE3 and 0 otherwise.
+   // The result is the same for all the threads, hence the benign race.
+
+   static Int_t level = -1;
+   if (level < 0) {
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2"))       level = 2;
+      else if (__builtin_cpu_supports("ssse3")) level = 1;
+      else                                      level = 0;
+   }
+   return level;
+}
+
+//______________________________________________________________________________
+static inline Int_t R__SwapArray(void *to, const void *from, Int_t n, Int_t size, const char *mask)
+{
+   // Swap the bytes of the first elements of the array 'from' (n elements
+   // of 'size' bytes) into 'to'. Return the number of elements swapped.
+
+   Long64_t nbytes = Long64_t(n) * size;
+   if (nbytes < 16) return 0;
+   Int_t level = R__SwapArrayLevel();
+   Long64_t done = 0;
+   if (level == 2) {
+      done = R__SwapBytesAVX2((char*)to, (const char*)from, nbytes & ~Long64_t(31), mask);
+   }
+   if (level >= 1 && nbytes - done >= 16) {
+      done += R__SwapBytesSSSE3((char*)to + done, (const char*)from + done, (nbytes - done) & ~Long64_t(15), mask);
+   }
+   return Int_t(done / size);
+}
+
+static inline Int_t R__SwapArray16(void *to, const void *from, Int_t n) { return R__SwapArray(to, from, n, 2, gSwapMask16); }
+static inline Int_t R__SwapArray32(void *to, const void *from, Int_t n) { return R__SwapArray(to, from, n, 4, gSwapMask32); }
+static inline Int_t R__SwapArray64(void *to, const void *from, Int_t n) { return R__SwapArray(to, from, n, 8, gSwapMask64); }
+
+#else
+
+static inline Int_t R__SwapArray16(void *, const void *, Int_t) { return 0; }
+static inline Int_t R__SwapArray32(void *, const void *, Int_t) { return 0; }
+static inline Int_t R__SwapArray64(void *, const void *, Int_t) { return 0; }
+
+#endif
+
 
 const UInt_t kNullTag           = 0;
 const UInt_t kNewClassTag       = 0xFFFFFFFF;
@@ -746,7 +855,9 @@ Int_t TBufferFile::ReadArray(Short_t *&h)
    bswapcpy16(h, fBufCur, n);
    fBufCur += l;
 # else
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray16(h, fBufCur, n);
+   fBufCur += sizeof(Short_t)*i;
+   for (; i < n; i++)
       frombuf(fBufCur, &h[i]);
 # endif
 #else
@@ -779,7 +890,9 @@ Int_t TBufferFile::ReadArray(Int_t *&ii)
    bswapcpy32(ii, fBufCur, n);
    fBufCur += l;
 # else
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray32(ii, fBufCur, n);
+   fBufCur += sizeof(Int_t)*i;
+   for (; i < n; i++)
       frombuf(fBufCur, &ii[i]);
 # endif
 #else
@@ -834,7 +947,9 @@ Int_t TBufferFile::ReadArray(Long64_t *&ll)
    if (!ll) ll = new Long64_t[n];
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray64(ll, fBufCur, n);
+   fBufCur += sizeof(Long64_t)*i;
+   for (; i < n; i++)
       frombuf(fBufCur, &ll[i]);
 #else
    memcpy(ll, fBufCur, l);
@@ -866,7 +981,9 @@ Int_t TBufferFile::ReadArray(Float_t *&f)
    bswapcpy32(f, fBufCur, n);
    fBufCur += l;
 # else
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray32(f, fBufCur, n);
+   fBufCur += sizeof(Float_t)*i;
+   for (; i < n; i++)
       frombuf(fBufCur, &f[i]);
 # endif
 #else
@@ -895,7 +1012,9 @@ Int_t TBufferFile::ReadArray(Double_t *&d)
    if (!d) d = new Double_t[n];
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray64(d, fBufCur, n);
+   fBufCur += sizeof(Double_t)*i;
+   for (; i < n; i++)
       frombuf(fBufCur, &d[i]);
 #else
    memcpy(d, fBufCur, l);
@@ -1019,7 +1138,9 @@ Int_t TBufferFile::ReadStaticArray(Short_t *h)
    bswapcpy16(h, fBufCur, n);
    fBufCur += l;
 # else
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray16(h, fBufCur, n);
+   fBufCur += sizeof(Short_t)*i;
+   for (; i < n; i++)
       frombuf(fBufCur, &h[i]);
 # endif
 #else
@@ -1051,7 +1172,9 @@ Int_t TBufferFile::ReadStaticArray(Int_t *ii)
    bswapcpy32(ii, fBufCur, n);
    fBufCur += sizeof(Int_t)*n;
 # else
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray32(ii, fBufCur, n);
+   fBufCur += sizeof(Int_t)*i;
+   for (; i < n; i++)
       frombuf(fBufCur, &ii[i]);
 # endif
 #else
@@ -1104,7 +1227,9 @@ Int_t TBufferFile::ReadStaticArray(Long64_t *ll)
    if (!ll) return 0;
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray64(ll, fBufCur, n);
+   fBufCur += sizeof(Long64_t)*i;
+   for (; i < n; i++)
       frombuf(fBufCur, &ll[i]);
 #else
    memcpy(ll, fBufCur, l);
@@ -1135,7 +1260,9 @@ Int_t TBufferFile::ReadStaticArray(Float_t *f)
    bswapcpy32(f, fBufCur, n);
    fBufCur += sizeof(Float_t)*n;
 # else
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray32(f, fBufCur, n);
+   fBufCur += sizeof(Float_t)*i;
+   for (; i < n; i++)
       frombuf(fBufCur, &f[i]);
 # endif
 #else
@@ -1163,7 +1290,9 @@ Int_t TBufferFile::ReadStaticArray(Double_t *d)
    if (!d) return 0;
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray64(d, fBufCur, n);
+   fBufCur += sizeof(Double_t)*i;
+   for (; i < n; i++)
       frombuf(fBufCur, &d[i]);
 #else
    memcpy(d, fBufCur, l);
@@ -1285,7 +1414,9 @@ void TBufferFile::ReadFastArray(Short_t *h, Int_t n)
    bswapcpy16(h, fBufCur, n);
    fBufCur += sizeof(Short_t)*n;
 # else
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray16(h, fBufCur, n);
+   fBufCur += sizeof(Short_t)*i;
+   for (; i < n; i++)
       frombuf(fBufCur, &h[i]);
 # endif
 #else
@@ -1307,7 +1438,9 @@ void TBufferFile::ReadFastArray(Int_t *ii, Int_t n)
    bswapcpy32(ii, fBufCur, n);
    fBufCur += sizeof(Int_t)*n;
 # else
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray32(ii, fBufCur, n);
+   fBufCur += sizeof(Int_t)*i;
+   for (; i < n; i++)
       frombuf(fBufCur, &ii[i]);
 # endif
 #else
@@ -1341,7 +1474,9 @@ void TBufferFile::ReadFastArray(Long64_t *ll, Int_t n)
    if (l <= 0 || l > fBufSize) return;
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray64(ll, fBufCur, n);
+   fBufCur += sizeof(Long64_t)*i;
+   for (; i < n; i++)
       frombuf(fBufCur, &ll[i]);
 #else
    memcpy(ll, fBufCur, l);
@@ -1362,7 +1497,9 @@ void TBufferFile::ReadFastArray(Float_t *f, Int_t n)
    bswapcpy32(f, fBufCur, n);
    fBufCur += sizeof(Float_t)*n;
 # else
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray32(f, fBufCur, n);
+   fBufCur += sizeof(Float_t)*i;
+   for (; i < n; i++)
       frombuf(fBufCur, &f[i]);
 # endif
 #else
@@ -1380,7 +1517,9 @@ void TBufferFile::ReadFastArray(Double_t *d, Int_t n)
    if (l <= 0 || l > fBufSize) return;
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray64(d, fBufCur, n);
+   fBufCur += sizeof(Double_t)*i;
+   for (; i < n; i++)
       frombuf(fBufCur, &d[i]);
 #else
    memcpy(d, fBufCur, l);
@@ -1717,7 +1856,9 @@ void TBufferFile::WriteArray(const Short_t *h, Int_t n)
    bswapcpy16(fBufCur, h, n);
    fBufCur += l;
 # else
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray16(fBufCur, h, n);
+   fBufCur += sizeof(Short_t)*i;
+   for (; i < n; i++)
       tobuf(fBufCur, h[i]);
 # endif
 #else
@@ -1747,7 +1888,9 @@ void TBufferFile::WriteArray(const Int_t *ii, Int_t n)
    bswapcpy32(fBufCur, ii, n);
    fBufCur += l;
 # else
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray32(fBufCur, ii, n);
+   fBufCur += sizeof(Int_t)*i;
+   for (; i < n; i++)
       tobuf(fBufCur, ii[i]);
 # endif
 #else
@@ -1811,7 +1954,9 @@ void TBufferFile::WriteArray(const Long64_t *ll, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray64(fBufCur, ll, n);
+   fBufCur += sizeof(Long64_t)*i;
+   for (; i < n; i++)
       tobuf(fBufCur, ll[i]);
 #else
    memcpy(fBufCur, ll, l);
@@ -1840,7 +1985,9 @@ void TBufferFile::WriteArray(const Float_t *f, Int_t n)
    bswapcpy32(fBufCur, f, n);
    fBufCur += l;
 # else
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray32(fBufCur, f, n);
+   fBufCur += sizeof(Float_t)*i;
+   for (; i < n; i++)
       tobuf(fBufCur, f[i]);
 # endif
 #else
@@ -1866,7 +2013,9 @@ void TBufferFile::WriteArray(const Double_t *d, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray64(fBufCur, d, n);
+   fBufCur += sizeof(Double_t)*i;
+   for (; i < n; i++)
       tobuf(fBufCur, d[i]);
 #else
    memcpy(fBufCur, d, l);
@@ -1983,7 +2132,9 @@ void TBufferFile::WriteFastArray(const Short_t *h, Int_t n)
    bswapcpy16(fBufCur, h, n);
    fBufCur += l;
 # else
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray16(fBufCur, h, n);
+   fBufCur += sizeof(Short_t)*i;
+   for (; i < n; i++)
       tobuf(fBufCur, h[i]);
 # endif
 #else
@@ -2007,7 +2158,9 @@ void TBufferFile::WriteFastArray(const Int_t *ii, Int_t n)
    bswapcpy32(fBufCur, ii, n);
    fBufCur += l;
 # else
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray32(fBufCur, ii, n);
+   fBufCur += sizeof(Int_t)*i;
+   for (; i < n; i++)
       tobuf(fBufCur, ii[i]);
 # endif
 #else
@@ -2055,7 +2208,9 @@ void TBufferFile::WriteFastArray(const Long64_t *ll, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray64(fBufCur, ll, n);
+   fBufCur += sizeof(Long64_t)*i;
+   for (; i < n; i++)
       tobuf(fBufCur, ll[i]);
 #else
    memcpy(fBufCur, ll, l);
@@ -2078,7 +2233,9 @@ void TBufferFile::WriteFastArray(const Float_t *f, Int_t n)
    bswapcpy32(fBufCur, f, n);
    fBufCur += l;
 # else
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray32(fBufCur, f, n);
+   fBufCur += sizeof(Float_t)*i;
+   for (; i < n; i++)
       tobuf(fBufCur, f[i]);
 # endif
 #else
@@ -2098,7 +2255,9 @@ void TBufferFile::WriteFastArray(const Double_t *d, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
-   for (int i = 0; i < n; i++)
+   int i = R__SwapArray64(fBufCur, d, n);
+   fBufCur += sizeof(Double_t)*i;
+   for (; i < n; i++)
       tobuf(fBufCur, d[i]);
 #else
    memcpy(fBufCur, d, l);
@@ -70,6 +70,7 @@
 #include <sys/stat.h>
 #ifndef WIN32
 #   include <unistd.h>
+#   include <sys/mman.h>
 #else
 #   define ssize_t int
 #   include <io.h>
@@ -82,6 +83,7 @@
 #include "RConfigure.h"
 #include "Strlen.h"
 #include "TArrayC.h"
+#include "TBufferFile.h"
 #include "TClass.h"
 #include "TClassEdit.h"
 #include "TClassTable.h"
@@ -112,8 +114,12 @@
 #include "TObjString.h"
 #include "TStopwatch.h"
 #include "compiledata.h"
+#include "TThread.h"
+#include "TMutex.h"
+#include "TCondition.h"
 #include <cmath>
 #include <set>
+#include <vector>
 #include "TSchemaRule.h"
 #include "TSchemaRuleSet.h"
 #include "TThreadSlots.h"
@@ -126,6 +132,7 @@ std::atomic<Long64_t> TFile::fgBytesWrite{0};
 std::atomic<Long64_t> TFile::fgFileCounter{0};
 std::atomic<Int_t>    TFile::fgReadCalls{0};
 Int_t    TFile::fgReadaheadSize = 256000;
+Int_t    TFile::fgReadQueueDepth = -1;
 Bool_t   TFile::fgReadInfo = kTRUE;
 TList   *TFile::fgAsyncOpenRequests = 0;
 TString  TFile::fgCacheFileDir;
@@ -173,6 +180,9 @@ TFile::TFile() : TDirectoryFile(), fInfoCache(0)
    fReadCalls       = 0;
    fInfoCache       = 0;
    fOpenPhases      = 0;
+   fMapAddress      = 0;
+   fMapSize         = 0;
+   fMappedBuffers   = 0;
    fNoAnchorInName  = kFALSE;
    fIsRootFile      = kTRUE;
    fIsArchive       = kFALSE;
@@ -201,7 +211,8 @@ TFile::TFile() : TDirectoryFile(), fInfoCache(0)
 
 //_____________________________________________________________________________
 TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t compress)
-           : TDirectoryFile(), fUrl(fname1,kTRUE), fInfoCache(0), fOpenPhases(0)
+           : TDirectoryFile(), fUrl(fname1,kTRUE), fInfoCache(0), fOpenPhases(0),
+             fMapAddress(0), fMapSize(0), fMappedBuffers(0)
 {
    // Opens or creates a local ROOT file whose name is fname1. It is
    // recommended to specify fname1 as "<file>.root". The suffix ".root"
@@ -221,6 +232,8 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
    //           = UPDATE          open an existing file for writing.
    //                             if no file exists, it is created.
    //           = READ            open an existing file for reading (default).
+   //           = MMAP            open an existing file for reading and map it
+   //                             in memory (see below).
    //           = NET             used by derived remote file access
    //                             classes, not a user callable option
    //           = WEB             used by derived remote http access
@@ -237,6 +250,14 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
    // archive or member 1 from the archive. For more on archive file
    // support see the TArchiveFile class.
    //
+   // With option MMAP, a local file is opened for reading and mapped in
+   // memory. The buffers are then copied from the mapping instead of being
+   // read with a system call, the prefetching done by the read cache
+   // (TTreeCache) only advises the kernel to load the pages in advance and
+   // the baskets of a TTree are unzipped, or used in place if they are not
+   // compressed, directly from the mapping (see GetMappedBuffer). If the
+   // file cannot be mapped, it is read as with option READ.
+   //
    // TFile and its remote access plugins can also be used to open any
    // file, i.e. also non ROOT files, using:
    //    file.tar?filetype=raw
@@ -278,7 +299,9 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
    //   ROOT::CompressionSettings(ROOT::kLZMA, 1)
    // will build an integer which will set the compression to use
    // the LZMA algorithm and compression level 1.  These are defined
-   // in the header file Compression.h.
+   // in the header file Compression.h. The available algorithms are
+   // ZLIB (the default), LZMA, LZ4 (fastest decompression) and
+   // ZSTD (ratio close to ZLIB, faster to compress and decompress).
    //
    // Note that the compression settings may be changed at any time.
    // The new compression settings will only apply to branches created
@@ -390,6 +413,12 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
    if (fOption == "NEW")
       fOption = "CREATE";
 
+   Bool_t mmap = kFALSE;
+   if (fOption == "MMAP") {
+      fOption = "READ";
+      mmap    = kTRUE;
+   }
+
    Bool_t create   = (fOption == "CREATE") ? kTRUE : kFALSE;
    Bool_t recreate = (fOption == "RECREATE") ? kTRUE : kFALSE;
    Bool_t update   = (fOption == "UPDATE") ? kTRUE : kFALSE;
@@ -489,6 +518,7 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
          goto zombie;
       }
       fWritable = kFALSE;
+      if (mmap) MapFile();
    }
 
    Init(create);
@@ -506,7 +536,8 @@ zombie:
 }
 
 //______________________________________________________________________________
-TFile::TFile(const TFile &) : TDirectoryFile(), fInfoCache(0)
+TFile::TFile(const TFile &) : TDirectoryFile(), fInfoCache(0), fMapAddress(0), fMapSize(0),
+                              fMappedBuffers(0)
 {
    // TFile objects can not be copied.
 
@@ -877,6 +908,7 @@ void TFile::Close(Option_t *option)
 
    if (fIsArchive || !fIsRootFile) {
       FlushWriteCache();
+      UnmapFile();
       SysClose(fD);
       fD = -1;
 
@@ -932,6 +964,7 @@ void TFile::Close(Option_t *option)
    }
 
    if (IsOpen()) {
+      UnmapFile();
       SysClose(fD);
       fD = -1;
    }
@@ -1507,6 +1540,9 @@ Bool_t TFile::ReadBuffer(char *buf, Long64_t pos, Int_t len)
          return kFALSE;
       }
 
+      if (fMapAddress && ReadBufferViaMap(buf, pos + fArchiveOffset, len))
+         return kFALSE;
+
       Seek(pos);
       ssize_t siz;
 
@@ -1552,6 +1588,13 @@ Bool_t TFile::ReadBuffer(char *buf, Int_t len)
          return kFALSE;
       }
 
+      if (fMapAddress) {
+         if (ReadBufferViaMap(buf, fOffset, len))
+            return kFALSE;
+         // the reads from the mapping do not move the file pointer
+         Seek(GetRelOffset());
+      }
+
       ssize_t siz;
       Double_t start = 0;
 
@@ -1584,6 +1627,210 @@ Bool_t TFile::ReadBuffer(char *buf, Int_t len)
    return kTRUE;
 }
 
+#ifndef WIN32
+//______________________________________________________________________________
+//
+// TFileReadPool
+//
+// Process wide pool of threads reading byte ranges of local files with
+// pread(). TFile::ReadBuffersParallel submits all the segments of a cache
+// transfer at once, the segments are then read in any order directly into
+// their place in the destination buffer. This keeps up to
+// TFile::GetReadQueueDepth() requests in flight, letting the disk and the
+// kernel reorder them, instead of reading the segments one after the other.
+//______________________________________________________________________________
+
+class TFileReadPool {
+public:
+   struct Request_t {
+      char     *fBuf;   // destination of the bytes
+      Long64_t  fPos;   // physical offset in the file
+      Int_t     fLen;   // number of bytes to read
+   };
+
+private:
+   std::vector<TThread*> fThreads;
+   TMutex           fBatchMutex;     // serializes the batches of different files
+   TMutex           fMutex;          // protects the members below
+   TCondition       fWorkCondition;  // signaled when a batch is submitted and at shutdown
+   TCondition       fDoneCondition;  // signaled when the batch is read
+   Int_t            fFd;             // file descriptor of the current batch
+   const Request_t *fRequests;       // requests of the current batch
+   Int_t            fNRequests;      // number of requests of the current batch
+   Int_t            fNext;           // next request to read
+   Int_t            fNDone;          // number of requests completed
+   Int_t            fNReads;         // number of pread() calls issued for the batch
+   Int_t            fStatus;         // first error of the batch (errno, -1 for end of file)
+   Bool_t           fShutdown;       // kTRUE when the threads must stop
+
+   TFileReadPool();
+   ~TFileReadPool();
+
+   void         AddThreads(Int_t nthreads);
+   Bool_t       ReadNext();
+   static Int_t ReadRequest(Int_t fd, const Request_t &req, Int_t &nreads);
+   static void *WorkerLoop(void *arg);
+
+public:
+   Int_t Read(Int_t fd, const Request_t *req, Int_t n, Int_t &nreads);
+
+   static TFileReadPool *Instance(Int_t nthreads);
+};
+
+//______________________________________________________________________________
+TFileReadPool::TFileReadPool() :
+   fMutex(kTRUE), fWorkCondition(&fMutex), fDoneCondition(&fMutex), fFd(-1), fRequests(0),
+   fNRequests(0), fNext(0), fNDone(0), fNReads(0), fStatus(0), fShutdown(kFALSE)
+{
+   // Constructor, the threads are started by Instance.
+
+   TThread::Initialize();
+}
+
+//______________________________________________________________________________
+TFileReadPool::~TFileReadPool()
+{
+   // Stop the reading threads and join them.
+
+   {
+      R__LOCKGUARD(&fMutex);
+      fShutdown = kTRUE;
+      fWorkCondition.Broadcast();
+   }
+   for (UInt_t i = 0; i < fThreads.size(); i++) {
+      fThreads[i]->Join();
+      delete fThreads[i];
+   }
+}
+
+//______________________________________________________________________________
+TFileReadPool *TFileReadPool::Instance(Int_t nthreads)
+{
+   // Return the process wide pool, making sure that it has at least nthreads
+   // reading threads. The pool is created at the first call (the
+   // initialization of the static is thread safe) and its threads, which
+   // sleep between the batches, are stopped at the end of the program.
+
+   static TFileReadPool pool;
+   R__LOCKGUARD(&pool.fBatchMutex);
+   if ((Int_t)pool.fThreads.size() < nthreads)
+      pool.AddThreads(nthreads - (Int_t)pool.fThreads.size());
+   return &pool;
+}
+
+//______________________________________________________________________________
+void TFileReadPool::AddThreads(Int_t nthreads)
+{
+   // Start nthreads more reading threads.
+
+   for (Int_t i = 0; i < nthreads; i++) {
+      TThread *thread = new TThread(TString::Format("FileRead%d", (Int_t)fThreads.size()),
+                                    WorkerLoop, (void*)this);
+      fThreads.push_back(thread);
+      thread->Run();
+   }
+}
+
+//______________________________________________________________________________
+Int_t TFileReadPool::ReadRequest(Int_t fd, const Request_t &req, Int_t &nreads)
+{
+   // Read the bytes of one request, restarting interrupted and short reads.
+   // nreads is incremented by the number of pread() calls.
+   // Returns 0 in case of success, errno in case of error and -1 if the
+   // end of the file is reached before the requested bytes are read.
+
+   char    *buf = req.fBuf;
+   Long64_t pos = req.fPos;
+   Int_t    len = req.fLen;
+   while (len > 0) {
+      ssize_t siz = ::pread(fd, buf, len, pos);
+      if (siz < 0) {
+         if (errno == EINTR) continue;
+         return errno;
+      }
+      ++nreads;
+      if (siz == 0) return -1;
+      buf += siz;
+      pos += siz;
+      len -= siz;
+   }
+   return 0;
+}
+
+//______________________________________________________________________________
+Bool_t TFileReadPool::ReadNext()
+{
+   // Read the next request of the current batch.
+   // Returns kFALSE if there is no request left to read.
+
+   Int_t fd, i;
+   {
+      R__LOCKGUARD(&fMutex);
+      if (fNext >= fNRequests) return kFALSE;
+      fd = fFd;
+      i  = fNext++;
+   }
+   Int_t nreads = 0;
+   Int_t status = ReadRequest(fd, fRequests[i], nreads);
+
+   R__LOCKGUARD(&fMutex);
+   if (status && !fStatus) fStatus = status;
+   fNReads += nreads;
+   if (++fNDone == fNRequests) fDoneCondition.Signal();
+   return kTRUE;
+}
+
+//______________________________________________________________________________
+void *TFileReadPool::WorkerLoop(void *arg)
+{
+   // Function executed by the reading threads, until the shutdown of the pool.
+
+   TFileReadPool *pool = (TFileReadPool*)arg;
+   while (1) {
+      if (pool->ReadNext()) continue;
+      R__LOCKGUARD(&pool->fMutex);
+      if (pool->fShutdown) break;
+      if (pool->fNext >= pool->fNRequests) pool->fWorkCondition.Wait();
+   }
+   return 0;
+}
+
+//______________________________________________________________________________
+Int_t TFileReadPool::Read(Int_t fd, const Request_t *req, Int_t n, Int_t &nreads)
+{
+   // Read the n requests from the file descriptor fd. Returns when all of
+   // them are completed, with the status of the first failed request
+   // (see ReadRequest) or 0 if all of them succeeded. nreads is set to
+   // the number of pread() calls issued.
+
+   R__LOCKGUARD(&fBatchMutex);
+   {
+      R__LOCKGUARD(&fMutex);
+      fFd        = fd;
+      fRequests  = req;
+      fNRequests = n;
+      fNext      = 0;
+      fNDone     = 0;
+      fNReads    = 0;
+      fStatus    = 0;
+      fWorkCondition.Broadcast();
+   }
+   while (ReadNext()) {}
+
+   R__LOCKGUARD(&fMutex);
+   while (fNDone < fNRequests) fDoneCondition.Wait();
+   Int_t status = fStatus;
+   nreads     = fNReads;
+   fFd        = -1;
+   fRequests  = 0;
+   fNRequests = 0;
+   fNext      = 0;
+   fNDone     = 0;
+   fNReads    = 0;
+   return status;
+}
+#endif
+
 //______________________________________________________________________________
 Bool_t TFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
 {
@@ -1591,6 +1838,8 @@ Bool_t TFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
    // where pos[i] is the seek position of block i of length len[i].
    // Note that for nbuf=1, this call is equivalent to TFile::ReafBuffer.
    // This function is overloaded by TNetFile, TWebFile, etc.
+   // For local files, if GetReadQueueDepth() is larger than 1, the blocks
+   // are read in parallel (see ReadBuffersParallel).
    // Returns kTRUE in case of failure.
 
    // called with buf=0, from TFileCacheRead to pass list of readahead buffers
@@ -1607,6 +1856,22 @@ Bool_t TFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
    Bool_t result = kTRUE;
    TFileCacheRead *old = fCacheRead;
    fCacheRead = 0;
+
+   if (fMapAddress) {
+      // no need to read ahead, copy each block from the mapping
+      result = kFALSE;
+      for (Int_t j = 0; j < nbuf && !result; j++) {
+         result = ReadBuffer(&buf[k], pos[j], len[j]);
+         k += len[j];
+      }
+      fCacheRead = old;
+      return result;
+   }
+   if (nbuf > 1 && IsA() == TFile::Class() && GetReadQueueDepth() > 1) {
+      result = ReadBuffersParallel(buf, pos, len, nbuf);
+      fCacheRead = old;
+      return result;
+   }
    Long64_t curbegin = pos[0];
    Long64_t cur;
    char *buf2 = 0;
@@ -1653,6 +1918,75 @@ Bool_t TFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
    return result;
 }
 
+//______________________________________________________________________________
+Bool_t TFile::ReadBuffersParallel(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
+{
+   // Read the nbuf blocks described in arrays pos and len into buf, like
+   // ReadBuffers, submitting all of them at once to a pool of reading
+   // threads. Up to GetReadQueueDepth() blocks are read at the same time and
+   // they complete in any order. Blocks which are contiguous both in the
+   // file and in buf are read with a single request, the gaps between the
+   // blocks are never read.
+   // Returns kTRUE in case of failure.
+
+#ifndef WIN32
+   std::vector<TFileReadPool::Request_t> req;
+   req.reserve(nbuf);
+   Long64_t total = 0;
+   for (Int_t j = 0; j < nbuf; j++) {
+      Long64_t off = pos[j] + fArchiveOffset;
+      if (!req.empty() && req.back().fPos + req.back().fLen == off &&
+          (Long64_t)req.back().fLen + len[j] < kMaxInt) {
+         req.back().fLen += len[j];
+      } else {
+         TFileReadPool::Request_t r;
+         r.fBuf = buf + total;
+         r.fPos = off;
+         r.fLen = len[j];
+         req.push_back(r);
+      }
+      total += len[j];
+   }
+
+   Double_t start = 0;
+   if (gPerfStats != 0) start = TTimeStamp();
+
+   Int_t nreads = 0;
+   Int_t status = TFileReadPool::Instance(GetReadQueueDepth() - 1)->Read(fD, &req[0], req.size(), nreads);
+   if (status > 0) {
+      errno = status;
+      SysError("ReadBuffersParallel", "error reading from file %s", GetName());
+      return kTRUE;
+   }
+   if (status < 0) {
+      Error("ReadBuffersParallel", "error reading all requested bytes from file %s, end of file reached",
+            GetName());
+      return kTRUE;
+   }
+   SetOffset(pos[nbuf-1] + len[nbuf-1]);
+   fBytesRead  += total;
+   fgBytesRead += total;
+   // as in ReadBuffer, one call per read issued
+   fReadCalls  += nreads;
+   fgReadCalls += nreads;
+
+   if (gMonitoringWriter)
+      gMonitoringWriter->SendFileReadProgress(this);
+   if (gPerfStats != 0) {
+      gPerfStats->FileReadEvent(this, total, start);
+   }
+   return kFALSE;
+#else
+   // no pread() on Windows, read the blocks one after the other
+   Int_t k = 0;
+   for (Int_t j = 0; j < nbuf; j++) {
+      if (ReadBuffer(&buf[k], pos[j], len[j])) return kTRUE;
+      k += len[j];
+   }
+   return kFALSE;
+#endif
+}
+
 //______________________________________________________________________________
 Int_t TFile::ReadBufferViaCache(char *buf, Int_t len)
 {
@@ -1687,6 +2021,19 @@ Int_t TFile::ReadBufferViaCache(char *buf, Int_t len)
    return 0;
 }
 
+//______________________________________________________________________________
+Bool_t TFile::ReadBufferViaMap(char *buf, Long64_t offset, Int_t len)
+{
+   // Copy len bytes at the (physical) offset of the memory mapped file into
+   // buf. Returns kFALSE if the range is not in the mapping, in which case
+   // the caller must read it from the file.
+
+   char *mapped = GetMappedBuffer(offset - fArchiveOffset, len);
+   if (!mapped) return kFALSE;
+   memcpy(buf, mapped, len);
+   return kTRUE;
+}
+
 //______________________________________________________________________________
 void TFile::ReadFree()
 {
@@ -1967,6 +2314,7 @@ Int_t TFile::ReOpen(Option_t *mode)
 
       // close readonly file
       if (IsOpen()) {
+         UnmapFile();
          SysClose(fD);
          fD = -1;
       }
@@ -2094,7 +2442,9 @@ void TFile::SetCompressionSettings(Int_t settings)
    //   ROOT::CompressionSettings(ROOT::kLZMA, 1)
    // will build an integer which will set the compression to use
    // the LZMA algorithm and compression level 1.  These are defined
-   // in the header file Compression.h.
+   // in the header file Compression.h. The available algorithms are
+   // ZLIB (the default), LZMA, LZ4 (fastest decompression) and
+   // ZSTD (ratio close to ZLIB, faster to compress and decompress).
    //
    // Note that the compression settings may be changed at any time.
    // The new compression settings will only apply to branches created
@@ -3787,6 +4137,11 @@ TFile *TFile::Open(const char *url, Option_t *options, const char *ftitle,
    //                   it will be internally checked with granularity of
    //                   one millisec.
    //
+   // For local files there is the option:
+   //  MMAP          opens an existing file for reading and maps it in memory
+   //                (see the TFile constructor). For remote files it is
+   //                equivalent to READ.
+   //
    // For remote files there is the option:
    //  CACHEREAD     opens an existing file for reading through the file cache.
    //                The file will be downloaded to the cache and opened from there.
@@ -3915,6 +4270,10 @@ TFile *TFile::Open(const char *url, Option_t *options, const char *ftitle,
          TString lfname = gEnv->GetValue("Path.Localroot", "");
          type = GetType(name, option, &lfname);
 
+         // Only local files can be memory mapped
+         if (type != kLocal && type != kFile && !strcasecmp(option, "MMAP"))
+            option = "READ";
+
          if (type == kLocal) {
 
             // Local files
@@ -4278,6 +4637,34 @@ Int_t TFile::GetReadaheadSize()
 //______________________________________________________________________________
 void TFile::SetReadaheadSize(Int_t bytes) { fgReadaheadSize = bytes; }
 
+//______________________________________________________________________________
+Int_t TFile::GetReadQueueDepth()
+{
+   // Static function returning the maximum number of blocks read in parallel
+   // by TFile::ReadBuffers for local files. 0 or 1 means that the blocks are
+   // read sequentially. The default is taken from the rootrc variable
+   // TFile.ReadQueueDepth (0 if not set), until SetReadQueueDepth is called.
+
+   // the initialization of a local static is thread safe
+   static const Int_t envDepth = gEnv->GetValue("TFile.ReadQueueDepth", 0);
+   Int_t depth = fgReadQueueDepth;
+   return depth < 0 ? envDepth : depth;
+}
+
+//______________________________________________________________________________
+void TFile::SetReadQueueDepth(Int_t depth)
+{
+   // Static function setting the maximum number of blocks read in parallel
+   // by TFile::ReadBuffers for local files (see ReadBuffersParallel).
+   // With depth larger than 1, the blocks of a TTreeCache transfer are
+   // all submitted at once to a pool of depth-1 reading threads (the
+   // calling thread reads too). SSDs and RAID arrays serve such parallel
+   // requests much faster than a sequence of single reads.
+   // 0 or 1 disables the parallel reads.
+
+   fgReadQueueDepth = depth < 0 ? 0 : depth;
+}
+
 //______________________________________________________________________________
 void TFile::SetFileBytesRead(Long64_t bytes) { fgBytesRead = bytes; }
 
@@ -4532,10 +4919,11 @@ TFile::EFileType TFile::GetType(const char *name, Option_t *option, TString *pre
             } else {
                lfname.Form("%s/%s", gSystem->HomeDirectory(), fname);
             }
-            // If option "READ" test existence and access
+            // If option "READ" (or "MMAP") test existence and access
             TString opt = option;
             Bool_t read = (opt.IsNull() ||
-                          !opt.CompareTo("READ", TString::kIgnoreCase)) ? kTRUE : kFALSE;
+                          !opt.CompareTo("READ", TString::kIgnoreCase) ||
+                          !opt.CompareTo("MMAP", TString::kIgnoreCase)) ? kTRUE : kFALSE;
             if (read) {
                char *fn;
                if ((fn = gSystem->ExpandPathName(TUrl(lfname).GetFile()))) {
@@ -4878,13 +5266,141 @@ Bool_t TFile::ReadBufferAsync(Long64_t offset, Int_t len)
    return (result != 0);
 }
 #else
-Bool_t TFile::ReadBufferAsync(Long64_t, Int_t)
+Bool_t TFile::ReadBufferAsync(Long64_t offset, Int_t len)
+{
+   // Read specified byte range asynchronously. This is only supported for
+   // memory mapped files (option MMAP), for which the kernel is advised to
+   // load the pages of the byte range in advance.
+
+#ifndef WIN32
+   if (fMapAddress) {
+      if (len == 0) return kFALSE; // probing the readahead capabilities
+      offset += fArchiveOffset;
+      if (offset < 0 || offset >= fMapSize) return kTRUE;
+      if (offset + len > fMapSize) len = fMapSize - offset;
+      static const Long64_t pagesize = sysconf(_SC_PAGESIZE);
+      Long64_t first = offset - offset % pagesize;
+      return posix_madvise(fMapAddress + first, offset + len - first, POSIX_MADV_WILLNEED) != 0;
+   }
+#endif
+   return kTRUE;
+}
+#endif
+
+//______________________________________________________________________________
+char *TFile::GetMappedBuffer(Long64_t pos, Int_t len)
+{
+   // Return the address of the len bytes at position pos of a file opened
+   // with option MMAP, or 0 if the file is not mapped or the range is not
+   // in the mapping. The bytes are accounted as read from the file. The
+   // memory is owned by the file and valid until it is closed; the mapping
+   // is private to the process, modifying it does not change the file.
+
+   if (!fMapAddress) return 0;
+   pos += fArchiveOffset;
+   if (pos < 0 || len < 0 || pos + len > fMapSize) return 0;
+
+   Double_t start = 0;
+   if (gPerfStats != 0) start = TTimeStamp();
+
+   fOffset = pos + len;
+   fBytesRead  += len;
+   fgBytesRead += len;
+   fReadCalls++;
+   fgReadCalls++;
+
+   if (gMonitoringWriter)
+      gMonitoringWriter->SendFileReadProgress(this);
+   if (gPerfStats != 0) {
+      gPerfStats->FileReadEvent(this, len, start);
+   }
+   return fMapAddress + pos;
+}
+
+//______________________________________________________________________________
+void TFile::AttachMappedBuffer(TBuffer *buf)
+{
+   // Register buf, whose memory was obtained with GetMappedBuffer and is not
+   // owned by buf, e.g. a basket read in place. Before the file is unmapped
+   // (Close, ReOpen) the registered buffers get a copy of their content, so
+   // that their owners stay valid. The owner of buf must call
+   // DetachMappedBuffer before deleting it or giving it other memory.
+
+   if (!fMapAddress || !buf) return;
+   if (buf->TestBit(TBufferFile::kMappedFile)) {
+      if (buf->GetParent() == this) return;
+      ((TFile*)buf->GetParent())->DetachMappedBuffer(buf);
+   }
+   if (!fMappedBuffers) fMappedBuffers = new TList;
+   fMappedBuffers->Add(buf);
+   buf->SetParent(this);
+   buf->SetBit(TBufferFile::kMappedFile);
+}
+
+//______________________________________________________________________________
+void TFile::DetachMappedBuffer(TBuffer *buf)
 {
-   // Not supported yet on non Linux systems.
+   // Unregister buf (see AttachMappedBuffer).
 
+   if (fMappedBuffers) fMappedBuffers->Remove(buf);
+   buf->ResetBit(TBufferFile::kMappedFile);
+}
+
+//______________________________________________________________________________
+Bool_t TFile::MapFile()
+{
+   // Map the file read only in memory. Returns kFALSE (and the file is read
+   // with system calls) if it could not be mapped.
+
+#ifndef WIN32
+   Long64_t size = SysSeek(fD, 0, SEEK_END);
+   SysSeek(fD, 0, SEEK_SET);
+   if (size <= 0 || (sizeof(size_t) < sizeof(Long64_t) && size > 0x7fffffff)) {
+      Warning("MapFile", "cannot map %s, reading it normally", GetName());
+      return kFALSE;
+   }
+   // A private mapping is used as the baskets read in place may be modified.
+   void *addr = mmap(0, (size_t)size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fD, 0);
+   if (addr == MAP_FAILED) {
+      SysError("MapFile", "cannot map %s, reading it normally", GetName());
+      return kFALSE;
+   }
+   fMapAddress = (char*)addr;
+   fMapSize    = size;
    return kTRUE;
+#else
+   Warning("MapFile", "memory mapped files are not supported on Windows, reading %s normally", GetName());
+   return kFALSE;
+#endif
 }
+
+//______________________________________________________________________________
+void TFile::UnmapFile()
+{
+   // Remove the memory mapping of the file (if any). The buffers still
+   // pointing into it (see AttachMappedBuffer) get a copy of their content.
+
+   if (fMappedBuffers) {
+      TIter next(fMappedBuffers);
+      TBuffer *buf;
+      while ((buf = (TBuffer*)next())) {
+         Int_t size = buf->BufferSize();
+         Int_t offset = buf->Length();
+         char *copy = new char[size];
+         memcpy(copy, buf->Buffer(), size);
+         buf->SetBuffer(copy, size, kTRUE);
+         buf->SetBufferOffset(offset);
+         buf->ResetBit(TBufferFile::kMappedFile);
+      }
+      delete fMappedBuffers;
+      fMappedBuffers = 0;
+   }
+#ifndef WIN32
+   if (fMapAddress) munmap(fMapAddress, (size_t)fMapSize);
 #endif
+   fMapAddress = 0;
+   fMapSize    = 0;
+}
 
 //______________________________________________________________________________
 Int_t TFile::GetBytesToPrefetch() const
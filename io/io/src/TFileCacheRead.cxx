@@ -135,10 +135,12 @@ TFileCacheRead::TFileCacheRead(TFile *file, Int_t buffersize, TObject *tree)
    fPrefetchedBlocks = 0;
 
    //initialise the prefetch object and set the cache directory
-   // start the thread only if the file is not local
+   // start the thread only if the file is not local, or if the local
+   // file is read with parallel requests (see TFile::SetReadQueueDepth)
    fEnablePrefetching = gEnv->GetValue("TFile.AsyncPrefetching", 0);
 
-   if (fEnablePrefetching && strcmp(file->GetEndpointUrl()->GetProtocol(), "file")){
+   if (fEnablePrefetching && (strcmp(file->GetEndpointUrl()->GetProtocol(), "file") ||
+                              TFile::GetReadQueueDepth() > 1)){
       SetEnablePrefetchingImpl(true);
    }
    else { //disable the async pref for local files
@@ -541,8 +543,11 @@ void TFileCacheRead::SetFile(TFile *file, TFile::ECacheAction action)
       // we use sync primitives, hence we need the local buffer
       if (file && file->ReadBufferAsync(0, 0)) {
          fAsyncReading = kFALSE;
-         fBuffer       = new char[fBufferSize];
+         if (!fBuffer) fBuffer = new char[fBufferSize];
       }
+   } else if (file && file->IsMapped() && !fEnablePrefetching) {
+      // The blocks of a memory mapped file are read directly from the mapping
+      fAsyncReading = kTRUE;
    }
 
    if (action == TFile::kDisconnect)
@@ -729,7 +734,9 @@ void TFileCacheRead::SetEnablePrefetchingImpl(Bool_t setPrefetching)
       fAsyncReading = kFALSE;
    }
    else {
-      fAsyncReading = gEnv->GetValue("TFile.AsyncReading", 0);
+      // A memory mapped file is always read asynchronously: the prefetch
+      // only advises the kernel and the blocks are copied from the mapping.
+      fAsyncReading = gEnv->GetValue("TFile.AsyncReading", 0) || (fFile && fFile->IsMapped());
       if (fAsyncReading) {
          // Check if asynchronous reading is supported by this TFile specialization
          fAsyncReading = kFALSE;
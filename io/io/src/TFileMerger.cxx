@@ -40,6 +40,9 @@
 #include "TClassRef.h"
 #include "TROOT.h"
 #include "TMemFile.h"
+#include "TMath.h"
+#include <errno.h>
+#include <vector>
 
 #ifdef WIN32
 // For _getmaxstdio
@@ -48,6 +51,10 @@
 // For getrlimit
 #include <sys/time.h>
 #include <sys/resource.h>
+// For fork and waitpid
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #endif
 
 ClassImp(TFileMerger)
@@ -56,6 +63,8 @@ TClassRef R__TH1_Class("TH1");
 TClassRef R__TTree_Class("TTree");
 
 static const Int_t kCpProgress = BIT(14);
+static const Int_t kFromTFile  = BIT(15);   // the file was added as a TFile object, it may not be reopened by name
+static const Int_t kMergeFanIn = 8;         // maximum number of partial files merged by one process
 static const Int_t kCintFileNumber = 100;
 //______________________________________________________________________________
 static Int_t R__GetSystemMaxOpenedFiles()
@@ -87,7 +96,7 @@ static Int_t R__GetSystemMaxOpenedFiles()
 TFileMerger::TFileMerger(Bool_t isLocal, Bool_t histoOneGo)
             : fOutputFile(0), fFastMethod(kTRUE), fNoTrees(kFALSE), fExplicitCompLevel(kFALSE), fCompressionChange(kFALSE),
               fPrintLevel(0), fMsgPrefix("TFileMerger"), fMaxOpenedFiles( R__GetSystemMaxOpenedFiles() ),
-              fLocal(isLocal), fHistoOneGo(histoOneGo), fObjectNames()
+              fLocal(isLocal), fHistoOneGo(histoOneGo), fObjectNames(), fNProcesses(1)
 {
    // Create file merger object.
 
@@ -171,7 +180,7 @@ Bool_t TFileMerger::AddFile(const char *url, Bool_t cpProgress)
          Error("AddFile", "cannot open file %s", url);
       return kFALSE;
    } else {
-      if (fOutputFile && fOutputFile->GetCompressionLevel() != newfile->GetCompressionLevel()) fCompressionChange = kTRUE;
+      if (fOutputFile && fOutputFile->GetCompressionSettings() != newfile->GetCompressionSettings()) fCompressionChange = kTRUE;
 
       newfile->SetBit(kCanDelete);
       fFileList->Add(newfile);
@@ -246,7 +255,7 @@ Bool_t TFileMerger::AddFile(TFile *source, Bool_t own, Bool_t cpProgress)
          Error("AddFile", "cannot open file %s", source->GetName());
       return kFALSE;
    } else {
-      if (fOutputFile && fOutputFile->GetCompressionLevel() != newfile->GetCompressionLevel()) fCompressionChange = kTRUE;
+      if (fOutputFile && fOutputFile->GetCompressionSettings() != newfile->GetCompressionSettings()) fCompressionChange = kTRUE;
 
       if (own || newfile != source) {
          newfile->SetBit(kCanDelete);
@@ -259,6 +268,7 @@ Bool_t TFileMerger::AddFile(TFile *source, Bool_t own, Bool_t cpProgress)
          fMergeList = new TList;
       }
       TObjString *urlObj = new TObjString(source->GetName());
+      urlObj->SetBit(kFromTFile);
       fMergeList->Add(urlObj);
 
       if (newfile != source && own) {
@@ -337,10 +347,213 @@ Bool_t TFileMerger::Merge(Bool_t)
    // Merge the files. If no output file was specified it will write into
    // the file "FileMerger.root" in the working directory. Returns true
    // on success, false in case of error.
+   // If more than one process is requested (see SetNProcesses), the files
+   // are merged in parallel (see MergeInParallel).
 
+   if (fNProcesses > 1 && fOutputFile && fMergeList->GetEntries() >= 4)
+      return MergeInParallel();
    return PartialMerge(kAll | kRegular);
 }
 
+//______________________________________________________________________________
+Bool_t TFileMerger::MergeGroups(const TList &groups, const TList &targets)
+{
+   // Merge in parallel each group of files (a TList of TObjString) into
+   // the corresponding target file, in one forked process per group,
+   // with the settings of this merger and the compression of its output.
+   // Returns kTRUE if all the groups were merged successfully.
+
+#ifdef WIN32
+   Error("MergeGroups", "not supported on Windows");
+   return kFALSE;
+#else
+   Int_t compress = fOutputFile->GetCompressionSettings();
+   Int_t ngroups = groups.GetEntries();
+   std::vector<pid_t> pids;
+
+   std::cout.flush();
+   std::cerr.flush();
+   fflush(stdout);
+   fflush(stderr);
+   for (Int_t i = 0; i < ngroups; i++) {
+      pid_t pid = fork();
+      if (pid < 0) {
+         SysError("MergeGroups", "cannot fork");
+         break;
+      }
+      if (pid == 0) {
+         // child: merge the group and leave without running any cleanup
+         // which would touch the files inherited from the parent
+         TFileMerger merger(fLocal, fHistoOneGo);
+         merger.SetMsgPrefix(TString::Format("%s[%d]", fMsgPrefix.Data(), i));
+         merger.SetPrintLevel(fPrintLevel);
+         merger.SetMaxOpenedFiles(TMath::Max(2, fMaxOpenedFiles / ngroups));
+         merger.SetFastMethod(fFastMethod);
+         merger.SetMergeOptions(fMergeOptions);
+         merger.SetNotrees(fNoTrees);
+         Bool_t ok = merger.OutputFile(targets.At(i)->GetName(), "RECREATE", compress);
+         TIter next((TList*)groups.At(i));
+         TObjString *url;
+         while (ok && (url = (TObjString*)next()))
+            ok = merger.AddFile(url->GetName(), kFALSE);
+         if (ok) ok = merger.Merge();
+         std::cout.flush();
+         std::cerr.flush();
+         fflush(stdout);
+         fflush(stderr);
+         _exit(ok ? 0 : 1);
+      }
+      pids.push_back(pid);
+   }
+
+   Bool_t result = ((Int_t)pids.size() == ngroups);
+   for (size_t i = 0; i < pids.size(); i++) {
+      int status = 0;
+      while (waitpid(pids[i], &status, 0) < 0 && errno == EINTR) { }
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+         Error("MergeGroups", "merge of the group %d into %s failed", (Int_t)i, targets.At(i)->GetName());
+         result = kFALSE;
+      }
+   }
+   return result;
+#endif
+}
+
+//______________________________________________________________________________
+Bool_t TFileMerger::MergeInParallel()
+{
+   // Merge the files with up to fNProcesses processes.
+   //
+   // The input files are split in fNProcesses groups of consecutive files
+   // which are merged in parallel, each by a forked process, into partial
+   // files written next to the output file. The partial files are then
+   // merged in the same way by groups of at most kMergeFanIn until there
+   // are few enough of them to be merged into the output file by this
+   // process. Since the order of the files is kept, the trees are merged
+   // in the same order as by a sequential merge, and the fast merging of
+   // the trees (TTreeCloner) is used at each step when possible (the
+   // partial files use the compression of the output file).
+   //
+   // The files added as TFile objects can not be reopened by the other
+   // processes: in that case, and on Windows, the merge is sequential.
+
+#ifdef WIN32
+   return PartialMerge(kAll | kRegular);
+#else
+   TIter nextname(fMergeList);
+   TObjString *name;
+   while ((name = (TObjString*)nextname())) {
+      if (name->TestBit(kFromTFile)) return PartialMerge(kAll | kRegular);
+   }
+
+   // The forked processes reopen the files: close ours, the file offsets
+   // would otherwise be shared between the processes.
+   TIter nextfile(fFileList);
+   TFile *file;
+   while ((file = (TFile*) nextfile())) {
+      if (fLocal) {
+         TUrl u(file->GetPath(), kTRUE);
+         gSystem->Unlink(u.GetFile());
+      }
+      file->Close();
+      delete file;
+   }
+   fFileList->Clear("nodelete");
+   fExcessFiles->Clear();
+
+   TString dir;
+   TUrl outurl(fOutputFilename, kTRUE);
+   if (!strcmp(outurl.GetProtocol(), "file")) {
+      dir = gSystem->DirName(outurl.GetFile());
+   } else {
+      dir = gSystem->TempDirectory();
+   }
+   TUUID uuid;
+
+   // The names of the files to merge at each step, initially the inputs.
+   TList inputs;
+   inputs.SetOwner(kTRUE);
+   nextname.Reset();
+   while ((name = (TObjString*)nextname())) inputs.Add(new TObjString(name->GetName()));
+
+   Bool_t result = kTRUE;
+   Bool_t partial = kFALSE; // kTRUE once the inputs are partial files
+   Int_t step = 0;
+   while (result && (!partial || inputs.GetEntries() > kMergeFanIn)) {
+      Int_t n = inputs.GetEntries();
+      Int_t ngroups = partial ? (n + kMergeFanIn - 1) / kMergeFanIn : TMath::Min(fNProcesses, n / 2);
+      if (ngroups < 2) break;
+      if (fPrintLevel > 0) {
+         Printf("%s Merging %d files in %d groups in parallel", fMsgPrefix.Data(), n, ngroups);
+      }
+
+      // groups of consecutive files, at most fNProcesses at a time
+      TList outputs;
+      outputs.SetOwner(kTRUE);
+      for (Int_t first = 0; result && first < ngroups; first += fNProcesses) {
+         Int_t last = TMath::Min(ngroups, first + fNProcesses);
+         TList groups;
+         groups.SetOwner(kTRUE);
+         TList targets;
+         targets.SetOwner(kTRUE);
+         for (Int_t g = first; g < last; g++) {
+            TList *group = new TList;
+            group->SetOwner(kTRUE);
+            for (Int_t i = (Int_t)((Long64_t)n*g/ngroups); i < (Int_t)((Long64_t)n*(g+1)/ngroups); i++)
+               group->Add(new TObjString(inputs.At(i)->GetName()));
+            groups.Add(group);
+            TString target = TString::Format("%s/%s-%s-%d-%d.root", dir.Data(),
+                                             gSystem->BaseName(outurl.GetFile()), uuid.AsString(), step, g);
+            targets.Add(new TObjString(target));
+            outputs.Add(new TObjString(target));
+         }
+         result = MergeGroups(groups, targets);
+      }
+      if (partial) {
+         TIter next(&inputs);
+         while ((name = (TObjString*)next())) gSystem->Unlink(name->GetName());
+      }
+      inputs.Delete();
+      TIter next(&outputs);
+      while ((name = (TObjString*)next())) inputs.Add(new TObjString(name->GetName()));
+      partial = kTRUE;
+      step++;
+   }
+
+   // merge the remaining files into the output file
+   if (result) {
+      TDirectory::TContext ctx(0);
+      TIter next(&inputs);
+      while (result && (name = (TObjString*)next())) {
+         TFile *f = TFile::Open(name->GetName(), "READ");
+         if (!f || f->IsZombie()) {
+            Error("MergeInParallel", "cannot open the file %s", name->GetName());
+            delete f;
+            result = kFALSE;
+            break;
+         }
+         f->SetBit(kCanDelete);
+         fFileList->Add(f);
+      }
+      Bool_t local = fLocal;
+      fLocal = kFALSE;   // do not remove the files, whether partial or not
+      // the partial files already have the compression of the output file,
+      // they must not be recompressed a second time
+      Bool_t compressionChange = fCompressionChange;
+      if (partial) fCompressionChange = kFALSE;
+      if (result) result = PartialMerge(kAll | kRegular);
+      else fFileList->Delete();
+      fCompressionChange = compressionChange;
+      fLocal = local;
+   }
+   if (partial) {
+      TIter next(&inputs);
+      while ((name = (TObjString*)next())) gSystem->Unlink(name->GetName());
+   }
+   return result;
+#endif
+}
+
 //______________________________________________________________________________
 Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t type /* = kRegular | kAll */)
 {
@@ -380,8 +593,16 @@ Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t
 
    TFileMergeInfo info(target);
 
-   if ((fFastMethod && !fCompressionChange)) {
-      info.fOptions.Append(" fast");
+   if (fFastMethod) {
+      // When the compression of some input differs, the baskets are still
+      // copied without being unstreamed, but those of the branches whose
+      // compression differs from the output are unzipped and zipped again
+      // (the fast cloning decides it for each input tree and branch).
+      info.fOptions.Append(fCompressionChange ? " fast recompress" : " fast");
+   }
+   if (fMergeOptions.Length()) {
+      info.fOptions.Append(" ");
+      info.fOptions.Append(fMergeOptions);
    }
 
    TFile      *current_file;
@@ -788,9 +1009,12 @@ Bool_t TFileMerger::PartialMerge(Int_t in_type)
       }
    }
 
-   // Special treament for the single file case ...
+   // Special treament for the single file case, copied as it is unless it
+   // must be rewritten (new compression, or merge options such as a basket
+   // order, see SetMergeOptions) ...
    if ((fFileList->GetEntries() == 1) && !fExcessFiles->GetEntries() &&
-      !(in_type & kIncremental) && !fCompressionChange && !fExplicitCompLevel) {
+      !(in_type & kIncremental) && !fCompressionChange && !fExplicitCompLevel &&
+      fMergeOptions.IsNull()) {
       fOutputFile->Close();
       SafeDelete(fOutputFile);
 
@@ -907,7 +1131,7 @@ Bool_t TFileMerger::OpenExcessFiles()
             Error("OpenExcessFiles", "cannot open file %s", url->GetName());
          return kFALSE;
       } else {
-         if (fOutputFile && fOutputFile->GetCompressionLevel() != newfile->GetCompressionLevel()) fCompressionChange = kTRUE;
+         if (fOutputFile && fOutputFile->GetCompressionSettings() != newfile->GetCompressionSettings()) fCompressionChange = kTRUE;
 
          newfile->SetBit(kCanDelete);
          fFileList->Add(newfile);
@@ -48,6 +48,18 @@
   (i.e. direct copy of the raw byte on disk). The "fast" mode is typically
   5 times faster than the mode unzipping and unstreaming the baskets.
 
+  With the option -c, the baskets of the Trees are written in the target
+  file so that all the baskets of each cluster are contiguous (sorted by
+  branch within the cluster, see TTree::CloneTree and SortBasketsByCluster),
+  which makes reading each cluster a single read. This is only done by the
+  "fast" merge. hadd can use one source file to rewrite it with this layout:
+       hadd -c target.root source.root
+
+  The merge can be run in parallel by several processes with
+       hadd -j 8 targetfile source1 source2 ...
+  the sources are then split into 8 groups merged in parallel into
+  temporary files, which are then merged into the target file.
+
   NOTE1: By default histograms are added. However hadd does not support the case where
          histograms have their bit TH1::kIsAverage set.
 
@@ -77,7 +89,7 @@ int main( int argc, char **argv )
 {
 
    if ( argc < 3 || "-h" == std::string(argv[1]) || "--help" == std::string(argv[1]) ) {
-      std::cout << "Usage: " << argv[0] << " [-f[0-9]] [-k] [-T] [-O] [-n maxopenedfiles] [-v verbosity] targetfile source1 [source2 source3 ...]" << std::endl;
+      std::cout << "Usage: " << argv[0] << " [-f[0-9]] [-k] [-T] [-O] [-c] [-n maxopenedfiles] [-j nprocesses] [-v verbosity] targetfile source1 [source2 source3 ...]" << std::endl;
       std::cout << "This program will add histograms from a list of root files and write them" << std::endl;
       std::cout << "to a target root file. The target file is newly created and must not " << std::endl;
       std::cout << "exist, or if -f (\"force\") is given, must not be one of the source files." << std::endl;
@@ -85,22 +97,26 @@ int main( int argc, char **argv )
       std::cout << "If the option -k is used, hadd will not exit on corrupt or non-existant input files but skip the offending files instead." << std::endl;
       std::cout << "If the option -T is used, Trees are not merged" <<std::endl;
       std::cout << "If the option -O is used, when merging TTree, the basket size is re-optimized" <<std::endl;
+      std::cout << "If the option -c is used, when merging TTree, the baskets of each cluster are written contiguously" <<std::endl;
       std::cout << "If the option -v is used, explicitly set the verbosity level; 0 request no output, 99 is the default" <<std::endl;
       std::cout << "If the option -n is used, hadd will open at most 'maxopenedfiles' at once, use 0 to request to use the system maximum." << std::endl;
+      std::cout << "If the option -j is used, hadd will merge the files in parallel with 'nprocesses' processes." << std::endl;
       std::cout << "When -the -f option is specified, one can also specify the compression" <<std::endl;
       std::cout << "level of the target file. By default the compression level is 1, but" <<std::endl;
       std::cout << "if \"-f0\" is specified, the target file will not be compressed." <<std::endl;
       std::cout << "if \"-f6\" is specified, the compression level 6 will be used." <<std::endl;
       std::cout << "if Target and source files have different compression levels"<<std::endl;
-      std::cout << " a slower method is used"<<std::endl;
+      std::cout << " the baskets are recompressed (in parallel), unless -O is used"<<std::endl;
       return 1;
    }
 
    Bool_t force = kFALSE;
    Bool_t skip_errors = kFALSE;
    Bool_t reoptimize = kFALSE;
+   Bool_t clusterLayout = kFALSE;
    Bool_t noTrees = kFALSE;
    Int_t maxopenedfiles = 0;
+   Int_t nprocesses = 1;
    Int_t verbosity = 99;
 
    int outputPlace = 0;
@@ -119,6 +135,9 @@ int main( int argc, char **argv )
       } else if ( strcmp(argv[a],"-O") == 0 ) {
          reoptimize = kTRUE;
          ++ffirst;
+      } else if ( strcmp(argv[a],"-c") == 0 ) {
+         clusterLayout = kTRUE;
+         ++ffirst;
       } else if ( strcmp(argv[a],"-n") == 0 ) {
          if (a+1 >= argc) {
             std::cerr << "Error: no maximum number of opened was provided after -n.\n";
@@ -133,6 +152,20 @@ int main( int argc, char **argv )
             }
          }
          ++ffirst;
+      } else if ( strcmp(argv[a],"-j") == 0 ) {
+         if (a+1 >= argc) {
+            std::cerr << "Error: no number of processes was provided after -j.\n";
+         } else {
+            Long_t request = strtol(argv[a+1], 0, 10);
+            if (request < kMaxInt && request > 0) {
+               nprocesses = (Int_t)request;
+               ++a;
+               ++ffirst;
+            } else {
+               std::cerr << "Error: could not parse the number of processes passed after -j: " << argv[a+1] << ". We will use 1 process.\n";
+            }
+         }
+         ++ffirst;
       } else if ( strcmp(argv[a],"-v") == 0 ) {
          if (a+1 >= argc) {
             std::cerr << "Error: no verbosity level was provided after -v.\n";
@@ -222,10 +255,17 @@ int main( int argc, char **argv )
       if (merger.HasCompressionChange()) {
          // Don't warn if the user any request re-optimization.
          std::cout <<"hadd Sources and Target have different compression levels"<<std::endl;
-         std::cout <<"hadd merging will be slower"<<std::endl;
+         std::cout <<"hadd the baskets will be recompressed"<<std::endl;
+      }
+   }
+   if (clusterLayout) {
+      if (reoptimize) {
+         std::cout <<"hadd the layout by cluster (-c) is only done by the fast merge, it is ignored"<<std::endl;
       }
+      merger.SetMergeOptions("SortBasketsByCluster");
    }
    merger.SetNotrees(noTrees);
+   merger.SetNProcesses(nprocesses);
    Bool_t status = merger.Merge();
 
    if (status) {
@@ -31,14 +31,6 @@
 #include "Fit/FitUtil.h"
 #endif
 
-//#define ROOT_FIT_PARALLEL
-
-#ifdef ROOT_FIT_PARALLEL
-#ifndef ROOT_Fit_FitUtilParallel
-#include "Fit/FitUtilParallel.h"
-#endif
-#endif
-
 /**
 @defgroup FitMethodFunc Fit Method Classes
 
@@ -82,7 +74,9 @@ public:
       fData(data),
       fFunc(func),
       fNEffPoints(0),
-      fGrad ( std::vector<double> ( func.NPar() ) )
+      fGrad ( std::vector<double> ( func.NPar() ) ),
+      fExecutionPolicy(FitUtil::kSerial),
+      fNThreads(0)
    { }
 
    /**
@@ -111,6 +105,7 @@ public:
    virtual BaseFunction * Clone() const {
       // clone the function
       Chi2FCN * fcn =  new Chi2FCN(fData,fFunc);
+      fcn->SetExecutionPolicy(fExecutionPolicy, fNThreads);
       return fcn;
    }
 
@@ -132,7 +127,13 @@ public:
    // need to be virtual to be instantiated
    virtual void Gradient(const double *x, double *g) const {
       // evaluate the chi2 gradient
-      FitUtil::EvaluateChi2Gradient(fFunc, fData, x, g, fNEffPoints);
+      FitUtil::EvaluateChi2Gradient(fFunc, fData, x, g, fNEffPoints, fExecutionPolicy, fNThreads);
+   }
+
+   /// set the policy (serial or multithread) and the number of threads used to evaluate the chi2 and its gradient
+   void SetExecutionPolicy(FitUtil::EExecutionPolicy policy, unsigned int nThreads = 0) {
+      fExecutionPolicy = policy;
+      fNThreads = nThreads;
    }
 
    /// get type of fit method function
@@ -159,14 +160,10 @@ private:
     */
    virtual double DoEval (const double * x) const {
       this->UpdateNCalls();
-#ifdef ROOT_FIT_PARALLEL
-      return FitUtilParallel::EvaluateChi2(fFunc, fData, x, fNEffPoints);
-#else
       if (!fData.HaveCoordErrors() )
-         return FitUtil::EvaluateChi2(fFunc, fData, x, fNEffPoints);
+         return FitUtil::EvaluateChi2(fFunc, fData, x, fNEffPoints, fExecutionPolicy, fNThreads);
       else
          return FitUtil::EvaluateChi2Effective(fFunc, fData, x, fNEffPoints);
-#endif
    }
 
    // for derivatives
@@ -182,6 +179,8 @@ private:
 
    mutable std::vector<double> fGrad; // for derivatives
 
+   FitUtil::EExecutionPolicy fExecutionPolicy;  // serial or multithread evaluation
+   unsigned int fNThreads;                      // number of threads (0 is the default number)
 
 };
 
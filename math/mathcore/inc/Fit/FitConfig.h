@@ -26,6 +26,10 @@
 #include "Math/IParamFunctionfwd.h"
 #endif
 
+#ifndef ROOT_Fit_FitUtil
+#include "Fit/FitUtil.h"
+#endif
+
 
 #include <vector>
 
@@ -186,6 +190,12 @@ public:
    /// return vector of parameter indeces for which the Minos Error will be computed
    const std::vector<unsigned int> & MinosParams() const { return fMinosParams; }
 
+   /// execution policy (serial or multithread) of the evaluation of the chi2 or likelihood function
+   FitUtil::EExecutionPolicy ExecutionPolicy() const { return fExecutionPolicy; }
+
+   /// number of threads used by the multithread policy (0 means FitUtil::DefaultNThreads())
+   unsigned int NThreads() const { return fNThreads; }
+
    /**
       set the option to normalize the error on the result  according to chi2/ndf
    */
@@ -211,6 +221,16 @@ public:
    ///Update configuration after a fit using the FitResult
    void SetUpdateAfterFit(bool on = true) { fUpdateAfterFit = on; }
 
+   /**
+      set the execution policy of the evaluation of the chi2 or likelihood function and of its gradient.
+      With FitUtil::kMultithread the data points are evaluated by nThreads threads
+      (0 means the number of cores) and the model function must be thread safe
+   */
+   void SetExecutionPolicy(FitUtil::EExecutionPolicy policy, unsigned int nThreads = 0) {
+      fExecutionPolicy = policy;
+      fNThreads = nThreads;
+   }
+
 
    /**
       static function to control default minimizer type and algorithm
@@ -231,6 +251,9 @@ private:
    bool fUpdateAfterFit;   // update the configuration after a fit using the result
    bool fWeightCorr;       // apply correction to errors for weights fits
 
+   FitUtil::EExecutionPolicy fExecutionPolicy;  // serial or multithread evaluation of the fit method function
+   unsigned int fNThreads;                      // number of threads for the multithread evaluation (0 = default)
+
    std::vector<ROOT::Fit::ParameterSettings> fSettings;  // vector with the parameter settings
    std::vector<unsigned int> fMinosParams;               // vector with the parameter indeces for running Minos
 
@@ -40,13 +40,35 @@ namespace FitUtil {
    typedef  ROOT::Math::IParamMultiFunction IModelFunction;
    typedef  ROOT::Math::IParamMultiGradFunction IGradModelFunction;
 
+   /**
+      execution policy of the evaluation of the fit method functions (chi2, likelihood)
+      and of their gradient.
+      With kMultithread the data points are split in chunks of fixed size, which are
+      evaluated by a pool of threads. The sum of each chunk and the total sum
+      are computed with the Kahan compensated summation, adding the chunks always in
+      the same order: the result does not depend on the number of threads and is
+      reproduced from run to run. The model function must be thread safe.
+      The evaluation functions below take the policy and the number of threads
+      (0 means DefaultNThreads()).
+   */
+   enum EExecutionPolicy {
+      kSerial,        // evaluate the data points in the calling thread (default)
+      kMultithread    // split the data points among a pool of threads
+   };
+
+   /**
+      number of threads used by default by the kMultithread policy (the number of cores)
+   */
+   unsigned int DefaultNThreads();
+
    /** Chi2 Functions */
 
    /**
        evaluate the Chi2 given a model function and the data at the point x.
        return also nPoints as the effective number of used points in the Chi2 evaluation
    */
-   double EvaluateChi2(const IModelFunction & func, const BinData & data, const double * x, unsigned int & nPoints);
+   double EvaluateChi2(const IModelFunction & func, const BinData & data, const double * x, unsigned int & nPoints,
+                       EExecutionPolicy policy = kSerial, unsigned int nThreads = 0);
 
    /**
        evaluate the effective Chi2 given a model function and the data at the point x.
@@ -59,38 +81,37 @@ namespace FitUtil {
        evaluate the Chi2 gradient given a model function and the data at the point x.
        return also nPoints as the effective number of used points in the Chi2 evaluation
    */
-   void EvaluateChi2Gradient(const IModelFunction & func, const BinData & data, const double * x, double * grad, unsigned int & nPoints);
+   void EvaluateChi2Gradient(const IModelFunction & func, const BinData & data, const double * x, double * grad, unsigned int & nPoints,
+                             EExecutionPolicy policy = kSerial, unsigned int nThreads = 0);
 
    /**
        evaluate the LogL given a model function and the data at the point x.
        return also nPoints as the effective number of used points in the LogL evaluation
    */
-   double EvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints);
+   double EvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints,
+                       EExecutionPolicy policy = kSerial, unsigned int nThreads = 0);
 
    /**
        evaluate the LogL gradient given a model function and the data at the point x.
        return also nPoints as the effective number of used points in the LogL evaluation
    */
-   void EvaluateLogLGradient(const IModelFunction & func, const UnBinData & data, const double * x, double * grad, unsigned int & nPoints);
+   void EvaluateLogLGradient(const IModelFunction & func, const UnBinData & data, const double * x, double * grad, unsigned int & nPoints,
+                             EExecutionPolicy policy = kSerial, unsigned int nThreads = 0);
 
    /**
        evaluate the Poisson LogL given a model function and the data at the point x.
        return also nPoints as the effective number of used points in the LogL evaluation
        By default is extended, pass extedend to false if want to be not extended (MultiNomial)
    */
-   double EvaluatePoissonLogL(const IModelFunction & func, const BinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints);
+   double EvaluatePoissonLogL(const IModelFunction & func, const BinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints,
+                              EExecutionPolicy policy = kSerial, unsigned int nThreads = 0);
 
    /**
        evaluate the Poisson LogL given a model function and the data at the point x.
        return also nPoints as the effective number of used points in the LogL evaluation
    */
-   void EvaluatePoissonLogLGradient(const IModelFunction & func, const BinData & data, const double * x, double * grad);
-
-//    /**
-//        Parallel evaluate the Chi2 given a model function and the data at the point x.
-//        return also nPoints as the effective number of used points in the Chi2 evaluation
-//    */
-//    double ParallelEvalChi2(const IModelFunction & func, const BinData & data, const double * x, unsigned int & nPoints);
+   void EvaluatePoissonLogLGradient(const IModelFunction & func, const BinData & data, const double * x, double * grad,
+                                    EExecutionPolicy policy = kSerial, unsigned int nThreads = 0);
 
    // methods required by dedicate minimizer like Fumili
 
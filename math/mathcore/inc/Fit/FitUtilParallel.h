@@ -42,7 +42,9 @@ namespace ROOT {
 /**
    namespace defining free functions for Fitting parallel mode
 
-   Status: functions are not not completed and are still preliminary
+   Status: functions are not not completed and are still preliminary.
+   They are superseded by the FitUtil::kMultithread execution policy of
+   the FitUtil functions (see FitConfig::SetExecutionPolicy)
 
    @ingroup FitMain
 */
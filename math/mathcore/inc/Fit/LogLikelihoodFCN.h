@@ -29,12 +29,6 @@
 #include "Fit/FitUtil.h"
 #endif
 
-#ifdef ROOT_FIT_PARALLEL
-#ifndef ROOT_Fit_FitUtilParallel
-#include "Fit/FitUtilParallel.h"
-#endif
-#endif
-
 namespace ROOT {
 
    namespace Fit {
@@ -72,7 +66,9 @@ public:
       fData(data),
       fFunc(func),
       fNEffPoints(0),
-      fGrad ( std::vector<double> ( func.NPar() ) )
+      fGrad ( std::vector<double> ( func.NPar() ) ),
+      fExecutionPolicy(FitUtil::kSerial),
+      fNThreads(0)
    {}
 
 
@@ -97,7 +93,11 @@ private:
 public:
 
    /// clone the function (need to return Base for Windows)
-   virtual BaseFunction * Clone() const { return  new LogLikelihoodFCN(fData,fFunc,fWeight,fIsExtended); }
+   virtual BaseFunction * Clone() const {
+      LogLikelihoodFCN * fcn = new LogLikelihoodFCN(fData,fFunc,fWeight,fIsExtended);
+      fcn->SetExecutionPolicy(fExecutionPolicy, fNThreads);
+      return fcn;
+   }
 
 
    //using BaseObjFunction::operator();
@@ -115,7 +115,7 @@ public:
    // need to be virtual to be instantited
    virtual void Gradient(const double *x, double *g) const {
       // evaluate the chi2 gradient
-      FitUtil::EvaluateLogLGradient(fFunc, fData, x, g, fNEffPoints);
+      FitUtil::EvaluateLogLGradient(fFunc, fData, x, g, fNEffPoints, fExecutionPolicy, fNThreads);
    }
 
    /// get type of fit method function
@@ -135,6 +135,12 @@ public:
       else fWeight = 1;
    }
 
+   /// set the policy (serial or multithread) and the number of threads used to evaluate the likelihood and its gradient
+   void SetExecutionPolicy(FitUtil::EExecutionPolicy policy, unsigned int nThreads = 0) {
+      fExecutionPolicy = policy;
+      fNThreads = nThreads;
+   }
+
 
 
 protected:
@@ -147,12 +153,7 @@ private:
     */
    virtual double DoEval (const double * x) const {
       this->UpdateNCalls();
-
-#ifdef ROOT_FIT_PARALLEL
-      return FitUtilParallel::EvaluateLogL(fFunc, fData, x, fNEffPoints);
-#else
-      return FitUtil::EvaluateLogL(fFunc, fData, x, fWeight, fIsExtended, fNEffPoints);
-#endif
+      return FitUtil::EvaluateLogL(fFunc, fData, x, fWeight, fIsExtended, fNEffPoints, fExecutionPolicy, fNThreads);
    }
 
    // for derivatives
@@ -173,6 +174,8 @@ private:
 
    mutable std::vector<double> fGrad; // for derivatives
 
+   FitUtil::EExecutionPolicy fExecutionPolicy;  // serial or multithread evaluation
+   unsigned int fNThreads;                      // number of threads (0 is the default number)
 
 };
 
@@ -29,13 +29,6 @@
 #include "Fit/FitUtil.h"
 #endif
 
-//#define PARALLEL
-// #ifdef PARALLEL
-// #ifndef ROOT_Fit_FitUtilParallel
-// #include "Fit/FitUtilParallel.h"
-// #endif
-// #endif
-
 namespace ROOT {
 
    namespace Fit {
@@ -71,7 +64,9 @@ public:
       fData(data),
       fFunc(func),
       fNEffPoints(0),
-      fGrad ( std::vector<double> ( func.NPar() ) )
+      fGrad ( std::vector<double> ( func.NPar() ) ),
+      fExecutionPolicy(FitUtil::kSerial),
+      fNThreads(0)
    { }
 
 
@@ -96,7 +91,11 @@ private:
 public:
 
    /// clone the function (need to return Base for Windows)
-   virtual BaseFunction * Clone() const { return new  PoissonLikelihoodFCN(fData,fFunc,fWeight,fIsExtended); }
+   virtual BaseFunction * Clone() const {
+      PoissonLikelihoodFCN * fcn = new  PoissonLikelihoodFCN(fData,fFunc,fWeight,fIsExtended);
+      fcn->SetExecutionPolicy(fExecutionPolicy, fNThreads);
+      return fcn;
+   }
 
    // effective points used in the fit
    virtual unsigned int NFitPoints() const { return fNEffPoints; }
@@ -110,7 +109,7 @@ public:
    /// evaluate gradient
    virtual void Gradient(const double *x, double *g) const {
       // evaluate the chi2 gradient
-      FitUtil::EvaluatePoissonLogLGradient(fFunc, fData, x, g );
+      FitUtil::EvaluatePoissonLogLGradient(fFunc, fData, x, g, fExecutionPolicy, fNThreads );
    }
 
    /// get type of fit method function
@@ -138,6 +137,12 @@ public:
       else fWeight = 1;
    }
 
+   /// set the policy (serial or multithread) and the number of threads used to evaluate the likelihood and its gradient
+   void SetExecutionPolicy(FitUtil::EExecutionPolicy policy, unsigned int nThreads = 0) {
+      fExecutionPolicy = policy;
+      fNThreads = nThreads;
+   }
+
 
 protected:
 
@@ -149,7 +154,7 @@ private:
     */
    virtual double DoEval (const double * x) const {
       this->UpdateNCalls();
-      return FitUtil::EvaluatePoissonLogL(fFunc, fData, x, fWeight, fIsExtended, fNEffPoints);
+      return FitUtil::EvaluatePoissonLogL(fFunc, fData, x, fWeight, fIsExtended, fNEffPoints, fExecutionPolicy, fNThreads);
    }
 
    // for derivatives
@@ -172,6 +177,8 @@ private:
 
    mutable std::vector<double> fGrad; // for derivatives
 
+   FitUtil::EExecutionPolicy fExecutionPolicy;  // serial or multithread evaluation
+   unsigned int fNThreads;                      // number of threads (0 is the default number)
 };
 
       // define useful typedef's
@@ -285,6 +285,19 @@ public:
       else
          return fDataWrapper->Coords(ipoint);
    }
+   /**
+      copy the coordinates of the n points starting at ipoint in x as a structure of arrays:
+      x[j*n + i] is the coordinate j of the point ipoint+i.
+      Used for the evaluation of the model function by batches of points
+    */
+   void GetCoordsBatch(unsigned int ipoint, unsigned int n, double * x) const {
+      for (unsigned int i = 0; i < n; ++i) {
+         const double * xi = Coords(ipoint + i);
+         for (unsigned int j = 0; j < fDim; ++j)
+            x[j*n + i] = xi[j];
+      }
+   }
+
 
    bool IsWeighted() const {
       return (fPointSize == fDim+1);
@@ -27,6 +27,7 @@
 
 
 #include <cassert>
+#include <vector>
 
 /**
    @defgroup ParamFunc Interfaces for parametric functions
@@ -127,6 +128,36 @@ public:
 
    using BaseFunc::operator();
 
+   /**
+      Evaluate the function at n points for the given parameters p and write the values in f.
+      The coordinates are given as a structure of arrays: x[j*n + i] is the coordinate j of the point i.
+      Use the virtual function DoEvalBatch to implement it
+   */
+   void EvalBatch(unsigned int n, const double * x, const double * p, double * f) const {
+      DoEvalBatch(n, x, p, f);
+   }
+
+
+protected:
+
+   /**
+      Implementation of the evaluation at n points. The default evaluates the points one by one
+      with DoEvalPar; derived classes can override it with a vectorized implementation
+   */
+   virtual void DoEvalBatch(unsigned int n, const double * x, const double * p, double * f) const {
+      unsigned int ndim = NDim();
+      if (ndim == 1) {
+         for (unsigned int i = 0; i < n; ++i)
+            f[i] = DoEvalPar(x + i, p);
+         return;
+      }
+      std::vector<double> xi(ndim);
+      for (unsigned int i = 0; i < n; ++i) {
+         for (unsigned int j = 0; j < ndim; ++j)
+            xi[j] = x[j*n + i];
+         f[i] = DoEvalPar(&xi[0], p);
+      }
+   }
 
 private:
 
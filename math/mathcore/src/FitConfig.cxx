@@ -44,6 +44,8 @@ FitConfig::FitConfig(unsigned int npar) :
    fMinosErrors(false),    // do full Minos error analysis for all parameters
    fUpdateAfterFit(true),    // update after fit
    fWeightCorr(false),
+   fExecutionPolicy(FitUtil::kSerial),
+   fNThreads(0),
    fSettings(std::vector<ParameterSettings>(npar) )
 {
    // constructor implementation
@@ -70,6 +72,9 @@ FitConfig & FitConfig::operator = (const FitConfig &rhs) {
    fUpdateAfterFit = rhs.fUpdateAfterFit;
    fWeightCorr     = rhs.fWeightCorr;
 
+   fExecutionPolicy = rhs.fExecutionPolicy;
+   fNThreads        = rhs.fNThreads;
+
    fSettings = rhs.fSettings;
    fMinosParams = rhs.fMinosParams;
 
@@ -29,6 +29,10 @@
 #include <limits>
 #include <cmath>
 #include <cassert>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <atomic>
 //#include <memory>
 
 //#define DEBUG
@@ -322,6 +326,143 @@ namespace ROOT {
          }
 
 
+         // accumulators of the sums over the data points.
+         // PlainSum is the simple summation used by the serial policy.
+         // KahanSum is the compensated summation used by the multithread policy,
+         // which keeps the rounding error independent of the number of points in a sum
+         class PlainSum {
+         public:
+            PlainSum() : fSum(0) {}
+            void Add(double x) { fSum += x; }
+            double Sum() const { return fSum; }
+         private:
+            double fSum;
+         };
+
+         class KahanSum {
+         public:
+            KahanSum() : fSum(0), fCarry(0) {}
+            void Add(double x) {
+               double y = x - fCarry;
+               double t = fSum + y;
+               fCarry = (t - fSum) - y;
+               fSum = t;
+            }
+            double Sum() const { return fSum; }
+         private:
+            double fSum;
+            double fCarry;   // low order bits lost in the last addition
+         };
+
+         // number of data points evaluated in one chunk by the multithread policy.
+         // It does not depend on the number of threads, so the partial sums
+         // and their reduction are always the same
+         const unsigned int kChunkSize = 4096;
+
+         inline unsigned int ChunkCount(unsigned int n) { return (n + kChunkSize - 1) / kChunkSize; }
+
+         // number of points for which the model function is evaluated at once with
+         // IParamMultiFunction::EvalBatch
+         const unsigned int kBatchSize = 64;
+
+         // evaluation of the model function at the coordinates of the data points by batches:
+         // Value(i) returns the function value for the point i, evaluating with EvalBatch the
+         // batch of points starting at i when i is not in the current one.
+         // The points are expected to be accessed in increasing order
+         template <class Data>
+         class BatchEvaluator {
+         public:
+            BatchEvaluator(const IModelFunction & func, const Data & data, const double * p, unsigned int end) :
+               fFunc(func), fData(data), fParams(p), fEnd(end), fBegin(0), fN(0),
+               fX(kBatchSize * data.NDim()), fValues(kBatchSize)
+            {}
+
+            double Value(unsigned int i) {
+               if (i < fBegin || i >= fBegin + fN) {
+                  fBegin = i;
+                  fN = std::min(kBatchSize, fEnd - i);
+                  fData.GetCoordsBatch(fBegin, fN, &fX[0]);
+                  fFunc.EvalBatch(fN, &fX[0], fParams, &fValues[0]);
+               }
+               return fValues[i - fBegin];
+            }
+
+         private:
+            const IModelFunction & fFunc;
+            const Data & fData;
+            const double * fParams;
+            unsigned int fEnd;              // end of the range of evaluated points
+            unsigned int fBegin;            // first point of the current batch
+            unsigned int fN;                // number of points in the current batch
+            std::vector<double> fX;         // coordinates of the batch (structure of arrays)
+            std::vector<double> fValues;    // function values of the batch
+         };
+
+         // evaluation of all the chunks of an Evaluator by the multithread policy.
+         // An Evaluator computes NSums() partial sums of the data points [begin,end)
+         // in operator()(begin, end, sums); it must be usable from several threads at once.
+         // The partial sums of each chunk are stored by chunk index and reduced in the
+         // chunk order, whatever the thread which computed them
+         template <class Evaluator>
+         class ChunkWork {
+         public:
+            ChunkWork(const Evaluator & eval, unsigned int n) :
+               fEval(eval),
+               fN(n),
+               fNChunks(ChunkCount(n)),
+               fSums(ChunkCount(n) * eval.NSums()),
+               fNext(0)
+            {}
+
+            // take the chunks one after the other until none is left
+            void Run() {
+               unsigned int nsums = fEval.NSums();
+               for (unsigned int ichunk = fNext++; ichunk < fNChunks; ichunk = fNext++) {
+                  unsigned int begin = ichunk * kChunkSize;
+                  unsigned int end = std::min(fN, begin + kChunkSize);
+                  fEval(begin, end, &fSums[ichunk * nsums]);
+               }
+            }
+
+            static void RunThread(ChunkWork * work) { work->Run(); }
+
+            // sum the partial sums of the chunks in their order
+            void Reduce(double * sums) const {
+               unsigned int nsums = fEval.NSums();
+               for (unsigned int k = 0; k < nsums; ++k) {
+                  KahanSum s;
+                  for (unsigned int ichunk = 0; ichunk < fNChunks; ++ichunk)
+                     s.Add(fSums[ichunk * nsums + k]);
+                  sums[k] = s.Sum();
+               }
+            }
+
+            unsigned int NChunks() const { return fNChunks; }
+
+         private:
+            const Evaluator & fEval;
+            unsigned int fN;
+            unsigned int fNChunks;
+            std::vector<double> fSums;            // partial sums of each chunk
+            std::atomic<unsigned int> fNext;      // next chunk to be evaluated
+         };
+
+         // evaluate the sums of the n data points by chunks with nThreads threads
+         // (the calling thread included)
+         template <class Evaluator>
+         void EvaluateChunks(const Evaluator & eval, unsigned int n, unsigned int nThreads, double * sums) {
+            ChunkWork<Evaluator> work(eval, n);
+            if (nThreads == 0) nThreads = DefaultNThreads();
+            if (nThreads > work.NChunks()) nThreads = work.NChunks();
+            std::vector<std::thread> threads;
+            for (unsigned int i = 1; i < nThreads; ++i)
+               threads.push_back(std::thread(&ChunkWork<Evaluator>::RunThread, &work));
+            work.Run();
+            for (unsigned int i = 0; i < threads.size(); ++i)
+               threads[i].join();
+            work.Reduce(sums);
+         }
+
 
       } // end namespace  FitUtil
 
@@ -331,16 +472,39 @@ namespace ROOT {
 // for chi2 functions
 //___________________________________________________________________________________________________________________________
 
-double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data, const double * p, unsigned int & nPoints) {
-   // evaluate the chi2 given a  function reference  , the data and returns the value and also in nPoints
-   // the actual number of used points
+unsigned int FitUtil::DefaultNThreads() {
+   // number of threads used by default by the multithread policy
+   unsigned int n = std::thread::hardware_concurrency();
+   return (n > 0) ? n : 1;
+}
+
+namespace FitUtil {
+
+   // evaluator of the chi2 sum of the points [begin,end)
+   template <class Sum>
+   class Chi2Evaluator {
+   public:
+      Chi2Evaluator(const IModelFunction & func, const BinData & data, const double * p) :
+         fFunc(func), fData(data), fParams(p) {}
+      unsigned int NSums() const { return 1; }
+      void operator() (unsigned int begin, unsigned int end, double * sums) const;
+   private:
+      const IModelFunction & fFunc;
+      const BinData & fData;
+      const double * fParams;
+   };
+
+template <class Sum>
+void Chi2Evaluator<Sum>::operator() (unsigned int begin, unsigned int end, double * sums) const {
    // normal chi2 using only error on values (from fitting histogram)
    // optionally the integral of function in the bin is used
 
+   const IModelFunction & func = fFunc;
+   const BinData & data = fData;
+   const double * p = fParams;
    unsigned int n = data.Size();
 
-   double chi2 = 0;
-   nPoints = 0; // count the effective non-zero points
+   Sum chi2;
 
    // do not cache parameter values (it is not thread safe)
    //func.SetParameters(p);
@@ -362,6 +526,7 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
 
 
    IntegralEvaluator<> igEval( func, p, useBinIntegral);
+   BatchEvaluator<BinData> batchEval( func, data, p, end);
 
    double maxResValue = std::numeric_limits<double>::max() /n;
    double wrefVolume = 1.0;
@@ -371,7 +536,7 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
       xc.resize(data.NDim() );
    }
 
-   for (unsigned int i = 0; i < n; ++ i) {
+   for (unsigned int i = begin; i < end; ++ i) {
 
 
       double y, invError;
@@ -395,7 +560,8 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
       const double * x = (useBinVolume) ? &xc.front() : x1;
 
       if (!useBinIntegral) {
-         fval = func ( x, p );
+         // the values at the bin coordinates are computed by batches
+         fval = (useBinVolume) ? func ( x, p ) : batchEval.Value(i);
       }
       else {
          // calculate integral normalized by bin volume
@@ -427,7 +593,6 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
 
 
       if (invError > 0) {
-         nPoints++;
 
          double tmp = ( y -fval )* invError;
          double resval = tmp * tmp;
@@ -435,15 +600,34 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
 
          // avoid inifinity or nan in chi2 values due to wrong function values
          if ( resval < maxResValue )
-            chi2 += resval;
+            chi2.Add(resval);
          else {
             //nRejected++;
-            chi2 += maxResValue;
+            chi2.Add(maxResValue);
          }
       }
 
 
    }
+
+   sums[0] = chi2.Sum();
+}
+
+} // end namespace FitUtil
+
+double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data, const double * p, unsigned int & nPoints,
+                             EExecutionPolicy policy, unsigned int nThreads) {
+   // evaluate the chi2 given a  function reference  , the data and returns the value and also in nPoints
+   // the actual number of used points
+
+   unsigned int n = data.Size();
+
+   double chi2 = 0;
+   if (policy == kMultithread)
+      EvaluateChunks(Chi2Evaluator<KahanSum>(func, data, p), n, nThreads, &chi2);
+   else
+      Chi2Evaluator<PlainSum>(func, data, p)(0, n, &chi2);
+
    nPoints=n;
 
 #ifdef DEBUG
@@ -683,31 +867,32 @@ double FitUtil::EvaluateChi2Residual(const IModelFunction & func, const BinData
 
 }
 
-void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & data, const double * p, double * grad, unsigned int & nPoints) {
-   // evaluate the gradient of the chi2 function
-   // this function is used when the model function knows how to calculate the derivative and we can
-   // avoid that the minimizer re-computes them
-   //
-   // case of chi2 effective (errors on coordinate) is not supported
-
-   if ( data.HaveCoordErrors() ) {
-      MATH_ERROR_MSG("FitUtil::EvaluateChi2Residual","Error on the coordinates are not used in calculating Chi2 gradient");            return; // it will assert otherwise later in GetPoint
-   }
+namespace FitUtil {
+
+   // evaluator of the chi2 gradient of the points [begin,end):
+   // the npar components of the gradient and the number of rejected points
+   template <class Sum>
+   class Chi2GradientEvaluator {
+   public:
+      Chi2GradientEvaluator(const IGradModelFunction & func, const BinData & data, const double * p) :
+         fFunc(func), fData(data), fParams(p) {}
+      unsigned int NSums() const { return fFunc.NPar() + 1; }
+      void operator() (unsigned int begin, unsigned int end, double * sums) const;
+   private:
+      const IGradModelFunction & fFunc;
+      const BinData & fData;
+      const double * fParams;
+   };
+
+template <class Sum>
+void Chi2GradientEvaluator<Sum>::operator() (unsigned int begin, unsigned int end, double * sums) const {
+
+   const IGradModelFunction & func = fFunc;
+   const BinData & data = fData;
+   const double * p = fParams;
 
    unsigned int nRejected = 0;
 
-   const IGradModelFunction * fg = dynamic_cast<const IGradModelFunction *>( &f);
-   assert (fg != 0); // must be called by a gradient function
-
-   const IGradModelFunction & func = *fg;
-   unsigned int n = data.Size();
-
-
-#ifdef DEBUG
-   std::cout << "\n\nFit data size = " << n << std::endl;
-   std::cout << "evaluate chi2 using function gradient " << &func << "  " << p << std::endl;
-#endif
-
    const DataOptions & fitOpt = data.Opt();
    bool useBinIntegral = fitOpt.fIntegral && data.HasBinEdges();
    bool useBinVolume = (fitOpt.fBinVolume && data.HasBinEdges());
@@ -728,9 +913,9 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
    //   assert (npar == NDim() );  // npar MUST be  Chi2 dimension
    std::vector<double> gradFunc( npar );
    // set all vector values to zero
-   std::vector<double> g( npar);
+   std::vector<Sum> g( npar);
 
-   for (unsigned int i = 0; i < n; ++ i) {
+   for (unsigned int i = begin; i < end; ++ i) {
 
 
       double y, invError = 0;
@@ -793,7 +978,7 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
 
          // calculate derivative point contribution
          double tmp = - 2.0 * ( y -fval )* invError * invError * gradFunc[ipar];
-         g[ipar] += tmp;
+         g[ipar].Add(tmp);
 
       }
 
@@ -806,6 +991,47 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
 
    }
 
+   for (unsigned int ipar = 0; ipar < npar; ++ipar)
+      sums[ipar] = g[ipar].Sum();
+   sums[npar] = nRejected;
+}
+
+} // end namespace FitUtil
+
+void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & data, const double * p, double * grad, unsigned int & nPoints,
+                                   EExecutionPolicy policy, unsigned int nThreads) {
+   // evaluate the gradient of the chi2 function
+   // this function is used when the model function knows how to calculate the derivative and we can
+   // avoid that the minimizer re-computes them
+   //
+   // case of chi2 effective (errors on coordinate) is not supported
+
+   if ( data.HaveCoordErrors() ) {
+      MATH_ERROR_MSG("FitUtil::EvaluateChi2Residual","Error on the coordinates are not used in calculating Chi2 gradient");            return; // it will assert otherwise later in GetPoint
+   }
+
+   const IGradModelFunction * fg = dynamic_cast<const IGradModelFunction *>( &f);
+   assert (fg != 0); // must be called by a gradient function
+
+   const IGradModelFunction & func = *fg;
+   unsigned int n = data.Size();
+
+
+#ifdef DEBUG
+   std::cout << "\n\nFit data size = " << n << std::endl;
+   std::cout << "evaluate chi2 using function gradient " << &func << "  " << p << std::endl;
+#endif
+
+   unsigned int npar = func.NPar();
+   // gradient components followed by the number of rejected points
+   std::vector<double> sums( npar + 1);
+   if (policy == kMultithread)
+      EvaluateChunks(Chi2GradientEvaluator<KahanSum>(func, data, p), n, nThreads, &sums[0]);
+   else
+      Chi2GradientEvaluator<PlainSum>(func, data, p)(0, n, &sums[0]);
+
+   unsigned int nRejected = (unsigned int) sums[npar];
+
    // correct the number of points
    nPoints = n;
    if (nRejected != 0)  {
@@ -815,7 +1041,7 @@ void FitUtil::EvaluateChi2Gradient(const IModelFunction & f, const BinData & dat
    }
 
    // copy result
-   std::copy(g.begin(), g.end(), grad);
+   std::copy(sums.begin(), sums.begin() + npar, grad);
 
 }
 
@@ -875,42 +1101,53 @@ double FitUtil::EvaluatePdf(const IModelFunction & func, const UnBinData & data,
    return logPdf;
 }
 
-double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * p,
-                                   int iWeight,  bool extended, unsigned int &nPoints) {
-   // evaluate the LogLikelihood
-
-   unsigned int n = data.Size();
-
-#ifdef DEBUG
-   std::cout << "\n\nFit data size = " << n << std::endl;
-   std::cout << "func pointer is " << typeid(func).name() << std::endl;
-#endif
-
-   double logl = 0;
-   //unsigned int nRejected = 0;
-
-   // this is needed if function must be normalized
-   bool normalizeFunc = false;
-   double norm = 1.0;
-   if (normalizeFunc) {
-      // compute integral of the function
-      std::vector<double> xmin(data.NDim());
-      std::vector<double> xmax(data.NDim());
-      IntegralEvaluator<> igEval( func, p, true);
-      data.Range().GetRange(&xmin[0],&xmax[0]);
-      norm = igEval.Integral(&xmin[0],&xmax[0]);
-   }
-
+namespace FitUtil {
+
+   // evaluator of the log likelihood sum of the points [begin,end),
+   // followed by the sum of the weights and of the weight squares
+   // (needed for the extended likelihood with weight squares)
+   template <class Sum>
+   class LogLEvaluator {
+   public:
+      LogLEvaluator(const IModelFunction & func, const UnBinData & data, const double * p, int iWeight, bool extended, double norm) :
+         fFunc(func), fData(data), fParams(p), fWeight(iWeight), fIsExtended(extended), fNorm(norm) {}
+      unsigned int NSums() const { return 3; }
+      void operator() (unsigned int begin, unsigned int end, double * sums) const;
+   private:
+      const IModelFunction & fFunc;
+      const UnBinData & fData;
+      const double * fParams;
+      int fWeight;
+      bool fIsExtended;
+      double fNorm;   // normalization of the function (1 if not normalized)
+   };
+
+template <class Sum>
+void LogLEvaluator<Sum>::operator() (unsigned int begin, unsigned int end, double * sums) const {
+
+   const IModelFunction & func = fFunc;
+   const UnBinData & data = fData;
+   const double * p = fParams;
+   int iWeight = fWeight;
+   bool extended = fIsExtended;
+
+   bool normalizeFunc = (fNorm != 1.0);
+   double norm = fNorm;
+
+   Sum logl;
    // needed to compue effective global weight in case of extended likelihood
-   double sumW = 0;
-   double sumW2 = 0;
+   Sum sumW;
+   Sum sumW2;
 
-   for (unsigned int i = 0; i < n; ++ i) {
-      const double * x = data.Coords(i);
-      double fval = func ( x, p );
+   // the function values are computed by batches
+   BatchEvaluator<UnBinData> batchEval( func, data, p, end);
+
+   for (unsigned int i = begin; i < end; ++ i) {
+      double fval = batchEval.Value(i);
       if (normalizeFunc) fval = fval / norm;
 
 #ifdef DEBUG
+      const double * x = data.Coords(i);
       std::cout << "x [ " << data.NDim() << " ] = ";
       for (unsigned int j = 0; j < data.NDim(); ++j)
          std::cout << x[j] << "\t";
@@ -928,14 +1165,58 @@ double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data
             logval *= weight; // use square of weights in likelihood
             if (extended) {
                // needed sum of weights and sum of weight square if likelkihood is extended
-               sumW += weight;
-               sumW2 += weight*weight;
+               sumW.Add(weight);
+               sumW2.Add(weight*weight);
             }
          }
       }
-      logl += logval;
+      logl.Add(logval);
    }
 
+   sums[0] = logl.Sum();
+   sums[1] = sumW.Sum();
+   sums[2] = sumW2.Sum();
+}
+
+} // end namespace FitUtil
+
+double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * p,
+                             int iWeight,  bool extended, unsigned int &nPoints,
+                             EExecutionPolicy policy, unsigned int nThreads) {
+   // evaluate the LogLikelihood
+
+   unsigned int n = data.Size();
+
+#ifdef DEBUG
+   std::cout << "\n\nFit data size = " << n << std::endl;
+   std::cout << "func pointer is " << typeid(func).name() << std::endl;
+#endif
+
+   //unsigned int nRejected = 0;
+
+   // this is needed if function must be normalized
+   bool normalizeFunc = false;
+   double norm = 1.0;
+   if (normalizeFunc) {
+      // compute integral of the function
+      std::vector<double> xmin(data.NDim());
+      std::vector<double> xmax(data.NDim());
+      IntegralEvaluator<> igEval( func, p, true);
+      data.Range().GetRange(&xmin[0],&xmax[0]);
+      norm = igEval.Integral(&xmin[0],&xmax[0]);
+   }
+
+   // sum of the log of the pdf values, of the weights and of the weight squares
+   double sums[3] = { 0, 0, 0 };
+   if (policy == kMultithread)
+      EvaluateChunks(LogLEvaluator<KahanSum>(func, data, p, iWeight, extended, norm), n, nThreads, sums);
+   else
+      LogLEvaluator<PlainSum>(func, data, p, iWeight, extended, norm)(0, n, sums);
+
+   double logl = sums[0];
+   double sumW = sums[1];
+   double sumW2 = sums[2];
+
    if (extended) {
       // add Poisson extended term
       double extendedTerm = 0; // extended term in likelihood
@@ -991,41 +1272,76 @@ double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data
    return -logl;
 }
 
-void FitUtil::EvaluateLogLGradient(const IModelFunction & f, const UnBinData & data, const double * p, double * grad, unsigned int & ) {
-   // evaluate the gradient of the log likelihood function
-
-   const IGradModelFunction * fg = dynamic_cast<const IGradModelFunction *>( &f);
-   assert (fg != 0); // must be called by a grad function
-   const IGradModelFunction & func = *fg;
+namespace FitUtil {
+
+   // evaluator of the gradient of the log likelihood of the points [begin,end)
+   template <class Sum>
+   class LogLGradientEvaluator {
+   public:
+      LogLGradientEvaluator(const IGradModelFunction & func, const UnBinData & data, const double * p) :
+         fFunc(func), fData(data), fParams(p) {}
+      unsigned int NSums() const { return fFunc.NPar(); }
+      void operator() (unsigned int begin, unsigned int end, double * sums) const;
+   private:
+      const IGradModelFunction & fFunc;
+      const UnBinData & fData;
+      const double * fParams;
+   };
+
+template <class Sum>
+void LogLGradientEvaluator<Sum>::operator() (unsigned int begin, unsigned int end, double * sums) const {
+
+   const IGradModelFunction & func = fFunc;
+   const UnBinData & data = fData;
+   const double * p = fParams;
 
    unsigned int n = data.Size();
    //int nRejected = 0;
 
    unsigned int npar = func.NPar();
    std::vector<double> gradFunc( npar );
-   std::vector<double> g( npar);
+   std::vector<Sum> g( npar);
 
-   for (unsigned int i = 0; i < n; ++ i) {
+   for (unsigned int i = begin; i < end; ++ i) {
       const double * x = data.Coords(i);
       double fval = func ( x , p);
       func.ParameterGradient( x, p, &gradFunc[0] );
       for (unsigned int kpar = 0; kpar < npar; ++ kpar) {
          if (fval > 0)
-            g[kpar] -= 1./fval * gradFunc[ kpar ];
+            g[kpar].Add( - 1./fval * gradFunc[ kpar ] );
          else if (gradFunc [ kpar] != 0) {
             const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
             const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
             double gg = kdmax1 * gradFunc[ kpar ];
             if ( gg > 0) gg = std::min( gg, kdmax2);
             else gg = std::max(gg, - kdmax2);
-            g[kpar] -= gg;
+            g[kpar].Add( - gg );
          }
          // if func derivative is zero term is also zero so do not add in g[kpar]
       }
-
-    // copy result
-   std::copy(g.begin(), g.end(), grad);
    }
+
+   for (unsigned int kpar = 0; kpar < npar; ++ kpar)
+      sums[kpar] = g[kpar].Sum();
+}
+
+} // end namespace FitUtil
+
+void FitUtil::EvaluateLogLGradient(const IModelFunction & f, const UnBinData & data, const double * p, double * grad, unsigned int &,
+                                   EExecutionPolicy policy, unsigned int nThreads) {
+   // evaluate the gradient of the log likelihood function
+
+   const IGradModelFunction * fg = dynamic_cast<const IGradModelFunction *>( &f);
+   assert (fg != 0); // must be called by a grad function
+   const IGradModelFunction & func = *fg;
+
+   unsigned int n = data.Size();
+
+   // the result is copied directly in grad
+   if (policy == kMultithread)
+      EvaluateChunks(LogLGradientEvaluator<KahanSum>(func, data, p), n, nThreads, grad);
+   else
+      LogLGradientEvaluator<PlainSum>(func, data, p)(0, n, grad);
 }
 //_________________________________________________________________________________________________
 // for binned log likelihood functions
@@ -1136,34 +1452,36 @@ double FitUtil::EvaluatePoissonBinPdf(const IModelFunction & func, const BinData
    return logPdf;
 }
 
-double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData & data,
-                                    const double * p, int iWeight, bool extended,  unsigned int &   nPoints ) {
-   // evaluate the Poisson Log Likelihood
-   // for binned likelihood fits
-   // this is Sum ( f(x_i)  -  y_i * log( f (x_i) ) )
-   // add as well constant term for saturated model to make it like a Chi2/2
-   // by default is etended. If extended is false the fit is not extended and
-   // the global poisson term is removed (i.e is a binomial fit)
-   // (remember that in this case one needs to have a function with a fixed normalization
-   // like in a non extended binned fit)
-   //
-   // if use Weight use a weighted dataset
-   // iWeight = 1 ==> logL = Sum( w f(x_i) )
-   // case of iWeight==1 is actually identical to weight==0
-   // iWeight = 2 ==> logL = Sum( w*w * f(x_i) )
-   //
-   // nPoints returns the points where bin content is not zero
-
-
-   unsigned int n = data.Size();
-#ifdef DEBUG
-   std::cout << "Evaluate PoissonLogL for params = [ ";
-   for (unsigned int j=0; j < func.NPar(); ++j) std::cout << p[j] << " , ";
-   std::cout << "]  - data size = " << n << std::endl;
-#endif
-
-   double nloglike = 0;  // negative loglikelihood
-   nPoints = 0;  // npoints
+namespace FitUtil {
+
+   // evaluator of the Poisson log likelihood sum of the points [begin,end),
+   // followed by the number of points with non-zero content
+   template <class Sum>
+   class PoissonLogLEvaluator {
+   public:
+      PoissonLogLEvaluator(const IModelFunction & func, const BinData & data, const double * p, int iWeight, bool extended) :
+         fFunc(func), fData(data), fParams(p), fWeight(iWeight), fIsExtended(extended) {}
+      unsigned int NSums() const { return 2; }
+      void operator() (unsigned int begin, unsigned int end, double * sums) const;
+   private:
+      const IModelFunction & fFunc;
+      const BinData & fData;
+      const double * fParams;
+      int fWeight;
+      bool fIsExtended;
+   };
+
+template <class Sum>
+void PoissonLogLEvaluator<Sum>::operator() (unsigned int begin, unsigned int end, double * sums) const {
+
+   const IModelFunction & func = fFunc;
+   const BinData & data = fData;
+   const double * p = fParams;
+   int iWeight = fWeight;
+   bool extended = fIsExtended;
+
+   Sum nloglike;  // negative loglikelihood
+   unsigned int nPoints = 0;  // npoints
 
 
    // get fit option and check case of using integral of bins
@@ -1180,13 +1498,14 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
    }
 
    IntegralEvaluator<> igEval( func, p, fitOpt.fIntegral);
+   BatchEvaluator<BinData> batchEval( func, data, p, end);
 
    // double nuTot = 0; // total number of expected events (needed for non-extended fits)
    // double wTot = 0; // sum of all weights
    // double w2Tot = 0; // sum of weight squared  (these are needed for useW2)
 
 
-   for (unsigned int i = 0; i < n; ++ i) {
+   for (unsigned int i = begin; i < end; ++ i) {
       const double * x1 = data.Coords(i);
       double y = data.Value(i);
 
@@ -1207,7 +1526,8 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
       const double * x = (useBinVolume) ? &xc.front() : x1;
 
       if (!useBinIntegral) {
-         fval = func ( x, p );
+         // the values at the bin coordinates are computed by batches
+         fval = (useBinVolume) ? func ( x, p ) : batchEval.Value(i);
       }
       else {
          // calculate integral (normalized by bin volume)
@@ -1276,9 +1596,52 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
       }
 
 
-      nloglike +=  tmp;
+      nloglike.Add(tmp);
    }
 
+   sums[0] = nloglike.Sum();
+   sums[1] = nPoints;
+}
+
+} // end namespace FitUtil
+
+double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData & data,
+                                    const double * p, int iWeight, bool extended,  unsigned int &   nPoints,
+                                    EExecutionPolicy policy, unsigned int nThreads) {
+   // evaluate the Poisson Log Likelihood
+   // for binned likelihood fits
+   // this is Sum ( f(x_i)  -  y_i * log( f (x_i) ) )
+   // add as well constant term for saturated model to make it like a Chi2/2
+   // by default is etended. If extended is false the fit is not extended and
+   // the global poisson term is removed (i.e is a binomial fit)
+   // (remember that in this case one needs to have a function with a fixed normalization
+   // like in a non extended binned fit)
+   //
+   // if use Weight use a weighted dataset
+   // iWeight = 1 ==> logL = Sum( w f(x_i) )
+   // case of iWeight==1 is actually identical to weight==0
+   // iWeight = 2 ==> logL = Sum( w*w * f(x_i) )
+   //
+   // nPoints returns the points where bin content is not zero
+
+
+   unsigned int n = data.Size();
+#ifdef DEBUG
+   std::cout << "Evaluate PoissonLogL for params = [ ";
+   for (unsigned int j=0; j < func.NPar(); ++j) std::cout << p[j] << " , ";
+   std::cout << "]  - data size = " << n << std::endl;
+#endif
+
+   // negative loglikelihood and number of points
+   double sums[2] = { 0, 0 };
+   if (policy == kMultithread)
+      EvaluateChunks(PoissonLogLEvaluator<KahanSum>(func, data, p, iWeight, extended), n, nThreads, sums);
+   else
+      PoissonLogLEvaluator<PlainSum>(func, data, p, iWeight, extended)(0, n, sums);
+
+   double nloglike = sums[0];
+   nPoints = (unsigned int) sums[1];
+
    // if (notExtended) {
    //    // not extended : remove from the Likelihood the global Poisson term
    //    if (!useW2)
@@ -1303,12 +1666,28 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
    return nloglike;
 }
 
-void FitUtil::EvaluatePoissonLogLGradient(const IModelFunction & f, const BinData & data, const double * p, double * grad ) {
-   // evaluate the gradient of the Poisson log likelihood function
-
-   const IGradModelFunction * fg = dynamic_cast<const IGradModelFunction *>( &f);
-   assert (fg != 0); // must be called by a grad function
-   const IGradModelFunction & func = *fg;
+namespace FitUtil {
+
+   // evaluator of the gradient of the Poisson log likelihood of the points [begin,end)
+   template <class Sum>
+   class PoissonLogLGradientEvaluator {
+   public:
+      PoissonLogLGradientEvaluator(const IGradModelFunction & func, const BinData & data, const double * p) :
+         fFunc(func), fData(data), fParams(p) {}
+      unsigned int NSums() const { return fFunc.NPar(); }
+      void operator() (unsigned int begin, unsigned int end, double * sums) const;
+   private:
+      const IGradModelFunction & fFunc;
+      const BinData & fData;
+      const double * fParams;
+   };
+
+template <class Sum>
+void PoissonLogLGradientEvaluator<Sum>::operator() (unsigned int begin, unsigned int end, double * sums) const {
+
+   const IGradModelFunction & func = fFunc;
+   const BinData & data = fData;
+   const double * p = fParams;
 
    unsigned int n = data.Size();
 
@@ -1327,9 +1706,9 @@ void FitUtil::EvaluatePoissonLogLGradient(const IModelFunction & f, const BinDat
 
    unsigned int npar = func.NPar();
    std::vector<double> gradFunc( npar );
-   std::vector<double> g( npar);
+   std::vector<Sum> g( npar);
 
-   for (unsigned int i = 0; i < n; ++ i) {
+   for (unsigned int i = begin; i < end; ++ i) {
       const double * x1 = data.Coords(i);
       double y = data.Value(i);
       double fval = 0;
@@ -1370,23 +1749,41 @@ void FitUtil::EvaluatePoissonLogLGradient(const IModelFunction & f, const BinDat
 
          // df/dp * (1.  - y/f )
          if (fval > 0)
-            g[kpar] += gradFunc[ kpar ] * ( 1. - y/fval );
+            g[kpar].Add( gradFunc[ kpar ] * ( 1. - y/fval ) );
          else if (gradFunc [ kpar] != 0) {
             const double kdmax1 = std::sqrt( std::numeric_limits<double>::max() );
             const double kdmax2 = std::numeric_limits<double>::max() / (4*n);
             double gg = kdmax1 * gradFunc[ kpar ];
             if ( gg > 0) gg = std::min( gg, kdmax2);
             else gg = std::max(gg, - kdmax2);
-            g[kpar] -= gg;
+            g[kpar].Add( - gg );
          }
       }
-
-      // copy result
-      std::copy(g.begin(), g.end(), grad);
    }
+
+   for (unsigned int kpar = 0; kpar < npar; ++ kpar)
+      sums[kpar] = g[kpar].Sum();
+}
+
+} // end namespace FitUtil
+
+void FitUtil::EvaluatePoissonLogLGradient(const IModelFunction & f, const BinData & data, const double * p, double * grad,
+                                          EExecutionPolicy policy, unsigned int nThreads) {
+   // evaluate the gradient of the Poisson log likelihood function
+
+   const IGradModelFunction * fg = dynamic_cast<const IGradModelFunction *>( &f);
+   assert (fg != 0); // must be called by a grad function
+   const IGradModelFunction & func = *fg;
+
+   unsigned int n = data.Size();
+
+   // the result is copied directly in grad
+   if (policy == kMultithread)
+      EvaluateChunks(PoissonLogLGradientEvaluator<KahanSum>(func, data, p), n, nThreads, grad);
+   else
+      PoissonLogLGradientEvaluator<PlainSum>(func, data, p)(0, n, grad);
 }
 
 }
 
 } // end namespace ROOT
-
@@ -9,11 +9,13 @@
 #include "TRandom3.h"
 #include "TROOT.h"
 #include "TVirtualFitter.h"
+#include "TMath.h"
 
 #include "Fit/BinData.h"
 #include "Fit/UnBinData.h"
 #include "HFitInterface.h"
 #include "Fit/Fitter.h"
+#include "Fit/FitUtil.h"
 
 #include "Math/WrappedMultiTF1.h"
 #include "Math/WrappedParamFunction.h"
@@ -914,6 +916,102 @@ int testGraphFit() {
 }
 
 
+int testBatchEvaluation() {
+
+   int iret = 0;
+
+   // the batch evaluation of the builtin functions must agree with TF1::EvalPar
+   // (gausn is evaluated point by point)
+   const char * names[] = { "gaus", "gausn", "expo", "pol3", "landau", "landaun" };
+   double pars[] = { 2., 0.5, 1.5, -0.3 };
+
+   const unsigned int n = 100;
+   double x[n];
+   double f[n];
+   for (unsigned int i = 0; i < n; ++i) x[i] = -5. + 0.1 * i;
+
+   for (int k = 0; k < 6; ++k) {
+      TF1 * func = new TF1("fbatch", names[k], -5, 5);
+      ROOT::Math::WrappedMultiTF1 wf(*func);
+      wf.EvalBatch(n, x, pars, f);
+      for (unsigned int i = 0; i < n; ++i) {
+         double fref = func->EvalPar(&x[i], pars);
+         if (std::abs(f[i] - fref) > 1.E-12 * std::abs(fref)) {
+            std::cerr << "Batch evaluation of " << names[k] << " at x = " << x[i] << " is " << f[i] << " it should be " << fref << std::endl;
+            iret |= 1;
+            break;
+         }
+      }
+      delete func;
+   }
+
+   return iret;
+}
+
+// thread safe model function for the multithread fits
+double gausModel(const double * x, const double * p) {
+   double t = (x[0] - p[1]) / p[2];
+   return p[0] * std::exp(-0.5 * t * t) / (std::sqrt(2. * TMath::Pi()) * p[2]);
+}
+
+int testMultithreadFit() {
+
+   int iret = 0;
+
+   TRandom3 rndm;
+
+   int n = 100000;
+   ROOT::Fit::UnBinData d(n);
+   for (int i = 0; i <n; ++i)
+      d.Add( rndm.Gaus(0,1) );
+
+   ROOT::Math::WrappedParamFunction<> f(&gausModel, 1, 3);
+   double p[3] = {1,0.2,1.5};
+   f.SetParameters(p);
+
+   // the multithread evaluation must not depend on the number of threads
+   unsigned int np = 0;
+   double lserial = ROOT::Fit::FitUtil::EvaluateLogL(f, d, p, 0, false, np);
+   double lmt2 = ROOT::Fit::FitUtil::EvaluateLogL(f, d, p, 0, false, np, ROOT::Fit::FitUtil::kMultithread, 2);
+   double lmt4 = ROOT::Fit::FitUtil::EvaluateLogL(f, d, p, 0, false, np, ROOT::Fit::FitUtil::kMultithread, 4);
+   if (lmt2 != lmt4) {
+      std::cerr << "Multithread likelihood depends on the number of threads " << lmt2 << "  " << lmt4 << std::endl;
+      iret |= 1;
+   }
+   iret |= compareResult(lmt2, lserial, "multithread likelihood evaluation", 1.E-10);
+
+   ROOT::Fit::Fitter fitter;
+   fitter.SetFunction(f);
+   fitter.Config().ParSettings(0).Fix();
+   fitter.Config().ParSettings(2).SetLowerLimit(0);
+   fitter.Config().SetMinimizer("Minuit2");
+
+   bool ret = fitter.Fit(d);
+   if (!ret) {
+      std::cout << "Unbinned Likelihood Fit Failed " << std::endl;
+      return 1;
+   }
+   double lref = fitter.Result().MinFcnValue();
+
+   f.SetParameters(p);
+   fitter.SetFunction(f);
+   fitter.Config().ParSettings(0).Fix();
+   fitter.Config().ParSettings(2).SetLowerLimit(0);
+   fitter.Config().SetExecutionPolicy(ROOT::Fit::FitUtil::kMultithread, 4);
+
+   ret = fitter.Fit(d);
+   if (ret)
+      fitter.Result().Print(std::cout);
+   else {
+      std::cout << "Multithread Unbinned Likelihood Fit Failed " << std::endl;
+      iret |= 1;
+   }
+
+   iret |= compareResult(fitter.Result().MinFcnValue(), lref,"1D unbin multithread fit", 1.E-6);
+
+   return iret;
+}
+
 template<typename Test>
 int testFit(Test t, std::string name) {
    std::cout << name << "\n\t\t";
@@ -934,6 +1032,8 @@ int main() {
    iret |= testFit( testHisto2DFit, "Histogram2D Gradient Fit");
    iret |= testFit( testUnBin1DFit, "Unbin 1D Fit");
    iret |= testFit( testGraphFit, "Graph 1D Fit");
+   iret |= testFit( testMultithreadFit, "Multithread Fit");
+   iret |= testFit( testBatchEvaluation, "Batch Evaluation");
 
    std::cout << "\n******************************\n";
    if (iret) std::cerr << "\n\t testFit FAILED !!!!!!!!!!!!!!!! \n";
@@ -63,6 +63,12 @@ public:
       as it searches for the Minimum or performs whatever analysis is requested by
       the user.
 
+      When the numerical gradient and the Hessian are computed with several threads
+      (MnStrategy::SetNThreads, or the option NThreads of Minuit2Minimizer), this
+      function is called concurrently from different threads: it must then be
+      reentrant, i.e. not modify any state shared between the calls (e.g. cached
+      values or a counter of calls) without synchronization.
+
       @param par function parameters as defined by the user.
 
       @return the Value of the function.
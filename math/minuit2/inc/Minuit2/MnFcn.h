@@ -39,9 +39,24 @@ public:
 
   virtual ~MnFcn();
 
-  virtual double operator()(const MnAlgebraicVector&) const;
+  /// evaluate the function and increment the counter of calls.
+  /// The threaded gradient and Hessian (see MnStrategy::SetNThreads) call Eval instead,
+  /// so a derived class must implement the evaluation in Eval
+  virtual double operator()(const MnAlgebraicVector& v) const {
+     fNumCall++;
+     return Eval(v);
+  }
+
+  /// evaluate the function without incrementing the counter of calls.
+  /// It can be called concurrently from different threads if the FCN is thread safe;
+  /// the calls are then added to the counter afterwards with AddCalls
+  virtual double Eval(const MnAlgebraicVector&) const;
+
   unsigned int NumOfCalls() const {return fNumCall;}
 
+  /// add to the counter the calls done via Eval
+  void AddCalls(unsigned int ncalls) const { fNumCall += ncalls; }
+
   //
   //forward interface
   //
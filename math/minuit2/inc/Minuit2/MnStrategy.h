@@ -49,6 +49,8 @@ public:
 
    int StorageLevel() const { return fStoreLevel; }
 
+   unsigned int NThreads() const { return fNThreads; }
+
    bool IsLow() const {return fStrategy == 0;}
    bool IsMedium() const {return fStrategy == 1;}
    bool IsHigh() const {return fStrategy >= 2;}
@@ -69,6 +71,13 @@ public:
    // set storage level of iteration quantities
    // 0 = store only last iterations 1 = full storage (default)
    void SetStorageLevel(unsigned int level) { fStoreLevel = level; }
+
+   // set number of threads used to compute the numerical gradient and the Hessian
+   // (1 = serial, the default). The result does not depend on the number of threads,
+   // but with n > 1 the FCN must be reentrant, since it is evaluated concurrently
+   // (see FCNBase::operator())
+   void SetNThreads(unsigned int n) { fNThreads = (n > 0) ? n : 1; }
+
 private:
 
    unsigned int fStrategy;
@@ -81,6 +90,7 @@ private:
    double fHessTlrG2;
    unsigned int fHessGradNCyc;
    int fStoreLevel;
+   unsigned int fNThreads;
 };
 
   }  // namespace Minuit2
@@ -461,6 +461,11 @@ bool Minuit2Minimizer::Minimize() {
       bool ret = minuit2Opt->GetValue("StorageLevel",storageLevel);
       if (ret) SetStorageLevel(storageLevel);
 
+      // number of threads used for the numerical gradient and Hessian (the function must be reentrant)
+      int nThreads = strategy.NThreads();
+      minuit2Opt->GetValue("NThreads",nThreads);
+      strategy.SetNThreads(nThreads > 0 ? nThreads : 1);
+
    }
 
    // set a minimizer tracer object (default for printlevel=10, from gROOT for printLevel=11)
@@ -1021,7 +1026,15 @@ bool Minuit2Minimizer::Hesse( ) {
    // set the precision if needed
    if (Precision() > 0) fState.SetPrecision(Precision());
 
-   ROOT::Minuit2::MnHesse hesse( strategy );
+   ROOT::Minuit2::MnStrategy mnStrategy( strategy );
+   ROOT::Math::IOptions * minuit2Opt = ROOT::Math::MinimizerOptions::FindDefault("Minuit2");
+   if (minuit2Opt) {
+      int nThreads = mnStrategy.NThreads();
+      minuit2Opt->GetValue("NThreads",nThreads);
+      mnStrategy.SetNThreads(nThreads > 0 ? nThreads : 1);
+   }
+
+   ROOT::Minuit2::MnHesse hesse( mnStrategy );
 
    // case when function minimum exists
    if (fMinimum  ) {
@@ -20,9 +20,8 @@ MnFcn::~MnFcn() {
    //   std::cout<<"Total number of calls to FCN: "<<fNumCall<<std::endl;
 }
 
-double MnFcn::operator()(const MnAlgebraicVector& v) const {
+double MnFcn::Eval(const MnAlgebraicVector& v) const {
    // evaluate FCN converting from from MnAlgebraicVector to std::vector
-   fNumCall++;
    return fFCN(MnVectorTransform()(v));
 }
 
@@ -26,12 +26,170 @@
 #endif
 
 #include "Minuit2/MPIProcess.h"
+#include "MnParallelFor.h"
+
+#include <vector>
 
 namespace ROOT {
 
    namespace Minuit2 {
 
 
+namespace {
+
+// second derivative and related quantities computed for a single parameter
+struct HessianDiagonal {
+   double g2;
+   double grd;
+   double gst;
+   double dirin;
+   double yy;
+   unsigned int ncalls;
+   bool failed;      // second derivative found to be zero
+};
+
+// compute the diagonal element of the Hessian for the internal parameter i varying only the component x(i)
+// (which is restored before returning). When countCalls is false the function calls are not recorded in
+// the MnFcn counter, so different parameters can be computed concurrently, each thread with its own copy of x
+void ComputeHessianDiagonal(const MnHesse& hesse, const MnFcn& mfcn, const MnUserTransformation& trafo,
+                            unsigned int i, MnAlgebraicVector& x, double amin, double aimsag,
+                            HessianDiagonal& elem, bool countCalls) {
+
+   const MnMachinePrecision& prec = trafo.Precision();
+
+   double xtf = x(i);
+   double dmin = 8.*prec.Eps2()*(fabs(xtf) + prec.Eps2());
+   double d = fabs(elem.gst);
+   if(d < dmin) d = dmin;
+
+#ifdef DEBUG
+   std::cout << "\nDerivative parameter  " << i << " d = " << d << " dmin = " << dmin << std::endl;
+#endif
+
+
+   for(unsigned int icyc = 0; icyc < hesse.Ncycles(); icyc++) {
+      double sag = 0.;
+      double fs1 = 0.;
+      double fs2 = 0.;
+      for(unsigned int multpy = 0; multpy < 5; multpy++) {
+         x(i) = xtf + d;
+         fs1 = (countCalls) ? mfcn(x) : mfcn.Eval(x);
+         x(i) = xtf - d;
+         fs2 = (countCalls) ? mfcn(x) : mfcn.Eval(x);
+         x(i) = xtf;
+         elem.ncalls += 2;
+         sag = 0.5*(fs1+fs2-2.*amin);
+
+#ifdef DEBUG
+         std::cout << "cycle " << icyc << " mul " << multpy << "\t sag = " << sag << " d = " << d << std::endl;
+#endif
+         //  Now as F77 Minuit - check taht sag is not zero
+         if (sag != 0) break;
+         if(trafo.Parameter(i).HasLimits()) {
+            if(d > 0.5) break;
+            d *= 10.;
+            if(d > 0.5) d = 0.51;
+            continue;
+         }
+         d *= 10.;
+      }
+
+      if (sag == 0) {
+         elem.failed = true;
+         return;
+      }
+
+      double g2bfor = elem.g2;
+      elem.g2 = 2.*sag/(d*d);
+      elem.grd = (fs1-fs2)/(2.*d);
+      elem.gst = d;
+      elem.dirin = d;
+      elem.yy = fs1;
+      double dlast = d;
+      d = sqrt(2.*aimsag/fabs(elem.g2));
+      if(trafo.Parameter(i).HasLimits()) d = std::min(0.5, d);
+      if(d < dmin) d = dmin;
+
+#ifdef DEBUG
+      std::cout << "\t g1 = " << elem.grd << " g2 = " << elem.g2 << " step = " << elem.gst << " d = " << d
+                << " diffd = " <<  fabs(d-dlast)/d << " diffg2 = " << fabs(elem.g2-g2bfor)/elem.g2 << std::endl;
+#endif
+
+
+      // see if converged
+      if(fabs((d-dlast)/d) < hesse.Tolerstp()) break;
+      if(fabs((elem.g2-g2bfor)/elem.g2) < hesse.TolerG2()) break;
+      d = std::min(d, 10.*dlast);
+      d = std::max(d, 0.1*dlast);
+   }
+}
+
+// task computing the diagonal elements in the multi-thread case
+class HessianDiagonalTask {
+
+public:
+
+   HessianDiagonalTask(const MnHesse& hesse, const MnFcn& mfcn, const MnUserTransformation& trafo,
+                       const MnAlgebraicVector& x0, double amin, double aimsag, std::vector<HessianDiagonal>& diag) :
+      fHesse(hesse), fFcn(mfcn), fTrafo(trafo), fX0(x0), fAmin(amin), fAimsag(aimsag), fDiag(diag) {}
+
+   void operator() (unsigned int i) const {
+      MnAlgebraicVector x = fX0;
+      ComputeHessianDiagonal(fHesse, fFcn, fTrafo, i, x, fAmin, fAimsag, fDiag[i], false);
+   }
+
+private:
+
+   const MnHesse& fHesse;
+   const MnFcn& fFcn;
+   const MnUserTransformation& fTrafo;
+   const MnAlgebraicVector& fX0;
+   double fAmin;
+   double fAimsag;
+   std::vector<HessianDiagonal>& fDiag;
+};
+
+// task computing the function values needed for the off-diagonal elements in the multi-thread case.
+// In the serial loop the components x(i) and x(j) are shifted by dirin and back for every element,
+// and (x + d) - d can differ from x in the last bit. To obtain the same result, the parameter
+// vector of each element is built from the values the components have after the same number
+// of shifts in the serial loop: xshift[m](k) is the component k after m shifts
+class HessianOffDiagonalTask {
+
+public:
+
+   HessianOffDiagonalTask(const MnFcn& mfcn, const std::vector<MnAlgebraicVector>& xshift, const MnAlgebraicVector& dirin,
+                          const std::vector<unsigned int>& irow, const std::vector<unsigned int>& icol,
+                          std::vector<double>& fval) :
+      fFcn(mfcn), fXShift(xshift), fDirin(dirin), fRow(irow), fCol(icol), fFval(fval) {}
+
+   void operator() (unsigned int in) const {
+      unsigned int i = fRow[in];
+      unsigned int j = fCol[in];
+      unsigned int n = fDirin.size();
+      MnAlgebraicVector x(n);
+      for (unsigned int k = 0; k < n; ++k) {
+         if (k < i)       x(k) = fXShift[k+1](k);
+         else if (k == i) x(k) = fXShift[i](k) + fDirin(k);
+         else if (k < j)  x(k) = fXShift[i+1](k);
+         else if (k == j) x(k) = fXShift[i](k) + fDirin(k);
+         else             x(k) = fXShift[i](k);
+      }
+      fFval[in] = fFcn.Eval(x);
+   }
+
+private:
+
+   const MnFcn& fFcn;
+   const std::vector<MnAlgebraicVector>& fXShift;
+   const MnAlgebraicVector& fDirin;
+   const std::vector<unsigned int>& fRow;
+   const std::vector<unsigned int>& fCol;
+   std::vector<double>& fFval;
+};
+
+}
+
 MnUserParameterState MnHesse::operator()(const FCNBase& fcn, const std::vector<double>& par, const std::vector<double>& err, unsigned int maxcalls) const {
    // interface from vector of params and errors
    return (*this)(fcn, MnUserParameterState(par, err), maxcalls);
@@ -127,45 +285,41 @@ MinimumState MnHesse::operator()(const MnFcn& mfcn, const MinimumState& st, cons
 #endif
 
 
-   for(unsigned int i = 0; i < n; i++) {
+   // the diagonal elements of the different parameters are independent: in the multi-thread case
+   // they are all computed first and then used in the same order as in the serial loop,
+   // which computes and uses one parameter at the time
+   bool useThreads = (fStrategy.NThreads() > 1 && n > 1);
 
-      double xtf = x(i);
-      double dmin = 8.*prec.Eps2()*(fabs(xtf) + prec.Eps2());
-      double d = fabs(gst(i));
-      if(d < dmin) d = dmin;
+   std::vector<HessianDiagonal> diag(n);
+   for(unsigned int i = 0; i < n; i++) {
+      diag[i].g2 = g2(i);
+      diag[i].grd = grd(i);
+      diag[i].gst = gst(i);
+      diag[i].dirin = dirin(i);
+      diag[i].yy = yy(i);
+      diag[i].ncalls = 0;
+      diag[i].failed = false;
+   }
 
-#ifdef DEBUG
-      std::cout << "\nDerivative parameter  " << i << " d = " << d << " dmin = " << dmin << std::endl;
-#endif
+   if (useThreads) {
+      HessianDiagonalTask task(*this, mfcn, trafo, x, amin, aimsag, diag);
+      MnParallelFor(n, fStrategy.NThreads(), task);
+   }
 
+   for(unsigned int i = 0; i < n; i++) {
 
-      for(unsigned int icyc = 0; icyc < Ncycles(); icyc++) {
-         double sag = 0.;
-         double fs1 = 0.;
-         double fs2 = 0.;
-         for(unsigned int multpy = 0; multpy < 5; multpy++) {
-            x(i) = xtf + d;
-            fs1 = mfcn(x);
-            x(i) = xtf - d;
-            fs2 = mfcn(x);
-            x(i) = xtf;
-            sag = 0.5*(fs1+fs2-2.*amin);
+      if (useThreads)
+         mfcn.AddCalls(diag[i].ncalls);
+      else
+         ComputeHessianDiagonal(*this, mfcn, trafo, i, x, amin, aimsag, diag[i], true);
 
-#ifdef DEBUG
-            std::cout << "cycle " << icyc << " mul " << multpy << "\t sag = " << sag << " d = " << d << std::endl;
-#endif
-            //  Now as F77 Minuit - check taht sag is not zero
-            if (sag != 0) goto L30; // break
-            if(trafo.Parameter(i).HasLimits()) {
-               if(d > 0.5) goto L26;
-               d *= 10.;
-               if(d > 0.5) d = 0.51;
-               continue;
-            }
-            d *= 10.;
-         }
+      g2(i) = diag[i].g2;
+      grd(i) = diag[i].grd;
+      gst(i) = diag[i].gst;
+      dirin(i) = diag[i].dirin;
+      yy(i) = diag[i].yy;
 
-L26:
+      if (diag[i].failed) {
 #ifdef WARNINGMSG
 
          // get parameter name for i
@@ -183,31 +337,8 @@ L26:
          }
 
          return MinimumState(st.Parameters(), MinimumError(vhmat, MinimumError::MnHesseFailed()), st.Gradient(), st.Edm(), mfcn.NumOfCalls());
-
-L30:
-            double g2bfor = g2(i);
-         g2(i) = 2.*sag/(d*d);
-         grd(i) = (fs1-fs2)/(2.*d);
-         gst(i) = d;
-         dirin(i) = d;
-         yy(i) = fs1;
-         double dlast = d;
-         d = sqrt(2.*aimsag/fabs(g2(i)));
-         if(trafo.Parameter(i).HasLimits()) d = std::min(0.5, d);
-         if(d < dmin) d = dmin;
-
-#ifdef DEBUG
-         std::cout << "\t g1 = " << grd(i) << " g2 = " << g2(i) << " step = " << gst(i) << " d = " << d
-                   << " diffd = " <<  fabs(d-dlast)/d << " diffg2 = " << fabs(g2(i)-g2bfor)/g2(i) << std::endl;
-#endif
-
-
-         // see if converged
-         if(fabs((d-dlast)/d) < Tolerstp()) break;
-         if(fabs((g2(i)-g2bfor)/g2(i)) < TolerG2()) break;
-         d = std::min(d, 10.*dlast);
-         d = std::max(d, 0.1*dlast);
       }
+
       vhmat(i,i) = g2(i);
       if(mfcn.NumOfCalls()  > maxcalls) {
 
@@ -241,6 +372,42 @@ L30:
    }
 
    //off-diagonal Elements
+   if (useThreads) {
+      unsigned int nelem = n*(n-1)/2;
+      std::vector<unsigned int> irow(nelem);
+      std::vector<unsigned int> icol(nelem);
+      unsigned int in = 0;
+      for (unsigned int i = 0; i < n; i++) {
+         for (unsigned int j = i+1; j < n; j++) {
+            irow[in] = i;
+            icol[in] = j;
+            in++;
+         }
+      }
+      std::vector<MnAlgebraicVector> xshift(n+1, x);
+      for (unsigned int m = 1; m <= n; m++) {
+         for (unsigned int k = 0; k < n; k++) {
+            double xk = xshift[m-1](k);
+            xk += dirin(k);
+            xk -= dirin(k);
+            xshift[m](k) = xk;
+         }
+      }
+
+      std::vector<double> fval(nelem);
+      HessianOffDiagonalTask task(mfcn, xshift, dirin, irow, icol, fval);
+      MnParallelFor(nelem, fStrategy.NThreads(), task);
+      mfcn.AddCalls(nelem);
+
+      for (in = 0; in < nelem; in++) {
+         unsigned int i = irow[in];
+         unsigned int j = icol[in];
+         double elem = (fval[in] + amin - yy(i) - yy(j))/(dirin(i)*dirin(j));
+         vhmat(i,j) = elem;
+      }
+   }
+   else {
+
    // initial starting values
    MPIProcess mpiprocOffDiagonal(n*(n-1)/2,0);
    unsigned int startParIndexOffDiagonal = mpiprocOffDiagonal.StartElementIndex();
@@ -275,6 +442,8 @@ L30:
 
    mpiprocOffDiagonal.SyncSymMatrixOffDiagonal(vhmat);
 
+   }
+
    //verify if matrix pos-def (still 2nd derivative)
 
 #ifdef DEBUG
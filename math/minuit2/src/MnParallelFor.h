@@ -0,0 +1,69 @@
+// @(#)root/minuit2:$Id$
+// Authors: M. Winkler, F. James, L. Moneta, A. Zsenei   2003-2005
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2005 LCG ROOT Math team,  CERN/PH-SFT                *
+ *                                                                    *
+ **********************************************************************/
+
+#ifndef ROOT_Minuit2_MnParallelFor
+#define ROOT_Minuit2_MnParallelFor
+
+// internal header (not installed) used by the numerical gradient and Hessian
+// calculators to distribute independent evaluations among threads
+
+#include <vector>
+#include <thread>
+#include <atomic>
+
+namespace ROOT {
+
+   namespace Minuit2 {
+
+/**
+   Helper class calling task(i) for all i in [0,n) using a given number of threads
+   (the calling thread included). The indices are given to the threads one at the time,
+   so the task must write only the results belonging to the index i it receives.
+ */
+template<class Task>
+class MnParallelLoop {
+
+public:
+
+   MnParallelLoop(const Task& task, unsigned int n) : fTask(task), fN(n), fNext(0) {}
+
+   void Run(unsigned int nthreads) {
+      if (nthreads > fN) nthreads = fN;
+      std::vector<std::thread> threads;
+      for (unsigned int ith = 1; ith < nthreads; ++ith)
+         threads.push_back(std::thread(&MnParallelLoop::Work, this) );
+      Work();
+      for (unsigned int ith = 0; ith < threads.size(); ++ith)
+         threads[ith].join();
+   }
+
+private:
+
+   void Work() {
+      for (unsigned int i = fNext++; i < fN; i = fNext++)
+         fTask(i);
+   }
+
+   const Task& fTask;
+   unsigned int fN;
+   std::atomic<unsigned int> fNext;
+};
+
+/// run task(i) for i = 0,...,n-1 on nthreads threads
+template<class Task>
+inline void MnParallelFor(unsigned int n, unsigned int nthreads, const Task& task) {
+   MnParallelLoop<Task> loop(task, n);
+   loop.Run(nthreads);
+}
+
+  }  // namespace Minuit2
+
+}  // namespace ROOT
+
+#endif  // ROOT_Minuit2_MnParallelFor
@@ -32,6 +32,7 @@
 #include <math.h>
 
 #include "Minuit2/MPIProcess.h"
+#include "MnParallelFor.h"
 
 namespace ROOT {
 
@@ -69,6 +70,113 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const std::vector<dou
 
 
 
+namespace {
+
+// compute the derivatives for the internal parameter i varying only the component x(i)
+// (which is restored before returning). Return the number of function calls performed.
+// When countCalls is false the calls are not recorded in the MnFcn counter, so the function
+// can be called concurrently for different parameters (each thread with its own copy of x)
+unsigned int ParameterGradient(const Numerical2PGradientCalculator & calc, unsigned int i, MnAlgebraicVector & x,
+                               double fcnmin, double dfmin, double vrysml, double eps2,
+                               double & grd, double & g2, double & gstep, bool countCalls) {
+
+   const MnFcn & fcn = calc.Fcn();
+   unsigned int ncycle = calc.Ncycle();
+   unsigned int ncalls = 0;
+
+   double xtf = x(i);
+   double epspri = eps2 + fabs(grd*eps2);
+   double stepb4 = 0.;
+   for(unsigned int j = 0; j < ncycle; j++)  {
+      double optstp = sqrt(dfmin/(fabs(g2)+epspri));
+      double step = std::max(optstp, fabs(0.1*gstep));
+      //       std::cout<<"step: "<<step;
+      if(calc.Trafo().Parameter(calc.Trafo().ExtOfInt(i)).HasLimits()) {
+         if(step > 0.5) step = 0.5;
+      }
+      double stpmax = 10.*fabs(gstep);
+      if(step > stpmax) step = stpmax;
+      //       std::cout<<" "<<step;
+      double stpmin = std::max(vrysml, 8.*fabs(eps2*x(i)));
+      if(step < stpmin) step = stpmin;
+      //       std::cout<<" "<<step<<std::endl;
+      //       std::cout<<"step: "<<step<<std::endl;
+      if(fabs((step-stepb4)/step) < calc.StepTolerance()) {
+         //    std::cout<<"(step-stepb4)/step"<<std::endl;
+         //    std::cout<<"j= "<<j<<std::endl;
+         //    std::cout<<"step= "<<step<<std::endl;
+         break;
+      }
+      gstep = step;
+      stepb4 = step;
+      //       MnAlgebraicVector pstep(n);
+      //       pstep(i) = step;
+      //       double fs1 = Fcn()(pstate + pstep);
+      //       double fs2 = Fcn()(pstate - pstep);
+
+      x(i) = xtf + step;
+      double fs1 = (countCalls) ? fcn(x) : fcn.Eval(x);
+      x(i) = xtf - step;
+      double fs2 = (countCalls) ? fcn(x) : fcn.Eval(x);
+      x(i) = xtf;
+      ncalls += 2;
+
+      double grdb4 = grd;
+      grd = 0.5*(fs1 - fs2)/step;
+      g2 = (fs1 + fs2 - 2.*fcnmin)/step/step;
+
+#ifdef DEBUG
+      int pr = std::cout.precision(13);
+      std::cout << "cycle " << j << " x " << x(i) << " step " << step << " f1 " << fs1 << " f2 " << fs2
+                << " grd " << grd << " g2 " << g2 << std::endl;
+      std::cout.precision(pr);
+#endif
+
+      if(fabs(grdb4-grd)/(fabs(grd)+dfmin/step) < calc.GradTolerance())  {
+         //    std::cout<<"j= "<<j<<std::endl;
+         //    std::cout<<"step= "<<step<<std::endl;
+         //    std::cout<<"fs1, fs2: "<<fs1<<" "<<fs2<<std::endl;
+         //    std::cout<<"fs1-fs2: "<<fs1-fs2<<std::endl;
+         break;
+      }
+   }
+   return ncalls;
+}
+
+// task for the multi-thread calculation of the gradient: each parameter is computed
+// independently, on its own copy of the parameter vector
+class ParameterGradientTask {
+
+public:
+
+   ParameterGradientTask(const Numerical2PGradientCalculator & calc, const MnAlgebraicVector & x0,
+                         double fcnmin, double dfmin, double vrysml, double eps2,
+                         MnAlgebraicVector & grd, MnAlgebraicVector & g2, MnAlgebraicVector & gstep,
+                         std::vector<unsigned int> & ncalls) :
+      fCalc(calc), fX0(x0), fFcnMin(fcnmin), fDfMin(dfmin), fVrySml(vrysml), fEps2(eps2),
+      fGrd(grd), fG2(g2), fGstep(gstep), fNCalls(ncalls) {}
+
+   void operator() (unsigned int i) const {
+      MnAlgebraicVector x = fX0;
+      fNCalls[i] = ParameterGradient(fCalc, i, x, fFcnMin, fDfMin, fVrySml, fEps2, fGrd(i), fG2(i), fGstep(i), false);
+   }
+
+private:
+
+   const Numerical2PGradientCalculator & fCalc;
+   const MnAlgebraicVector & fX0;
+   double fFcnMin;
+   double fDfMin;
+   double fVrySml;
+   double fEps2;
+   MnAlgebraicVector & fGrd;
+   MnAlgebraicVector & fG2;
+   MnAlgebraicVector & fGstep;
+   std::vector<unsigned int> & fNCalls;
+};
+
+}
+
 FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParameters& par, const FunctionGradient& Gradient) const {
    // calculate numerical gradient from MinimumParameters object
    // the algorithm takes correctly care when the gradient is approximatly zero
@@ -94,12 +202,24 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
    //    std::cout << " ncycle " << Ncycle() << std::endl;
 
    unsigned int n = (par.Vec()).size();
-   unsigned int ncycle = Ncycle();
    //   MnAlgebraicVector vgrd(n), vgrd2(n), vgstp(n);
    MnAlgebraicVector grd = Gradient.Grad();
    MnAlgebraicVector g2 = Gradient.G2();
    MnAlgebraicVector gstep = Gradient.Gstep();
 
+   if (Strategy().NThreads() > 1 && n > 1) {
+      // multi-thread calculation: the parameters are distributed among the threads.
+      // The derivatives of each parameter are computed exactly as in the serial loop, so the
+      // result does not depend on the number of threads. The function calls are added
+      // to the counter at the end, since the counter of MnFcn is not thread safe
+      std::vector<unsigned int> ncalls(n);
+      ParameterGradientTask task(*this, par.Vec(), fcnmin, dfmin, vrysml, eps2, grd, g2, gstep, ncalls);
+      MnParallelFor(n, Strategy().NThreads(), task);
+      for (unsigned int i = 0; i < n; ++i) Fcn().AddCalls(ncalls[i]);
+
+      return FunctionGradient(grd, g2, gstep);
+   }
+
 #ifndef _OPENMP
    MPIProcess mpiproc(n,0);
 #endif
@@ -142,62 +262,7 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
       MnAlgebraicVector x = par.Vec();
 #endif
 
-      double xtf = x(i);
-      double epspri = eps2 + fabs(grd(i)*eps2);
-      double stepb4 = 0.;
-      for(unsigned int j = 0; j < ncycle; j++)  {
-         double optstp = sqrt(dfmin/(fabs(g2(i))+epspri));
-         double step = std::max(optstp, fabs(0.1*gstep(i)));
-         //       std::cout<<"step: "<<step;
-         if(Trafo().Parameter(Trafo().ExtOfInt(i)).HasLimits()) {
-            if(step > 0.5) step = 0.5;
-         }
-         double stpmax = 10.*fabs(gstep(i));
-         if(step > stpmax) step = stpmax;
-         //       std::cout<<" "<<step;
-         double stpmin = std::max(vrysml, 8.*fabs(eps2*x(i)));
-         if(step < stpmin) step = stpmin;
-         //       std::cout<<" "<<step<<std::endl;
-         //       std::cout<<"step: "<<step<<std::endl;
-         if(fabs((step-stepb4)/step) < StepTolerance()) {
-            //    std::cout<<"(step-stepb4)/step"<<std::endl;
-            //    std::cout<<"j= "<<j<<std::endl;
-            //    std::cout<<"step= "<<step<<std::endl;
-            break;
-         }
-         gstep(i) = step;
-         stepb4 = step;
-         //       MnAlgebraicVector pstep(n);
-         //       pstep(i) = step;
-         //       double fs1 = Fcn()(pstate + pstep);
-         //       double fs2 = Fcn()(pstate - pstep);
-
-         x(i) = xtf + step;
-         double fs1 = Fcn()(x);
-         x(i) = xtf - step;
-         double fs2 = Fcn()(x);
-         x(i) = xtf;
-
-         double grdb4 = grd(i);
-         grd(i) = 0.5*(fs1 - fs2)/step;
-         g2(i) = (fs1 + fs2 - 2.*fcnmin)/step/step;
-
-#ifdef DEBUG
-         pr = std::cout.precision(13);
-         std::cout << "cycle " << j << " x " << x(i) << " step " << step << " f1 " << fs1 << " f2 " << fs2
-                   << " grd " << grd(i) << " g2 " << g2(i) << std::endl;
-         std::cout.precision(pr);
-#endif
-
-         if(fabs(grdb4-grd(i))/(fabs(grd(i))+dfmin/step) < GradTolerance())  {
-            //    std::cout<<"j= "<<j<<std::endl;
-            //    std::cout<<"step= "<<step<<std::endl;
-            //    std::cout<<"fs1, fs2: "<<fs1<<" "<<fs2<<std::endl;
-            //    std::cout<<"fs1-fs2: "<<fs1-fs2<<std::endl;
-            break;
-         }
-      }
-
+      ParameterGradient(*this, i, x, fcnmin, dfmin, vrysml, eps2, grd(i), g2(i), gstep(i), true);
 
 #ifdef DEBUG_MP
 #pragma omp critical
@@ -13,6 +13,8 @@
 #include "Minuit2/MnUserParameterState.h"
 #include "Minuit2/MnPrint.h"
 #include "Minuit2/MnMigrad.h"
+#include "Minuit2/MnHesse.h"
+#include "Minuit2/MnStrategy.h"
 #include "Minuit2/MnMinos.h"
 #include "Minuit2/MnPlot.h"
 #include "Minuit2/MinosError.h"
@@ -27,11 +29,15 @@
 // The default number of dimension is 20 (fit in 40 parameters) on 1000 data events.
 // One can change the dimension and the number of events by doing:
 // ./test_Minuit2_Parallel    ndim  nevents
+// The fit is then repeated computing the numerical gradient and Hessian with std::thread's
+// (MnStrategy::SetNThreads) and the result is checked to be identical to the serial one.
+// The number of threads can be given as third argument (default is 4)
 
 using namespace ROOT::Minuit2;
 
 const int default_ndim = 20;
 const int default_ndata = 1000;
+const int default_nthreads = 4;
 
 
 double GaussPdf(double x, double x0, double sigma) {
@@ -70,7 +76,7 @@ struct LogLikeFCN  : public FCNBase {
    const Data & fData;
 };
 
-int doFit(int ndim, int ndata) {
+int doFit(int ndim, int ndata, int nthreads) {
 
   // generate the data (1000 data points) in 100 dimension
 
@@ -116,6 +122,34 @@ int doFit(int ndim, int ndata) {
   // output
   std::cout<<"minimum: "<<min<<std::endl;
 
+  // repeat the minimization and the Hessian calculation using threads
+  // the FCN is thread safe, since it does not modify any data member
+  std::vector<FunctionMinimum> minima;
+  int nth[2] = { 1, nthreads };
+  for (int k = 0; k < 2; ++k) {
+     MnStrategy strategy(1);
+     strategy.SetNThreads(nth[k]);
+     MnMigrad migrad(fcn, MnUserParameterState(init_par, init_err), strategy);
+     minima.push_back( migrad() );
+     MnHesse hesse(strategy);
+     hesse(fcn, minima.back() );
+  }
+
+  const MnUserParameterState & st0 = minima.front().UserState();
+  const MnUserParameterState & st1 = minima.back().UserState();
+  std::cout << "minimization using " << nthreads << " threads: fval = " << minima.back().Fval()
+            << " ncalls = " << minima.back().NFcn() << std::endl;
+  bool identical = (minima.front().Fval() == minima.back().Fval() && minima.front().NFcn() == minima.back().NFcn() );
+  for (unsigned int i = 0; i < st0.Params().size(); ++i) {
+     identical &= (st0.Value(i) == st1.Value(i) && st0.Error(i) == st1.Error(i) );
+     for (unsigned int j = 0; j < st0.Params().size(); ++j)
+        identical &= (st0.Covariance()(i,j) == st1.Covariance()(i,j) );
+  }
+  if (!identical) {
+     std::cerr << "Error: result with " << nthreads << " threads differs from the serial one " << std::endl;
+     return 1;
+  }
+
 
 //     // create MINOS Error factory
 //     MnMinos Minos(fFCN, min);
@@ -153,6 +187,10 @@ int main(int argc, char **argv) {
    if (argc > 2) {
       ndata = atoi(argv[2] );
    }
+   int nthreads = default_nthreads;
+   if (argc > 3) {
+      nthreads = atoi(argv[3] );
+   }
    std::cout << "do fit of " << ndim << " dimensional data on " << ndata << " events " << std::endl;
-   doFit(ndim,ndata);
+   return doFit(ndim,ndata,nthreads);
 }
@@ -59,6 +59,21 @@ Double_t RooExponential::evaluate() const{
 }
 
 
+//_____________________________________________________________________________
+Bool_t RooExponential::evaluateBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& data) const
+{
+  // Calculate the values of evaluate() for a batch of events
+  std::vector<Double_t> xBuf, cBuf ;
+  const Double_t* xVal = x.arg().getValBatch(begin,nEvents,data,xBuf,x.nset()) ;
+  const Double_t* cVal = c.arg().getValBatch(begin,nEvents,data,cBuf,c.nset()) ;
+
+  for (Int_t i=0 ; i<nEvents ; i++) {
+    output[i] = exp(cVal[i]*xVal[i]) ;
+  }
+  return kTRUE ;
+}
+
+
 //_____________________________________________________________________________
 Int_t RooExponential::getAnalyticalIntegral(RooArgSet& allVars, RooArgSet& analVars, const char* /*rangeName*/) const 
 {
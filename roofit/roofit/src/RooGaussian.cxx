@@ -75,25 +75,24 @@ Double_t RooGaussian::evaluate() const
 
 
 //_____________________________________________________________________________
-Double_t RooGaussian::getLogVal(const RooArgSet* set) const 
+Bool_t RooGaussian::evaluateBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& data) const
 {
-  // calculate and return the negative log-likelihood of the Poisson                                                                                                                                    
-  return RooAbsPdf::getLogVal(set) ;
-//   Double_t prob = getVal(set) ;
-//   return log(prob) ;
-
-  Double_t arg= x - mean;  
-  Double_t sig = sigma ;
-  
-  //static const Double_t rootPiBy2 = sqrt(atan2(0.0,-1.0)/2.0);
-  //Double_t extra = -0.5*arg*arg/(sig*sig) - log(2*rootPiBy2*sig) ;
-  Double_t extra = -0.5*arg*arg/(sig*sig) - log(analyticalIntegral(1,0)) ;
-  
-  return extra ; 
-  
+  // Calculate the values of evaluate() for a batch of events
+  std::vector<Double_t> xBuf, meanBuf, sigmaBuf ;
+  const Double_t* xVal = x.arg().getValBatch(begin,nEvents,data,xBuf,x.nset()) ;
+  const Double_t* meanVal = mean.arg().getValBatch(begin,nEvents,data,meanBuf,mean.nset()) ;
+  const Double_t* sigmaVal = sigma.arg().getValBatch(begin,nEvents,data,sigmaBuf,sigma.nset()) ;
+
+  for (Int_t i=0 ; i<nEvents ; i++) {
+    Double_t arg= xVal[i] - meanVal[i] ;
+    Double_t sig = sigmaVal[i] ;
+    output[i] = exp(-0.5*arg*arg/(sig*sig)) ;
+  }
+  return kTRUE ;
 }
 
 
+
 //_____________________________________________________________________________
 Int_t RooGaussian::getAnalyticalIntegral(RooArgSet& allVars, RooArgSet& analVars, const char* /*rangeName*/) const 
 {
@@ -37,6 +37,7 @@
 #include "RooAbsReal.h"
 #include "RooRealVar.h"
 #include "RooArgList.h"
+#include "RooVectorDataStore.h"
 
 #include "TError.h"
 
@@ -146,6 +147,41 @@ Double_t RooPolynomial::evaluate() const
 
 
 
+//_____________________________________________________________________________
+Bool_t RooPolynomial::evaluateBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& data) const 
+{
+  // Calculate the values of evaluate() for a batch of events. The batch is
+  // evaluated event by event if the coefficients depend on the observables
+
+  RooAbsReal* coef ;
+  RooFIter coefIter = _coefList.fwdIterator() ;
+  while((coef=(RooAbsReal*)coefIter.next())) {
+    if (coef->dependsOnValue(*data.get())) return kFALSE ;
+  }
+
+  std::vector<Double_t> xBuf ;
+  const Double_t* xVal = _x.arg().getValBatch(begin,nEvents,data,xBuf,_x.nset()) ;
+
+  Int_t order(_lowestOrder) ;
+  for (Int_t i=0 ; i<nEvents ; i++) {
+    output[i] = (order<1 ? 0 : 1) ;
+  }
+
+  const RooArgSet* nset = _coefList.nset() ;
+  coefIter = _coefList.fwdIterator() ;
+  while((coef=(RooAbsReal*)coefIter.next())) {
+    Double_t coefVal = coef->getVal(nset) ;
+    for (Int_t i=0 ; i<nEvents ; i++) {
+      output[i] += coefVal*TMath::Power(xVal[i],order) ;
+    }
+    order++ ;
+  }
+
+  return kTRUE ;
+}
+
+
+
 //_____________________________________________________________________________
 Int_t RooPolynomial::getAnalyticalIntegral(RooArgSet& allVars, RooArgSet& analVars, const char* /*rangeName*/) const 
 {
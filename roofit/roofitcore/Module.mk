@@ -58,7 +58,7 @@ ROOFITCOREH2   := RooDouble.h RooEffGenContext.h RooEllipse.h RooErrorHandler.h
 
 ROOFITCOREH3   := RooRandomizeParamMCSModule.h RooRangeBinning.h RooRealAnalytic.h \
                   RooRealBinding.h RooRealConstant.h RooRealIntegral.h \
-                  RooRealMPFE.h RooRealProxy.h RooRealVar.h \
+                  RooRealMPFE.h RooRealMTFE.h RooRealProxy.h RooRealVar.h \
                   RooRealVarSharedProperties.h RooRefCountList.h RooScaledFunc.h \
                   RooSegmentedIntegrator1D.h RooSegmentedIntegrator2D.h \
                   RooSetPair.h RooSetProxy.h RooSharedProperties.h \
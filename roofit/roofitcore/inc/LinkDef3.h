@@ -13,6 +13,7 @@
 #pragma link C++ class RooRealConstant+ ;
 #pragma link C++ class RooRealIntegral+ ;
 #pragma link C++ class RooRealMPFE+ ;
+#pragma link C++ class RooRealMTFE+ ;
 #pragma link C++ class RooRealProxy+ ;
 #pragma link C++ class RooRealVar- ;
 #pragma link C++ class RooRealVarSharedProperties+ ;
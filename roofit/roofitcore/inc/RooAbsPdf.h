@@ -298,6 +298,8 @@ protected:
 
   virtual Bool_t syncNormalization(const RooArgSet* dset, Bool_t adjustProxies=kTRUE) const ;
 
+  virtual void computeBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& data, const RooArgSet* normSet) const ;
+
   friend class RooAbsAnaConvPdf ;
   mutable Double_t _rawValue ;
   mutable RooAbsReal* _norm   ;      //! Normalization integral (owned by _normMgr)
@@ -48,6 +48,7 @@ class TH3F;
 
 #include <list>
 #include <string>
+#include <vector>
 #include <iostream>
 
 class RooAbsReal : public RooAbsArg {
@@ -73,6 +74,9 @@ public:
 
   virtual Double_t getValV(const RooArgSet* set=0) const ;
 
+  const Double_t* getValBatch(Int_t begin, Int_t nEvents, const RooVectorDataStore& data, 
+			      std::vector<Double_t>& buffer, const RooArgSet* normSet=0) const ;
+
   Double_t getPropagatedError(const RooFitResult& fr) ;
 
   Bool_t operator==(Double_t value) const ;
@@ -371,6 +375,15 @@ protected:
   }
   virtual Double_t evaluate() const = 0 ;
 
+  // Batch evaluation over the columns of a RooVectorDataStore
+  virtual void computeBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& data, const RooArgSet* normSet) const ;
+  virtual Bool_t evaluateBatch(Double_t* /*output*/, Int_t /*begin*/, Int_t /*nEvents*/, const RooVectorDataStore& /*data*/) const { 
+    // Hook for derived classes to calculate the values of evaluate() for a batch of events
+    // in a single call. Return kFALSE if not implemented
+    return kFALSE ; 
+  }
+  void computeBatchScalar(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& data, const RooArgSet* normSet) const ;
+
   // Hooks for RooDataSet interface
   friend class RooRealIntegral ;
   friend class RooVectorDataStore ;
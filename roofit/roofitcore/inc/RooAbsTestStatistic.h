@@ -28,14 +28,17 @@ class RooAbsData ;
 class RooAbsReal ;
 class RooSimultaneous ;
 class RooRealMPFE ;
+class RooRealMTFE ;
 
 class RooAbsTestStatistic ;
 typedef RooAbsTestStatistic* pRooAbsTestStatistic ;
 typedef RooAbsData* pRooAbsData ;
 typedef RooRealMPFE* pRooRealMPFE ;
+typedef RooRealMTFE* pRooRealMTFE ;
 
 class RooAbsTestStatistic : public RooAbsReal {
     friend class RooRealMPFE;
+    friend class RooRealMTFE;
 public:
 
   // Constructors, assignment etc
@@ -64,6 +67,12 @@ public:
   virtual Double_t offset() const { return _offset ; }
   virtual Double_t offsetCarry() const { return _offsetCarry; }
 
+  void enableThreads(Bool_t flag) ;
+  Bool_t isThreaded() const { 
+    // Return true if parallel calculation uses threads rather than processes
+    return _mtMode ; 
+  }
+
 protected:
 
   virtual void printCompactTreeHook(std::ostream& os, const char* indent="") ;
@@ -122,6 +131,7 @@ protected:
   Bool_t initialize() ;
   void initSimMode(RooSimultaneous* pdf, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;    
   void initMPMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;
+  void initMTMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;
 
   mutable Bool_t _init ;          //! Is object initialized  
   GOFOpMode   _gofOpMode ;        // Operation mode of test statistic instance 
@@ -139,6 +149,8 @@ protected:
   // Parallel mode data
   Int_t          _nCPU ;      //  Number of processors to use in parallel calculation mode
   pRooRealMPFE*  _mpfeArray ; //! Array of parallel execution frond ends
+  Bool_t         _mtMode ;    //  Use threads rather than processes in parallel calculation mode
+  pRooRealMTFE*  _mtfeArray ; //! Array of multi-thread execution front ends
 
   RooFit::MPSplit        _mpinterl ; // Use interleaving strategy rather than N-wise split for partioning of dataset for multiprocessor-split
   Bool_t         _doOffset ; // Apply interval value offset to control numeric precision?
@@ -146,7 +158,7 @@ protected:
   mutable Double_t _offsetCarry; //! avoids loss of precision
   mutable Double_t _evalCarry; //! carry of Kahan sum in evaluatePartition
 
-  ClassDef(RooAbsTestStatistic,2) // Abstract base class for real-valued test statistics
+  ClassDef(RooAbsTestStatistic,3) // Abstract base class for real-valued test statistics
 
 };
 
@@ -137,6 +137,8 @@ RooCmdArg OwnLinked() ;
 RooCmdArg Extended(Bool_t flag=kTRUE) ;
 RooCmdArg DataError(Int_t) ;
 RooCmdArg NumCPU(Int_t nCPU, Int_t interleave=0) ;
+RooCmdArg UseThreads(Bool_t flag=kTRUE) ;
+RooCmdArg BatchMode(Bool_t flag=kTRUE) ;
 
 // RooAbsPdf::printLatex arguments
 RooCmdArg Columns(Int_t ncol) ;
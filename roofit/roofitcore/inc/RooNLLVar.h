@@ -27,7 +27,7 @@ class RooNLLVar : public RooAbsOptTestStatistic {
 public:
 
   // Constructors, assignment etc
-  RooNLLVar() { _first = kTRUE ; }
+  RooNLLVar() { _first = kTRUE ; _batchMode = kFALSE ; }
   RooNLLVar(const char *name, const char* title, RooAbsPdf& pdf, RooAbsData& data,
 	    const RooCmdArg& arg1=RooCmdArg::none(), const RooCmdArg& arg2=RooCmdArg::none(),const RooCmdArg& arg3=RooCmdArg::none(),
 	    const RooCmdArg& arg4=RooCmdArg::none(), const RooCmdArg& arg5=RooCmdArg::none(),const RooCmdArg& arg6=RooCmdArg::none(),
@@ -49,13 +49,21 @@ public:
   virtual RooAbsTestStatistic* create(const char *name, const char *title, RooAbsReal& pdf, RooAbsData& adata,
 				      const RooArgSet& projDeps, const char* rangeName, const char* addCoefRangeName=0, 
 				      Int_t nCPU=1, RooFit::MPSplit interleave=RooFit::BulkPartition, Bool_t verbose=kTRUE, Bool_t splitRange=kFALSE, Bool_t binnedL=kFALSE) {
-    return new RooNLLVar(name,title,(RooAbsPdf&)pdf,adata,projDeps,_extended,rangeName, addCoefRangeName, nCPU, interleave,verbose,splitRange,kFALSE,binnedL) ;
+    RooNLLVar* nll = new RooNLLVar(name,title,(RooAbsPdf&)pdf,adata,projDeps,_extended,rangeName, addCoefRangeName, nCPU, interleave,verbose,splitRange,kFALSE,binnedL) ;
+    nll->_batchMode = _batchMode ;
+    return nll ;
   }
   
   virtual ~RooNLLVar();
 
   void applyWeightSquared(Bool_t flag) ; 
 
+  void enableBatchMode(Bool_t flag) ;
+  Bool_t batchMode() const { 
+    // Return true if the p.d.f. is evaluated for batches of events
+    return _batchMode ; 
+  }
+
   virtual Double_t defaultErrorLevel() const { return 0.5 ; }
 
 protected:
@@ -67,6 +75,7 @@ protected:
   Bool_t _extended ;
   virtual Double_t evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t stepSize) const ;
   Bool_t _weightSq ; // Apply weights squared?
+  Bool_t _batchMode ; // Evaluate p.d.f. for batches of events?
   mutable Bool_t _first ; //!
   Double_t _offsetSaveW2; //!
   Double_t _offsetCarrySaveW2; //!
@@ -74,7 +83,7 @@ protected:
   mutable std::vector<Double_t> _binw ; //!
   mutable RooRealSumPdf* _binnedPdf ; //!
    
-  ClassDef(RooNLLVar,2) // Function representing (extended) -log(L) of p.d.f and dataset
+  ClassDef(RooNLLVar,3) // Function representing (extended) -log(L) of p.d.f and dataset
 };
 
 #endif
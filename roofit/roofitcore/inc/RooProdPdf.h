@@ -152,6 +152,9 @@ protected:
   Double_t calculate(const RooProdPdf::CacheElem& cache, Bool_t verbose=kFALSE) const ;
   Double_t calculate(const RooArgList* partIntList, const RooLinkedList* normSetList) const ;
 
+  virtual void computeBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& data, const RooArgSet* normSet) const ;
+  virtual Bool_t evaluateBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& data) const ;
+
  
   friend class RooProdGenContext ;
   virtual RooAbsGenContext* genContext(const RooArgSet &vars, const RooDataSet *prototype=0, 
@@ -0,0 +1,64 @@
+/*****************************************************************************
+ * Project: RooFit                                                           *
+ * Package: RooFitCore                                                       *
+ *    File: $Id$
+ * Authors:                                                                  *
+ *   WV, Wouter Verkerke, UC Santa Barbara, verkerke@slac.stanford.edu       *
+ *   DK, David Kirkby,    UC Irvine,         dkirkby@uci.edu                 *
+ *                                                                           *
+ * Copyright (c) 2000-2005, Regents of the University of California          *
+ *                          and Stanford University. All rights reserved.    *
+ *                                                                           *
+ * Redistribution and use in source and binary forms,                        *
+ * with or without modification, are permitted according to the terms        *
+ * listed in LICENSE (http://roofit.sourceforge.net/license.txt)             *
+ *****************************************************************************/
+#ifndef ROO_REAL_MTFE
+#define ROO_REAL_MTFE
+
+#include "RooAbsReal.h"
+#include "RooRealProxy.h"
+
+class RooArgSet ;
+class RooRealMTFEWorker ;
+
+class RooRealMTFE : public RooAbsReal {
+public:
+  // Constructors, assignment etc
+  RooRealMTFE(const char *name, const char *title, RooAbsReal& arg) ;
+  RooRealMTFE(const RooRealMTFE& other, const char* name=0);
+  virtual TObject* clone(const char* newname) const { return new RooRealMTFE(*this,newname); }
+  virtual ~RooRealMTFE();
+
+  void calculate() const ;
+  virtual Double_t getValV(const RooArgSet* nset=0) const ;
+  void standby() ;
+
+  void applyNLLWeightSquared(Bool_t flag) ;
+
+  void enableOffsetting(Bool_t flag) ;
+
+  static Bool_t threadsActive() ;
+
+  protected:
+
+  // Function evaluation
+  virtual Double_t evaluate() const ;
+  friend class RooAbsTestStatistic ;
+  friend class RooRealMTFEWorker ;
+  virtual void constOptimizeTestStatistic(ConstOpCode opcode, Bool_t doAlsoTracking=kTRUE) ;
+  virtual Double_t getCarry() const;
+
+  void calculateInline() const ;
+
+  RooRealProxy _arg ; // Function to calculate in worker thread
+  mutable Bool_t _calcInProgress ; //! Calculation dispatched to worker thread and not yet retrieved
+  mutable Bool_t _calcInline ; //! Perform next calculation synchronously in calling thread
+  mutable Double_t _evalCarry; //!
+
+  mutable RooRealMTFEWorker* _worker ; //! Worker thread
+
+  ClassDef(RooRealMTFE,1) // Multi-thread front-end for parallel calculation of a real valued function
+};
+
+#endif
@@ -67,6 +67,8 @@ public:
   static Bool_t getFloorGlobal() { return _doFloorGlobal ; }
 
 protected:
+
+  virtual Bool_t evaluateBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& data) const ;
   
   class CacheElem : public RooAbsCacheElement {
   public:
@@ -107,6 +107,10 @@ public:
 
   const RooVectorDataStore* cache() const { return _cache ; }
 
+  // Column access for batch evaluation
+  const Double_t* realColumn(const RooAbsReal& real) const ;
+  const Double_t* weightArray() const ;
+
   void loadValues(const RooAbsDataStore *tds, const RooFormulaVar* select=0, const char* rangeName=0, Int_t nStart=0, Int_t nStop=2000000000) ;
   
   void dump() ;
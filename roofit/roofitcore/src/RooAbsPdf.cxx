@@ -152,6 +152,7 @@
 #include "RooChi2Var.h"
 #include "RooMinimizer.h"
 #include "RooRealIntegral.h"
+#include "RooVectorDataStore.h"
 #include "Math/CholeskyDecomp.h"
 #include <string>
 
@@ -303,6 +304,63 @@ Double_t RooAbsPdf::getValV(const RooArgSet* nset) const
 
 
 
+//_____________________________________________________________________________
+void RooAbsPdf::computeBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& data, const RooArgSet* normSet) const
+{
+  // Calculate the values of this p.d.f. for a batch of events of 'data', normalized
+  // over the observables in 'normSet'. The unnormalized values calculated by evaluateBatch()
+  // are divided by the normalization integral, which is evaluated once for the batch.
+  //
+  // The events are evaluated one by one with getVal() if the normalization integral
+  // depends on the event (conditional observables), if the class does not implement
+  // evaluateBatch(), or if any value of the batch is negative or not-a-number or the
+  // normalization is not positive, so that these are handled and reported exactly as
+  // in getVal()
+
+  Bool_t ok ;
+  Double_t normVal(1) ;
+
+  if (normSet) {
+
+    if (normSet!=_normSet || _norm==0) {
+      syncNormalization(normSet) ;
+    }
+    if (_norm->dependsOnValue(*data.get())) {
+      computeBatchScalar(output,begin,nEvents,data,normSet) ;
+      return ;
+    }
+    ok = evaluateBatch(output,begin,nEvents,data) ;
+    if (ok) normVal = _norm->getVal() ;
+
+  } else {
+
+    // Special handling of case without normalization set, as in getValV()
+    RooArgSet* tmp = _normSet ;
+    _normSet = 0 ;
+    ok = evaluateBatch(output,begin,nEvents,data) ;
+    _normSet = tmp ;
+
+  }
+
+  if (ok && !(normVal>0)) ok = kFALSE ;
+  for (Int_t i=0 ; ok && i<nEvents ; i++) {
+    if (!(output[i]>=0)) ok = kFALSE ;
+  }
+
+  if (!ok) {
+    computeBatchScalar(output,begin,nEvents,data,normSet) ;
+    return ;
+  }
+
+  if (normSet) {
+    for (Int_t i=0 ; i<nEvents ; i++) {
+      output[i] /= normVal ;
+    }
+  }
+}
+
+
+
 //_____________________________________________________________________________
 Double_t RooAbsPdf::analyticalIntegralWN(Int_t code, const RooArgSet* normSet, const char* rangeName) const
 {
@@ -729,6 +787,13 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooCmdArg& arg1, const
   //                                    Strategy 3 = RooFit::Hybrid --> Follow strategy 0 for all RooSimultaneous components, except those with less than
   //                                                 30 dataset entries, for which strategy 2 is followed.
   //
+  // UseThreads(Bool_t flag)         -- Calculate the NumCPU() partitions in threads of the current process instead of in forked
+  //                                    processes. Each thread evaluates its own clone of the p.d.f. and the dataset, which must
+  //                                    therefore be safe to evaluate concurrently
+  //
+  // BatchMode(Bool_t flag)          -- Evaluate the p.d.f. for batches of events on the columns of the dataset rather than
+  //                                    event by event. Applies to unbinned datasets with the default (vector) storage
+  //
   // Optimize(Bool_t flag)           -- Activate constant term optimization (on by default)
   // SplitRange(Bool_t flag)         -- Use separate fit ranges in a simultaneous fit. Actual range name for each
   //                                    subsample is assumed to by rangeName_{indexState} where indexState
@@ -781,6 +846,8 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
   pc.defineInt("ext","Extended",0,2) ;
   pc.defineInt("numcpu","NumCPU",0,1) ;
   pc.defineInt("interleave","NumCPU",1,0) ;
+  pc.defineInt("useThreads","UseThreads",0,0) ;
+  pc.defineInt("batchMode","BatchMode",0,0) ;
   pc.defineInt("verbose","Verbose",0,0) ;
   pc.defineInt("optConst","Optimize",0,0) ;
   pc.defineInt("cloneData","CloneData",2,0) ;
@@ -807,6 +874,8 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
   Int_t ext      = pc.getInt("ext") ;
   Int_t numcpu   = pc.getInt("numcpu") ;
   RooFit::MPSplit interl = (RooFit::MPSplit) pc.getInt("interleave") ;
+  Bool_t useThreads = pc.getInt("useThreads") ;
+  Bool_t batchMode = pc.getInt("batchMode") ;
 
   Int_t splitr   = pc.getInt("splitRange") ;
   Bool_t verbose = pc.getInt("verbose") ;
@@ -891,7 +960,10 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
     // Simple case: default range, or single restricted range
     //cout<<"FK: Data test 1: "<<data.sumEntries()<<endl;
 
-    nll = new RooNLLVar(baseName.c_str(),"-log(likelihood)",*this,data,projDeps,ext,rangeName,addCoefRangeName,numcpu,interl,verbose,splitr,cloneData) ;
+    RooNLLVar* nllVar = new RooNLLVar(baseName.c_str(),"-log(likelihood)",*this,data,projDeps,ext,rangeName,addCoefRangeName,numcpu,interl,verbose,splitr,cloneData) ;
+    if (useThreads) nllVar->enableThreads(kTRUE) ;
+    if (batchMode) nllVar->enableBatchMode(kTRUE) ;
+    nll = nllVar ;
 
   } else {
     // Composite case: multiple ranges
@@ -901,7 +973,9 @@ RooAbsReal* RooAbsPdf::createNLL(RooAbsData& data, const RooLinkedList& cmdList)
     strlcpy(buf,rangeName,bufSize) ;
     char* token = strtok(buf,",") ;
     while(token) {
-      RooAbsReal* nllComp = new RooNLLVar(Form("%s_%s",baseName.c_str(),token),"-log(likelihood)",*this,data,projDeps,ext,token,addCoefRangeName,numcpu,interl,verbose,splitr,cloneData) ;
+      RooNLLVar* nllComp = new RooNLLVar(Form("%s_%s",baseName.c_str(),token),"-log(likelihood)",*this,data,projDeps,ext,token,addCoefRangeName,numcpu,interl,verbose,splitr,cloneData) ;
+      if (useThreads) nllComp->enableThreads(kTRUE) ;
+      if (batchMode) nllComp->enableBatchMode(kTRUE) ;
       nllList.add(*nllComp) ;
       token = strtok(0,",") ;
     }
@@ -992,6 +1066,13 @@ RooFitResult* RooAbsPdf::fitTo(RooAbsData& data, const RooCmdArg& arg1, const Ro
   //                                    Strategy 3 = RooFit::Hybrid --> Follow strategy 0 for all RooSimultaneous components, except those with less than
   //                                                 30 dataset entries, for which strategy 2 is followed.
   //
+  // UseThreads(Bool_t flag)         -- Calculate the NumCPU() partitions in threads of the current process instead of in forked
+  //                                    processes. Each thread evaluates its own clone of the p.d.f. and the dataset, which must
+  //                                    therefore be safe to evaluate concurrently
+  //
+  // BatchMode(Bool_t flag)          -- Evaluate the p.d.f. for batches of events on the columns of the dataset rather than
+  //                                    event by event. Applies to unbinned datasets with the default (vector) storage
+  //
   // SplitRange(Bool_t flag)         -- Use separate fit ranges in a simultaneous fit. Actual range name for each
   //                                    subsample is assumed to by rangeName_{indexState} where indexState
   //                                    is the state of the master index category of the simultaneous fit
@@ -1075,7 +1156,7 @@ RooFitResult* RooAbsPdf::fitTo(RooAbsData& data, const RooLinkedList& cmdList)
   RooCmdConfig pc(Form("RooAbsPdf::fitTo(%s)",GetName())) ;
 
   RooLinkedList fitCmdList(cmdList) ;
-  RooLinkedList nllCmdList = pc.filterCmdList(fitCmdList,"ProjectedObservables,Extended,Range,RangeWithName,SumCoefRange,NumCPU,SplitRange,Constrained,Constrain,ExternalConstraints,CloneData,GlobalObservables,GlobalObservablesTag,OffsetLikelihood") ;
+  RooLinkedList nllCmdList = pc.filterCmdList(fitCmdList,"ProjectedObservables,Extended,Range,RangeWithName,SumCoefRange,NumCPU,UseThreads,BatchMode,SplitRange,Constrained,Constrain,ExternalConstraints,CloneData,GlobalObservables,GlobalObservablesTag,OffsetLikelihood") ;
 
   pc.defineString("fitOpt","FitOptions",0,"") ;
   pc.defineInt("optConst","Optimize",0,2) ;
@@ -1447,7 +1528,7 @@ RooFitResult* RooAbsPdf::chi2FitTo(RooDataHist& data, const RooLinkedList& cmdLi
 
   // Pull arguments to be passed to chi2 construction from list
   RooLinkedList fitCmdList(cmdList) ;
-  RooLinkedList chi2CmdList = pc.filterCmdList(fitCmdList,"Range,RangeWithName,NumCPU,Optimize,ProjectedObservables,AddCoefRange,SplitRange,DataError") ;
+  RooLinkedList chi2CmdList = pc.filterCmdList(fitCmdList,"Range,RangeWithName,NumCPU,UseThreads,Optimize,ProjectedObservables,AddCoefRange,SplitRange,DataError") ;
 
   RooAbsReal* chi2 = createChi2(data,chi2CmdList) ;
   RooFitResult* ret = chi2FitDriver(*chi2,fitCmdList) ;
@@ -1475,6 +1556,7 @@ RooAbsReal* RooAbsPdf::createChi2(RooDataHist& data, const RooCmdArg& arg1,  con
   //  DataError()  -- Choose between Expected error [RooAbsData::Expected] , or Observed error (e.g. Sum-of-weights [RooAbsData:SumW2] or Poisson interval [RooAbsData::Poisson] ) 
   //                  Default is AUTO : Expected error for unweighted data, Sum-of-weights for weighted data
   //  NumCPU()     -- Activate parallel processing feature
+  //  UseThreads() -- Calculate NumCPU() partitions in threads rather than in processes
   //  Range()      -- Fit only selected region
   //  SumCoefRange() -- Set the range in which to interpret the coefficients of RooAddPdf components 
   //  SplitRange() -- Fit range is split by index catory of simultaneous PDF
@@ -98,6 +98,8 @@
 #include "TVector.h"
 
 #include <sstream>
+#include <algorithm>
+#include <mutex>
 
 using namespace std ;
  
@@ -115,6 +117,9 @@ RooAbsReal::ErrorLoggingMode RooAbsReal::_evalErrorMode = RooAbsReal::PrintError
 Int_t RooAbsReal::_evalErrorCount = 0 ;
 map<const RooAbsArg*,pair<string,list<RooAbsReal::EvalError> > > RooAbsReal::_evalErrorList ;
 
+// Serializes error logging of test statistic partitions evaluated in concurrent threads
+static recursive_mutex _evalErrorMutex ;
+
 
 //_____________________________________________________________________________
 RooAbsReal::RooAbsReal() : _specIntegratorConfig(0), _treeVar(kFALSE), _selectComp(kTRUE), _lastNSet(0)
@@ -254,6 +259,70 @@ Double_t RooAbsReal::getValV(const RooArgSet* nset) const
 }
 
 
+
+//_____________________________________________________________________________
+const Double_t* RooAbsReal::getValBatch(Int_t begin, Int_t nEvents, const RooVectorDataStore& data, 
+					std::vector<Double_t>& buffer, const RooArgSet* normSet) const
+{
+  // Return the values of this object for the 'nEvents' events of 'data' starting at
+  // event 'begin', with the same meaning of 'normSet' as in getVal(). The returned
+  // array points directly to the stored values if 'data' holds a column for this object
+  // (observables and functions cached by the constant term optimizer), otherwise it
+  // points to the contents of 'buffer', which is resized as needed. 
+  //
+  // Objects that do not depend on the observables of 'data' are evaluated once.
+  // Classes implementing evaluateBatch() calculate all values in a single call,
+  // all other objects are evaluated event by event by loading each event
+  // of 'data' and calling getVal()
+
+  if (nEvents<=0) return 0 ;
+
+  const Double_t* column = data.realColumn(*this) ;
+  if (column) return column + begin ;
+
+  buffer.resize(nEvents) ;
+  if (!dependsOnValue(*data.get())) {
+    std::fill(buffer.begin(),buffer.end(),getVal(normSet)) ;
+  } else {
+    computeBatch(&buffer[0],begin,nEvents,data,normSet) ;
+  }
+  return &buffer[0] ;
+}
+
+
+
+//_____________________________________________________________________________
+void RooAbsReal::computeBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& data, const RooArgSet* normSet) const
+{
+  // Calculate the values of this object for a batch of events of 'data' with evaluateBatch(),
+  // or event by event if the class does not implement it. Unlike getVal(), the values
+  // calculated by evaluateBatch() are not traced
+
+  if (normSet && normSet!=_lastNSet) {
+    ((RooAbsReal*) this)->setProxyNormSet(normSet) ;    
+    _lastNSet = (RooArgSet*) normSet ;
+  }
+
+  if (!evaluateBatch(output,begin,nEvents,data)) {
+    computeBatchScalar(output,begin,nEvents,data,normSet) ;
+  }
+}
+
+
+
+//_____________________________________________________________________________
+void RooAbsReal::computeBatchScalar(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& data, const RooArgSet* normSet) const
+{
+  // Calculate the values of this object for a batch of events of 'data'
+  // by loading the events one by one and calling getVal()
+
+  for (Int_t i=0 ; i<nEvents ; i++) {
+    data.get(begin+i) ;
+    output[i] = getVal(normSet) ;
+  }
+}
+
+
 //_____________________________________________________________________________
 Int_t RooAbsReal::numEvalErrorItems() 
 { 
@@ -3367,6 +3436,8 @@ void RooAbsReal::logEvalError(const RooAbsReal* originator, const char* origName
     return ;
   }
 
+  lock_guard<recursive_mutex> lock(_evalErrorMutex) ;
+
   if (_evalErrorMode==CountErrors) {
     _evalErrorCount++ ;
     return ;
@@ -3422,6 +3493,8 @@ void RooAbsReal::logEvalError(const char* message, const char* serverValueString
     return ;
   }
 
+  lock_guard<recursive_mutex> lock(_evalErrorMutex) ;
+
   if (_evalErrorMode==CountErrors) {
     _evalErrorCount++ ;
     return ;
@@ -4017,6 +4090,7 @@ RooFitResult* RooAbsReal::chi2FitTo(RooDataHist& data, const RooCmdArg& arg1,  c
   // Range(Double_t lo, Double_t hi) -- Fit only data inside given range. A range named "fit" is created on the fly on all observables.
   //                                    Multiple comma separated range names can be specified.
   // NumCPU(int num)                 -- Parallelize NLL calculation on num CPUs
+  // UseThreads(Bool_t flag)         -- Calculate the NumCPU() partitions in threads rather than in processes
   // Optimize(Bool_t flag)           -- Activate constant term optimization (on by default)
   //
   // Options to control flow of fit procedure
@@ -4064,7 +4138,7 @@ RooFitResult* RooAbsReal::chi2FitTo(RooDataHist& data, const RooLinkedList& cmdL
 
   // Pull arguments to be passed to chi2 construction from list
   RooLinkedList fitCmdList(cmdList) ;
-  RooLinkedList chi2CmdList = pc.filterCmdList(fitCmdList,"Range,RangeWithName,NumCPU,Optimize") ;
+  RooLinkedList chi2CmdList = pc.filterCmdList(fitCmdList,"Range,RangeWithName,NumCPU,UseThreads,Optimize") ;
 
   RooAbsReal* chi2 = createChi2(data,chi2CmdList) ;
   RooFitResult* ret = chi2FitDriver(*chi2,fitCmdList) ;
@@ -4090,6 +4164,7 @@ RooAbsReal* RooAbsReal::createChi2(RooDataHist& data, const RooCmdArg& arg1,  co
   //  ------------------------------------------
   //  DataError(RooAbsData::ErrorType)  -- Choose between Poisson errors and Sum-of-weights errors
   //  NumCPU(Int_t)                     -- Activate parallel processing feature on N processes
+  //  UseThreads(Bool_t)                -- Use N threads instead of N processes for NumCPU()
   //  Range()                           -- Calculate Chi2 only in selected region
 
   string name = Form("chi2_%s_%s",GetName(),data.GetName()) ;
@@ -29,7 +29,9 @@
 // organizes multi-processor parallel calculation of test statistic
 // values. For the latter, the test statistic value is calculated in
 // partitions in parallel executing processes and a posteriori
-// combined in the main thread.
+// combined in the main thread. With enableThreads() the partitions
+// are instead calculated by worker threads of the current process, see
+// RooRealMTFE.
 // END_HTML
 //
 
@@ -45,6 +47,7 @@
 #include "RooRealVar.h"
 #include "RooNLLVar.h"
 #include "RooRealMPFE.h"
+#include "RooRealMTFE.h"
 #include "RooErrorHandler.h"
 #include "RooMsgService.h"
 #include "TTimeStamp.h"
@@ -64,7 +67,7 @@ RooAbsTestStatistic::RooAbsTestStatistic() :
   _func(0), _data(0), _projDeps(0), _splitRange(0), _simCount(0),
   _verbose(kFALSE), _init(kFALSE), _gofOpMode(Slave), _nEvents(0), _setNum(0),
   _numSets(0), _extSet(0), _nGof(0), _gofArray(0), _nCPU(1), _mpfeArray(0),
-  _mpinterl(RooFit::BulkPartition), _doOffset(kFALSE), _offset(0),
+  _mtMode(kFALSE), _mtfeArray(0), _mpinterl(RooFit::BulkPartition), _doOffset(kFALSE), _offset(0),
   _offsetCarry(0), _evalCarry(0)
 {
       // Default constructor
@@ -90,6 +93,8 @@ RooAbsTestStatistic::RooAbsTestStatistic(const char *name, const char *title, Ro
   _gofArray(0),
   _nCPU(nCPU),
   _mpfeArray(0),
+  _mtMode(kFALSE),
+  _mtfeArray(0),
   _mpinterl(interleave),
   _doOffset(kFALSE),
   _offset(0),
@@ -106,6 +111,8 @@ RooAbsTestStatistic::RooAbsTestStatistic(const char *name, const char *title, Ro
   // in each processing block many vary greatly thereby distributing the workload rather unevenly.
   // If interleave is set to true, the interleave partitioning strategy is used where each partition
   // i takes all bins for which (ibin % ncpu == i) which is more likely to result in an even workload.
+  // The partitions are calculated in threads rather than in processes if enableThreads() is called
+  // before the first evaluation.
   // If splitCutRange is true, a different rangeName constructed as rangeName_{catName} will be used
   // as range definition for each index state of a RooSimultaneous
 
@@ -160,6 +167,8 @@ RooAbsTestStatistic::RooAbsTestStatistic(const RooAbsTestStatistic& other, const
   _gofSplitMode(other._gofSplitMode),
   _nCPU(other._nCPU),
   _mpfeArray(0),
+  _mtMode(other._mtMode),
+  _mtfeArray(0),
   _mpinterl(other._mpinterl),
   _doOffset(other._doOffset),
   _offset(other._offset),
@@ -208,8 +217,13 @@ RooAbsTestStatistic::~RooAbsTestStatistic()
   // Destructor
 
   if (MPMaster == _gofOpMode && _init) {
-    for (Int_t i = 0; i < _nCPU; ++i) delete _mpfeArray[i];
-    delete[] _mpfeArray ;
+    if (_mtMode) {
+      for (Int_t i = 0; i < _nCPU; ++i) delete _mtfeArray[i];
+      delete[] _mtfeArray ;
+    } else {
+      for (Int_t i = 0; i < _nCPU; ++i) delete _mpfeArray[i];
+      delete[] _mpfeArray ;
+    }
   }
 
   if (SimMaster == _gofOpMode && _init) {
@@ -230,7 +244,7 @@ Double_t RooAbsTestStatistic::evaluate() const
   // is calculated from on a RooSimultaneous, the test statistic calculation
   // is performed separately on each simultaneous p.d.f component and associated
   // data and then combined. If the test statistic calculation is parallelized
-  // partitions are calculated in nCPU processes and a posteriori combined.
+  // partitions are calculated in nCPU processes (or threads) and a posteriori combined.
 
   // One-time Initialization
   if (!_init) {
@@ -268,6 +282,26 @@ Double_t RooAbsTestStatistic::evaluate() const
 
     return ret ;
 
+  } else if (MPMaster == _gofOpMode && _mtMode) {
+
+    // Start calculations in parallel threads
+    for (Int_t i = 0; i < _nCPU; ++i) _mtfeArray[i]->calculate();
+
+    // Combine partitions in fixed order so that the result does not depend on thread timing
+    Double_t sum(0), carry = 0.;
+    for (Int_t i = 0; i < _nCPU; ++i) {
+      Double_t y = _mtfeArray[i]->getValV();
+      carry += _mtfeArray[i]->getCarry();
+      y -= carry;
+      const Double_t t = sum + y;
+      carry = (t - sum) - y;
+      sum = t;
+    }
+
+    Double_t ret = sum ;
+    _evalCarry = carry;
+    return ret ;
+
   } else if (MPMaster == _gofOpMode) {
     
     // Start calculations in parallel
@@ -341,7 +375,9 @@ Bool_t RooAbsTestStatistic::initialize()
   
   if (_init) return kFALSE;
   
-  if (MPMaster == _gofOpMode) {
+  if (MPMaster == _gofOpMode && _mtMode) {
+    initMTMode(_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
+  } else if (MPMaster == _gofOpMode) {
     initMPMode(_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
   } else if (SimMaster == _gofOpMode) {
     initSimMode((RooSimultaneous*)_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
@@ -363,6 +399,13 @@ Bool_t RooAbsTestStatistic::redirectServersHook(const RooAbsCollection& newServe
 	_gofArray[i]->recursiveRedirectServers(newServerList,mustReplaceAll,nameChange);
       }
     }
+  } else if (MPMaster == _gofOpMode && _mtfeArray) {
+    // Forward to thread front ends
+    for (Int_t i = 0; i < _nCPU; ++i) {
+      if (_mtfeArray[i]) {
+	_mtfeArray[i]->recursiveRedirectServers(newServerList,mustReplaceAll,nameChange);
+      }
+    }
   } else if (MPMaster == _gofOpMode&& _mpfeArray) {
     // Forward to slaves
     for (Int_t i = 0; i < _nCPU; ++i) {
@@ -415,6 +458,10 @@ void RooAbsTestStatistic::constOptimizeTestStatistic(ConstOpCode opcode, Bool_t
 	if (_gofArray[i]) _gofArray[i]->constOptimizeTestStatistic(opcode,doAlsoTrackingOpt);
       }
     }
+  } else if (MPMaster == _gofOpMode && _mtMode) {
+    for (Int_t i = 0; i < _nCPU; ++i) {
+      _mtfeArray[i]->constOptimizeTestStatistic(opcode,doAlsoTrackingOpt);
+    }
   } else if (MPMaster == _gofOpMode) {
     for (Int_t i = 0; i < _nCPU; ++i) {
       _mpfeArray[i]->constOptimizeTestStatistic(opcode,doAlsoTrackingOpt);
@@ -475,6 +522,31 @@ void RooAbsTestStatistic::initMPMode(RooAbsReal* real, RooAbsData* data, const R
 
 
 
+//_____________________________________________________________________________
+void RooAbsTestStatistic::initMTMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName)
+{
+  // Initialize multi-thread calculation mode. Create for each partition a component test
+  // statistic with its own clone of the function and the dataset and connect it to this
+  // object through a RooRealMTFE front-end class, which calculates it in a worker thread.
+  // All component test statistics share the parameter objects of this test statistic.
+
+  _mtfeArray = new pRooRealMTFE[_nCPU];
+
+  for (Int_t i = 0; i < _nCPU; ++i) {
+    RooAbsTestStatistic* gof = create(Form("%s_GOF%d",GetName(),i),Form("%s_GOF%d",GetTitle(),i),*real,*data,*projDeps,rangeName,addCoefRangeName,1,_mpinterl,_verbose,_splitRange);
+    gof->recursiveRedirectServers(_paramSet);
+    gof->setMPSet(i,_nCPU);
+
+    ccoutD(Eval) << "RooAbsTestStatistic::initMTMode: creating thread front end #" << i << endl;
+    _mtfeArray[i] = new RooRealMTFE(Form("%s_%lx_MTFE%d",GetName(),(ULong_t)this,i),Form("%s_%lx_MTFE%d",GetTitle(),(ULong_t)this,i),*gof);
+    _mtfeArray[i]->addOwnedComponents(*gof);
+  }
+  coutI(Eval) << "RooAbsTestStatistic::initMTMode: created " << _nCPU << " calculation threads." << endl;
+  return ;
+}
+
+
+
 //_____________________________________________________________________________
 void RooAbsTestStatistic::initSimMode(RooSimultaneous* simpdf, RooAbsData* data,
 				      const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName)
@@ -685,12 +757,46 @@ void RooAbsTestStatistic::enableOffsetting(Bool_t flag)
   case MPMaster:    
     _doOffset = flag;
     for (Int_t i = 0; i < _nCPU; ++i) {
-      _mpfeArray[i]->enableOffsetting(flag);
+      if (_mtMode) {
+	_mtfeArray[i]->enableOffsetting(flag);
+      } else {
+	_mpfeArray[i]->enableOffsetting(flag);
+      }
     }
     break;
   }
 }
 
 
+//_____________________________________________________________________________
+void RooAbsTestStatistic::enableThreads(Bool_t flag)
+{
+  // Calculate the partitions of a parallelized test statistic (nCPU>1) in threads
+  // of the current process rather than in forked processes. Each thread evaluates
+  // its own clone of the function and of the dataset, only the parameters are
+  // shared with this object. All objects in the function expression must
+  // therefore be safe to evaluate concurrently on separate clones.
+  // The classes known to be safe are RooRealVar, RooConstVar, RooFormulaVar,
+  // RooPolyVar, RooGaussian, RooExponential, RooPolynomial, RooChebychev,
+  // RooAddPdf, RooProdPdf and RooRealSumPdf, whose evaluation only reads
+  // their servers (stressRooFit tests a model of Gaussians and polynomials). The
+  // clones of RooHistPdf and RooHistFunc share their RooDataHist, whose
+  // lookups are not thread safe: use the forked mode for these.
+  // This must be called before the test statistic is first evaluated or optimized.
+
+  if (_init) {
+    coutE(Eval) << "RooAbsTestStatistic::enableThreads(" << GetName() 
+		<< ") ERROR: calculation mode cannot be changed after initialization" << endl ;
+    return ;
+  }
+  if (flag && MPMaster != _gofOpMode) {
+    coutW(Eval) << "RooAbsTestStatistic::enableThreads(" << GetName() 
+		<< ") WARNING: test statistic is not parallelized (nCPU=1), no threads will be used" << endl ;
+  }
+  _mtMode = flag ;
+}
+
+
+
 Double_t RooAbsTestStatistic::getCarry() const
 { return _evalCarry; }
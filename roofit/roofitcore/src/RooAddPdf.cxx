@@ -65,6 +65,7 @@
 #include "RooRecursiveFraction.h"
 #include "RooGlobalFunc.h"
 #include "RooRealIntegral.h"
+#include "RooVectorDataStore.h"
 
 #include "Riostream.h"
 #include <algorithm>
@@ -843,6 +844,67 @@ Double_t RooAddPdf::evaluate() const
 }
 
 
+
+//_____________________________________________________________________________
+Bool_t RooAddPdf::evaluateBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& data) const 
+{
+  // Calculate the values of evaluate() for a batch of events. The coefficients are
+  // calculated once for the batch, the batch is evaluated event by event if they
+  // depend on the observables of the event
+
+  const RooArgSet* nset = _normSet ; 
+
+  if (nset==0 || nset->getSize()==0) {
+    if (_refCoefNorm.getSize()!=0) {
+      nset = &_refCoefNorm ;
+    }
+  }
+
+  CacheElem* cache = getProjCache(nset) ;
+
+  const RooArgSet& obs = *data.get() ;
+  const RooArgList* coefLists[] = { &_coefList, &cache->_suppNormList, &cache->_projList, 
+				    &cache->_suppProjList, &cache->_refRangeProjList, &cache->_rangeProjList } ;
+  for (UInt_t k=0 ; k<sizeof(coefLists)/sizeof(coefLists[0]) ; k++) {
+    RooFIter ci = coefLists[k]->fwdIterator() ;
+    RooAbsArg* arg ;
+    while((arg = ci.next())) {
+      if (arg->dependsOnValue(obs)) return kFALSE ;
+    }
+  }
+
+  updateCoefficients(*cache,nset) ;
+  
+  // Do running sum of coef/pdf batch pairs
+  for (Int_t j=0 ; j<nEvents ; j++) {
+    output[j] = 0 ;
+  }
+
+  std::vector<Double_t> buffer ;
+  RooAbsPdf* pdf ;
+  Int_t i(0) ;
+  RooFIter pi = _pdfList.fwdIterator() ;
+  while((pdf = (RooAbsPdf*)pi.next())) {
+    if (pdf->isSelectedComp()) {
+      const Double_t* pdfVal = pdf->getValBatch(begin,nEvents,data,buffer,nset) ;
+      if (cache->_needSupNorm) {
+	Double_t snormVal = ((RooAbsReal*)cache->_suppNormList.at(i))->getVal() ;
+	for (Int_t j=0 ; j<nEvents ; j++) {
+	  output[j] += pdfVal[j]*_coefCache[i]/snormVal ;
+	}
+      } else {
+	for (Int_t j=0 ; j<nEvents ; j++) {
+	  output[j] += pdfVal[j]*_coefCache[i] ;
+	}
+      }
+    }
+    i++ ;
+  }
+
+  return kTRUE ;
+}
+
+
 //_____________________________________________________________________________
 void RooAddPdf::resetErrorCounters(Int_t resetValue)
 {
@@ -45,6 +45,7 @@
 #include <iomanip>
 #include <fstream>
 #include <list>
+#include <mutex>
 #include "TClass.h"
 #include "RooArgSet.h"
 #include "RooStreamParser.h"
@@ -56,6 +57,7 @@
 #include "RooArgList.h"
 #include "RooSentinel.h"
 #include "RooMsgService.h"
+#include "RooRealMTFE.h"
 
 using namespace std ;
 
@@ -77,6 +79,18 @@ struct POOLDATA
 } ;
 
 static std::list<POOLDATA> _memPoolList ;
+static std::mutex _memPoolMutex ; // Serializes pool access of RooArgSets created in concurrent test statistic threads
+
+namespace {
+  // Lock of the memory pool, taken only while test statistic threads run
+  // (see RooRealMTFE::threadsActive)
+  class MemPoolLock {
+  public:
+    MemPoolLock() : _lock(_memPoolMutex, std::defer_lock) { if (RooRealMTFE::threadsActive()) _lock.lock() ; }
+  private:
+    std::unique_lock<std::mutex> _lock ;
+  } ;
+}
 
 //_____________________________________________________________________________
 void RooArgSet::cleanup()
@@ -106,6 +120,8 @@ void* RooArgSet::operator new (size_t bytes)
 
   //cout << " RooArgSet::operator new(" << bytes << ")" << endl ;
 
+  MemPoolLock lock ;
+
   if (!_poolBegin || _poolCur+(sizeof(RooArgSet)) >= _poolEnd) {
 
     if (_poolBegin!=0) {
@@ -176,6 +192,7 @@ void RooArgSet::operator delete (void* ptr)
   // Memory is owned by pool, we need to do nothing to release it
 
   // Decrease use count in pool that ptr is on
+  MemPoolLock lock ;
   for (std::list<POOLDATA>::iterator poolIter =  _memPoolList.begin() ; poolIter!=_memPoolList.end() ; ++poolIter) {
     if ((char*)ptr > (char*)poolIter->_base && (char*)ptr < (char*)poolIter->_base + POOLSIZE) {
       (*(Int_t*)(poolIter->_base))-- ;
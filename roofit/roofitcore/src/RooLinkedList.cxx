@@ -27,6 +27,7 @@
 //
 
 #include <algorithm>
+#include <mutex>
 
 #include "RooFit.h"
 #include "Riostream.h"
@@ -36,6 +37,7 @@
 #include "RooHashTable.h"
 #include "RooAbsArg.h"
 #include "RooMsgService.h"
+#include "RooRealMTFE.h"
 
 using namespace std;
 
@@ -250,11 +252,25 @@ namespace RooLinkedListImplDetails {
 }
 
 RooLinkedList::Pool* RooLinkedList::_pool = 0;
+// Serializes access to the element pool by lists used in concurrent test statistic threads
+static std::mutex _poolMutex;
+
+namespace {
+  // Lock of the element pool, taken only while test statistic threads run
+  // (see RooRealMTFE::threadsActive)
+  class PoolLock {
+  public:
+    PoolLock() : _lock(_poolMutex, std::defer_lock) { if (RooRealMTFE::threadsActive()) _lock.lock() ; }
+  private:
+    std::unique_lock<std::mutex> _lock ;
+  } ;
+}
 
 //_____________________________________________________________________________
 RooLinkedList::RooLinkedList(Int_t htsize) : 
   _hashThresh(htsize), _size(0), _first(0), _last(0), _htableName(0), _htableLink(0), _useNptr(kFALSE)
 {
+  PoolLock lock;
   if (!_pool) _pool = new Pool;
   _pool->acquire();
 }
@@ -265,8 +281,11 @@ RooLinkedList::RooLinkedList(const RooLinkedList& other) :
   _name(other._name), _useNptr(other._useNptr)
 {
   // Copy constructor
-  if (!_pool) _pool = new Pool;
-  _pool->acquire();
+  {
+    PoolLock lock;
+    if (!_pool) _pool = new Pool;
+    _pool->acquire();
+  }
   if (other._htableName) _htableName = new RooHashTable(other._htableName->size()) ;
   if (other._htableLink) _htableLink = new RooHashTable(other._htableLink->size(),RooHashTable::Pointer) ;
   for (RooLinkedListElem* elem = other._first; elem; elem = elem->_next) {
@@ -278,7 +297,11 @@ RooLinkedList::RooLinkedList(const RooLinkedList& other) :
 RooLinkedListElem* RooLinkedList::createElement(TObject* obj, RooLinkedListElem* elem) 
 {
 //   cout << "RooLinkedList::createElem(" << this << ") obj = " << obj << " elem = " << elem << endl ;
-  RooLinkedListElem* ret = _pool->pop_free_elem();
+  RooLinkedListElem* ret;
+  {
+    PoolLock lock;
+    ret = _pool->pop_free_elem();
+  }
   ret->init(obj, elem);
   return ret ;
 }
@@ -287,6 +310,7 @@ RooLinkedListElem* RooLinkedList::createElement(TObject* obj, RooLinkedListElem*
 void RooLinkedList::deleteElement(RooLinkedListElem* elem) 
 {  
   elem->release() ;
+  PoolLock lock;
   _pool->push_free_elem(elem);
   //delete elem ;
 }
@@ -364,6 +388,7 @@ RooLinkedList::~RooLinkedList()
   }
   
   Clear() ;
+  PoolLock lock;
   if (_pool->release()) {
     delete _pool;
     _pool = 0;
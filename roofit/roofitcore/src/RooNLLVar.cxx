@@ -31,6 +31,8 @@
 #include "RooFit.h"
 #include "Riostream.h"
 #include "TMath.h"
+#include "TClass.h"
+#include "TMethod.h"
 
 #include "RooNLLVar.h"
 #include "RooAbsData.h"
@@ -39,11 +41,28 @@
 #include "RooMsgService.h"
 #include "RooAbsDataStore.h"
 #include "RooRealMPFE.h"
+#include "RooRealMTFE.h"
+#include "RooVectorDataStore.h"
+#include "RooDataSet.h"
 #include "RooRealSumPdf.h"
 #include "RooRealVar.h"
 #include "RooProdPdf.h"
 
 ClassImp(RooNLLVar)
+
+namespace {
+
+  //_____________________________________________________________________________
+  Bool_t overridesLogVal(const RooAbsPdf& pdf)
+  {
+    // Return true if the class of 'pdf' implements its own getLogVal(). The batch
+    // values are then not used, as the log of the value may differ from it
+
+    TMethod* method = pdf.IsA()->GetMethodAllAny("getLogVal") ;
+    return method && method->GetClass()!=RooAbsPdf::Class() ;
+  }
+
+}
 ;
 
 RooArgSet RooNLLVar::_emptySet ;
@@ -69,6 +88,8 @@ RooNLLVar::RooNLLVar(const char *name, const char* title, RooAbsPdf& pdf, RooAbs
   //
   //  Extended()     -- Include extended term in calculation
   //  NumCPU()       -- Activate parallel processing feature
+  //  UseThreads()   -- Calculate NumCPU() partitions in threads rather than in processes
+  //  BatchMode()    -- Evaluate the p.d.f. for batches of events rather than event by event
   //  Range()        -- Fit only selected region
   //  SumCoefRange() -- Set the range in which to interpret the coefficients of RooAddPdf components 
   //  SplitRange()   -- Fit range is split by index catory of simultaneous PDF
@@ -79,13 +100,17 @@ RooNLLVar::RooNLLVar(const char *name, const char* title, RooAbsPdf& pdf, RooAbs
   RooCmdConfig pc("RooNLLVar::RooNLLVar") ;
   pc.allowUndefined() ;
   pc.defineInt("extended","Extended",0,kFALSE) ;
+  pc.defineInt("usethreads","UseThreads",0,kFALSE) ;
+  pc.defineInt("batchmode","BatchMode",0,kFALSE) ;
 
   pc.process(arg1) ;  pc.process(arg2) ;  pc.process(arg3) ;
   pc.process(arg4) ;  pc.process(arg5) ;  pc.process(arg6) ;
   pc.process(arg7) ;  pc.process(arg8) ;  pc.process(arg9) ;
 
   _extended = pc.getInt("extended") ;
+  if (pc.getInt("usethreads")) enableThreads(kTRUE) ;
   _weightSq = kFALSE ;
+  _batchMode = pc.getInt("batchmode") ;
   _first = kTRUE ;
   _offset = 0.;
   _offsetCarry = 0.;
@@ -104,6 +129,7 @@ RooNLLVar::RooNLLVar(const char *name, const char *title, RooAbsPdf& pdf, RooAbs
   RooAbsOptTestStatistic(name,title,pdf,indata,RooArgSet(),rangeName,addCoefRangeName,nCPU,interleave,verbose,splitRange,cloneData),
   _extended(extended),
   _weightSq(kFALSE),
+  _batchMode(kFALSE),
   _first(kTRUE), _offsetSaveW2(0.), _offsetCarrySaveW2(0.)
 {
   // Construct likelihood from given p.d.f and (binned or unbinned dataset)
@@ -146,6 +172,7 @@ RooNLLVar::RooNLLVar(const char *name, const char *title, RooAbsPdf& pdf, RooAbs
   RooAbsOptTestStatistic(name,title,pdf,indata,projDeps,rangeName,addCoefRangeName,nCPU,interleave,verbose,splitRange,cloneData),
   _extended(extended),
   _weightSq(kFALSE),
+  _batchMode(kFALSE),
   _first(kTRUE), _offsetSaveW2(0.), _offsetCarrySaveW2(0.)
 {
   // Construct likelihood from given p.d.f and (binned or unbinned dataset)
@@ -186,6 +213,7 @@ RooNLLVar::RooNLLVar(const RooNLLVar& other, const char* name) :
   RooAbsOptTestStatistic(other,name),
   _extended(other._extended),
   _weightSq(other._weightSq),
+  _batchMode(other._batchMode),
   _first(kTRUE), _offsetSaveW2(other._offsetSaveW2),
   _offsetCarrySaveW2(other._offsetCarrySaveW2),
   _binw(other._binw) {
@@ -216,6 +244,9 @@ void RooNLLVar::applyWeightSquared(Bool_t flag)
       std::swap(_offsetCarry, _offsetCarrySaveW2);
     }
     setValueDirty();
+  } else if ( _gofOpMode==MPMaster && _mtMode) {
+    for (Int_t i=0 ; i<_nCPU ; i++)
+      _mtfeArray[i]->applyNLLWeightSquared(flag);
   } else if ( _gofOpMode==MPMaster) {
     for (Int_t i=0 ; i<_nCPU ; i++)
       _mpfeArray[i]->applyNLLWeightSquared(flag);
@@ -227,6 +258,28 @@ void RooNLLVar::applyWeightSquared(Bool_t flag)
 
 
 
+//_____________________________________________________________________________
+void RooNLLVar::enableBatchMode(Bool_t flag) 
+{
+  // Evaluate the p.d.f. for batches of events, using the columns of the dataset
+  // (see RooAbsReal::getValBatch()), rather than loading and evaluating the
+  // events one by one. This applies to unbinned datasets stored in a
+  // RooVectorDataStore, all other datasets are processed event by event.
+  // P.d.f.s whose class overloads getLogVal() are also evaluated event by event.
+  // For parallelized and simultaneous likelihoods this must be called before
+  // the likelihood is first evaluated or optimized.
+
+  if (_init && _gofOpMode!=Slave) {
+    coutE(Eval) << "RooNLLVar::enableBatchMode(" << GetName() 
+		<< ") ERROR: calculation mode cannot be changed after initialization" << std::endl ;
+    return ;
+  }
+  _batchMode = flag ;
+  setValueDirty() ;
+}
+
+
+
 //_____________________________________________________________________________
 Double_t RooNLLVar::evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t stepSize) const 
 {
@@ -282,28 +335,83 @@ Double_t RooNLLVar::evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t s
 
   } else {
 
-    for (i=firstEvent ; i<lastEvent ; i+=stepSize) {
+    // In batch mode the p.d.f. is evaluated on the columns of a vector data store
+    const RooVectorDataStore* vstore(0) ;
+    if (_batchMode && stepSize==1 && dynamic_cast<RooDataSet*>(_dataClone)) {
+      vstore = dynamic_cast<const RooVectorDataStore*>(_dataClone->store()) ;
+      if (vstore && vstore->isWeighted() && !vstore->weightArray()) vstore = 0 ;
+      if (vstore && overridesLogVal(*pdfClone)) vstore = 0 ;
+    }
+
+    if (vstore) {
+
+      const Int_t batchSize(4096) ;
+      std::vector<Double_t> batchBuf ;
+      const Double_t* batchWeights = vstore->weightArray() ;
+      const Double_t* batchProbs(0) ;
+      Int_t batchBegin(firstEvent), batchEnd(firstEvent) ;
+
+      for (i=firstEvent ; i<lastEvent ; i++) {
+
+        if (i==batchEnd) {
+	  batchBegin = i ;
+	  batchEnd = std::min(i+batchSize,lastEvent) ;
+	  batchProbs = pdfClone->getValBatch(batchBegin,batchEnd-batchBegin,*vstore,batchBuf,_normSet) ;
+        }
+
+        Double_t eventWeight = batchWeights ? batchWeights[i] : 1.0 ;
+        if (0. == eventWeight * eventWeight) continue ;
+        if (_weightSq) eventWeight = eventWeight * eventWeight ;
+
+        // Values that getLogVal() warns about or rejects are recalculated by it
+        Double_t prob = batchProbs[i-batchBegin] ;
+        Double_t logProb ;
+        if (prob>0 && prob<=1e6) {
+	  logProb = log(prob) ;
+        } else {
+	  _dataClone->get(i) ;
+	  logProb = pdfClone->getLogVal(_normSet) ;
+        }
+
+        Double_t term = -eventWeight * logProb ;
+
+        Double_t y = eventWeight - sumWeightCarry;
+        Double_t t = sumWeight + y;
+        sumWeightCarry = (t - sumWeight) - y;
+        sumWeight = t;
+      
+        y = term - carry;
+        t = result + y;
+        carry = (t - result) - y;
+        result = t;
+      }
+
+    } else {
+
+      for (i=firstEvent ; i<lastEvent ; i+=stepSize) {
             
-      _dataClone->get(i) ;
+        _dataClone->get(i) ;
       
-      if (!_dataClone->valid()) continue;
+        if (!_dataClone->valid()) continue;
       
-      Double_t eventWeight = _dataClone->weight();
-      if (0. == eventWeight * eventWeight) continue ;
-      if (_weightSq) eventWeight = _dataClone->weightSquared() ;
+        Double_t eventWeight = _dataClone->weight();
+        if (0. == eventWeight * eventWeight) continue ;
+        if (_weightSq) eventWeight = _dataClone->weightSquared() ;
       
-      Double_t term = -eventWeight * pdfClone->getLogVal(_normSet);
+        Double_t term = -eventWeight * pdfClone->getLogVal(_normSet);
       
       
-      Double_t y = eventWeight - sumWeightCarry;
-      Double_t t = sumWeight + y;
-      sumWeightCarry = (t - sumWeight) - y;
-      sumWeight = t;
+        Double_t y = eventWeight - sumWeightCarry;
+        Double_t t = sumWeight + y;
+        sumWeightCarry = (t - sumWeight) - y;
+        sumWeight = t;
       
-      y = term - carry;
-      t = result + y;
-      carry = (t - result) - y;
-      result = t;
+        y = term - carry;
+        t = result + y;
+        carry = (t - result) - y;
+        result = t;
+      }
+
     }
     
     // include the extended maximum likelihood term, if requested
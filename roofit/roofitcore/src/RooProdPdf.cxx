@@ -533,6 +533,69 @@ Double_t RooProdPdf::evaluate() const
 
 
 
+//_____________________________________________________________________________
+void RooProdPdf::computeBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& data, const RooArgSet* normSet) const
+{
+  // Overload computeBatch() to intercept normalization set for use in evaluateBatch()
+  _curNormSet = (RooArgSet*)normSet ;
+  RooAbsPdf::computeBatch(output,begin,nEvents,data,normSet) ;
+}
+
+
+
+//_____________________________________________________________________________
+Bool_t RooProdPdf::evaluateBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& data) const 
+{
+  // Calculate the values of evaluate() for a batch of events: the running product
+  // of the batches of values of all terms, with the same cutoff as in calculate()
+
+  Int_t code ;
+  CacheElem* cache = (CacheElem*) _cacheMgr.getObj(_curNormSet,0,&code) ;
+  
+  // If cache doesn't have our configuration, recalculate here
+  if (!cache) {
+    RooArgList *plist(0) ;
+    RooLinkedList *nlist(0) ;
+    getPartIntList(_curNormSet,0,plist,nlist,code) ;
+    cache = (CacheElem*) _cacheMgr.getObj(_curNormSet,0,&code) ;
+  }
+
+  std::vector<Double_t> buffer ;
+
+  if (cache->_isRearranged) {
+
+    std::vector<Double_t> denBuffer ;
+    const Double_t* num = cache->_rearrangedNum->getValBatch(begin,nEvents,data,buffer) ;
+    const Double_t* den = cache->_rearrangedDen->getValBatch(begin,nEvents,data,denBuffer) ;
+    for (Int_t j=0 ; j<nEvents ; j++) {
+      output[j] = num[j] / den[j] ;
+    }
+    return kTRUE ;
+  }
+
+  for (Int_t j=0 ; j<nEvents ; j++) {
+    output[j] = 1.0 ;
+  }
+
+  RooFIter plIter = cache->_partList.fwdIterator() ;
+  RooFIter nlIter = cache->_normList.fwdIterator() ;
+  RooAbsReal* partInt ;
+  Bool_t first(kTRUE) ;
+  while((partInt=(RooAbsReal*)plIter.next())) {
+    RooArgSet* normSet = (RooArgSet*) nlIter.next() ;
+    const Double_t* piVal = partInt->getValBatch(begin,nEvents,data,buffer,normSet->getSize()>0 ? normSet : 0) ;
+    for (Int_t j=0 ; j<nEvents ; j++) {
+      // Terms after the running product dropped below the cutoff are skipped
+      if (first || output[j]>_cutOff) output[j] *= piVal[j] ;
+    }
+    first = kFALSE ;
+  }
+
+  return kTRUE ;
+}
+
+
+
 //_____________________________________________________________________________
 Double_t RooProdPdf::calculate(const RooArgList* partIntList, const RooLinkedList* normSetList) const
 {
@@ -0,0 +1,344 @@
+/*****************************************************************************
+ * Project: RooFit                                                           *
+ * Package: RooFitCore                                                       *
+ * @(#)root/roofitcore:$Id$
+ * Authors:                                                                  *
+ *   WV, Wouter Verkerke, UC Santa Barbara, verkerke@slac.stanford.edu       *
+ *   DK, David Kirkby,    UC Irvine,         dkirkby@uci.edu                 *
+ *                                                                           *
+ * Copyright (c) 2000-2005, Regents of the University of California          *
+ *                          and Stanford University. All rights reserved.    *
+ *                                                                           *
+ * Redistribution and use in source and binary forms,                        *
+ * with or without modification, are permitted according to the terms        *
+ * listed in LICENSE (http://roofit.sourceforge.net/license.txt)             *
+ *****************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// BEGIN_HTML
+// RooRealMTFE is the multi-thread front-end for parallel calculation
+// of RooAbsReal objects. It is the in-process counterpart of RooRealMPFE:
+// each RooRealMTFE owns a worker thread that calculates the value of the
+// proxied RooAbsReal object. The (re)calculation is started asynchronously
+// with calculate(), a subsequent call to getVal() blocks until the worker
+// thread has finished and returns the calculated value. The worker thread
+// is terminated when the front-end object is deleted or standby() is called.
+// <p>
+// As the proxied object lives in the same process, no parameter values
+// need to be transferred: the proxied object must however not share any
+// object that is modified during its evaluation with the calling thread or
+// with the objects calculated by other front-ends. RooAbsTestStatistic
+// guarantees this by giving each front-end a test statistic with its own
+// clone of the p.d.f. and of the dataset, all clones sharing only the
+// (read-only during evaluation) parameter objects.
+// <p>
+// The first calculation after construction and after each constant term
+// optimization call is performed synchronously in the calling thread, so that
+// objects the proxied function creates lazily (e.g. normalization integrals)
+// and registers with the shared parameters are not created concurrently.
+// END_HTML
+//
+
+#include "RooFit.h"
+#include "Riostream.h"
+
+#include "RooRealMTFE.h"
+#include "RooAbsTestStatistic.h"
+#include "RooNLLVar.h"
+#include "RooMsgService.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <atomic>
+
+using namespace std;
+
+ClassImp(RooRealMTFE)
+  ;
+
+// Number of existing worker threads, see threadsActive()
+static atomic<int> _nWorkers(0) ;
+
+
+//_____________________________________________________________________________
+class RooRealMTFEWorker {
+public:
+  // Persistent thread calculating the value of a RooRealMTFE on request
+
+  RooRealMTFEWorker(const RooRealMTFE& fe) :
+    _fe(fe), _request(false), _done(false), _stop(false),
+    _thread(&RooRealMTFEWorker::loop, this) {}
+
+  ~RooRealMTFEWorker() {
+    {
+      lock_guard<mutex> lock(_mutex) ;
+      _stop = true ;
+    }
+    _cond.notify_all() ;
+    _thread.join() ;
+  }
+
+  void post() {
+    // Start calculation in worker thread
+    {
+      lock_guard<mutex> lock(_mutex) ;
+      _request = true ;
+      _done = false ;
+      _error = exception_ptr() ;
+    }
+    _cond.notify_all() ;
+  }
+
+  void wait() {
+    // Wait for calculation to finish. Exceptions thrown in the worker thread
+    // are rethrown in the calling thread
+    unique_lock<mutex> lock(_mutex) ;
+    while (!_done) _cond.wait(lock) ;
+    if (_error) {
+      exception_ptr error = _error ;
+      _error = exception_ptr() ;
+      rethrow_exception(error) ;
+    }
+  }
+
+private:
+
+  void loop() {
+    unique_lock<mutex> lock(_mutex) ;
+    while (true) {
+      while (!_request && !_stop) _cond.wait(lock) ;
+      if (_stop) return ;
+      _request = false ;
+      lock.unlock() ;
+      exception_ptr error ;
+      try {
+	_fe.calculateInline() ;
+      } catch (...) {
+	error = current_exception() ;
+      }
+      lock.lock() ;
+      _error = error ;
+      _done = true ;
+      _cond.notify_all() ;
+    }
+  }
+
+  const RooRealMTFE& _fe ;
+  mutex _mutex ;
+  condition_variable _cond ;
+  bool _request ;
+  bool _done ;
+  bool _stop ;
+  exception_ptr _error ;
+  thread _thread ;
+} ;
+
+
+
+//_____________________________________________________________________________
+RooRealMTFE::RooRealMTFE(const char *name, const char *title, RooAbsReal& arg) :
+  RooAbsReal(name,title),
+  _arg("arg","arg",this,arg),
+  _calcInProgress(kFALSE),
+  _calcInline(kTRUE),
+  _evalCarry(0.),
+  _worker(0)
+{
+  // Construct front-end object for object 'arg' whose evaluation will be calculated
+  // asynchronously in a separate thread. The worker thread is started at the
+  // second calculation request, the first calculation is done in the calling thread
+}
+
+
+
+//_____________________________________________________________________________
+RooRealMTFE::RooRealMTFE(const RooRealMTFE& other, const char* name) :
+  RooAbsReal(other, name),
+  _arg("arg",this,other._arg),
+  _calcInProgress(kFALSE),
+  _calcInline(kTRUE),
+  _evalCarry(other._evalCarry),
+  _worker(0)
+{
+  // Copy constructor. Initializes in clean state so that upon eval
+  // this instance will create its own worker thread
+}
+
+
+
+//_____________________________________________________________________________
+RooRealMTFE::~RooRealMTFE()
+{
+  // Destructor
+  standby() ;
+}
+
+
+
+//_____________________________________________________________________________
+void RooRealMTFE::calculate() const
+{
+  // Instruct worker thread to start asynchronuous (re)calculation of
+  // function value. This function returns immediately, except for the
+  // first calculation, which is done synchronously. The calculated
+  // value can be retrieved using getVal()
+
+  if (_calcInProgress) return ;
+
+  if (_calcInline) {
+    calculateInline() ;
+    clearValueDirty() ;
+    _calcInline = kFALSE ;
+    return ;
+  }
+
+  if (!_worker) {
+    // Count the worker before it starts
+    ++_nWorkers ;
+    _worker = new RooRealMTFEWorker(*this) ;
+  }
+
+  clearValueDirty() ;
+  _calcInProgress = kTRUE ;
+  _worker->post() ;
+}
+
+
+
+//_____________________________________________________________________________
+void RooRealMTFE::calculateInline() const
+{
+  // Calculate value and carry of proxied function in the current thread
+
+  RooAbsReal& arg = (RooAbsReal&) _arg.arg() ;
+  _value = arg.getVal() ;
+  RooAbsTestStatistic* gof = dynamic_cast<RooAbsTestStatistic*>(&arg) ;
+  _evalCarry = gof ? gof->getCarry() : 0. ;
+}
+
+
+
+//_____________________________________________________________________________
+Double_t RooRealMTFE::getValV(const RooArgSet* /*nset*/) const
+{
+  // If value needs recalculation and calculation has not beed started
+  // with a call to calculate() start it now. This function blocks
+  // until the worker thread has finished calculation and returns
+  // the calculated value
+
+  // Do not inspect the dirty state while the worker thread is running
+  if (_calcInProgress) {
+    _value = evaluate() ;
+  } else if (isValueDirty()) {
+    calculate() ;
+    _value = evaluate() ;
+  }
+
+  return _value ;
+}
+
+
+
+//_____________________________________________________________________________
+Double_t RooRealMTFE::evaluate() const
+{
+  // Wait for worker thread to finish the calculation and return the
+  // calculated value
+
+  if (_calcInProgress) {
+    _calcInProgress = kFALSE ;
+    _worker->wait() ;
+    // Dirty flags may have been raised during the calculation by the
+    // evaluation of the proxied function
+    clearValueDirty() ;
+  }
+  return _value ;
+}
+
+
+
+//_____________________________________________________________________________
+Double_t RooRealMTFE::getCarry() const
+{
+  // Return carry of Kahan sum of last calculation
+  return _evalCarry ;
+}
+
+
+
+//_____________________________________________________________________________
+void RooRealMTFE::standby()
+{
+  // Terminate worker thread. Calls to calculate() or evaluate() after
+  // this call will automatically recreate the worker thread.
+
+  if (_calcInProgress) {
+    _calcInProgress = kFALSE ;
+    try {
+      _worker->wait() ;
+    } catch (...) {
+      coutE(Eval) << "RooRealMTFE::standby(" << GetName() << ") ERROR: exception in pending calculation ignored" << endl ;
+    }
+  }
+  if (_worker) {
+    delete _worker ;
+    _worker = 0 ;
+    --_nWorkers ;
+  }
+}
+
+
+
+//_____________________________________________________________________________
+Bool_t RooRealMTFE::threadsActive()
+{
+  // Return true while worker threads of front-ends exist. The memory pools
+  // of RooArgSet and RooLinkedList are only locked then, the single threaded
+  // use of RooFit does not pay for the locks. The workers are counted before
+  // they start and after they are joined, by the thread owning the front-end.
+
+  return _nWorkers.load() > 0 ;
+}
+
+
+
+//_____________________________________________________________________________
+void RooRealMTFE::constOptimizeTestStatistic(ConstOpCode opcode, Bool_t doAlsoTracking)
+{
+  // Intercept call to optimize constant term in test statistics
+  // and forward it to the calculated object. As the optimization
+  // may change which objects are lazily created during evaluation,
+  // the next calculation is done in the calling thread
+
+  if (_calcInProgress) evaluate() ;
+  ((RooAbsReal&)_arg.arg()).constOptimizeTestStatistic(opcode,doAlsoTracking) ;
+  _calcInline = kTRUE ;
+}
+
+
+
+//_____________________________________________________________________________
+void RooRealMTFE::enableOffsetting(Bool_t flag)
+{
+  // Forward offsetting request to the calculated object
+
+  if (_calcInProgress) evaluate() ;
+  ((RooAbsReal&)_arg.arg()).enableOffsetting(flag) ;
+}
+
+
+
+//_____________________________________________________________________________
+void RooRealMTFE::applyNLLWeightSquared(Bool_t flag)
+{
+  // Forward weight squared request to the calculated object, if it is a RooNLLVar
+
+  if (_calcInProgress) evaluate() ;
+  RooNLLVar* nll = dynamic_cast<RooNLLVar*>(_arg.absArg()) ;
+  if (nll) {
+    nll->applyWeightSquared(flag) ;
+  }
+}
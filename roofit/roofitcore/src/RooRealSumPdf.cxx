@@ -42,6 +42,7 @@
 #include "RooRealIntegral.h"
 #include "RooMsgService.h"
 #include "RooNameReg.h"
+#include "RooVectorDataStore.h"
 #include <memory>
 #include <algorithm>
 
@@ -268,6 +269,76 @@ Double_t RooRealSumPdf::evaluate() const
 
 
 
+//_____________________________________________________________________________
+Bool_t RooRealSumPdf::evaluateBatch(Double_t* output, Int_t begin, Int_t nEvents, const RooVectorDataStore& data) const 
+{
+  // Calculate the values of evaluate() for a batch of events. The coefficients are
+  // calculated once for the batch, the batch is evaluated event by event if they
+  // depend on the observables of the event
+
+  RooFIter coefIter = _coefList.fwdIterator() ;
+  RooAbsReal* coef ;
+  while((coef=(RooAbsReal*)coefIter.next())) {
+    if (coef->dependsOnValue(*data.get())) return kFALSE ;
+  }
+
+  for (Int_t j=0 ; j<nEvents ; j++) {
+    output[j] = 0 ;
+  }
+
+  // Do running sum of coef/func batch pairs, calculate lastCoef.
+  RooFIter funcIter = _funcList.fwdIterator() ;
+  coefIter = _coefList.fwdIterator() ;
+  RooAbsReal* func ;
+  std::vector<Double_t> buffer ;
+      
+  // N funcs, N-1 coefficients 
+  Double_t lastCoef(1) ;
+  while((coef=(RooAbsReal*)coefIter.next())) {
+    func = (RooAbsReal*)funcIter.next() ;
+    Double_t coefVal = coef->getVal() ;
+    if (coefVal) {
+      if (func->isSelectedComp()) {
+	const Double_t* funcVal = func->getValBatch(begin,nEvents,data,buffer) ;
+	for (Int_t j=0 ; j<nEvents ; j++) {
+	  output[j] += funcVal[j]*coefVal ;
+	}
+      }
+      lastCoef -= coef->getVal() ;
+    }
+  }
+  
+  if (!_haveLastCoef) {
+    // Add last func with correct coefficient
+    func = (RooAbsReal*) funcIter.next() ;
+    if (func->isSelectedComp()) {
+      const Double_t* funcVal = func->getValBatch(begin,nEvents,data,buffer) ;
+      for (Int_t j=0 ; j<nEvents ; j++) {
+	output[j] += funcVal[j]*lastCoef ;
+      }
+    }
+
+    // Warn about coefficient degeneration
+    if (lastCoef<0 || lastCoef>1) {
+      coutW(Eval) << "RooRealSumPdf::evaluateBatch(" << GetName() 
+		  << " WARNING: sum of FUNC coefficients not in range [0-1], value=" 
+		  << 1-lastCoef << endl ;
+    } 
+  }
+
+  // Introduce floor if so requested
+  if (_doFloor || _doFloorGlobal) {
+    for (Int_t j=0 ; j<nEvents ; j++) {
+      if (output[j]<0) output[j] = 0 ;
+    }
+  }
+
+  return kTRUE ;
+}
+
+
+
+
 //_____________________________________________________________________________
 Bool_t RooRealSumPdf::checkObservables(const RooArgSet* nset) const 
 {
@@ -1378,6 +1378,40 @@ void RooVectorDataStore::attachCache(const RooAbsArg* newOwner, const RooArgSet&
 
 
 
+//_____________________________________________________________________________
+const Double_t* RooVectorDataStore::realColumn(const RooAbsReal& real) const
+{
+  // Return pointer to the first element of the stored values of 'real', which
+  // can be an observable of this store or a function whose values are kept
+  // in the optimization cache. Return zero if no values are stored for 'real'
+
+  for (Int_t i=0 ; i<_nReal ; i++) {
+    const RealVector* rv = *(_firstReal+i) ;
+    if (rv->_real==&real || rv->_nativeReal==&real) return rv->_vec0 ;
+  }
+  for (Int_t i=0 ; i<_nRealF ; i++) {
+    const RealVector* rv = *(_firstRealF+i) ;
+    if (rv->_real==&real || rv->_nativeReal==&real) return rv->_vec0 ;
+  }
+
+  return _cache ? _cache->realColumn(real) : 0 ;
+}
+
+
+
+//_____________________________________________________________________________
+const Double_t* RooVectorDataStore::weightArray() const
+{
+  // Return pointer to the array of event weights, or zero if this
+  // store is not weighted
+
+  if (_extWgtArray) return _extWgtArray ;
+  if (_wgtVar) return realColumn(*_wgtVar) ;
+  return 0 ;
+}
+
+
+
 //_____________________________________________________________________________
 void RooVectorDataStore::resetCache() 
 {
@@ -38,6 +38,9 @@
 //  if comp = 1 event is compressed.
 //  if comp = 2 same as 1. In addition branches with floats in the TClonesArray
 //                         are also compressed.
+//  comp may also be given as 100*algorithm+level to select the compression
+//  algorithm (see ROOT::ECompressionAlgorithm), e.g. 401 for LZ4 level 1
+//  or 505 for ZSTD level 5.
 //  The 4th argument fill can be set to 0 if one wants to time
 //     the percentage of time spent in creating the event structure and
 //     not write the event in the file.
@@ -193,7 +196,7 @@ int main(int argc, char **argv)
          hfile = new TNetFile("root://localhost/root/test/EventNet.root","RECREATE","TTree benchmark ROOT file");
       } else
          hfile = new TFile("Event.root","RECREATE","TTree benchmark ROOT file");
-      hfile->SetCompressionLevel(comp);
+      hfile->SetCompressionSettings(comp);
 
      // Create histogram to show write_time in function of time
      Float_t curtime = -0.5;
@@ -0,0 +1,146 @@
+// @(#)root/test:$Id$
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Riostream.h"
+#include "TBranch.h"
+#include "TFile.h"
+#include "TMath.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TTreeCache.h"
+//
+// This program checks the adaptive mode of the TTreeCache (see
+// TTreeCache::SetAdaptive): the branches no longer read are removed from
+// the cache and a removed branch read again is put back in the cache.
+//
+// Usage: cachebm -h                     - to print a usage info
+//        cachebm [nentries] [cluster]   - to run the benchmark
+//
+// parameters:
+//       nentries      - number of entries of the tree
+//       cluster       - number of entries of each cluster
+//
+// The branches a and b are read during the first fifth of the entries, then
+// only a during the next fifth: b must be removed from the cache. b is read
+// once more at the middle of the tree, which must read only the basket of b
+// (the current cluster of a is not read again), and a alone is read until
+// the end: b must stay in the cache. The read calls and the bytes read are
+// printed.
+
+int nentries = 200000;   // Number of entries of the tree.
+int cluster  = 1000;     // Number of entries of each cluster.
+
+//_____________________________________________________________
+
+void MakeFile(const char *name)
+{
+   // Create the file name with a tree of 3 branches.
+
+   TFile f(name, "RECREATE");
+   TRandom3 rnd(4357);
+   TTree *t = new TTree("T", "benchmark tree");
+   Float_t a, b, c;
+   t->Branch("a", &a, "a/F");
+   t->Branch("b", &b, "b/F");
+   t->Branch("c", &c, "c/F");
+   t->SetAutoFlush(cluster);
+   for (int e = 0; e < nentries; e++) {
+      a = rnd.Gaus(0, 1);
+      b = rnd.Gaus(0, 1);
+      c = rnd.Gaus(0, 1);
+      t->Fill();
+   }
+   t->Write();
+}
+
+//_____________________________________________________________
+
+bool IsCached(TTreeCache *cache, const char *name)
+{
+   // Return true if the branch name is in the cache.
+
+   const TObjArray *branches = cache->GetCachedBranches();
+   for (Int_t i = 0; i < branches->GetEntriesFast(); i++) {
+      TObject *b = branches->UncheckedAt(i);
+      if (b && !strcmp(b->GetName(), name)) return true;
+   }
+   return false;
+}
+
+//_____________________________________________________________
+
+int main(int argc,char **argv)
+{
+   if (argc > 1 && !strcmp(argv[1], "-h")) {
+      printf("Usage: cachebm [nentries] [cluster]\n");
+      printf("  nentries - number of entries of the tree (default %d)\n", nentries);
+      printf("  cluster  - number of entries of each cluster (default %d)\n", cluster);
+      return 0;
+   }
+   if (argc > 1) nentries = atoi(argv[1]);
+   if (argc > 2) cluster  = atoi(argv[2]);
+   if (nentries < 20*cluster || cluster < 100) {
+      printf("cachebm: invalid arguments, try cachebm -h\n");
+      return 1;
+   }
+
+   const char *name = "cachebm.root";
+   printf("Creating a tree with %d entries\n", nentries);
+   MakeFile(name);
+
+   TFile *f = TFile::Open(name);
+   if (!f || f->IsZombie()) return 1;
+   TTree *t = (TTree*)f->Get("T");
+   if (!t) return 1;
+   Float_t a, b;
+   TBranch *ba = 0, *bb = 0;
+   t->SetBranchAddress("a", &a, &ba);
+   t->SetBranchAddress("b", &b, &bb);
+   // A cache of a few clusters, whose read-ahead does not grow.
+   Int_t cachesize = 8 * (Int_t)(t->GetZipBytes() / t->GetNbranches() / (nentries / cluster));
+   t->SetCacheSize(cachesize);
+   TTreeCache *cache = (TTreeCache*)f->GetCacheRead(t);
+   if (!cache) return 1;
+   cache->SetAdaptive(kTRUE, cachesize);
+
+   TStopwatch timer;
+   timer.Start();
+   bool ok = true;
+   Long64_t middle = nentries / 2;
+   Int_t calls = 0;
+   Long64_t bytes = 0, expected = 0;
+   for (Long64_t e = 0; e < nentries; e++) {
+      t->LoadTree(e);
+      ba->GetEntry(e);
+      if (e < nentries / 5) {
+         bb->GetEntry(e);
+      } else if (e == middle) {
+         // b was removed from the cache: only its basket is read
+         ok = ok && !IsCached(cache, "b");
+         Int_t basket = TMath::BinarySearch(bb->GetWriteBasket() + 1, bb->GetBasketEntry(), e);
+         expected = bb->GetBasketBytes()[basket];
+         calls = f->GetReadCalls();
+         bytes = f->GetBytesRead();
+         bb->GetEntry(e);
+         calls = f->GetReadCalls() - calls;
+         bytes = f->GetBytesRead() - bytes;
+         ok = ok && IsCached(cache, "b") && calls == 1 && bytes == expected;
+      }
+   }
+   timer.Stop();
+   // b stays in the cache once read again
+   ok = ok && IsCached(cache, "b") && IsCached(cache, "a") && !IsCached(cache, "c");
+   printf("Read of b after its removal: %d call(s), %lld bytes (basket: %lld bytes)\n",
+          calls, bytes, expected);
+   printf("Total: %d read calls, %lld bytes read, %7.3f s   %s\n",
+          f->GetReadCalls(), f->GetBytesRead(), timer.RealTime(), ok ? "OK" : "FAILED");
+   if (gDebug > 0) cache->Print();
+
+   delete f;
+   gSystem->Unlink(name);
+   return ok ? 0 : 1;
+}
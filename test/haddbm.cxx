@@ -0,0 +1,234 @@
+// @(#)root/test:$Id$
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Riostream.h"
+#include "TBranch.h"
+#include "TFile.h"
+#include "TFileMerger.h"
+#include "TH1.h"
+#include "TH2.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TTree.h"
+//
+// This program benchmarks the merge of files by TFileMerger (i.e. hadd)
+// with 1, 2, 4, ... processes (see TFileMerger::SetNProcesses and the
+// option -j of hadd), and checks that the merged files are identical.
+//
+// Usage: haddbm -h                              - to print a usage info
+//        haddbm [nfiles] [nentries] [maxprocs]  - to run the benchmark
+//
+// parameters:
+//       nfiles        - number of files to merge
+//       nentries      - number of entries of the tree of each file
+//       maxprocs      - maximum number of processes
+//
+// Each file contains a directory with 20 TH1F and 5 TH2F, and a tree
+// with 4 branches. The wall time of each merge and the speedup with respect
+// to the merge by one process are printed. The merged file is written with
+// LZMA while half of the input files use ZLIB: the program also checks that
+// the merged file, its branches and all its baskets have the compression of
+// the output, that the values of the tree are unchanged, and that no
+// partial file of the parallel merge is left behind.
+
+int nfiles   = 32;       // Number of files to merge.
+int nentries = 100000;   // Number of entries of the tree of each file.
+int maxprocs = 8;        // Maximum number of processes.
+int compress = 201;      // Compression settings of the merged file (LZMA, level 1).
+
+//_____________________________________________________________
+
+double MakeFile(const char *name, int seed, int settings)
+{
+   // Create the file name with histograms and a tree, with the compression
+   // settings. Returns the sum of the values of pz.
+
+   TFile f(name, "RECREATE", "", settings);
+   double sumpz = 0;
+   TRandom3 rnd(seed);
+   TDirectory *dir = f.mkdir("histos");
+   dir->cd();
+   TH1F *h1[20];
+   TH2F *h2[5];
+   for (int i = 0; i < 20; i++) h1[i] = new TH1F(Form("h1_%d", i), "h1", 1000, -5, 5);
+   for (int i = 0; i < 5; i++)  h2[i] = new TH2F(Form("h2_%d", i), "h2", 200, -5, 5, 200, -5, 5);
+   f.cd();
+   TTree *t = new TTree("T", "benchmark tree");
+   Float_t px, py, pz;
+   Int_t   n;
+   t->Branch("px", &px, "px/F");
+   t->Branch("py", &py, "py/F");
+   t->Branch("pz", &pz, "pz/F");
+   t->Branch("n", &n, "n/I");
+   for (int e = 0; e < nentries; e++) {
+      rnd.Rannor(px, py);
+      pz = px*px + py*py;
+      n  = e;
+      sumpz += pz;
+      t->Fill();
+      if (e < 20000) {
+         h1[e%20]->Fill(px);
+         h2[e%5]->Fill(px, py);
+      }
+   }
+   f.Write();
+   return sumpz;
+}
+
+//_____________________________________________________________
+
+bool Merge(const char *target, int nprocs, double &seconds)
+{
+   // Merge the input files into target with nprocs processes.
+
+   TFileMerger merger(kFALSE, kFALSE);
+   merger.SetPrintLevel(0);
+   merger.SetNProcesses(nprocs);
+   if (!merger.OutputFile(target, "RECREATE", compress)) return false;
+   for (int i = 0; i < nfiles; i++) {
+      if (!merger.AddFile(Form("haddbm_in%d.root", i), kFALSE)) return false;
+   }
+   TStopwatch timer;
+   timer.Start();
+   bool ok = merger.Merge();
+   timer.Stop();
+   seconds = timer.RealTime();
+   return ok;
+}
+
+//_____________________________________________________________
+
+bool CheckBaskets(TFile &f, TBranch *b)
+{
+   // Check that the compressed baskets of the branch b of the file f
+   // start with the header of the algorithm of compress.
+
+   const char *magic = compress / 100 == 2 ? "XZ" : "ZL";
+   for (Int_t i = 0; i < b->GetWriteBasket(); i++) {
+      Int_t len = b->GetBasketBytes()[i];
+      char header[64];
+      if (len < (Int_t)sizeof(header)) continue;
+      if (f.ReadBuffer(header, b->GetBasketSeek(i), sizeof(header))) return false;
+      // key: Nbytes (4), Version (2), ObjLen (4), Datime (4), KeyLen (2), ...
+      Int_t objlen = ((UChar_t)header[6] << 24) | ((UChar_t)header[7] << 16) |
+                     ((UChar_t)header[8] << 8) | (UChar_t)header[9];
+      Int_t keylen = ((UChar_t)header[14] << 8) | (UChar_t)header[15];
+      if (keylen + 2 > (Int_t)sizeof(header)) return false;
+      if (objlen <= len - keylen) continue; // not compressed
+      if (strncmp(header + keylen, magic, 2)) return false;
+   }
+   return true;
+}
+
+//_____________________________________________________________
+
+bool Check(const char *target, Double_t &entries, Double_t &sum, double &sumpz)
+{
+   // Compute the number of entries of the tree, the sum of the integrals
+   // of the histograms of target and the sum of the values of pz, and check
+   // the compression of the file, of the branches and of the baskets.
+
+   TFile f(target);
+   if (f.IsZombie()) return false;
+   TTree *t = (TTree*)f.Get("T");
+   if (!t) return false;
+   if (f.GetCompressionSettings() != compress) return false;
+   TIter nextb(t->GetListOfBranches());
+   TBranch *b;
+   while ((b = (TBranch*)nextb())) {
+      if (b->GetCompressionSettings() != compress || !CheckBaskets(f, b)) return false;
+   }
+   entries = t->GetEntries();
+   Float_t pz;
+   t->SetBranchAddress("pz", &pz);
+   sumpz = 0;
+   for (Long64_t e = 0; e < t->GetEntries(); e++) {
+      t->GetEntry(e);
+      sumpz += pz;
+   }
+   sum = t->GetMaximum("n");
+   for (int i = 0; i < 20; i++) {
+      TH1 *h = (TH1*)f.Get(Form("histos/h1_%d", i));
+      if (!h) return false;
+      sum += h->Integral();
+   }
+   for (int i = 0; i < 5; i++) {
+      TH1 *h = (TH1*)f.Get(Form("histos/h2_%d", i));
+      if (!h) return false;
+      sum += h->Integral();
+   }
+   return true;
+}
+
+//_____________________________________________________________
+
+int CountPartialFiles(const char *target)
+{
+   // Count the files of the current directory whose name starts like the
+   // partial files of the parallel merge into target.
+
+   int n = 0;
+   TString prefix = TString::Format("%s-", target);
+   void *dirp = gSystem->OpenDirectory(".");
+   if (!dirp) return -1;
+   const char *entry;
+   while ((entry = gSystem->GetDirEntry(dirp))) {
+      if (TString(entry).BeginsWith(prefix)) n++;
+   }
+   gSystem->FreeDirectory(dirp);
+   return n;
+}
+
+//_____________________________________________________________
+
+int main(int argc,char **argv)
+{
+   if (argc > 1 && !strcmp(argv[1], "-h")) {
+      printf("Usage: haddbm [nfiles] [nentries] [maxprocs]\n");
+      printf("  nfiles   - number of files to merge (default %d)\n", nfiles);
+      printf("  nentries - number of entries of the tree of each file (default %d)\n", nentries);
+      printf("  maxprocs - maximum number of processes (default %d)\n", maxprocs);
+      return 0;
+   }
+   if (argc > 1) nfiles   = atoi(argv[1]);
+   if (argc > 2) nentries = atoi(argv[2]);
+   if (argc > 3) maxprocs = atoi(argv[3]);
+   if (nfiles < 2 || nentries <= 0 || maxprocs <= 0) {
+      printf("haddbm: invalid arguments, try haddbm -h\n");
+      return 1;
+   }
+
+   printf("Creating %d files with %d entries\n", nfiles, nentries);
+   double refpz = 0;
+   for (int i = 0; i < nfiles; i++) refpz += MakeFile(Form("haddbm_in%d.root", i), i + 1, i % 2 ? 1 : compress);
+
+   bool ok = true;
+   double t1 = 0;
+   Double_t refentries = 0, refsum = 0;
+   for (int nprocs = 1; nprocs <= maxprocs; nprocs *= 2) {
+      double t;
+      Double_t entries = 0, sum = 0;
+      double sumpz = 0;
+      bool merged = Merge("haddbm_out.root", nprocs, t);
+      bool good = merged && Check("haddbm_out.root", entries, sum, sumpz);
+      if (nprocs == 1) {
+         t1 = t;
+         refentries = entries;
+         refsum = sum;
+      }
+      good = good && entries == Double_t(nfiles)*nentries && entries == refentries && sum == refsum;
+      good = good && sumpz == refpz;
+      good = good && CountPartialFiles("haddbm_out.root") == 0;
+      printf("%3d processes: %8.2f s   speedup: %5.2f   %s\n",
+             nprocs, t, t > 0 ? t1 / t : 0, good ? "OK" : "FAILED");
+      ok &= good;
+   }
+
+   gSystem->Unlink("haddbm_out.root");
+   for (int i = 0; i < nfiles; i++) gSystem->Unlink(Form("haddbm_in%d.root", i));
+   return ok ? 0 : 1;
+}
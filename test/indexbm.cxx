@@ -0,0 +1,190 @@
+// @(#)root/test:$Id$
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "Riostream.h"
+#include "TEnv.h"
+#include "TFile.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TVirtualIndex.h"
+//
+// This program benchmarks the tree indices built by TTree::BuildIndex:
+// the TTreeIndex and the TTreeCompactIndex (resource TTreeIndex.Compact),
+// and checks that they give the same entries.
+//
+// Usage: indexbm -h                          - to print a usage info
+//        indexbm [nentries] [nlookups]       - to run the benchmark
+//
+// parameters:
+//       nentries      - number of entries of the tree
+//       nlookups      - number of lookups after the file is opened
+//
+// For each kind of index the time to build it, the time and the number of
+// bytes read to open the file and do the lookups (also with the option
+// MMAP of TFile) and the size of the file are printed. The compact index
+// is then rebuilt and the tree overwritten a few times in the same file:
+// the records of the pages of the replaced index must be freed and reused,
+// the file must not grow by a new index at each rewrite.
+
+int nentries = 2000000;   // Number of entries of the tree.
+int nlookups = 1000;      // Number of lookups.
+
+//_____________________________________________________________
+
+bool MakeFile(const char *name, bool compact, double &seconds)
+{
+   // Create the file name with a tree of run and event numbers, not
+   // in order, and its index.
+
+   TFile f(name, "RECREATE");
+   TRandom3 rnd(4357);
+   TTree *t = new TTree("T", "benchmark tree");
+   Int_t run, event;
+   Float_t x;
+   t->Branch("run", &run, "run/I");
+   t->Branch("event", &event, "event/I");
+   t->Branch("x", &x, "x/F");
+   for (int e = 0; e < nentries; e++) {
+      run = 1000 + (e % 7) * 10 + e / (nentries / 4 + 1);
+      event = e;
+      x = rnd.Gaus();
+      t->Fill();
+   }
+   gEnv->SetValue("TTreeIndex.Compact", compact ? 1 : 0);
+   TStopwatch timer;
+   timer.Start();
+   Int_t n = t->BuildIndex("run", "event");
+   timer.Stop();
+   seconds = timer.RealTime();
+   if (n != nentries) return false;
+   t->Write();
+   return true;
+}
+
+//_____________________________________________________________
+
+bool Lookup(const char *name, const char *option, std::vector<Long64_t> &result, double &seconds, Long64_t &bytes)
+{
+   // Open the file name with option and look up nlookups pairs, half of
+   // them are not in the index.
+
+   TStopwatch timer;
+   timer.Start();
+   TFile *f = TFile::Open(name, option);
+   if (!f || f->IsZombie()) return false;
+   TTree *t = (TTree*)f->Get("T");
+   if (!t || !t->GetTreeIndex()) return false;
+   TRandom3 rnd(65539);
+   result.clear();
+   for (int i = 0; i < nlookups; i++) {
+      Int_t e = rnd.Integer(nentries);
+      Int_t run = 1000 + (e % 7) * 10 + e / (nentries / 4 + 1);
+      if (i % 2) e = -e - 1;
+      result.push_back(t->GetEntryNumberWithIndex(run, e));
+      result.push_back(t->GetTreeIndex()->GetEntryNumberWithBestIndex(run, e));
+   }
+   timer.Stop();
+   seconds = timer.RealTime();
+   bytes = f->GetBytesRead();
+   delete f;
+   return true;
+}
+
+//_____________________________________________________________
+
+bool Rebuild(const char *name, int nrewrites, std::vector<Long64_t> &sizes)
+{
+   // Open the file name in update mode, build the index again and overwrite
+   // the tree, nrewrites times. The size of the file after each rewrite is
+   // appended to sizes.
+
+   for (int i = 0; i < nrewrites; i++) {
+      TFile *f = TFile::Open(name, "UPDATE");
+      if (!f || f->IsZombie()) return false;
+      TTree *t = (TTree*)f->Get("T");
+      if (!t || t->BuildIndex("run", "event") != nentries) {
+         delete f;
+         return false;
+      }
+      t->Write("", TObject::kOverwrite);
+      delete f;
+      Long64_t size = 0;
+      gSystem->GetPathInfo(name, 0, &size, 0, 0);
+      sizes.push_back(size);
+   }
+   return true;
+}
+
+//_____________________________________________________________
+
+int main(int argc,char **argv)
+{
+   if (argc > 1 && !strcmp(argv[1], "-h")) {
+      printf("Usage: indexbm [nentries] [nlookups]\n");
+      printf("  nentries - number of entries of the tree (default %d)\n", nentries);
+      printf("  nlookups - number of lookups (default %d)\n", nlookups);
+      return 0;
+   }
+   if (argc > 1) nentries = atoi(argv[1]);
+   if (argc > 2) nlookups = atoi(argv[2]);
+   if (nentries < 4 || nlookups <= 0) {
+      printf("indexbm: invalid arguments, try indexbm -h\n");
+      return 1;
+   }
+
+   printf("Creating a tree with %d entries\n", nentries);
+   const char *names[2] = { "indexbm_full.root", "indexbm_compact.root" };
+   const char *labels[2] = { "TTreeIndex", "compact" };
+   bool ok = true;
+   std::vector<Long64_t> ref;
+   for (int k = 0; k < 2; k++) {
+      double tbuild;
+      if (!MakeFile(names[k], k == 1, tbuild)) {
+         printf("%-12s cannot build the index\n", labels[k]);
+         ok = false;
+         continue;
+      }
+      Long64_t size = 0;
+      gSystem->GetPathInfo(names[k], 0, &size, 0, 0);
+      const char *options[2] = { "READ", "MMAP" };
+      for (int o = 0; o < 2; o++) {
+         std::vector<Long64_t> result;
+         double tlookup;
+         Long64_t bytes;
+         bool good = Lookup(names[k], options[o], result, tlookup, bytes);
+         if (k == 0 && o == 0) ref = result;
+         good = good && result == ref;
+         printf("%-12s %s build: %6.2f s  open+lookups: %7.3f s  bytes read: %10lld  file: %10lld  %s\n",
+                labels[k], options[o], tbuild, tlookup, bytes, size, good ? "OK" : "FAILED");
+         ok = ok && good;
+      }
+      if (k == 1) {
+         // the first rewrite appends the new pages, the next ones reuse
+         // the records freed by the previous rewrite
+         std::vector<Long64_t> sizes;
+         std::vector<Long64_t> result;
+         double tlookup;
+         Long64_t bytes;
+         bool good = Rebuild(names[k], 3, sizes) && Lookup(names[k], "READ", result, tlookup, bytes);
+         good = good && result == ref && sizes[2] - sizes[0] < (sizes[0] - size) / 2;
+         if (sizes.size() == 3) {
+            printf("%-12s rewrites: file: %10lld %10lld %10lld  %s\n",
+                   labels[k], sizes[0], sizes[1], sizes[2], good ? "OK" : "FAILED");
+         } else {
+            printf("%-12s rewrites: cannot rebuild the index  FAILED\n", labels[k]);
+         }
+         ok = ok && good;
+      }
+   }
+   printf("%s\n", ok ? "OK" : "FAILED");
+
+   gSystem->Unlink(names[0]);
+   gSystem->Unlink(names[1]);
+   return ok ? 0 : 1;
+}
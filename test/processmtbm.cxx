@@ -0,0 +1,217 @@
+// @(#)root/test:$Id$
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Riostream.h"
+#include "TChain.h"
+#include "TFile.h"
+#include "TH1.h"
+#include "TParameter.h"
+#include "TRandom3.h"
+#include "TROOT.h"
+#include "TStopwatch.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TTree.h"
+//
+// This program compares the multithreaded TTree::Process (see
+// TTree::SetImplicitMT) with the sequential one: a selector compiled with
+// ACLiC is run with TTree::Process("processmtbm_sel.C+") on a tree and on
+// a chain of trees, sequentially and with several threads.
+//
+// Usage: processmtbm -h                     - to print a usage info
+//        processmtbm [nentries] [nthreads]  - to run the benchmark
+//
+// parameters:
+//       nentries      - number of entries of each tree
+//       nthreads      - number of threads of the multithreaded runs
+//
+// The selector fills a histogram of x, the number of processed entries and
+// the sum of the entry numbers n, and counts the calls to SlaveBegin. The
+// program fails if the merged outputs of the multithreaded runs differ from
+// those of the sequential runs, or if the multithreaded runs did not use
+// several selector instances.
+
+int nentries = 200000;   // Number of entries of each tree.
+int nthreads = 4;        // Number of threads of the multithreaded runs.
+
+const char *selname = "processmtbm_sel.C";
+
+//_____________________________________________________________
+
+void MakeFile(const char *name, int seed)
+{
+   // Create the file name with a tree of two branches and small clusters.
+
+   TFile f(name, "RECREATE");
+   TRandom3 rnd(seed);
+   TTree *t = new TTree("T", "benchmark tree");
+   Float_t x;
+   Int_t   n;
+   t->Branch("x", &x, "x/F");
+   t->Branch("n", &n, "n/I");
+   t->SetAutoFlush(nentries / 40 > 100 ? nentries / 40 : 100);
+   for (int e = 0; e < nentries; e++) {
+      x = rnd.Gaus(0, 1);
+      n = e;
+      t->Fill();
+   }
+   t->Write();
+}
+
+//_____________________________________________________________
+
+void MakeSelector()
+{
+   // Write the source of the selector. Terminate copies its outputs into
+   // gROOT, with the option of Process appended to their names.
+
+   std::ofstream out(selname);
+   out << "#include \"TSelector.h\"\n"
+          "#include \"TTree.h\"\n"
+          "#include \"TH1.h\"\n"
+          "#include \"TParameter.h\"\n"
+          "#include \"TROOT.h\"\n"
+          "#include \"TString.h\"\n"
+          "\n"
+          "class processmtbm_sel : public TSelector {\n"
+          "public:\n"
+          "   TTree *fChain;\n"
+          "   Float_t fX;\n"
+          "   Int_t fN;\n"
+          "   TH1D *fHist;\n"
+          "   TParameter<Long64_t> *fCount;\n"
+          "   TParameter<Double_t> *fSum;\n"
+          "   TParameter<Int_t> *fSlaves;\n"
+          "\n"
+          "   processmtbm_sel() : fChain(0), fX(0), fN(0), fHist(0), fCount(0), fSum(0), fSlaves(0) {}\n"
+          "   virtual Int_t Version() const { return 2; }\n"
+          "   virtual void Init(TTree *tree) {\n"
+          "      fChain = tree;\n"
+          "      fChain->SetBranchAddress(\"x\", &fX);\n"
+          "      fChain->SetBranchAddress(\"n\", &fN);\n"
+          "   }\n"
+          "   virtual void SlaveBegin(TTree *) {\n"
+          "      fHist = new TH1D(\"hx\", \"x\", 100, -5, 5);\n"
+          "      fCount = new TParameter<Long64_t>(\"count\", 0);\n"
+          "      fSum = new TParameter<Double_t>(\"sum\", 0);\n"
+          "      fSlaves = new TParameter<Int_t>(\"slaves\", 1);\n"
+          "      fOutput->Add(fHist);\n"
+          "      fOutput->Add(fCount);\n"
+          "      fOutput->Add(fSum);\n"
+          "      fOutput->Add(fSlaves);\n"
+          "   }\n"
+          "   virtual Bool_t Process(Long64_t entry) {\n"
+          "      fChain->GetTree()->GetEntry(entry);\n"
+          "      fHist->Fill(fX);\n"
+          "      fCount->SetVal(fCount->GetVal() + 1);\n"
+          "      fSum->SetVal(fSum->GetVal() + fN);\n"
+          "      return kTRUE;\n"
+          "   }\n"
+          "   virtual void Terminate() {\n"
+          "      TIter next(fOutput);\n"
+          "      TObject *obj;\n"
+          "      while ((obj = next())) {\n"
+          "         TNamed *copy = (TNamed*)obj->Clone();\n"
+          "         copy->SetName(TString::Format(\"%s_%s\", obj->GetName(), GetOption()));\n"
+          "         gROOT->Add(copy);\n"
+          "      }\n"
+          "   }\n"
+          "   ClassDef(processmtbm_sel, 0);\n"
+          "};\n";
+}
+
+//_____________________________________________________________
+
+bool Run(TTree *t, int threads, const char *tag, double &seconds)
+{
+   // Process t with the selector with threads threads; the outputs are
+   // in gROOT with the suffix tag.
+
+   TTree::SetImplicitMT(threads);
+   TStopwatch timer;
+   timer.Start();
+   Long64_t status = t->Process(TString::Format("%s+", selname), tag);
+   timer.Stop();
+   TTree::SetImplicitMT(0);
+   seconds = timer.RealTime();
+   return status >= 0 && gROOT->FindObject(TString::Format("hx_%s", tag));
+}
+
+//_____________________________________________________________
+
+bool Compare(const char *ref, const char *tag, int &slaves)
+{
+   // Compare the outputs of the runs ref and tag. slaves is set to the
+   // number of SlaveBegin calls of the run tag.
+
+   TH1D *h1 = (TH1D*)gROOT->FindObject(TString::Format("hx_%s", ref));
+   TH1D *h2 = (TH1D*)gROOT->FindObject(TString::Format("hx_%s", tag));
+   TParameter<Long64_t> *c1 = (TParameter<Long64_t>*)gROOT->FindObject(TString::Format("count_%s", ref));
+   TParameter<Long64_t> *c2 = (TParameter<Long64_t>*)gROOT->FindObject(TString::Format("count_%s", tag));
+   TParameter<Double_t> *s1 = (TParameter<Double_t>*)gROOT->FindObject(TString::Format("sum_%s", ref));
+   TParameter<Double_t> *s2 = (TParameter<Double_t>*)gROOT->FindObject(TString::Format("sum_%s", tag));
+   TParameter<Int_t> *n2 = (TParameter<Int_t>*)gROOT->FindObject(TString::Format("slaves_%s", tag));
+   slaves = n2 ? n2->GetVal() : 0;
+   if (!h1 || !h2 || !c1 || !c2 || !s1 || !s2) return false;
+   if (c1->GetVal() != c2->GetVal() || s1->GetVal() != s2->GetVal()) return false;
+   if (h1->GetEntries() != h2->GetEntries()) return false;
+   for (int i = 0; i <= h1->GetNbinsX() + 1; i++) {
+      if (h1->GetBinContent(i) != h2->GetBinContent(i)) return false;
+   }
+   return true;
+}
+
+//_____________________________________________________________
+
+int main(int argc,char **argv)
+{
+   if (argc > 1 && !strcmp(argv[1], "-h")) {
+      printf("Usage: processmtbm [nentries] [nthreads]\n");
+      printf("  nentries - number of entries of each tree (default %d)\n", nentries);
+      printf("  nthreads - number of threads of the multithreaded runs (default %d)\n", nthreads);
+      return 0;
+   }
+   if (argc > 1) nentries = atoi(argv[1]);
+   if (argc > 2) nthreads = atoi(argv[2]);
+   if (nentries <= 0 || nthreads < 2) {
+      printf("processmtbm: invalid arguments, try processmtbm -h\n");
+      return 1;
+   }
+
+   printf("Creating 3 trees with %d entries\n", nentries);
+   const char *names[3] = { "processmtbm_1.root", "processmtbm_2.root", "processmtbm_3.root" };
+   for (int k = 0; k < 3; k++) MakeFile(names[k], 4357 + k);
+   MakeSelector();
+
+   bool ok = true;
+   for (int k = 0; k < 2; k++) {
+      TFile *f = 0;
+      TTree *t = 0;
+      TChain *chain = 0;
+      if (k == 0) {
+         f = TFile::Open(names[0]);
+         if (f && !f->IsZombie()) t = (TTree*)f->Get("T");
+      } else {
+         t = chain = new TChain("T");
+         for (int i = 0; i < 3; i++) chain->Add(names[i]);
+      }
+      const char *label = k == 0 ? "tree" : "chain";
+      TString seq = TString::Format("%s_seq", label);
+      TString mt = TString::Format("%s_mt", label);
+      double tseq = 0, tmt = 0;
+      int slaves = 0;
+      bool good = t && Run(t, 1, seq, tseq) && Run(t, nthreads, mt, tmt) && Compare(seq, mt, slaves);
+      good = good && slaves > 1;
+      printf("%-6s sequential: %7.3f s  %d threads: %7.3f s  selectors: %2d  %s\n",
+             label, tseq, nthreads, tmt, slaves, good ? "OK" : "FAILED");
+      ok = ok && good;
+      delete chain;
+      delete f;
+   }
+   printf("%s\n", ok ? "OK" : "FAILED");
+
+   for (int k = 0; k < 3; k++) gSystem->Unlink(names[k]);
+   return ok ? 0 : 1;
+}
@@ -0,0 +1,270 @@
+// @(#)root/test:$Id$
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Riostream.h"
+#include "TChain.h"
+#include "TEnv.h"
+#include "TFile.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TTreeReader.h"
+#include "TTreeReaderArray.h"
+#include "TTreeReaderValue.h"
+//
+// This program benchmarks the reading of flat branches of fundamental types
+// with TTreeReaderValue and TTreeReaderArray, which read such branches by
+// columns (resource TTreeReader.Columns), compared to a loop with
+// TTree::SetBranchAddress and TTree::GetEntry.
+//
+// Usage: readerbm -h                  - to print a usage info
+//        readerbm [nentries]          - to run the benchmark
+//
+// parameters:
+//       nentries      - number of entries of the tree
+//
+// The time to read the tree and the number of entries read per second are
+// printed for the SetBranchAddress loop and for TTreeReader without and with
+// the columns, for a tree and for a chain of 3 trees (the columns are set up
+// again for each tree of the chain). The program fails if the sums of the
+// values differ. A friend tree joined by a TTreeIndex, whose entries are in
+// the reverse order, is also read with TTreeReader: its branches must not be
+// read by columns with the entry of the main tree.
+
+int nentries = 2000000;   // Number of entries of the tree.
+
+const int nfiles = 3;
+const char *names[nfiles] = { "readerbm.root", "readerbm_1.root", "readerbm_2.root" };
+const char *friendname = "readerbm_friend.root";
+
+//_____________________________________________________________
+
+void MakeFile(const char *name, int seed)
+{
+   // Create the file name with a tree of flat branches: 3 floats, an int,
+   // a double and a fixed size array.
+
+   TFile f(name, "RECREATE");
+   TRandom3 rnd(seed);
+   TTree *t = new TTree("T", "benchmark tree");
+   Float_t pt, eta, phi;
+   Int_t   n;
+   Double_t w;
+   Float_t p[3];
+   Int_t   id;
+   t->Branch("id", &id, "id/I");
+   t->Branch("pt", &pt, "pt/F");
+   t->Branch("eta", &eta, "eta/F");
+   t->Branch("phi", &phi, "phi/F");
+   t->Branch("n", &n, "n/I");
+   t->Branch("w", &w, "w/D");
+   t->Branch("p", p, "p[3]/F");
+   for (int e = 0; e < nentries; e++) {
+      pt  = rnd.Exp(20);
+      eta = rnd.Gaus(0, 2);
+      phi = rnd.Uniform(-3.14159, 3.14159);
+      n   = e % 17;
+      w   = rnd.Rndm();
+      for (int i = 0; i < 3; i++) p[i] = rnd.Gaus();
+      id  = e;
+      t->Fill();
+   }
+   t->Write();
+}
+
+//_____________________________________________________________
+
+void MakeFriend(const char *name)
+{
+   // Create the file name with a tree F of the entries of the tree of the
+   // first file in the reverse order, indexed by their number id, and a
+   // value v = 3*id+1.
+
+   TFile f(name, "RECREATE");
+   TTree *t = new TTree("F", "friend tree");
+   Int_t id, v;
+   t->Branch("id", &id, "id/I");
+   t->Branch("v", &v, "v/I");
+   for (int e = nentries - 1; e >= 0; e--) {
+      id = e;
+      v  = 3 * e + 1;
+      t->Fill();
+   }
+   t->BuildIndex("id");
+   t->Write();
+}
+
+//_____________________________________________________________
+
+bool ReadFriend(bool columns)
+{
+   // Read the branch id of the tree of the first file and the branch v of
+   // its indexed friend with a TTreeReader, check that v = 3*id+1.
+
+   gEnv->SetValue("TTreeReader.Columns", columns ? 1 : 0);
+   TFile *f = TFile::Open(names[0]);
+   if (!f || f->IsZombie()) return false;
+   TTree *t = (TTree*)f->Get("T");
+   if (!t || !t->AddFriend("F", friendname)) {
+      delete f;
+      return false;
+   }
+   bool good = true;
+   Long64_t nread = 0;
+   {
+      TTreeReader reader(t);
+      TTreeReaderValue<Int_t> id(reader, "id");
+      TTreeReaderValue<Int_t> v(reader, "F.v");
+      while (good && reader.Next()) {
+         good = *v == 3 * *id + 1 && *id == nread;
+         nread++;
+      }
+   }
+   delete f;
+   return good && nread == nentries;
+}
+
+//_____________________________________________________________
+
+TTree *GetTree(bool chain, TFile *&f)
+{
+   // Return the tree of the first file, or a chain of the trees of all the
+   // files. f is the file of the tree, 0 for the chain.
+
+   f = 0;
+   if (chain) {
+      TChain *c = new TChain("T");
+      for (int i = 0; i < nfiles; i++) c->Add(names[i]);
+      return c;
+   }
+   f = TFile::Open(names[0]);
+   if (!f || f->IsZombie()) return 0;
+   return (TTree*)f->Get("T");
+}
+
+//_____________________________________________________________
+
+bool ReadBranchAddress(bool chain, double &seconds, double &sum)
+{
+   // Read all the branches with SetBranchAddress.
+
+   TFile *f;
+   TTree *t = GetTree(chain, f);
+   if (!t) {
+      delete f;
+      return false;
+   }
+   Float_t pt, eta, phi;
+   Int_t   n;
+   Double_t w;
+   Float_t p[3];
+   t->SetBranchAddress("pt", &pt);
+   t->SetBranchAddress("eta", &eta);
+   t->SetBranchAddress("phi", &phi);
+   t->SetBranchAddress("n", &n);
+   t->SetBranchAddress("w", &w);
+   t->SetBranchAddress("p", p);
+   TStopwatch timer;
+   timer.Start();
+   sum = 0;
+   Long64_t nent = t->GetEntries();
+   for (Long64_t e = 0; e < nent; e++) {
+      t->GetEntry(e);
+      sum += pt + eta + phi + n + w + p[0] + p[1] + p[2];
+   }
+   timer.Stop();
+   seconds = timer.RealTime();
+   if (f) delete f;
+   else delete t;
+   return true;
+}
+
+//_____________________________________________________________
+
+bool ReadReader(bool chain, bool columns, double &seconds, double &sum)
+{
+   // Read all the branches with a TTreeReader, with or without the columns.
+
+   gEnv->SetValue("TTreeReader.Columns", columns ? 1 : 0);
+   TFile *f;
+   TTree *t = GetTree(chain, f);
+   if (!t) {
+      delete f;
+      return false;
+   }
+   Long64_t nent = t->GetEntries();
+   bool good;
+   {
+      TTreeReader reader(t);
+      TTreeReaderValue<Float_t> pt(reader, "pt");
+      TTreeReaderValue<Float_t> eta(reader, "eta");
+      TTreeReaderValue<Float_t> phi(reader, "phi");
+      TTreeReaderValue<Int_t> n(reader, "n");
+      TTreeReaderValue<Double_t> w(reader, "w");
+      TTreeReaderArray<Float_t> p(reader, "p");
+      TStopwatch timer;
+      timer.Start();
+      sum = 0;
+      Long64_t nread = 0;
+      while (reader.Next()) {
+         sum += *pt + *eta + *phi + *n + *w + p[0] + p[1] + p[2];
+         nread++;
+      }
+      timer.Stop();
+      seconds = timer.RealTime();
+      good = nread == nent;
+   }
+   if (f) delete f;
+   else delete t;
+   return good;
+}
+
+//_____________________________________________________________
+
+int main(int argc,char **argv)
+{
+   if (argc > 1 && !strcmp(argv[1], "-h")) {
+      printf("Usage: readerbm [nentries]\n");
+      printf("  nentries - number of entries of the tree (default %d)\n", nentries);
+      return 0;
+   }
+   if (argc > 1) nentries = atoi(argv[1]);
+   if (nentries <= 0) {
+      printf("readerbm: invalid arguments, try readerbm -h\n");
+      return 1;
+   }
+
+   printf("Creating %d trees with %d entries\n", nfiles, nentries);
+   for (int i = 0; i < nfiles; i++) MakeFile(names[i], 4357 + i);
+   MakeFriend(friendname);
+
+   const char *labels[3] = { "SetBranchAddress", "TTreeReader", "TTreeReader columns" };
+   bool ok = true;
+   for (int c = 0; c < 2; c++) {
+      double refsum = 0;
+      int ntrees = c == 0 ? 1 : nfiles;
+      for (int k = 0; k < 3; k++) {
+         double seconds = 0, sum = 0;
+         bool good = k == 0 ? ReadBranchAddress(c == 1, seconds, sum) : ReadReader(c == 1, k == 2, seconds, sum);
+         if (k == 0) refsum = sum;
+         good = good && sum == refsum;
+         printf("%-5s %-20s read: %7.3f s  %8.2f Mentries/s  %s\n", c == 0 ? "tree" : "chain", labels[k],
+                seconds, seconds > 0 ? ntrees * (double)nentries / seconds / 1e6 : 0, good ? "OK" : "FAILED");
+         ok = ok && good;
+      }
+   }
+   for (int k = 0; k < 2; k++) {
+      bool good = ReadFriend(k == 1);
+      printf("indexed friend %-20s %s\n", labels[k + 1], good ? "OK" : "FAILED");
+      ok = ok && good;
+   }
+   printf("%s\n", ok ? "OK" : "FAILED");
+
+   for (int i = 0; i < nfiles; i++) gSystem->Unlink(names[i]);
+   gSystem->Unlink(friendname);
+   return ok ? 0 : 1;
+}
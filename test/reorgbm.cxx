@@ -0,0 +1,189 @@
+// @(#)root/test:$Id$
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "Riostream.h"
+#include "TBranch.h"
+#include "TFile.h"
+#include "TFileMerger.h"
+#include "TLeaf.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TTree.h"
+//
+// This program benchmarks the layout of the baskets written by the fast
+// merge with the option SortBasketsByCluster (see TTree::CloneTree and the
+// option -c of hadd): a tree whose baskets are interleaved in the order they
+// were flushed is rewritten so that the baskets of each cluster are
+// contiguous, and the two files are compared.
+//
+// Usage: reorgbm -h                        - to print a usage info
+//        reorgbm [nentries] [nbranches]    - to run the benchmark
+//
+// parameters:
+//       nentries      - number of entries of the tree
+//       nbranches     - number of branches of the tree
+//
+// For each file the number of separate reads ("seeks", i.e. contiguous
+// ranges of baskets) needed to read every cluster is printed, for all the
+// branches and for one branch out of 4, together with the number of read
+// calls and the throughput of the reading of these branches with a TTreeCache.
+// The program fails if the rewritten file does not hold one contiguous
+// range per cluster or if the values read differ.
+
+int nentries  = 200000;   // Number of entries of the tree.
+int nbranches = 40;       // Number of branches of the tree.
+
+//_____________________________________________________________
+
+void MakeFile(const char *name)
+{
+   // Create the file name with a tree of nbranches branches of different
+   // sizes, with small baskets so that the baskets of the different branches
+   // are flushed at different rates and interleaved on disk.
+
+   TFile f(name, "RECREATE");
+   TRandom3 rnd(4357);
+   TTree *t = new TTree("T", "benchmark tree");
+   t->SetAutoFlush(10000);
+   std::vector<Float_t> values(nbranches * 8);
+   for (int b = 0; b < nbranches; b++) {
+      int n = 1 + b % 8;
+      t->Branch(Form("b%d", b), &values[b*8], Form("b%d[%d]/F", b, n), 4000);
+   }
+   for (int e = 0; e < nentries; e++) {
+      for (size_t i = 0; i < values.size(); i++) values[i] = rnd.Gaus();
+      t->Fill();
+   }
+   t->Write();
+}
+
+//_____________________________________________________________
+
+bool Reorganize(const char *input, const char *output)
+{
+   // Rewrite input into output with the baskets sorted by cluster.
+
+   TFileMerger merger(kFALSE, kFALSE);
+   merger.SetPrintLevel(0);
+   merger.SetMergeOptions("SortBasketsByCluster");
+   if (!merger.OutputFile(output, "RECREATE")) return false;
+   if (!merger.AddFile(input, kFALSE)) return false;
+   return merger.Merge();
+}
+
+//_____________________________________________________________
+
+int CountSeeks(TTree *t, int step, int &nclusters)
+{
+   // Return the number of contiguous ranges of baskets of the branches
+   // b0, b<step>, b<2*step>, ... to read the clusters of t one by one.
+
+   std::vector<Long64_t> starts;
+   TTree::TClusterIterator clusterIter = t->GetClusterIterator(0);
+   Long64_t start;
+   while ((start = clusterIter()) < t->GetEntries()) starts.push_back(start);
+   nclusters = starts.size();
+
+   std::vector<std::vector<std::pair<Long64_t,Long64_t> > > ranges(nclusters);
+   for (int b = 0; b < nbranches; b += step) {
+      TBranch *br = t->GetBranch(Form("b%d", b));
+      for (Int_t j = 0; j < br->GetWriteBasket(); j++) {
+         Long64_t seek = br->GetBasketSeek(j);
+         if (seek <= 0) continue;
+         Long64_t entry = br->GetBasketEntry()[j];
+         int c = std::upper_bound(starts.begin(), starts.end(), entry) - starts.begin() - 1;
+         ranges[c].push_back(std::make_pair(seek, seek + br->GetBasketBytes()[j]));
+      }
+   }
+   int nseeks = 0;
+   for (int c = 0; c < nclusters; c++) {
+      std::sort(ranges[c].begin(), ranges[c].end());
+      for (size_t i = 0; i < ranges[c].size(); i++) {
+         if (i == 0 || ranges[c][i].first != ranges[c][i-1].second) nseeks++;
+      }
+   }
+   return nseeks;
+}
+
+//_____________________________________________________________
+
+bool Read(const char *name, int step, const char *label, double &sum)
+{
+   // Read the branches b0, b<step>, ... of the file name with a TTreeCache
+   // and print the number of seeks and read calls and the throughput.
+
+   TFile *f = TFile::Open(name);
+   if (!f || f->IsZombie()) return false;
+   TTree *t = (TTree*)f->Get("T");
+   if (!t) return false;
+   int nclusters;
+   int nseeksall = CountSeeks(t, 1, nclusters);
+   int nseeks = CountSeeks(t, step, nclusters);
+
+   t->SetCacheSize(30000000);
+   t->SetBranchStatus("*", 0);
+   std::vector<Float_t> values(nbranches * 8);
+   for (int b = 0; b < nbranches; b += step) {
+      t->SetBranchStatus(Form("b%d", b), 1);
+      t->SetBranchAddress(Form("b%d", b), &values[b*8]);
+      t->AddBranchToCache(Form("b%d", b));
+   }
+   t->StopCacheLearningPhase();
+
+   TStopwatch timer;
+   timer.Start();
+   Long64_t bytes = 0;
+   sum = 0;
+   for (Long64_t e = 0; e < t->GetEntries(); e++) {
+      bytes += t->GetEntry(e);
+      sum += values[0];
+   }
+   timer.Stop();
+   double rtime = timer.RealTime();
+   printf("%-12s seeks (all branches): %6d  seeks (1/%d branches): %6d  clusters: %4d  read calls: %5d  %8.1f MB/s\n",
+          label, nseeksall, step, nseeks, nclusters, f->GetReadCalls(),
+          rtime > 0 ? bytes / rtime / 1e6 : 0);
+   bool ok = !strcmp(label, "sorted") ? nseeksall == nclusters : true;
+   delete f;
+   return ok;
+}
+
+//_____________________________________________________________
+
+int main(int argc,char **argv)
+{
+   if (argc > 1 && !strcmp(argv[1], "-h")) {
+      printf("Usage: reorgbm [nentries] [nbranches]\n");
+      printf("  nentries  - number of entries of the tree (default %d)\n", nentries);
+      printf("  nbranches - number of branches of the tree (default %d)\n", nbranches);
+      return 0;
+   }
+   if (argc > 1) nentries  = atoi(argv[1]);
+   if (argc > 2) nbranches = atoi(argv[2]);
+   if (nentries <= 0 || nbranches <= 0) {
+      printf("reorgbm: invalid arguments, try reorgbm -h\n");
+      return 1;
+   }
+
+   printf("Creating a tree with %d entries and %d branches\n", nentries, nbranches);
+   MakeFile("reorgbm_in.root");
+   bool ok = Reorganize("reorgbm_in.root", "reorgbm_out.root");
+   if (!ok) printf("reorgbm: the rewriting of the file failed\n");
+
+   double sumin = 0, sumout = 0;
+   ok = ok && Read("reorgbm_in.root", 4, "original", sumin);
+   ok = ok && Read("reorgbm_out.root", 4, "sorted", sumout);
+   ok = ok && sumin == sumout;
+   printf("%s\n", ok ? "OK" : "FAILED");
+
+   gSystem->Unlink("reorgbm_in.root");
+   gSystem->Unlink("reorgbm_out.root");
+   return ok ? 0 : 1;
+}
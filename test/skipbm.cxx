@@ -0,0 +1,189 @@
+// @(#)root/test:$Id$
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Riostream.h"
+#include "TFile.h"
+#include "TRandom3.h"
+#include "TStopwatch.h"
+#include "TString.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TTreePerfStats.h"
+//
+// This program benchmarks the skipping of the baskets by TTree::Draw with
+// the basket statistics (see TTree::SetBasketStatistics): the same tree is
+// written with and without the statistics and a selective TTree::Draw is
+// done on both files.
+//
+// Usage: skipbm -h                  - to print a usage info
+//        skipbm [nentries] [cut]    - to run the benchmark
+//
+// parameters:
+//       nentries      - number of entries of the tree
+//       cut           - cut on the branch pt (pt>cut)
+//
+// The values of pt follow an exponential distribution, except in a few
+// groups of entries where they are much larger, like in a search for rare
+// events in data sorted by time. For each file the time of the TTree::Draw,
+// the number of bytes read and the number of selected entries are printed.
+// The program fails if the selected entries differ, or if the TTree::Draw
+// with the statistics does not read fewer bytes and fewer baskets than the
+// one without (the default cut selects a few groups of entries only). The
+// reads are monitored with a TTreePerfStats whose per branch counters are
+// exported in JSON and CSV, and read back to check them.
+
+int nentries = 2000000;   // Number of entries of the tree.
+double cut   = 500;       // Cut on pt.
+
+//_____________________________________________________________
+
+void MakeFile(const char *name, bool stats)
+{
+   // Create the file name with a tree of 4 branches, with or without the
+   // basket statistics.
+
+   TFile f(name, "RECREATE");
+   TRandom3 rnd(4357);
+   TTree *t = new TTree("T", "benchmark tree");
+   Float_t pt, eta, phi;
+   Int_t   n;
+   t->Branch("pt", &pt, "pt/F");
+   t->Branch("eta", &eta, "eta/F");
+   t->Branch("phi", &phi, "phi/F");
+   t->Branch("n", &n, "n/I");
+   if (stats) t->SetBasketStatistics("*");
+   for (int e = 0; e < nentries; e++) {
+      pt  = rnd.Exp(20);
+      if ((e / 5000) % 97 == 13) pt += 2 * cut * rnd.Rndm();
+      eta = rnd.Gaus(0, 2);
+      phi = rnd.Uniform(-3.14159, 3.14159);
+      n   = e;
+      t->Fill();
+   }
+   t->Write();
+}
+
+//_____________________________________________________________
+
+bool CheckExport(const TTreePerfStats &ps)
+{
+   // Export the counters of ps in CSV and JSON and check the exported
+   // counters against those of ps.
+
+   const char *csvname = "skipbm_perf.csv";
+   const char *jsonname = "skipbm_perf.json";
+   ps.SaveAs(csvname);
+   ps.SaveAs(jsonname);
+   bool ok = ps.GetNbranches() > 0;
+
+   // CSV: a header and one line per branch, in the order of ps
+   std::ifstream csv(csvname);
+   std::string line;
+   ok = ok && std::getline(csv, line) && line.compare(0, 17, "branch,bytes_read") == 0;
+   for (int i = 0; ok && i < ps.GetNbranches(); i++) {
+      ok = !std::getline(csv, line).fail();
+      TString expected = TString::Format("%s,%lld,%d,", ps.GetBranchName(i),
+                                         ps.GetBranchBytesRead(i), ps.GetBranchBaskets(i));
+      ok = ok && TString(line.c_str()).BeginsWith(expected);
+      ok = ok && TString(line.c_str()).CountChar(',') == 9;
+   }
+   ok = ok && !std::getline(csv, line);
+
+   // JSON: the global counters and one object per branch
+   std::ifstream json(jsonname);
+   std::string text;
+   while (std::getline(json, line)) text += line + "\n";
+   TString js(text.c_str());
+   ok = ok && js.BeginsWith("{") && js.Contains("\"branches\": [");
+   ok = ok && js.Contains(TString::Format("\"read_calls\": %d,", ps.GetReadCalls()));
+   ok = ok && js.Contains(TString::Format("\"bytes_read\": %lld,", ps.GetBytesRead()));
+   for (int i = 0; ok && i < ps.GetNbranches(); i++) {
+      ok = js.Contains(TString::Format("{\"name\": \"%s\", \"bytes_read\": %lld, \"baskets_read\": %d,",
+                                       ps.GetBranchName(i), ps.GetBranchBytesRead(i), ps.GetBranchBaskets(i)));
+   }
+   gSystem->Unlink(csvname);
+   gSystem->Unlink(jsonname);
+   return ok;
+}
+
+//_____________________________________________________________
+
+bool Draw(const char *name, double &seconds, Long64_t &bytes, Int_t &baskets, Long64_t &selected, double &sum)
+{
+   // Draw n and eta for the entries with pt>cut and abs(eta)<2.5. baskets
+   // is the number of baskets read, counted by a TTreePerfStats.
+
+   TFile *f = TFile::Open(name);
+   if (!f || f->IsZombie()) return false;
+   TTree *t = (TTree*)f->Get("T");
+   if (!t) return false;
+   Long64_t start = TFile::GetFileBytesRead();
+   TTreePerfStats ps("ioperf", t);
+   TStopwatch timer;
+   timer.Start();
+   selected = t->Draw("n:eta", Form("pt>%g && abs(eta)<2.5", cut), "goff");
+   timer.Stop();
+   seconds = timer.RealTime();
+   bytes = TFile::GetFileBytesRead() - start;
+   sum = 0;
+   for (Long64_t i = 0; i < selected; i++) sum += t->GetV1()[i];
+   baskets = 0;
+   for (Int_t i = 0; i < ps.GetNbranches(); i++) baskets += ps.GetBranchBaskets(i);
+   bool exported = CheckExport(ps);
+   if (!exported) printf("skipbm: the exported TTreePerfStats counters of %s differ\n", name);
+   delete f;
+   return selected >= 0 && exported;
+}
+
+//_____________________________________________________________
+
+int main(int argc,char **argv)
+{
+   if (argc > 1 && !strcmp(argv[1], "-h")) {
+      printf("Usage: skipbm [nentries] [cut]\n");
+      printf("  nentries - number of entries of the tree (default %d)\n", nentries);
+      printf("  cut      - cut on pt (default %g)\n", cut);
+      return 0;
+   }
+   if (argc > 1) nentries = atoi(argv[1]);
+   if (argc > 2) cut = atof(argv[2]);
+   if (nentries <= 0) {
+      printf("skipbm: invalid arguments, try skipbm -h\n");
+      return 1;
+   }
+
+   printf("Creating a tree with %d entries\n", nentries);
+   const char *names[2] = { "skipbm_nostats.root", "skipbm_stats.root" };
+   const char *labels[2] = { "no statistics", "statistics" };
+   bool ok = true;
+   Long64_t refselected = 0, refbytes = 0;
+   Int_t refbaskets = 0;
+   double refsum = 0;
+   for (int k = 0; k < 2; k++) {
+      MakeFile(names[k], k == 1);
+      double seconds, sum;
+      Long64_t bytes, selected;
+      Int_t baskets;
+      bool good = Draw(names[k], seconds, bytes, baskets, selected, sum);
+      if (k == 0) {
+         refselected = selected;
+         refsum = sum;
+         refbytes = bytes;
+         refbaskets = baskets;
+      } else {
+         // the statistics must let the Draw skip baskets
+         good = good && bytes < refbytes && baskets < refbaskets;
+      }
+      good = good && selected == refselected && sum == refsum;
+      printf("%-14s Draw: %7.3f s  bytes read: %10lld  baskets: %6d  selected: %8lld  %s\n",
+             labels[k], seconds, bytes, baskets, selected, good ? "OK" : "FAILED");
+      ok = ok && good;
+   }
+   printf("%s\n", ok ? "OK" : "FAILED");
+
+   gSystem->Unlink(names[0]);
+   gSystem->Unlink(names[1]);
+   return ok ? 0 : 1;
+}
@@ -86,11 +86,14 @@
 #include <TPostScript.h>
 #include <TNtuple.h>
 #include <TTreeCache.h>
+#include <TBufferFile.h>
 #include <TChain.h>
+#include <TVirtualTreePlayer.h>
 #include <TCut.h>
 #include <TCutG.h>
 #include <TEventList.h>
 #include <TBenchmark.h>
+#include <TStopwatch.h>
 #include <TSystem.h>
 #include <TApplication.h>
 #include <TClassTable.h>
@@ -110,6 +113,7 @@ void stress9tree(TTree *tree, Int_t realTestNum);
 void stress9();
 void stress10();
 void stress11();
+void stress11codecs();
 void stress12(Int_t testid);
 void stress13();
 void stress14();
@@ -142,6 +146,11 @@ class TTree;
 
 int gPrintSubBench = 0;
 
+// Compression algorithms used for the 10 files of test 10
+const Int_t kNCodecs = 4;
+const ROOT::ECompressionAlgorithm gCodecs[kNCodecs] = { ROOT::kZLIB, ROOT::kLZMA, ROOT::kLZ4, ROOT::kZSTD };
+const char *gCodecNames[kNCodecs] = { "ZLIB", "LZMA", "LZ4", "ZSTD" };
+
 //_______________________common part_________________________
 
 Double_t ntotin=0, ntotout=0;
@@ -711,6 +720,42 @@ void stress7()
    //Double_t compsum = hcomp.GetSum();
    hall->Add(hpx,-1);
    Double_t compsum = hall->GetSum();
+
+   // Read the px column basket by basket and compare with an explicit loop
+   nt->SetEventList(0);
+   Double_t pxsum = 0, pxsumbulk = 0;
+   for (i=0;i<nall;i++) {
+      nt->GetEntry(i);
+      pxsum += pxr;
+   }
+   TBranch *bpx = nt->GetBranch("px");
+   TBufferFile bulk(TBuffer::kWrite, 32000);
+   Long64_t nbulk = 0;
+   while (nbulk < nall) {
+      Int_t n = bpx->GetBulkEntries(nbulk, bulk);
+      if (n <= 0) break;
+      const Float_t *pxbulk = (const Float_t*)bulk.Buffer();
+      for (Int_t j=0;j<n;j++) pxsumbulk += pxbulk[j];
+      nbulk += n;
+   }
+
+   // Draw an expression with the interpreted and with the compiled formulas
+   // (TTreeFormula::SetJitThreshold is in libTreePlayer, loaded by Draw).
+   // The formulas of the last Draw are kept by the player until the next one,
+   // jitted0 and jitted1 tell which of them were compiled.
+   const char *isJitted = "((TTreeFormula*)%p)->IsJitted() + 2*((TTreeFormula*)%p)->IsJitted();";
+   gROOT->ProcessLine("TTreeFormula::SetJitThreshold(0);");
+   nt->Draw("px*py+sqrt(pz)>>hjit0(100,-5,5)","py<0 || pz>4","goff");
+   Long_t jitted0 = gROOT->ProcessLine(Form(isJitted,(void*)nt->GetPlayer()->GetVar1(),(void*)nt->GetPlayer()->GetSelect()));
+   gROOT->ProcessLine("TTreeFormula::SetJitThreshold(1);");
+   nt->Draw("px*py+sqrt(pz)>>hjit1(100,-5,5)","py<0 || pz>4","goff");
+   Long_t jitted1 = gROOT->ProcessLine(Form(isJitted,(void*)nt->GetPlayer()->GetVar1(),(void*)nt->GetPlayer()->GetSelect()));
+   gROOT->ProcessLine("TTreeFormula::SetJitThreshold();");
+   TH1F *hjit0; gDirectory->GetObject("hjit0",hjit0);
+   TH1F *hjit1; gDirectory->GetObject("hjit1",hjit1);
+   Bool_t jitOK = hjit0 && hjit1 && hjit0->GetEntries() == hjit1->GetEntries()
+                  && TMath::Abs(hjit0->GetMean() - hjit1->GetMean()) < 1e-10
+                  && jitted0 == 0 && jitted1 == 3;
    ntotin  += f.GetBytesRead();
    ntotout += f.GetBytesWritten();
 
@@ -719,6 +764,8 @@ void stress7()
    if (n1 != n2 || n1 != n3 || n3 != nlist || nall !=elistall->GetN()
                 || npxpy != npxpyGood
                 || compsum != 0
+                || nbulk != nall || pxsumbulk != pxsum
+                || !jitOK
                 || TMath::Abs(pxmean0-pxmean2) > 0.1
                 || TMath::Abs(pxrms0-pxrms2) > 0.01) OK = kFALSE;
    if (OK) printf("OK\n");
@@ -727,18 +774,20 @@ void stress7()
       printf("%-8s n1=%d, n2=%d, n3=%d, elistallN=%d\n"," ",n1,n2,n3,elistall->GetN());
       printf("%-8s pxmean0=%g, pxmean2=%g, pxrms0=%g\n"," ",pxmean0,pxmean2,pxrms0);
       printf("%-8s pxrms2=%g, compsum=%g, npxpy=%d\n"," ",pxrms2,compsum,npxpy);
+      printf("%-8s nbulk=%lld, pxsum=%g, pxsumbulk=%g, jitOK=%d, jitted0=%ld, jitted1=%ld\n"," ",nbulk,pxsum,pxsumbulk,jitOK,jitted0,jitted1);
    }
    if (gPrintSubBench) { printf("Test  7 : "); gBenchmark->Show("stress");gBenchmark->Start("stress"); }
 }
 
 //_______________________________________________________________
-Int_t stress8read(Int_t nevent)
+Int_t stress8read(Int_t nevent, Option_t *option = "READ")
 {
 //  Read the event file
 //  Loop on all events in the file (reading everything).
 //  Count number of bytes read
+   // option = option used to open the file (READ or MMAP)
 
-   TFile *hfile = new TFile("Event.root");
+   TFile *hfile = new TFile("Event.root",option);
    TTree *tree; hfile->GetObject("T",tree);
    Event *event = 0;
    tree->SetBranchAddress("event",&event);
@@ -761,13 +810,39 @@ Int_t stress8read(Int_t nevent)
    return nb;
 }
 
+//_______________________________________________________________
+Bool_t stress8unmap()
+{
+//  Read the last event of the mapped event file, remove the mapping with
+//  ReOpen and read the event again from the basket still in memory: the
+//  baskets read in place must have been given a copy of their data.
+
+   TFile *hfile = new TFile("Event.root","MMAP");
+   TTree *tree; hfile->GetObject("T",tree);
+   Event *event = 0;
+   tree->SetBranchAddress("event",&event);
+   Long64_t last = tree->GetEntries() - 1;
+   Bool_t ok = tree->GetEntry(last) > 0 && hfile->IsMapped();
+   Int_t ntrack = event->GetNtrack();
+   Double_t temperature = event->GetTemperature();
+   hfile->ReOpen("UPDATE");
+   event->Clear();
+   ok = ok && !hfile->IsMapped() && tree->GetEntry(last) > 0;
+   ok = ok && event->GetNtrack() == ntrack && event->GetTemperature() == temperature;
+
+   delete event;
+   delete hfile;
+   return ok;
+}
 
 //_______________________________________________________________
-Int_t stress8write(Int_t nevent, Int_t comp, Int_t split)
+Int_t stress8write(Int_t nevent, Int_t comp, Int_t split, Bool_t parallelzip = kFALSE, Long64_t *fileend = 0)
 {
 //  Create the Event file in various modes
    // comp = compression level
    // split = 1 split mode, 0 = no split
+   // parallelzip = compress the baskets in parallel
+   // fileend = if not null, set to the size of the file
 
    // Create the Event file, the Tree and the branches
    TFile *hfile = new TFile("Event.root","RECREATE","TTree benchmark ROOT file");
@@ -779,6 +854,7 @@ Int_t stress8write(Int_t nevent, Int_t comp, Int_t split)
    // Create a ROOT Tree and one superbranch
    TTree *tree = new TTree("T","An example of a ROOT tree");
    tree->SetAutoSave(100000000);  // autosave when 100 Mbytes written
+   if (parallelzip) tree->SetParallelCompression();
    Int_t bufsize = 64000;
    if (split)  bufsize /= 4;
    tree->Branch("event", &event, bufsize,split);
@@ -793,6 +869,7 @@ Int_t stress8write(Int_t nevent, Int_t comp, Int_t split)
    }
    hfile->Write();
    ntotout += hfile->GetBytesWritten();
+   if (fileend) *fileend = hfile->GetEND();
    delete event;
    delete hfile;
    return nb;
@@ -832,6 +909,11 @@ void stress8(Int_t nevent)
    Int_t nbw0 = stress8write(100,0,0);
    Int_t nbr0 = stress8read(0);
    Event::Reset();
+   // and with the file mapped in memory (baskets read in place)
+   Int_t nbr0m = stress8read(0,"MMAP");
+   Event::Reset();
+   Bool_t unmap0 = stress8unmap();
+   Event::Reset();
 
    // Create the file compressed, in no-split mode and read it back
    gRandom->SetSeed(65539);
@@ -840,19 +922,40 @@ void stress8(Int_t nevent)
    Event::Reset();
 
    // Create the file compressed, in split mode and read it back
+   Long64_t end2 = 0;
    gRandom->SetSeed(65539);
-   Int_t nbw2 = stress8write(nevent,1,9);
+   Int_t nbw2 = stress8write(nevent,1,9,kFALSE,&end2);
    Int_t nbr2 = stress8read(0);
    Event::Reset();
 
+   // Same with the baskets compressed in parallel: the file layout must not change
+   Long64_t end3 = 0;
+   gRandom->SetSeed(65539);
+   Int_t nbw3 = stress8write(nevent,1,9,kTRUE,&end3);
+   Int_t nbr3 = stress8read(0);
+   Event::Reset();
+   // and with the file mapped in memory (baskets unzipped from the mapping)
+   Int_t nbr3m = stress8read(0,"MMAP");
+   Event::Reset();
+   // and with the cached baskets read in parallel
+   Int_t depth = TFile::GetReadQueueDepth();
+   TFile::SetReadQueueDepth(8);
+   Int_t nbr3p = stress8read(0);
+   TFile::SetReadQueueDepth(depth);
+   Event::Reset();
+
    Bool_t OK = kTRUE;
    if (nbw0 != nbr0 || nbw1 != nbr1 || nbw2 != nbr2) OK = kFALSE;
    if (nbw0 != nbw1) OK = kFALSE;
+   if (nbw3 != nbw2 || nbr3 != nbr2 || end3 != end2) OK = kFALSE;
+   if (nbr0m != nbr0 || nbr3m != nbr3 || nbr3p != nbr3 || !unmap0) OK = kFALSE;
    if (OK) printf("OK\n");
    else    {
       printf("failed\n");
       printf("%-8s nbw0=%d, nbr0=%d, nbw1=%d\n"," ",nbw0,nbr0,nbw1);
       printf("%-8s nbr1=%d, nbw2=%d, nbr2=%d\n"," ",nbr1,nbw2,nbr2);
+      printf("%-8s nbw3=%d, nbr3=%d, end2=%lld, end3=%lld\n"," ",nbw3,nbr3,end2,end3);
+      printf("%-8s nbr0m=%d, nbr3m=%d, nbr3p=%d, unmap0=%d\n"," ",nbr0m,nbr3m,nbr3p,unmap0);
    }
    if (gPrintSubBench) { printf("Test  8 : "); gBenchmark->Show("stress");gBenchmark->Start("stress"); }
 }
@@ -1203,9 +1306,7 @@ void stress10()
    for (file=0;file<10;file++) {
       snprintf(filename,20,"Event_%d.root",file);
       chfile[file] = new TFile(filename,"recreate");
-      if (file>=5) {
-         chfile[file]->SetCompressionAlgorithm(ROOT::kLZMA);
-      }
+      chfile[file]->SetCompressionAlgorithm(gCodecs[file%kNCodecs]);
       chTree[file] = (TTree*)tree->CloneTree(0);
    }
 
@@ -1274,6 +1375,38 @@ void stress11()
    gROOT->GetList()->Write();
    gROOT->GetList()->Delete();
    ntotout += f.GetBytesWritten();
+   f.Close();
+
+   if (gPrintSubBench) stress11codecs();
+}
+
+//_______________________________________________________________
+void stress11codecs()
+{
+// Compare the read throughput of the compression algorithms
+// used for the 10 files generated in test10.
+
+   printf("Test 11 : read throughput per compression algorithm\n");
+   TStopwatch timer;
+   char filename[20];
+   for (Int_t codec=0;codec<kNCodecs;codec++) {
+      Double_t nbytes = 0, zbytes = 0;
+      timer.Start();
+      for (Int_t file=codec;file<10;file+=kNCodecs) {
+         snprintf(filename,20,"Event_%d.root",file);
+         TFile f(filename);
+         TTree *tree; f.GetObject("T",tree);
+         if (!tree) continue;
+         Long64_t nentries = tree->GetEntries();
+         for (Long64_t entry=0;entry<nentries;entry++) nbytes += tree->GetEntry(entry);
+         zbytes += f.GetBytesRead();
+      }
+      timer.Stop();
+      Double_t rtime = timer.RealTime();
+      printf("          %-5s: %7.2f MB in %6.2f s, %8.2f MB/s, compression factor %5.2f\n",
+             gCodecNames[codec], nbytes/1000000., rtime,
+             rtime > 0 ? nbytes/1000000./rtime : 0., zbytes > 0 ? nbytes/zbytes : 0.);
+   }
 }
 
 //_______________________________________________________________
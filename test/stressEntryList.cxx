@@ -12,6 +12,9 @@
 //               and using ">>+elist" in TTree::Draw
 //   - Test3() - transforming TEventList objects into TEntryList objects for a TChain
 //   - Test4() - same as Test3() but for a TTree
+//   - Test5() - full and empty entry lists
+//   - Test6() - intersecting entry lists, blocks stored as runs of entries
+//               and reading the blocks written by the previous versions
 //
 //   To run in batch mode, do
 //     stressEntryList
@@ -31,13 +34,18 @@
 // Test2: Adding and subtracting entry lists-------------------------- OK
 // Test3: TEntryList and TEventList for TChain------------------------ OK
 // Test4: TEntryList and TEventList for TTree------------------------- OK
+// Test5: Full and Empty TEntryList----------------------------------- OK
+// Test6: Intersect, runs of entries and I/O of TEntryList------------ OK
 // **********************************************************************
 // *******************Deleting the data files****************************
 // **********************************************************************
 
 #include <stdlib.h>
+#include <vector>
 #include "TApplication.h"
+#include "TBufferFile.h"
 #include "TEntryList.h"
+#include "TEntryListBlock.h"
 #include "TEventList.h"
 #include "TTree.h"
 #include "TChain.h"
@@ -513,6 +521,144 @@ Bool_t Test5()
 }
 
 
+Int_t CheckBlock(TEntryListBlock *block, const std::vector<Int_t> &entries)
+{
+   //Return the number of differences between the entries of block, found
+   //with Next(), GetEntry() and Contains(), and the sorted entries
+
+   Int_t wrong = 0;
+   Int_t n = entries.size();
+   if (block->GetNPassed()!=n) wrong++;
+   block->ResetIndices();
+   for (Int_t i=0; i<n; i++){
+      if (block->Next()!=entries[i]) wrong++;
+   }
+   if (block->Next()!=-1) wrong++;
+   //GetEntry() going forward with steps, then backward
+   for (Int_t i=0; i<n; i+=7){
+      if (block->GetEntry(i)!=entries[i]) wrong++;
+   }
+   for (Int_t i=n-1; i>=0; i-=5){
+      if (block->GetEntry(i)!=entries[i]) wrong++;
+   }
+   std::vector<Bool_t> in(64000, kFALSE);
+   for (Int_t i=0; i<n; i++) in[entries[i]] = kTRUE;
+   for (Int_t i=0; i<64000; i++){
+      if ((block->Contains(i)!=0)!=in[i]) wrong++;
+   }
+   return wrong;
+}
+
+Bool_t Test6()
+{
+//Test TEntryList::Intersect(), the blocks stored as runs of entries and
+//the I/O of the blocks: a list with runs written and read back, and blocks
+//written as by the versions before the runs (bits or array, streamed
+//without the custom streamer of TEntryListBlock)
+
+   Int_t wrongentries1=0;
+   Int_t wrongentries2=0;
+   Int_t wrongentries3=0;
+   Int_t wrongentries4=0;
+
+   //Intersect must give the list of the combined selection
+   TChain *chain = new TChain("chain", "chain");
+   chain->Add("stressEntryListTrees*.root/tree1");
+   chain->Add("stressEntryListTrees*.root/tree2");
+   chain->Draw(">>elx", "x<0", "entrylist");
+   chain->Draw(">>ely", "y>0", "entrylist");
+   chain->Draw(">>elxy", "x<0 && y>0", "entrylist");
+   TEntryList *elx = (TEntryList*)gDirectory->Get("elx");
+   TEntryList *ely = (TEntryList*)gDirectory->Get("ely");
+   TEntryList *elxy = (TEntryList*)gDirectory->Get("elxy");
+   elx->Intersect(ely);
+   if (elx->GetN()!=elxy->GetN()) wrongentries1++;
+   for (Long64_t i=0; i<elxy->GetN(); i++){
+      if (elx->GetEntry(i)!=elxy->GetEntry(i)) wrongentries1++;
+   }
+   //the list must still select the same entries of the chain
+   chain->SetEntryList(elx);
+   Long64_t nsel = chain->Draw("x", "", "goff");
+   chain->SetEntryList(0);
+   if (nsel!=chain->Draw("x", "x<0 && y>0", "goff")) wrongentries1++;
+   //printf("wrongentries1=%d\n", wrongentries1);
+
+   //a block with long ranges of entries is stored as runs
+   std::vector<Int_t> runs;
+   for (Int_t i=0; i<64000; i++){
+      if ((i>=100 && i<2000) || (i>=30000 && i<30500) || i==50000 || i>=63000)
+         runs.push_back(i);
+   }
+   TEntryListBlock block;
+   for (UInt_t i=0; i<runs.size(); i++) block.Enter(runs[i]);
+   block.OptimizeStorage();
+   if (block.GetType()!=2) wrongentries2++;
+   wrongentries2 += CheckBlock(&block, runs);
+   //entering an entry goes back to the bits
+   block.Enter(2000);
+   block.Remove(2000);
+   wrongentries2 += CheckBlock(&block, runs);
+   //printf("wrongentries2=%d\n", wrongentries2);
+
+   //a list with blocks stored as runs, written to a file and read back
+   TEntryList *elruns = new TEntryList("elruns", "elruns");
+   Long64_t nruns = 0;
+   for (Long64_t i=0; i<200000; i++){
+      if ((i/1000)%3==0){
+         elruns->Enter(i);
+         nruns++;
+      }
+   }
+   elruns->OptimizeStorage();
+   TFile *f = new TFile("stressEntryListRuns.root", "RECREATE");
+   elruns->Write();
+   delete f;
+   f = new TFile("stressEntryListRuns.root");
+   TEntryList *elread = (TEntryList*)f->Get("elruns");
+   if (!elread || elread->GetN()!=nruns || elruns->GetN()!=nruns) wrongentries3++;
+   for (Long64_t i=0; elread && i<nruns; i++){
+      if (elread->GetEntry(i)!=elruns->GetEntry(i)) wrongentries3++;
+   }
+   for (Long64_t i=0; elread && i<200000; i+=250){
+      if (elread->Contains(i)!=elruns->Contains(i)) wrongentries3++;
+   }
+   delete elread;
+   delete f;
+   delete elruns;
+   gSystem->Unlink("stressEntryListRuns.root");
+   //printf("wrongentries3=%d\n", wrongentries3);
+
+   //blocks written as by the previous versions: an array (few entries)
+   //and bits (many entries)
+   std::vector<Int_t> many;
+   for (Int_t i=0; i<64000; i+=3) many.push_back(i);
+   for (Int_t k=0; k<2; k++){
+      const std::vector<Int_t> &entries = k==0 ? runs : many;
+      TEntryListBlock old;
+      for (UInt_t i=0; i<entries.size(); i++) old.Enter(entries[i]);
+      old.OptimizeStorage(kFALSE);
+      if (old.GetType()!=1-k) wrongentries4++;
+      TBufferFile buf(TBuffer::kWrite);
+      buf.WriteClassBuffer(TEntryListBlock::Class(), &old);
+      buf.SetReadMode();
+      buf.SetBufferOffset(0);
+      TEntryListBlock read;
+      read.Streamer(buf);
+      if (read.GetType()!=1-k) wrongentries4++;
+      wrongentries4 += CheckBlock(&read, entries);
+   }
+   //printf("wrongentries4=%d\n", wrongentries4);
+
+   delete elx;
+   delete ely;
+   delete elxy;
+   delete chain;
+   if (wrongentries1>0 || wrongentries2>0 || wrongentries3>0 || wrongentries4>0)
+      return kFALSE;
+   return kTRUE;
+}
+
+
 void MakeTrees(Int_t nentries, Int_t nfiles)
 {
    //Creates nfiles files with 2 trees of nentries each
@@ -579,6 +725,7 @@ Int_t stressEntryList(Int_t nentries, Int_t nfiles)
    Bool_t ok3=kTRUE;
    Bool_t ok4=kTRUE;
    Bool_t ok5=kTRUE;
+   Bool_t ok6=kTRUE;
 
    ok1 = Test1();
    if (ok1)
@@ -614,6 +761,12 @@ Int_t stressEntryList(Int_t nentries, Int_t nfiles)
    else
       printf("Test5: Full and Empty TEntryList----------------------------------- FAILED\n");
 
+   ok6 = Test6();
+   if (ok6)
+      printf("Test6: Intersect, runs of entries and I/O of TEntryList------------ OK\n");
+   else
+      printf("Test6: Intersect, runs of entries and I/O of TEntryList------------ FAILED\n");
+
    printf("**********************************************************************\n");
    printf("*******************Deleting the data files****************************\n");
    printf("**********************************************************************\n");
@@ -47,7 +47,9 @@
 // Test 14: Integral tests for Histograms....................................OK  //
 // Test 15: TH1-THn[Sparse] Conversion tests.................................OK  //
 // Test 16: Filldata tests for Histograms and THn[Sparse]....................OK  //
-// Test 17: Reference File Read for Histograms and Profiles..................OK  //
+// Test 17: Concurrent fill tests for Histograms and Profiles................OK  //
+// Test 18: FillN tests for Histograms.......................................OK  //
+// Test 19: Reference File Read for Histograms and Profiles..................OK  //
 // ****************************************************************************  //
 // stressHistogram: Real Time =  64.01 seconds Cpu Time =  63.89 seconds         //
 //  ROOTMARKS = 430.74 ROOT version: 5.25/01 branches/dev/mathDev@29787       //
@@ -62,6 +64,7 @@
 #include "TH2.h"
 #include "TH3.h"
 #include "TH2.h"
+#include "TH1ConcurrentFiller.h"
 #include "THn.h"
 #include "THnSparse.h"
 
@@ -87,8 +90,10 @@
 #include "TClass.h"
 
 #include "TROOT.h"
+#include "TThread.h"
 #include <algorithm>
 #include <cassert>
+#include <thread>
 
 using namespace std;
 
@@ -5734,6 +5739,191 @@ bool testMerge1DMixedLimits() {
    return testMerge1DWithBuffer(false);
 }
 
+// Number of threads of the concurrent fill tests
+const int nConcurrentThreads = 4;
+
+struct ConcurrentFillData {
+   // Fill arguments of the concurrent fill tests, shared by the threads
+   std::vector<Double_t> x, y, z, w;
+   int nargs;
+};
+
+void ConcurrentFillWork(TH1 *h, const ConcurrentFillData *d, int ithread, Int_t maxbins, bool *direct)
+{
+   // Fill h with every nConcurrentThreads-th point of d starting at
+   // ithread, through a TH1ConcurrentFiller of this thread
+
+   TH1ConcurrentFiller f(h, maxbins);
+   *direct = f.IsDirect();
+   for ( size_t e = ithread; e < d->x.size(); e += nConcurrentThreads ) {
+      switch (d->nargs) {
+         case 1: f.Fill(d->x[e]); break;
+         case 2: f.Fill(d->x[e], d->w[e]); break;
+         case 3: f.Fill(d->x[e], d->y[e], d->w[e]); break;
+         case 4: f.Fill(d->x[e], d->y[e], d->z[e], d->w[e]); break;
+      }
+   }
+}
+
+bool ConcurrentFill(TH1 *h, const ConcurrentFillData &d, Int_t maxbins, bool expectDirect)
+{
+   // Fill h from nConcurrentThreads threads; returns true if the fillers
+   // did not use the expected mode
+
+   TThread::Initialize();
+   std::vector<std::thread> threads;
+   bool direct[nConcurrentThreads];
+   for ( int i = 0; i < nConcurrentThreads; ++i )
+      threads.push_back(std::thread(ConcurrentFillWork, h, &d, i, maxbins, &direct[i]));
+   for ( int i = 0; i < nConcurrentThreads; ++i )
+      threads[i].join();
+   bool ret = false;
+   for ( int i = 0; i < nConcurrentThreads; ++i )
+      ret |= direct[i] != expectDirect;
+   return ret;
+}
+
+bool testConcurrentFill1D()
+{
+   // Tests filling a 1D Histogram with weights from several threads with
+   // TH1ConcurrentFiller, flushed several times, against filling it directly
+
+   TH1D* h1 = new TH1D("cfill1D-h1", "h1-Title", numberOfBins, minRange, maxRange);
+   TH1D* h2 = new TH1D("cfill1D-h2", "h2-Title", numberOfBins, minRange, maxRange);
+
+   ConcurrentFillData d;
+   d.nargs = 2;
+   for ( Int_t e = 0; e < nEvents * nEvents; ++e ) {
+      d.x.push_back(r.Uniform(0.9 * minRange, 1.1 * maxRange));
+      d.w.push_back(r.Uniform(0.5, 2.));
+      h1->Fill(d.x.back(), d.w.back());
+   }
+   bool ret = ConcurrentFill(h2, d, 5, true);
+
+   ret |= equals("ConcurrentFill1D", h1, h2, cmpOptStats, 1E-10);
+   delete h1;
+   delete h2;
+   return ret;
+}
+
+bool testConcurrentFill2D()
+{
+   // Tests filling a 2D Histogram from several threads with TH1ConcurrentFiller
+
+   TH2D* h1 = new TH2D("cfill2D-h1", "h1-Title",
+                       numberOfBins, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+   TH2D* h2 = new TH2D("cfill2D-h2", "h2-Title",
+                       numberOfBins, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+
+   ConcurrentFillData d;
+   d.nargs = 3;
+   for ( Int_t e = 0; e < nEvents * nEvents; ++e ) {
+      d.x.push_back(r.Uniform(0.9 * minRange, 1.1 * maxRange));
+      d.y.push_back(r.Uniform(0.9 * minRange, 1.1 * maxRange));
+      d.w.push_back(1.);
+      h1->Fill(d.x.back(), d.y.back());
+   }
+   bool ret = ConcurrentFill(h2, d, 50, true);
+
+   ret |= equals("ConcurrentFill2D", h1, h2, cmpOptStats, 1E-10);
+   delete h1;
+   delete h2;
+   return ret;
+}
+
+bool testConcurrentFill3D()
+{
+   // Tests filling a 3D Histogram with weights from several threads with
+   // TH1ConcurrentFiller
+
+   TH3D* h1 = new TH3D("cfill3D-h1", "h1-Title",
+                       numberOfBins, minRange, maxRange,
+                       numberOfBins + 1, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+   TH3D* h2 = new TH3D("cfill3D-h2", "h2-Title",
+                       numberOfBins, minRange, maxRange,
+                       numberOfBins + 1, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+
+   ConcurrentFillData d;
+   d.nargs = 4;
+   for ( Int_t e = 0; e < nEvents * nEvents; ++e ) {
+      d.x.push_back(r.Uniform(0.9 * minRange, 1.1 * maxRange));
+      d.y.push_back(r.Uniform(0.9 * minRange, 1.1 * maxRange));
+      d.z.push_back(r.Uniform(0.9 * minRange, 1.1 * maxRange));
+      d.w.push_back(r.Uniform(0.5, 2.));
+      h1->Fill(d.x.back(), d.y.back(), d.z.back(), d.w.back());
+   }
+   bool ret = ConcurrentFill(h2, d, 100, true);
+
+   ret |= equals("ConcurrentFill3D", h1, h2, cmpOptStats, 1E-10);
+   delete h1;
+   delete h2;
+   return ret;
+}
+
+bool testConcurrentFillProf1D()
+{
+   // Tests filling a 1D Profile (fills replayed) from several threads with
+   // TH1ConcurrentFiller
+
+   TProfile* p1 = new TProfile("cfillProf1D-p1", "p1-Title", numberOfBins, minRange, maxRange);
+   TProfile* p2 = new TProfile("cfillProf1D-p2", "p2-Title", numberOfBins, minRange, maxRange);
+
+   ConcurrentFillData d;
+   d.nargs = 3;
+   for ( Int_t e = 0; e < nEvents * nEvents; ++e ) {
+      d.x.push_back(r.Uniform(0.9 * minRange, 1.1 * maxRange));
+      d.y.push_back(r.Uniform(0.9 * minRange, 1.1 * maxRange));
+      d.w.push_back(r.Uniform(0.5, 2.));
+      p1->Fill(d.x.back(), d.y.back(), d.w.back());
+   }
+   bool ret = ConcurrentFill(p2, d, 10, false);
+
+   ret |= equals("ConcurrentFillProf1D", p1, p2, cmpOptStats, 1E-10);
+   delete p1;
+   delete p2;
+   return ret;
+}
+
+bool testConcurrentFillRange()
+{
+   // Tests that the fillers of a 2D Histogram whose axes have a range keep
+   // the statistics of the entries out of the range, as TH2::Fill
+
+   TH2D* h1 = new TH2D("cfillRange-h1", "h1-Title",
+                       numberOfBins, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+   TH2D* h2 = new TH2D("cfillRange-h2", "h2-Title",
+                       numberOfBins, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+   h1->GetXaxis()->SetRange(2, numberOfBins / 2);
+   h2->GetXaxis()->SetRange(2, numberOfBins / 2);
+   h1->GetYaxis()->SetRange(3, numberOfBins);
+   h2->GetYaxis()->SetRange(3, numberOfBins);
+
+   ConcurrentFillData d;
+   d.nargs = 3;
+   for ( Int_t e = 0; e < nEvents * nEvents; ++e ) {
+      d.x.push_back(r.Uniform(0.9 * minRange, 1.1 * maxRange));
+      d.y.push_back(r.Uniform(0.9 * minRange, 1.1 * maxRange));
+      d.w.push_back(r.Uniform(0.5, 2.));
+      h1->Fill(d.x.back(), d.y.back(), d.w.back());
+   }
+   bool ret = ConcurrentFill(h2, d, 50, true);
+
+   // without the ranges the statistics are those of all the entries
+   h1->GetXaxis()->SetRange(0, 0);
+   h2->GetXaxis()->SetRange(0, 0);
+   h1->GetYaxis()->SetRange(0, 0);
+   h2->GetYaxis()->SetRange(0, 0);
+   ret |= equals("ConcurrentFillRange", h1, h2, cmpOptStats, 1E-10);
+   delete h1;
+   delete h2;
+   return ret;
+}
 
 
 bool testLabel()
@@ -6754,6 +6944,171 @@ bool operator ==(ROOT::Fit::SparseData& sd1, ROOT::Fit::SparseData& sd2)
    return equals;
 }
 
+bool testFillN1D()
+{
+   // Tests TH1::FillN with weights, including underflows, overflows and a
+   // stride, against Fill
+
+   TH1D* h1 = new TH1D("fillN1D-h1", "h1-Title", numberOfBins, minRange, maxRange);
+   TH1D* h2 = new TH1D("fillN1D-h2", "h2-Title", numberOfBins, minRange, maxRange);
+
+   const Int_t n = 3 * nEvents + 1;
+   std::vector<Double_t> xw(2*n);
+   for ( Int_t e = 0; e < n; ++e ) {
+      xw[2*e]   = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      xw[2*e+1] = r.Uniform(0.5, 2.);
+      h1->Fill(xw[2*e], xw[2*e+1]);
+   }
+   h2->FillN(n, &xw[0], &xw[1], 2);
+
+   bool ret = equals("FillN1D", h1, h2, cmpOptStats, 1E-10);
+   delete h1;
+   delete h2;
+   return ret;
+}
+
+bool testFillNVar1D()
+{
+   // Tests TH1::FillN without weights on variable bins against Fill
+
+   Double_t v[numberOfBins+1];
+   FillVariableRange(v);
+
+   TH1D* h1 = new TH1D("fillNVar1D-h1", "h1-Title", numberOfBins, v);
+   TH1D* h2 = new TH1D("fillNVar1D-h2", "h2-Title", numberOfBins, v);
+
+   std::vector<Double_t> x(nEvents);
+   for ( Int_t e = 0; e < nEvents; ++e ) {
+      x[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      h1->Fill(x[e]);
+   }
+   h2->FillN(nEvents, &x[0], (const Double_t*)0);
+
+   bool ret = equals("FillNVar1D", h1, h2, cmpOptStats, 1E-10);
+   delete h1;
+   delete h2;
+   return ret;
+}
+
+bool testFillN2D()
+{
+   // Tests TH2::FillN against Fill
+
+   TH2D* h1 = new TH2D("fillN2D-h1", "h1-Title",
+                       numberOfBins, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+   TH2D* h2 = new TH2D("fillN2D-h2", "h2-Title",
+                       numberOfBins, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+
+   const Int_t n = nEvents * nEvents;
+   std::vector<Double_t> x(n), y(n), w(n);
+   for ( Int_t e = 0; e < n; ++e ) {
+      x[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      y[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      w[e] = r.Uniform(0.5, 2.);
+      h1->Fill(x[e], y[e], w[e]);
+   }
+   h2->FillN(n, &x[0], &y[0], &w[0]);
+
+   bool ret = equals("FillN2D", h1, h2, cmpOptStats, 1E-10);
+   delete h1;
+   delete h2;
+   return ret;
+}
+
+bool testFillN3D()
+{
+   // Tests TH3::FillN against Fill
+
+   TH3D* h1 = new TH3D("fillN3D-h1", "h1-Title",
+                       numberOfBins, minRange, maxRange,
+                       numberOfBins + 1, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+   TH3D* h2 = new TH3D("fillN3D-h2", "h2-Title",
+                       numberOfBins, minRange, maxRange,
+                       numberOfBins + 1, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+
+   const Int_t n = nEvents * nEvents;
+   std::vector<Double_t> x(n), y(n), z(n);
+   for ( Int_t e = 0; e < n; ++e ) {
+      x[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      y[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      z[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      h1->Fill(x[e], y[e], z[e]);
+   }
+   h2->FillN(n, &x[0], &y[0], &z[0], (const Double_t*)0);
+
+   bool ret = equals("FillN3D", h1, h2, cmpOptStats, 1E-10);
+   delete h1;
+   delete h2;
+   return ret;
+}
+
+bool testFillNBuffer1D()
+{
+   // Tests TH1::FillN with weights on an automatic range histogram in
+   // buffer mode, the buffer being filled up several times, against Fill
+
+   TH1D* h1 = new TH1D("fillNBuffer1D-h1", "h1-Title", numberOfBins, 1, 0);
+   TH1D* h2 = new TH1D("fillNBuffer1D-h2", "h2-Title", numberOfBins, 1, 0);
+   h1->SetBuffer(nEvents / 2);
+   h2->SetBuffer(nEvents / 2);
+
+   const Int_t n = 3 * nEvents + 1;
+   std::vector<Double_t> x(n), w(n);
+   for ( Int_t e = 0; e < n; ++e ) {
+      x[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      w[e] = r.Uniform(0.5, 2.);
+      h1->Fill(x[e], w[e]);
+   }
+   h2->FillN(nEvents / 4, &x[0], &w[0]);
+   h2->FillN(n - nEvents / 4, &x[nEvents / 4], &w[nEvents / 4]);
+   h1->BufferEmpty();
+   h2->BufferEmpty();
+
+   bool ret = equals("FillNBuffer1D", h1, h2, cmpOptStats, 1E-10);
+   delete h1;
+   delete h2;
+   return ret;
+}
+
+bool testFillNBuffer3D()
+{
+   // Tests TH3::FillN with weights in buffer mode against Fill
+
+   TH3D* h1 = new TH3D("fillNBuffer3D-h1", "h1-Title",
+                       numberOfBins, minRange, maxRange,
+                       numberOfBins + 1, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+   TH3D* h2 = new TH3D("fillNBuffer3D-h2", "h2-Title",
+                       numberOfBins, minRange, maxRange,
+                       numberOfBins + 1, minRange, maxRange,
+                       numberOfBins + 2, minRange, maxRange);
+   h1->SetBuffer(nEvents);
+   h2->SetBuffer(nEvents);
+
+   const Int_t n = 3 * nEvents + 1;
+   std::vector<Double_t> x(n), y(n), z(n), w(n);
+   for ( Int_t e = 0; e < n; ++e ) {
+      x[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      y[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      z[e] = r.Uniform(0.9 * minRange, 1.1 * maxRange);
+      w[e] = r.Uniform(0.5, 2.);
+      h1->Fill(x[e], y[e], z[e], w[e]);
+   }
+   h2->FillN(n, &x[0], &y[0], &z[0], &w[0]);
+   h1->BufferEmpty();
+   h2->BufferEmpty();
+
+   bool ret = equals("FillNBuffer3D", h1, h2, cmpOptStats, 1E-10);
+   delete h1;
+   delete h2;
+   return ret;
+}
+
+
 bool testSparseData1DFull()
 {
    TF1* func = new TF1( "GAUS", gaus1d, minRange, maxRange, 3);
@@ -9722,9 +10077,33 @@ int stressHistogram()
                                            "FillData tests for Histograms and Sparses........................",
                                            fillDataTestPointer };
 
+   // Test 17
+   // Concurrent Fill Tests
+   const unsigned int numberOfConcurrentFill = 5;
+   pointer2Test concurrentFillTestPointer[numberOfConcurrentFill] = { testConcurrentFill1D,
+                                                                      testConcurrentFill2D,
+                                                                      testConcurrentFill3D,
+                                                                      testConcurrentFillProf1D,
+                                                                      testConcurrentFillRange
+   };
+   struct TTestSuite concurrentFillTestSuite = { numberOfConcurrentFill,
+                                                 "Concurrent fill tests for Histograms and Profiles................",
+                                                 concurrentFillTestPointer };
+
+   // Test 18
+   // FillN Tests
+   const unsigned int numberOfFillN = 6;
+   pointer2Test fillNTestPointer[numberOfFillN] = { testFillN1D,        testFillNVar1D,
+                                                    testFillN2D,        testFillN3D,
+                                                    testFillNBuffer1D,  testFillNBuffer3D
+   };
+   struct TTestSuite fillNTestSuite = { numberOfFillN,
+                                        "FillN tests for Histograms.......................................",
+                                        fillNTestPointer };
+
 
    // Combination of tests
-   const unsigned int numberOfSuits = 14;
+   const unsigned int numberOfSuits = 16;
    struct TTestSuite* testSuite[numberOfSuits];
    testSuite[ 0] = &rangeTestSuite;
    testSuite[ 1] = &rebinTestSuite;
@@ -9740,6 +10119,8 @@ int stressHistogram()
    testSuite[11] = &integralTestSuite;
    testSuite[12] = &conversionsTestSuite;
    testSuite[13] = &fillDataTestSuite;
+   testSuite[14] = &concurrentFillTestSuite;
+   testSuite[15] = &fillNTestSuite;
 
    status = 0;
    for ( unsigned int i = 0; i < numberOfSuits; ++i ) {
@@ -9754,7 +10135,7 @@ int stressHistogram()
    }
    GlobalStatus += status;
 
-   // Test 17
+   // Test 19
    // Reference Tests
    const unsigned int numberOfRefRead = 7;
    pointer2Test refReadTestPointer[numberOfRefRead] = { testRefRead1D,  testRefReadProf1D,
@@ -145,11 +145,13 @@ Int_t stressRooFit(const char* refFile, Bool_t writeRef, Int_t doVerbose, Int_t
   testList.push_back(new TestBasic599(fref,writeRef,doVerbose)) ;
   testList.push_back(new TestBasic601(fref,writeRef,doVerbose)) ;
   testList.push_back(new TestBasic602(fref,writeRef,doVerbose)) ;
+  testList.push_back(new TestBasic603(fref,writeRef,doVerbose)) ;
   testList.push_back(new TestBasic604(fref,writeRef,doVerbose)) ;
   testList.push_back(new TestBasic605(fref,writeRef,doVerbose)) ;
   testList.push_back(new TestBasic606(fref,writeRef,doVerbose)) ;
   testList.push_back(new TestBasic607(fref,writeRef,doVerbose)) ;
   testList.push_back(new TestBasic609(fref,writeRef,doVerbose)) ;
+  testList.push_back(new TestBasic611(fref,writeRef,doVerbose)) ;
   testList.push_back(new TestBasic701(fref,writeRef,doVerbose)) ;
   testList.push_back(new TestBasic702(fref,writeRef,doVerbose)) ;
   testList.push_back(new TestBasic703(fref,writeRef,doVerbose)) ;
@@ -4458,6 +4458,176 @@ public:
 } ;
 /////////////////////////////////////////////////////////////////////////
 //
+// 'LIKELIHOOD AND MINIMIZATION' RooFit tutorial macro #603
+//
+// Parallel calculation of likelihoods and chi2, here with the partitions
+// calculated in threads (UseThreads) and compared with a single thread
+//
+//
+// 07/2008 - Wouter Verkerke
+//
+/////////////////////////////////////////////////////////////////////////
+
+#ifndef __CINT__
+#include "RooGlobalFunc.h"
+#endif
+#include "RooRealVar.h"
+#include "RooDataSet.h"
+#include "RooDataHist.h"
+#include "RooGaussian.h"
+#include "RooPolynomial.h"
+#include "RooAddPdf.h"
+#include "RooProdPdf.h"
+#include "RooFormulaVar.h"
+#include "RooFitResult.h"
+using namespace RooFit ;
+
+
+class TestBasic603 : public RooUnitTest
+{
+public:
+  TestBasic603(TFile* refFile, Bool_t writeRef, Int_t verbose) : RooUnitTest("Multithreaded likelihood and chi2",refFile,writeRef,verbose) {} ;
+
+  Bool_t compareValues(Double_t v1, Double_t v2, const char* what) {
+    // The threads sum the partitions in a different order than a single thread
+    if (fabs(v1-v2) <= 1e-9*(fabs(v1)+fabs(v2))) return kTRUE ;
+    if (_verb>0) cout << "TestBasic603: " << what << " is " << v2 << " with threads and " << v1 << " without" << endl ;
+    return kFALSE ;
+  }
+
+  Bool_t compareFits(const RooFitResult* r1, const RooFitResult* r2, const char* what) {
+    // Compare the values and errors of the parameters of two fits of the same model
+    if (!r1 || !r2 || r1->status()!=0 || r2->status()!=0) {
+      if (_verb>0) cout << "TestBasic603: fit " << what << " failed" << endl ;
+      return kFALSE ;
+    }
+    const RooArgList& p1 = r1->floatParsFinal() ;
+    const RooArgList& p2 = r2->floatParsFinal() ;
+    Bool_t ok = p1.getSize()==p2.getSize() ;
+    for (Int_t i=0 ; ok && i<p1.getSize() ; i++) {
+      RooRealVar* v1 = (RooRealVar*) p1.at(i) ;
+      RooRealVar* v2 = (RooRealVar*) p2.find(v1->GetName()) ;
+      ok = v2 && fabs(v1->getVal()-v2->getVal()) <= 1e-3*v1->getError() &&
+                 fabs(v1->getError()-v2->getError()) <= 1e-3*v1->getError() ;
+      if (!ok && _verb>0) cout << "TestBasic603: parameter " << v1->GetName() << " of fit " << what << " differs with threads" << endl ;
+    }
+    return ok ;
+  }
+
+  Bool_t testCode() {
+
+  // C r e a t e   3 D   p d f   a n d   d a t a
+  // -------------------------------------------
+
+  RooRealVar x("x","x",-5,5) ;
+  RooRealVar y("y","y",-5,5) ;
+  RooRealVar z("z","z",-5,5) ;
+
+  // Create signal pdf gauss(x)*gauss(y)*gauss(z)
+  RooRealVar mx("mx","mx",0,-1,1) ;
+  RooRealVar sx("sx","sx",1,0.5,2) ;
+  RooGaussian gx("gx","gx",x,mx,sx) ;
+  RooGaussian gy("gy","gy",y,RooConst(0),RooConst(1)) ;
+  RooGaussian gz("gz","gz",z,RooConst(0),RooConst(1)) ;
+  RooProdPdf sig("sig","sig",RooArgSet(gx,gy,gz)) ;
+
+  // Create background pdf poly(x)*poly(y)*poly(z)
+  RooRealVar a0("a0","a0",-0.1,-1,1) ;
+  RooPolynomial px("px","px",x,RooArgSet(a0,RooConst(0.004))) ;
+  RooPolynomial py("py","py",y,RooArgSet(RooConst(0.1),RooConst(-0.004))) ;
+  RooPolynomial pz("pz","pz",z) ;
+  RooProdPdf bkg("bkg","bkg",RooArgSet(px,py,pz)) ;
+
+  // Create composite pdf sig+bkg
+  RooRealVar fsig("fsig","signal fraction",0.3,0.,1.) ;
+  RooAddPdf model("model","model",RooArgList(sig,bkg),fsig) ;
+
+  RooDataSet* data = model.generate(RooArgSet(x,y,z),20000) ;
+
+  // Weighted dataset, weights w = x*x+10
+  RooDataSet data2(*data,"data2") ;
+  RooFormulaVar wFunc("w","event weight","(x*x+10)",x) ;
+  RooRealVar* w = (RooRealVar*) data2.addColumn(wFunc) ;
+  RooDataSet wdata(data2.GetName(),data2.GetTitle(),&data2,*data2.get(),0,w->GetName()) ;
+
+  RooArgSet* params = model.getParameters(RooArgSet(x,y,z)) ;
+  RooArgSet* init = (RooArgSet*) params->snapshot() ;
+  Bool_t ok = kTRUE ;
+
+
+  // L i k e l i h o o d   v a l u e s
+  // ---------------------------------
+
+  RooAbsReal* nll1 = model.createNLL(*data) ;
+  RooAbsReal* nll4 = model.createNLL(*data,NumCPU(4),UseThreads()) ;
+  ok &= compareValues(nll1->getVal(),nll4->getVal(),"nll") ;
+  // after a change of the parameters
+  fsig.setVal(0.4) ;
+  mx.setVal(0.1) ;
+  ok &= compareValues(nll1->getVal(),nll4->getVal(),"nll after a parameter change") ;
+  delete nll1 ;
+  delete nll4 ;
+  *params = *init ;
+
+
+  // F i t s   w i t h   a n d   w i t h o u t   t h r e a d s
+  // ---------------------------------------------------------
+
+  RooFitResult* r1 = model.fitTo(*data,Save()) ;
+  *params = *init ;
+  RooFitResult* r4 = model.fitTo(*data,NumCPU(4),UseThreads(),Save()) ;
+  *params = *init ;
+  ok &= compareFits(r1,r4,"unweighted") ;
+  ok &= compareValues(r1->minNll(),r4->minNll(),"minimum of the nll") ;
+  delete r1 ;
+  delete r4 ;
+
+  // Weighted fits with the errors from the sum of the squared weights
+  r1 = model.fitTo(wdata,SumW2Error(kTRUE),Save()) ;
+  *params = *init ;
+  r4 = model.fitTo(wdata,SumW2Error(kTRUE),NumCPU(4),UseThreads(),Save()) ;
+  *params = *init ;
+  ok &= compareFits(r1,r4,"weighted with SumW2Error") ;
+  delete r1 ;
+  delete r4 ;
+
+  // Fits with the likelihood offset
+  r1 = model.fitTo(*data,Offset(kTRUE),Save()) ;
+  *params = *init ;
+  r4 = model.fitTo(*data,Offset(kTRUE),NumCPU(4),UseThreads(),Save()) ;
+  *params = *init ;
+  ok &= compareFits(r1,r4,"with offset") ;
+  delete r1 ;
+  delete r4 ;
+
+
+  // C h i 2   o f   a   b i n n e d   p r o j e c t i o n
+  // -----------------------------------------------------
+
+  RooAddPdf modelx("modelx","modelx",RooArgList(gx,px),fsig) ;
+  RooDataHist dhx("dhx","dhx",x,*data) ;
+  RooAbsReal* chi2_1 = modelx.createChi2(dhx) ;
+  RooAbsReal* chi2_4 = modelx.createChi2(dhx,NumCPU(4),UseThreads()) ;
+  ok &= compareValues(chi2_1->getVal(),chi2_4->getVal(),"chi2") ;
+  delete chi2_1 ;
+  delete chi2_4 ;
+  r1 = modelx.chi2FitTo(dhx,Save()) ;
+  *params = *init ;
+  r4 = modelx.chi2FitTo(dhx,NumCPU(4),UseThreads(),Save()) ;
+  *params = *init ;
+  ok &= compareFits(r1,r4,"chi2") ;
+  delete r1 ;
+  delete r4 ;
+
+  delete params ;
+  delete init ;
+  delete data ;
+
+  return ok ;
+  }
+} ;
+/////////////////////////////////////////////////////////////////////////
+//
 // 'LIKELIHOOD AND MINIMIZATION' RooFit tutorial macro #604
 //
 // Fitting with constraints
@@ -4973,6 +5143,191 @@ public:
 
 
 
+/////////////////////////////////////////////////////////////////////////
+//
+// 'LIKELIHOOD AND MINIMIZATION' RooFit test
+//
+// Batch evaluation of likelihoods (BatchMode) compared with the event by
+// event evaluation
+//
+/////////////////////////////////////////////////////////////////////////
+
+#ifndef __CINT__
+#include "RooGlobalFunc.h"
+#endif
+#include "RooRealVar.h"
+#include "RooDataSet.h"
+#include "RooGaussian.h"
+#include "RooExponential.h"
+#include "RooPolynomial.h"
+#include "RooAddPdf.h"
+#include "RooProdPdf.h"
+#include "RooRealSumPdf.h"
+#include "RooFormulaVar.h"
+#include "RooFitResult.h"
+using namespace RooFit ;
+
+
+class TestBasic611 : public RooUnitTest
+{
+public:
+  TestBasic611(TFile* refFile, Bool_t writeRef, Int_t verbose) : RooUnitTest("Batch evaluation of likelihoods",refFile,writeRef,verbose) {} ;
+
+  Bool_t compareNLL(RooAbsPdf& pdf, RooAbsData& data, Bool_t optimize, RooArgSet& params, const RooCmdArg& arg=RooCmdArg::none()) {
+    // Compare the likelihood of pdf evaluated by batches and event by event,
+    // with and without constant term optimization, before and after a change
+    // of the parameters. The batches use the same expressions in the same
+    // order as the event by event evaluation.
+    RooAbsReal* nll0 = pdf.createNLL(data,arg) ;
+    RooAbsReal* nll1 = pdf.createNLL(data,BatchMode(),arg) ;
+    if (optimize) {
+      nll0->constOptimizeTestStatistic(RooAbsArg::Activate) ;
+      nll1->constOptimizeTestStatistic(RooAbsArg::Activate) ;
+    }
+    RooArgSet* init = (RooArgSet*) params.snapshot() ;
+    Bool_t ok = kTRUE ;
+    for (Int_t k=0 ; k<2 ; k++) {
+      if (k==1) {
+        // change all the parameters by 5%
+        RooFIter iter = params.fwdIterator() ;
+        RooAbsArg* arg2 ;
+        while((arg2=iter.next())) {
+          RooRealVar* par = dynamic_cast<RooRealVar*>(arg2) ;
+          if (par && !par->isConstant()) par->setVal(par->getVal()*1.05) ;
+        }
+      }
+      Double_t v0 = nll0->getVal() ;
+      Double_t v1 = nll1->getVal() ;
+      if (!(fabs(v0-v1) <= 1e-10*fabs(v0))) {
+        if (_verb>0) cout << "TestBasic611: nll of " << pdf.GetName() << " of " << data.GetName() << (optimize ? " with" : " without")
+                          << " optimization is " << v1 << " with batches and " << v0 << " without" << endl ;
+        ok = kFALSE ;
+      }
+    }
+    params = *init ;
+    delete init ;
+    delete nll0 ;
+    delete nll1 ;
+    return ok ;
+  }
+
+  Bool_t compareFits(RooAbsPdf& pdf, RooAbsData& data, RooArgSet& params, const RooCmdArg& arg=RooCmdArg::none()) {
+    // Compare the fits of pdf with batches and event by event
+    RooArgSet* init = (RooArgSet*) params.snapshot() ;
+    RooFitResult* r0 = pdf.fitTo(data,Save(),arg) ;
+    params = *init ;
+    RooFitResult* r1 = pdf.fitTo(data,Save(),BatchMode(),arg) ;
+    params = *init ;
+    delete init ;
+    Bool_t ok = r0 && r1 && r0->status()==0 && r1->status()==0 ;
+    if (ok) {
+      const RooArgList& p0 = r0->floatParsFinal() ;
+      const RooArgList& p1 = r1->floatParsFinal() ;
+      ok = p0.getSize()==p1.getSize() ;
+      for (Int_t i=0 ; ok && i<p0.getSize() ; i++) {
+        RooRealVar* v0 = (RooRealVar*) p0.at(i) ;
+        RooRealVar* v1 = (RooRealVar*) p1.find(v0->GetName()) ;
+        ok = v1 && fabs(v0->getVal()-v1->getVal()) <= 1e-6*v0->getError() &&
+                   fabs(v0->getError()-v1->getError()) <= 1e-6*v0->getError() ;
+      }
+    }
+    if (!ok && _verb>0) cout << "TestBasic611: the fits of " << pdf.GetName() << " of " << data.GetName() << " differ with batches" << endl ;
+    delete r0 ;
+    delete r1 ;
+    return ok ;
+  }
+
+  Bool_t testCode() {
+
+  // S e t u p   m o d e l s
+  // -----------------------
+
+  RooRealVar x("x","x",0,10) ;
+  RooRealVar y("y","y",0,10) ;
+
+  RooRealVar mean("mean","mean",4,0,10) ;
+  RooRealVar sigma("sigma","sigma",1,0.1,5) ;
+  RooGaussian gauss("gauss","gauss",x,mean,sigma) ;
+
+  RooRealVar c("c","c",-0.3,-2.,0.) ;
+  RooExponential expo("expo","expo",x,c) ;
+
+  RooRealVar a1("a1","a1",0.1,-0.1,1) ;
+  RooPolynomial poly("poly","poly",x,RooArgList(a1,RooConst(-0.005))) ;
+
+  RooRealVar frac("frac","frac",0.4,0.,1.) ;
+  RooAddPdf sum("sum","sum",RooArgList(gauss,expo),frac) ;
+
+  // The polynomial in y has constant coefficients: it is cached by the
+  // constant term optimization
+  RooPolynomial polyy("polyy","polyy",y,RooArgList(RooConst(0.05))) ;
+  RooProdPdf prod("prod","prod",RooArgSet(sum,polyy)) ;
+
+  RooRealSumPdf rsum("rsum","rsum",RooArgList(gauss,poly),RooArgList(frac)) ;
+
+  // Conditional p.d.f. of y given x: its normalization depends on the
+  // event, which is evaluated event by event also in batch mode
+  RooRealVar k("k","k",0.5,0.,2.) ;
+  RooFormulaVar meany("meany","@0*@1",RooArgList(k,x)) ;
+  RooGaussian gaussy("gaussy","gaussy",y,meany,sigma) ;
+
+  RooDataSet* data = prod.generate(RooArgSet(x,y),5000) ;
+  data->SetName("unweighted") ;
+
+  // Weighted dataset, weights w = x*x+10
+  RooDataSet data2(*data,"data2") ;
+  RooFormulaVar wFunc("w","event weight","(x*x+10)",x) ;
+  RooRealVar* w = (RooRealVar*) data2.addColumn(wFunc) ;
+  RooDataSet wdata("weighted","weighted",&data2,*data2.get(),0,w->GetName()) ;
+
+  RooArgSet* params = prod.getParameters(RooArgSet(x,y)) ;
+  params->add(a1) ;
+  params->add(k) ;
+
+
+  // L i k e l i h o o d s   w i t h   a n d   w i t h o u t   b a t c h e s
+  // -----------------------------------------------------------------------
+
+  RooAbsPdf* pdfs[6] = { &gauss, &expo, &poly, &sum, &prod, &rsum } ;
+  RooAbsData* datas[2] = { data, &wdata } ;
+  Bool_t ok = kTRUE ;
+  for (Int_t i=0 ; i<6 ; i++) {
+    for (Int_t d=0 ; d<2 ; d++) {
+      ok &= compareNLL(*pdfs[i],*datas[d],kFALSE,*params) ;
+      ok &= compareNLL(*pdfs[i],*datas[d],kTRUE,*params) ;
+    }
+  }
+
+  // Product rearranged for a fit in several ranges
+  x.setRange("low",0,3) ;
+  x.setRange("high",6,10) ;
+  for (Int_t d=0 ; d<2 ; d++) {
+    ok &= compareNLL(prod,*datas[d],kFALSE,*params,Range("low,high")) ;
+    ok &= compareNLL(prod,*datas[d],kTRUE,*params,Range("low,high")) ;
+  }
+
+  // Conditional p.d.f., evaluated event by event
+  ok &= compareNLL(gaussy,*data,kFALSE,*params,ConditionalObservables(x)) ;
+  ok &= compareNLL(gaussy,*data,kTRUE,*params,ConditionalObservables(x)) ;
+
+
+  // F i t s   w i t h   a n d   w i t h o u t   b a t c h e s
+  // ---------------------------------------------------------
+
+  ok &= compareFits(prod,*data,*params) ;
+  ok &= compareFits(prod,*data,*params,Optimize(0)) ;
+  ok &= compareFits(prod,wdata,*params,SumW2Error(kTRUE)) ;
+  ok &= compareFits(rsum,*data,*params) ;
+  ok &= compareFits(gaussy,*data,*params,ConditionalObservables(x)) ;
+
+  delete params ;
+  delete data ;
+
+  return ok ;
+  }
+} ;
+
+
 //////////////////////////////////////////////////////////////////////////
 //
 // 'SPECIAL PDFS' RooFit tutorial macro #701
@@ -0,0 +1,169 @@
+// @(#)root/test:$Id$
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Riostream.h"
+#include "Bytes.h"
+#include "TBufferFile.h"
+#include "TStopwatch.h"
+#include "TString.h"
+//
+// This program benchmarks the speed of TBufferFile::WriteFastArray and
+// TBufferFile::ReadFastArray for the arrays of fundamental types, i.e. of
+// the conversion between the machine and the big endian file representation,
+// and checks the result against the element by element conversion of
+// Bytes.h (tobuf/frombuf): the bytes written must be identical to those of
+// tobuf and the values read back identical to those of frombuf, for the
+// benchmark arrays and for short arrays at unaligned buffer offsets.
+//
+// Usage: tbufbm -h                  - to print a usage info
+//        tbufbm [nvalues] [ntimes]  - to run the benchmark
+//
+// parameters:
+//       nvalues       - number of elements of the arrays
+//       ntimes        - number of times each array is written and read
+//
+// The throughput is given in GB/s of array data (nvalues*sizeof(type)).
+
+int nvalues = 1000000;    // Number of elements of the arrays.
+int ntimes  = 100;        // Number of write/read of each array.
+
+//_____________________________________________________________
+
+template <typename T>
+T Value(int i)
+{
+   // Return the i-th test value, with all its bytes significant.
+
+   return T(i * 37 + 11) * T(1 + 0.125 * (i % 7)) + T(i % 3 ? 0 : -1);
+}
+
+//_____________________________________________________________
+
+template <typename T>
+bool CompareScalar(const T *in, Int_t n, const char *written, const T *read)
+{
+   // Compare the n values written from in and read back into read with
+   // the ones given by tobuf and frombuf.
+
+   char *ref = new char[n * sizeof(T) + 1];
+   char *p = ref;
+   for (Int_t i = 0; i < n; i++) tobuf(p, in[i]);
+   bool ok = memcmp(ref, written, n * sizeof(T)) == 0;
+   p = ref;
+   for (Int_t i = 0; ok && i < n; i++) {
+      T x;
+      frombuf(p, &x);
+      ok = memcmp(&x, &read[i], sizeof(T)) == 0;
+   }
+   delete [] ref;
+   return ok;
+}
+
+//_____________________________________________________________
+
+template <typename T>
+bool CheckShortArrays()
+{
+   // Write and read back arrays of 0 to 67 elements at buffer offsets 0 to
+   // 7, to cover the tails and the unaligned accesses of the vectorized
+   // conversion.
+
+   const Int_t nmax = 67;
+   T in[nmax], out[nmax];
+   for (Int_t i = 0; i < nmax; i++) in[i] = Value<T>(i);
+   for (Int_t offset = 0; offset < 8; offset++) {
+      for (Int_t n = 0; n <= nmax; n++) {
+         TBufferFile buf(TBuffer::kWrite, 1024);
+         buf.SetBufferOffset(offset);
+         buf.WriteFastArray(in, n);
+         buf.SetReadMode();
+         buf.SetBufferOffset(offset);
+         memset(out, 0, sizeof(out));
+         buf.ReadFastArray(out, n);
+         if (!CompareScalar(in, n, buf.Buffer() + offset, out)) return false;
+      }
+   }
+   return true;
+}
+
+//_____________________________________________________________
+
+template <typename T>
+bool BenchArray(const char *name, double &gbwrite, double &gbread)
+{
+   // Write and read back ntimes an array of nvalues elements of type T.
+   // Return false if the values read back differ from the ones written.
+
+   T *in  = new T[nvalues];
+   T *out = new T[nvalues];
+   for (int i = 0; i < nvalues; i++) {
+      in[i]  = Value<T>(i);
+      out[i] = 0;
+   }
+   Int_t size = nvalues * sizeof(T);
+   TBufferFile buf(TBuffer::kWrite, size + 64);
+
+   TStopwatch timer;
+   timer.Start();
+   for (int t = 0; t < ntimes; t++) {
+      buf.SetBufferOffset(0);
+      buf.WriteFastArray(in, nvalues);
+   }
+   timer.Stop();
+   Double_t twrite = timer.RealTime();
+
+   buf.SetReadMode();
+   timer.Start();
+   for (int t = 0; t < ntimes; t++) {
+      buf.SetBufferOffset(0);
+      buf.ReadFastArray(out, nvalues);
+   }
+   timer.Stop();
+   Double_t tread = timer.RealTime();
+
+   bool ok = true;
+   for (int i = 0; i < nvalues; i++) {
+      if (in[i] != out[i]) { ok = false; break; }
+   }
+   ok = ok && CompareScalar(in, nvalues, buf.Buffer(), out) && CheckShortArrays<T>();
+   Double_t gbytes = Double_t(size) * ntimes / 1e9;
+   gbwrite = twrite > 0 ? gbytes / twrite : 0;
+   gbread  = tread  > 0 ? gbytes / tread  : 0;
+   printf("%-10s write: %8.3f GB/s   read: %8.3f GB/s   %s\n",
+          name, gbwrite, gbread, ok ? "OK" : "FAILED");
+
+   delete [] in;
+   delete [] out;
+   return ok;
+}
+
+//_____________________________________________________________
+
+int main(int argc,char **argv)
+{
+   if (argc > 1 && !strcmp(argv[1], "-h")) {
+      printf("Usage: tbufbm [nvalues] [ntimes]\n");
+      printf("  nvalues - number of elements of the arrays (default %d)\n", nvalues);
+      printf("  ntimes  - number of write/read of each array (default %d)\n", ntimes);
+      return 0;
+   }
+   if (argc > 1) nvalues = atoi(argv[1]);
+   if (argc > 2) ntimes  = atoi(argv[2]);
+   if (nvalues <= 0 || nvalues > 100000000 || ntimes <= 0) {
+      printf("tbufbm: invalid arguments, try tbufbm -h\n");
+      return 1;
+   }
+
+   printf("TBufferFile fast array I/O: %d elements, %d times\n", nvalues, ntimes);
+   double w, r;
+   bool ok = true;
+   ok &= BenchArray<Short_t>("Short_t", w, r);
+   ok &= BenchArray<Int_t>("Int_t", w, r);
+   ok &= BenchArray<Long64_t>("Long64_t", w, r);
+   ok &= BenchArray<Float_t>("Float_t", w, r);
+   ok &= BenchArray<Double_t>("Double_t", w, r);
+
+   return ok ? 0 : 1;
+}
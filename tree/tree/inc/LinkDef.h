@@ -29,7 +29,7 @@
 #pragma link C++ class TEntryList-;
 #pragma link C++ class TEntryListArray+;
 #pragma link C++ class TEntryListFromFile+;
-#pragma link C++ class TEntryListBlock+;
+#pragma link C++ class TEntryListBlock-;
 #pragma link C++ class TEventList-;
 #pragma link C++ class TFriendElement+;
 #pragma link C++ class TTreeFriendLeafIter;
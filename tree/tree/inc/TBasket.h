@@ -60,6 +60,8 @@ protected:
    TBuffer    *fCompressedBufferRef; //! Compressed buffer.
    Bool_t      fOwnsCompressedBuffer; //! Whether or not we own the compressed buffer.
    Int_t       fLastWriteBufferSize; //! Size of the buffer last time we wrote it to disk
+   Int_t       fCompressedSize;  //! Size of the data compressed ahead of WriteBuffer (-1 if not done, 0 if not compressible)
+   TBuffer    *fSharedCompressedBufferRef; //! Compressed buffer of the TTree, set aside while using a private one
 
 public:
 
@@ -69,6 +71,7 @@ public:
    virtual ~TBasket();
 
    virtual void    AdjustSize(Int_t newsize);
+           Int_t   CompressBuffer(TFile *file, Bool_t privateBuffer = kFALSE);
    virtual void    DeleteEntryOffset();
    virtual Int_t   DropBuffers();
    TBranch        *GetBranch() const {return fBranch;}
@@ -86,6 +89,7 @@ public:
    virtual void    Reset();
 
            Int_t   LoadBasketBuffers(Long64_t pos, Int_t len, TFile *file, TTree *tree = 0);
+           Int_t   Recompress(Int_t settings);
    Long64_t        CopyTo(TFile *to);
 
            void    SetBranch(TBranch *branch) { fBranch = branch; }
@@ -59,6 +59,7 @@ class TBranch : public TNamed , public TAttFill {
 
 protected:
    friend class TTreeCloner;
+   friend class TTree;
    // TBranch status bits
    enum EStatusBits {
       kAutoDelete = BIT(15),
@@ -91,6 +92,10 @@ protected:
    Int_t      *fBasketBytes;     //[fMaxBaskets] Length of baskets on file
    Long64_t   *fBasketEntry;     //[fMaxBaskets] Table of first entry in each basket
    Long64_t   *fBasketSeek;      //[fMaxBaskets] Addresses of baskets on file
+   Double_t   *fBasketMin;       //[fMaxBaskets] Minimum of the values in each basket (basket statistics)
+   Double_t   *fBasketMax;       //[fMaxBaskets] Maximum of the values in each basket (basket statistics)
+   Double_t    fStatMin;         //! Minimum of the values filled in the current basket
+   Double_t    fStatMax;         //! Maximum of the values filled in the current basket
    TTree      *fTree;            //! Pointer to Tree header
    TBranch    *fMother;          //! Pointer to top-level parent branch in the tree.
    TBranch    *fParent;          //! Pointer to parent branch.
@@ -115,7 +120,11 @@ protected:
    void     SetSkipZip(Bool_t skip = kTRUE) { fSkipZip = skip; }
    void     Init(const char *name, const char *leaflist, Int_t compress);
 
+   void     CopyBasketStatistics(const TBranch *from, Int_t basket, Long64_t startEntry);
    TBasket *GetFreshBasket();
+   void     ResetBasketStatistics(Bool_t unknown);
+   void     StartNewBasket(TBasket* basket);
+   void     UpdateBasketStatistics();
    Int_t    WriteBasket(TBasket* basket, Int_t where);
 
    TString  GetRealFileName() const;
@@ -147,9 +156,12 @@ public:
            TBasket  *GetBasket(Int_t basket);
            Int_t    *GetBasketBytes() const {return fBasketBytes;}
            Long64_t *GetBasketEntry() const {return fBasketEntry;}
+           Double_t *GetBasketMax()   const {return fBasketMax;}
+           Double_t *GetBasketMin()   const {return fBasketMin;}
    virtual Long64_t  GetBasketSeek(Int_t basket) const;
    virtual Int_t     GetBasketSize() const {return fBasketSize;}
    virtual TList    *GetBrowsables();
+           Int_t     GetBulkEntries(Long64_t entry, TBuffer &user_buf);
    virtual const char* GetClassName() const;
            Int_t     GetCompressionAlgorithm() const;
            Int_t     GetCompressionLevel() const;
@@ -200,6 +212,7 @@ public:
    virtual void      SetObject(void *objadd);
    virtual void      SetAutoDelete(Bool_t autodel=kTRUE);
    virtual void      SetBasketSize(Int_t buffsize);
+           Bool_t    SetBasketStatistics(Bool_t enable = kTRUE);
    virtual void      SetBufferAddress(TBuffer *entryBuffer);
    void              SetCompressionAlgorithm(Int_t algorithm=0);
    void              SetCompressionLevel(Int_t level=1);
@@ -219,7 +232,7 @@ public:
 
    static  void      ResetCount();
 
-   ClassDef(TBranch,12);  //Branch descriptor
+   ClassDef(TBranch,13);  //Branch descriptor
 };
 
 //______________________________________________________________________________
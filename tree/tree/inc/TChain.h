@@ -26,6 +26,7 @@
 #endif
 
 class TFile;
+class TTreeCache;
 class TBrowser;
 class TCut;
 class TEntryList;
@@ -45,6 +46,7 @@ protected:
    TObjArray   *fFiles;            //-> List of file names containing the trees (TChainElement, owned)
    TList       *fStatus;           //-> List of active/inactive branches (TChainElement, owned)
    TChain      *fProofChain;       //! chain proxy when going to be processed by PROOF
+   TTreeCache  *fCacheKept;        //! Cache of the previous file kept while the current file can not be opened
 
 private:
    TChain(const TChain&);            // not implemented
@@ -14,21 +14,26 @@
 //
 // Used internally in TEntryList to store the entry numbers.
 //
-// There are 2 ways to represent entry numbers in a TEntryListBlock:
+// There are 3 ways to represent entry numbers in a TEntryListBlock:
 // 1) as bits, where passing entry numbers are assigned 1, not passing - 0
 // 2) as a simple array of entry numbers
-// In both cases, a UShort_t* is used. The second option is better in case
-// less than 1/16 of entries passes the selection, and the representation can be
-// changed by calling OptimizeStorage() function.
+// 3) as runs, i.e. pairs (first, last) of ranges of passing entry numbers
+// In all cases, a UShort_t* is used. The second option is better in case
+// less than 1/16 of entries passes the selection, the third one when the
+// passing entries come in long ranges, and the representation can be
+// changed by calling OptimizeStorage() function. The runs are not written
+// to the file: such a block is written as bits or as an array.
 // When the block is being filled, it's always stored as bits, and the OptimizeStorage()
 // function is called by TEntryList when it starts filling the next block. If
 // Enter() or Remove() is called after OptimizeStorage(), representation is
 // again changed to 1).
 //
 // Operations on blocks (see also function comments):
-// - Merge() - adds all entries from one block to the other. If the first block
-//             uses array representation, it's changed to bits representation only
-//             if the total number of passing entries is still less than kBlockSize
+// - Merge() - adds all entries from one block to the other. Two arrays are
+//             merged if the total number of passing entries is less than
+//             kBlockSize, otherwise the bits are combined 64 at a time
+// - Intersect() - keeps the entries which are also in the other block
+// - Subtract()  - removes the entries which are in the other block
 // - GetEntry(n) - returns n-th non-zero entry.
 // - Next()      - return next non-zero entry. In case of representation 1), Next()
 //                 is faster than GetEntry()
@@ -49,14 +54,19 @@ class TEntryListBlock:public TObject
                          //not in the entry list
    Int_t    fN;          //size of fIndices for I/O  =fNPassed for list, fBlockSize for bits
    UShort_t *fIndices;   //[fN]
-   Int_t    fType;       //0 - bits, 1 - list
+   Int_t    fType;       //0 - bits, 1 - list, 2 - runs (in memory only)
    Bool_t   fPassing;    //1 - stores entries that belong to the list
                          //0 - stores entries that don't belong to the list
    UShort_t fCurrent;    //! to fasten  Contains() in list mode
    Int_t    fLastIndexQueried; //! to optimize GetEntry() in a loop
    Int_t    fLastIndexReturned; //! to optimize GetEntry() in a loop
 
-   void Transform(Bool_t dir, UShort_t *indexnew);
+   void  Filter(TEntryListBlock *block, Bool_t keep);
+   Int_t FindRun(Int_t entry) const;
+   void  GetWords(ULong64_t *words) const;
+   void  SetList(UShort_t *list, Int_t n);
+   void  SetWords(const ULong64_t *words);
+   void  Transform(Bool_t dir, UShort_t *indexnew);
 
  public:
 
@@ -69,8 +79,10 @@ class TEntryListBlock:public TObject
    Bool_t  Enter(Int_t entry);
    Bool_t  Remove(Int_t entry);
    Int_t   Contains(Int_t entry);
-   void    OptimizeStorage();
+   void    OptimizeStorage(Bool_t runs = kTRUE);
    Int_t   Merge(TEntryListBlock *block);
+   Int_t   Intersect(TEntryListBlock *block);
+   Int_t   Subtract(TEntryListBlock *block);
    Int_t   Next();
    Int_t   GetEntry(Int_t entry);
    void    ResetIndices() {fLastIndexQueried = -1, fLastIndexReturned = -1;}
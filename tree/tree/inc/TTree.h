@@ -143,9 +143,13 @@ protected:
    TBuffer       *fTransientBuffer;   //! Pointer to the current transient buffer.
    Bool_t         fCacheDoAutoInit;   //! true if cache auto creation or resize check is needed
    Bool_t         fCacheUserSet;      //! true if the cache setting was explicitly given by user
+   Int_t          fParallelCompress;  //! Maximum number of baskets queued for their parallel compression (0: sequential compression)
+   Bool_t         fCollectBaskets;    //! true while Fill queues the full baskets to compress them in parallel
+   TList         *fBasketsToWrite;    //! Baskets queued for their parallel compression, in writing order
 
    static Int_t     fgBranchStyle;      //  Old/New branch style
    static Long64_t  fgMaxTreeSize;      //  Maximum size of a file containg a Tree
+   static Int_t     fgImplicitMT;       //  Number of threads used by Process (<=1 sequential)
 
 private:
    TTree(const TTree& tt);              // not implemented
@@ -154,6 +158,10 @@ private:
 protected:
    void             AddClone(TTree*);
    virtual void     KeepCircular();
+   Int_t            QueueBasket(TBasket *basket) const;
+   void             WaitQueuedBaskets();
+   Int_t            WriteQueuedBaskets(Int_t nwait) const;
+   static void      RecompressBaskets(TBasket **baskets, Int_t n);
    virtual TBranch *BranchImp(const char* branchname, const char* classname, TClass* ptrClass, void* addobj, Int_t bufsize, Int_t splitlevel);
    virtual TBranch *BranchImp(const char* branchname, TClass* ptrClass, void* addobj, Int_t bufsize, Int_t splitlevel);
    virtual TBranch *BranchImpRef(const char* branchname, const char* classname, TClass* ptrClass, void* addobj, Int_t bufsize, Int_t splitlevel);
@@ -189,6 +197,7 @@ protected:
    friend class TFriendLock;
    // So that the index class can use TFriendLock:
    friend class TTreeIndex;
+   friend class TTreeCompactIndex;
    friend class TChainIndex;
    // So that the TTreeCloner can access the protected interfaces
    friend class TTreeCloner;
@@ -347,6 +356,7 @@ public:
    virtual TBasket        *CreateBasket(TBranch*);
    virtual void            DirectoryAutoAdd(TDirectory *);
    Int_t                   Debug() const { return fDebug; }
+           Bool_t          DeferBasketWrite(TBasket *basket);
    virtual void            Delete(Option_t* option = ""); // *MENU*
    virtual void            Draw(Option_t* opt) { Draw(opt, "", "", 1000000000, 0); }
    virtual Long64_t        Draw(const char* varexp, const TCut& selection, Option_t* option = "", Long64_t nentries = 1000000000, Long64_t firstentry = 0);
@@ -393,6 +403,8 @@ public:
    TH1                    *GetHistogram() { return GetPlayer()->GetHistogram(); }
    virtual Int_t          *GetIndex() { return &fIndex.fArray[0]; }
    virtual Double_t       *GetIndexValues() { return &fIndexValues.fArray[0]; }
+   static  Int_t           GetImplicitMT();
+           Int_t           GetParallelCompression() const { return fParallelCompress; }
    virtual TIterator      *GetIteratorOnAllLeaves(Bool_t dir = kIterForward);
    virtual TLeaf          *GetLeaf(const char* branchname, const char* leafname);
    virtual TLeaf          *GetLeaf(const char* name);
@@ -493,6 +505,7 @@ public:
    virtual void            SetAutoSave(Long64_t autos = 300000000);
    virtual void            SetAutoFlush(Long64_t autof = -30000000);
    virtual void            SetBasketSize(const char* bname, Int_t buffsize = 16000);
+   virtual void            SetBasketStatistics(const char* bname = "*", Bool_t enable = kTRUE);
 #if !defined(__CINT__)
    virtual Int_t           SetBranchAddress(const char *bname,void *add, TBranch **ptr = 0);
 #endif
@@ -527,6 +540,7 @@ public:
    virtual Long64_t        SetEntries(Long64_t n = -1);
    virtual void            SetEstimate(Long64_t nentries = 1000000);
    virtual void            SetFileNumber(Int_t number = 0);
+   static  void            SetImplicitMT(Int_t nthreads = -1);
    virtual void            SetEventList(TEventList* list);
    virtual void            SetEntryList(TEntryList* list, Option_t *opt="");
    virtual void            SetMakeClass(Int_t make);
@@ -536,6 +550,7 @@ public:
    virtual void            SetName(const char* name); // *MENU*
    virtual void            SetNotify(TObject* obj) { fNotify = obj; }
    virtual void            SetObject(const char* name, const char* title);
+   virtual void            SetParallelCompression(Bool_t opt=kTRUE, Int_t maxBaskets=-1);
    virtual void            SetParallelUnzip(Bool_t opt=kTRUE, Float_t RelSize=-1);
    virtual void            SetScanField(Int_t n = 50) { fScanField = n; } // *MENU*
    virtual void            SetTimerInterval(Int_t msec = 333) { fTimerInterval=msec; }
@@ -61,6 +61,16 @@ protected:
    EPrefillType    fPrefillType; // Whether a prefilling is enabled (and if applicable which type)
    static  Int_t   fgLearnEntries; // number of entries used for learning mode
    Bool_t          fAutoSized;   //! true if cache size was calculated automatically
+   Bool_t          fAdaptive;    //! true if the branches and the read-ahead keep being adapted after the learning phase
+   Long64_t        fEntryPrev;   //! first entry of the range filled before the current one (adaptive mode)
+   Int_t           fBufferSizeMax; //! maximum size of the read-ahead in adaptive mode
+   Double_t        fFillTime;    //! time of the last fill of the buffer (adaptive mode)
+   Double_t        fFillReadTime;//! time spent reading the last filled buffer (adaptive mode)
+   Int_t           fNAdded;      //! number of branches added after the learning phase
+   Int_t           fNPruned;     //! number of branches removed after the learning phase
+   TList          *fBrPruned;    //! names of the branches removed after the learning phase (adaptive mode)
+
+   void            PruneBranches();
 
 private:
    TTreeCache(const TTreeCache &);            //this class cannot be copied
@@ -78,6 +88,7 @@ public:
    virtual void         Disable() {fEnabled = kFALSE;}
    virtual void         Enable() {fEnabled = kTRUE;}
    const TObjArray     *GetCachedBranches() const { return fBranches; }
+   Bool_t               GetConfiguredAdaptive() const;
    EPrefillType         GetConfiguredPrefillType() const;
    Double_t             GetEfficiency() const;
    Double_t             GetEfficiencyRel() const;
@@ -86,11 +97,14 @@ public:
    static Int_t         GetLearnEntries();
    virtual EPrefillType GetLearnPrefill() const {return fPrefillType;}
    TTree               *GetTree() const {return fTree;}
+   Int_t                GetBufferSizeMax() const {return fBufferSizeMax;}
+   Bool_t               IsAdaptive() const {return fAdaptive;}
    Bool_t               IsAutoSized() const {return fAutoSized;}
    virtual Bool_t       IsEnabled() const {return fEnabled;}
    virtual Bool_t       IsLearning() const {return fIsLearning;}
 
    virtual Bool_t       FillBuffer();
+   virtual void         LearnBranch(TBranch *b, Bool_t subbranches = kFALSE);
    virtual void         LearnPrefill();
 
    virtual void         Print(Option_t *option="") const;
@@ -98,6 +112,7 @@ public:
    virtual Int_t        ReadBufferNormal(char *buf, Long64_t pos, Int_t len);
    virtual Int_t        ReadBufferPrefetch(char *buf, Long64_t pos, Int_t len);
    virtual void         ResetCache();
+   void                 SetAdaptive(Bool_t adaptive = kTRUE, Int_t maxsize = 0);
    void                 SetAutoSized(Bool_t val) {fAutoSized = val;}
    virtual void         SetEntryRange(Long64_t emin,   Long64_t emax);
    virtual void         SetFile(TFile *file, TFile::ECacheAction action=TFile::kDisconnect);
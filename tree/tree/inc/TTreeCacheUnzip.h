@@ -29,11 +29,8 @@
 #include "TTreeCache.h"
 #endif
 
-#include <queue>
-
 class TTree;
 class TBranch;
-class TThread;
 class TCondition;
 class TBasket;
 class TMutex;
@@ -47,10 +44,8 @@ public:
 protected:
 
    // Members for paral. managing
-   TThread    *fUnzipThread[10];
-   Bool_t      fActiveThread;          // Used to terminate gracefully the unzippers
-   TCondition *fUnzipStartCondition;   // Used to signal the threads to start.
-   TCondition *fUnzipDoneCondition;    // Used to wait for an unzip tour to finish. Gives the Async feel.
+   Bool_t      fActiveThread;          // True while this instance may hand blocks to the unzip pool
+   TCondition *fUnzipDoneCondition;    // Used to wait for an unzip task to finish. Gives the Async feel.
    Bool_t      fParallel;              // Indicate if we want to activate the parallelism (for this instance)
    Bool_t      fAsyncReading;
    TMutex     *fMutexList;             // Mutex to protect the various lists. Used by the condvars.
@@ -58,14 +53,19 @@ protected:
 
    Int_t       fCycle;
    static TTreeCacheUnzip::EParUnzipMode fgParallel;  // Indicate if we want to activate the parallelism
+   static Int_t fgNThreads;            // Requested size of the shared unzip pool (0 = number of cores)
 
    Int_t       fLastReadPos;
-   Int_t       fBlocksToGo;
+   Int_t       fNextToSchedule;        // First block not yet considered for an unzip task in this cycle
+   Int_t       fNTasksInFlight;        // Unzip tasks submitted to the pool and not yet finished
+   Long64_t    fPendingUnzipBytes;     // Estimated unzipped size of the queued and running tasks
+   Double_t    fUnzipRatio;            // Observed ratio unzipped/zipped size, used for the estimate above
 
    // Unzipping related members
    Int_t      *fUnzipLen;         //! [fNseek] Length of the unzipped buffers
    char      **fUnzipChunks;      //! [fNseek] Individual unzipped chunks. Their summed size is kept under control.
-   Byte_t     *fUnzipStatus;      //! [fNSeek] For each blk, tells us if it's unzipped or pending
+   Byte_t     *fUnzipStatus;      //! [fNSeek] For each blk: 0 idle, 1 queued, 2 done, 3 being unzipped
+   Double_t   *fUnzipTimes;       //! [fNseek] Time spent by the unzip pool reading and unzipping each blk
    Long64_t    fTotalUnzipBytes;  //! The total sum of the currently unzipped blks
 
    Int_t       fNseekMax;         //!  fNseek can change so we need to know its max size
@@ -79,8 +79,6 @@ protected:
    Int_t       fNStalls;          //! number of hits which caused a stall
    Int_t       fNMissed;          //! number of blocks that were not found in the cache and were unzipped
 
-   std::queue<Int_t>       fActiveBlks; // The blocks which are active now
-
 private:
    TTreeCacheUnzip(const TTreeCacheUnzip &);            //this class cannot be copied
    TTreeCacheUnzip& operator=(const TTreeCacheUnzip &);
@@ -90,7 +88,10 @@ private:
 
    // Private methods
    void  Init();
-   Int_t StartThreadUnzip(Int_t nthreads);
+   void  ResizeUnzipArrays();
+   void  ReportUnzip(Int_t seekidx, Long64_t pos, Int_t len);
+   void  ScheduleUnzip();
+   Int_t StartThreadUnzip();
    Int_t StopThreadUnzip();
 
 public:
@@ -109,11 +110,13 @@ public:
    static EParUnzipMode GetParallelUnzip();
    static Bool_t        IsParallelUnzip();
    static Int_t         SetParallelUnzip(TTreeCacheUnzip::EParUnzipMode option = TTreeCacheUnzip::kEnable);
+   static Int_t         GetUnzipThreads();
+   static void          SetUnzipThreads(Int_t nthreads);
+   static Int_t         GetUnzipWorkerStats(Int_t worker, Double_t &busytime, Long64_t &ntasks, Long64_t &nstolen);
 
    Bool_t               IsActiveThread();
    Bool_t               IsQueueEmpty();
 
-   void                 WaitUnzipStartSignal();
    void                 SendUnzipStartSignal(Bool_t broadcast);
 
    // Unzipping related methods
@@ -123,7 +126,7 @@ public:
    void           SetUnzipBufferSize(Long64_t bufferSize);
    static void    SetUnzipRelBufferSize(Float_t relbufferSize);
    Int_t          UnzipBuffer(char **dest, char *src);
-   Int_t          UnzipCache(Int_t &startindex, Int_t &locbuffsz, char *&locbuff);
+   Int_t          UnzipCache(Int_t index, Int_t cycle, Long64_t estimate, Int_t &locbuffsz, char *&locbuff);
 
    // Methods to get stats
    Int_t  GetNUnzip() { return fNUnzip; }
@@ -132,8 +135,6 @@ public:
 
    void Print(Option_t* option = "") const;
 
-   // static members
-   static void* UnzipLoop(void *arg);
    ClassDef(TTreeCacheUnzip,0)  //Specialization of TTreeCache for parallel unzipping
 };
 
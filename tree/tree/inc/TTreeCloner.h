@@ -55,17 +55,20 @@ class TTreeCloner {
    Long64_t  *fBasketSeek;       //[fMaxBaskets] list of basket position to be read.
    Long64_t  *fBasketEntry;      //[fMaxBaskets] list of basket start entries.
    UInt_t    *fBasketIndex;      //[fMaxBaskets] ordered list of basket indices to be written.
+   UInt_t    *fBasketCluster;    //[fMaxBaskets] index of the cluster of the basket start entry (SortBasketsByCluster only).
 
    UShort_t   fPidOffset;        //Offset to be added to the copied key/basket.
 
    UInt_t     fCloneMethod;      //Indicates which cloning method was selected.
+   Bool_t     fRecompress;       //True if the baskets are recompressed with the compression of the output branches.
    Long64_t   fToStartEntries;   //Number of entries in the target tree before any addition.
 
    enum ECloneMethod {
       kDefault             = 0,
       kSortBasketsByBranch = 1,
       kSortBasketsByOffset = 2,
-      kSortBasketsByEntry  = 3
+      kSortBasketsByEntry  = 3,
+      kSortBasketsByCluster = 4
    };
 
    class CompareSeek {
@@ -82,8 +85,16 @@ class TTreeCloner {
       Bool_t operator()(UInt_t i1, UInt_t i2);
    };
 
+   class CompareCluster {
+      TTreeCloner *fObject;
+   public:
+      CompareCluster(TTreeCloner *obj) : fObject(obj) {}
+      Bool_t operator()(UInt_t i1, UInt_t i2);
+   };
+
    friend class CompareSeek;
    friend class CompareEntry;
+   friend class CompareCluster;
 
    void ImportClusterRanges();
 
@@ -115,6 +126,7 @@ public:
    Bool_t NeedConversion() { return fNeedConversion; }
    void   SortBaskets();
    void   WriteBaskets();
+   void   WriteBasketsRecompressed();
 
    ClassDef(TTreeCloner,0); // helper used for the fast cloning of TTrees.
 };
@@ -45,7 +45,7 @@ ClassImp(TBasket)
 //
 
 //_______________________________________________________________________
-TBasket::TBasket() : fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0)
+TBasket::TBasket() : fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0), fCompressedSize(-1), fSharedCompressedBufferRef(0)
 {
    // Default contructor.
 
@@ -62,7 +62,7 @@ TBasket::TBasket() : fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLa
 }
 
 //_______________________________________________________________________
-TBasket::TBasket(TDirectory *motherDir) : TKey(motherDir),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0)
+TBasket::TBasket(TDirectory *motherDir) : TKey(motherDir),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0), fCompressedSize(-1), fSharedCompressedBufferRef(0)
 {
    // Constructor used during reading.
    fDisplacement  = 0;
@@ -79,7 +79,7 @@ TBasket::TBasket(TDirectory *motherDir) : TKey(motherDir),fCompressedBufferRef(0
 
 //_______________________________________________________________________
 TBasket::TBasket(const char *name, const char *title, TBranch *branch) :
-   TKey(branch->GetDirectory()),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0)
+   TKey(branch->GetDirectory()),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0), fCompressedSize(-1), fSharedCompressedBufferRef(0)
 {
    // Basket normal constructor, used during writing.
 
@@ -122,6 +122,17 @@ TBasket::TBasket(const char *name, const char *title, TBranch *branch) :
    branch->GetTree()->IncrementTotalBuffers(fBufferSize);
 }
 
+//_______________________________________________________________________
+static inline void R__DetachMappedBuffer(TBuffer *buf)
+{
+   // Unregister buf from the memory mapped file it points into, if any
+   // (see TFile::AttachMappedBuffer), before it is deleted or reused.
+
+   if (R__unlikely(buf && buf->TestBit(TBufferFile::kMappedFile))) {
+      ((TFile*)buf->GetParent())->DetachMappedBuffer(buf);
+   }
+}
+
 //_______________________________________________________________________
 TBasket::~TBasket()
 {
@@ -129,6 +140,7 @@ TBasket::~TBasket()
 
    if (fDisplacement) delete [] fDisplacement;
    if (fEntryOffset)  delete [] fEntryOffset;
+   R__DetachMappedBuffer(fBufferRef);
    if (fBufferRef) delete fBufferRef;
    fBufferRef = 0;
    fBuffer = 0;
@@ -193,6 +205,7 @@ Int_t TBasket::DropBuffers()
 
    if (fDisplacement) delete [] fDisplacement;
    if (fEntryOffset)  delete [] fEntryOffset;
+   R__DetachMappedBuffer(fBufferRef);
    if (fBufferRef)    delete fBufferRef;
    if (fCompressedBufferRef && fOwnsCompressedBuffer) delete fCompressedBufferRef;
    fBufferRef   = 0;
@@ -275,6 +288,89 @@ Int_t TBasket::LoadBasketBuffers(Long64_t pos, Int_t len, TFile *file, TTree *tr
    return 0;
 }
 
+//_______________________________________________________________________
+Int_t TBasket::Recompress(Int_t settings)
+{
+   // Change the compression of a basket loaded by LoadBasketBuffers (key
+   // and data as read from the file) to the compression settings (see
+   // TFile::SetCompressionSettings). The data is unzipped and zipped
+   // again in a new buffer without being unstreamed: the entries and
+   // offsets are unchanged. CopyTo then writes the basket with its new size.
+   // Only the buffers of this basket are used, so that several baskets can
+   // be recompressed in parallel.
+   // Returns the new size of the data, or -1 in case of error (the basket
+   // is then left unchanged).
+
+   if (!fBufferRef || fObjlen <= 0) return -1;
+   char *raw = fBufferRef->Buffer();
+   Int_t nbytes = fNbytes - fKeylen;
+
+   // Unzip the data if needed.
+   char *objbuf = raw + fKeylen;
+   char *unzipped = 0;
+   if (fObjlen > nbytes) {
+      unzipped = new char[fObjlen];
+      UChar_t *src = (UChar_t*)raw + fKeylen;
+      Int_t noutot = 0;
+      while (noutot < fObjlen) {
+         Int_t nin, nbuf, nout = 0;
+         if (R__unzip_header(&nin, src, &nbuf) != 0) break;
+         if (noutot + nbuf > fObjlen) break;
+         R__unzip(&nin, src, &nbuf, (UChar_t*)unzipped + noutot, &nout);
+         if (!nout) break;
+         noutot += nout;
+         src += nin;
+      }
+      if (noutot != fObjlen) {
+         Error("Recompress", "cannot unzip the basket at %lld (fNbytes=%d, fKeylen=%d, fObjlen=%d)",
+               fSeekKey, fNbytes, fKeylen, fObjlen);
+         delete [] unzipped;
+         return -1;
+      }
+      objbuf = unzipped;
+   }
+
+   // Zip it with the new settings, as in CompressBuffer.
+   Int_t cxlevel = settings < 0 ? 1 : settings % 100;
+   Int_t cxAlgorithm = settings < 0 ? 0 : settings / 100;
+   Int_t nbuffers = 1 + (fObjlen - 1) / kMAXZIPBUF;
+   Int_t buflen = fKeylen + fObjlen + 9 * nbuffers + 28;
+   TBufferFile *zipped = new TBufferFile(TBuffer::kWrite, buflen);
+   zipped->SetParent(fBufferRef->GetParent());
+   char *dest = zipped->Buffer();
+   memcpy(dest, raw, fKeylen);
+   Int_t noutot = 0;
+   if (cxlevel > 0) {
+      char *bufcur = dest + fKeylen;
+      Int_t nzip = 0;
+      for (Int_t i = 0; i < nbuffers; ++i) {
+         Int_t bufmax = (i == nbuffers - 1) ? fObjlen - nzip : kMAXZIPBUF;
+         Int_t nout = 0;
+         R__zipMultipleAlgorithm(cxlevel, &bufmax, objbuf + nzip, &bufmax, bufcur, &nout, cxAlgorithm);
+         if (nout == 0 || noutot + nout >= fObjlen) {
+            noutot = 0;
+            break;
+         }
+         bufcur += nout;
+         noutot += nout;
+         nzip   += kMAXZIPBUF;
+      }
+   }
+   if (noutot == 0) {
+      // Not compressed, or not compressible: keep the data as is.
+      memcpy(dest + fKeylen, objbuf, fObjlen);
+      noutot = fObjlen;
+   }
+   delete [] unzipped;
+
+   R__DetachMappedBuffer(fBufferRef);
+   delete fBufferRef;
+   fBufferRef = zipped;
+   fBuffer = dest;
+   fNbytes = fKeylen + noutot;
+   return noutot;
+}
+
 //_______________________________________________________________________
 void TBasket::MoveEntries(Int_t dentries)
 {
@@ -349,6 +445,7 @@ Int_t TBasket::ReadBasketBuffersUnzip(char* buffer, Int_t size, Bool_t mustFree,
 {
    // We always create the TBuffer for the basket but it hold the buffer from the cache.
    if (fBufferRef) {
+      R__DetachMappedBuffer(fBufferRef);
       fBufferRef->SetBuffer(buffer, size, mustFree);
       fBufferRef->SetReadMode();
       fBufferRef->Reset();
@@ -380,6 +477,11 @@ static inline TBuffer* R__InitializeReadBasketBuffer(TBuffer* bufferRef, Int_t l
 
    TBuffer* result;
    if (R__likely(bufferRef)) {
+      if (R__unlikely(!bufferRef->TestBit(TBuffer::kIsOwner))) {
+         // The buffer is not ours (e.g. it points into a memory mapped file)
+         R__DetachMappedBuffer(bufferRef);
+         bufferRef->SetBuffer(new char[len], len, kTRUE);
+      }
       bufferRef->SetReadMode();
       Int_t curBufferSize = bufferRef->BufferSize();
       if (curBufferSize < len) {
@@ -429,7 +531,7 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
    }
 
    Bool_t oldCase;
-   char *rawUncompressedBuffer, *rawCompressedBuffer;
+   char *rawUncompressedBuffer, *rawCompressedBuffer, *mapped;
    Int_t uncompressedBufferLen;
 
    // See if the cache has already unzipped the buffer for us.
@@ -440,6 +542,9 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       char *buffer;
       res = pf->GetUnzipBuffer(&buffer, pos, len, &free);
       if (R__unlikely(res >= 0)) {
+         if (R__unlikely(gPerfStats)) {
+            gPerfStats->BasketReadEvent(fBranch,pos,len,TVirtualPerfStats::kBasketFromCache);
+         }
          len = ReadBasketBuffersUnzip(buffer, res, free, file);
          // Note that in the kNotDecompressed case, the above function will return 0;
          // In such a case, we should stop processing
@@ -448,6 +553,42 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       }
    }
 
+   // A memory mapped file gives a direct access to the basket: it is unzipped
+   // from the mapping or, if not compressed, used in place.
+   mapped = TestBit(TBufferFile::kNotDecompressed) ? 0 : file->GetMappedBuffer(pos, len);
+   if (mapped) {
+      // Let the cache prefetch (advise) the next baskets.
+      if (pf) pf->ReadBuffer(0, pos, len);
+      fBranch->GetTree()->IncrementTotalBuffers(-fBufferSize);
+      {
+         TBufferFile header(TBuffer::kRead, len, mapped, kFALSE);
+         header.SetParent(file);
+         Streamer(header);
+      }
+      if (IsZombie()) {
+         return 1;
+      }
+      if (R__unlikely(gPerfStats)) {
+         gPerfStats->BasketReadEvent(fBranch,pos,len,TVirtualPerfStats::kBasketMapped);
+      }
+      if (fObjlen+fKeylen == fNbytes) {
+         // Not compressed, read the data in place.
+         if (fBufferRef) {
+            fBufferRef->SetBuffer(mapped, len, kFALSE);
+            fBufferRef->SetReadMode();
+         } else {
+            fBufferRef = new TBufferFile(TBuffer::kRead, len, mapped, kFALSE);
+         }
+         // Let the file copy the data if it is unmapped while we use it.
+         file->AttachMappedBuffer(fBufferRef);
+         fBufferRef->SetBufferOffset(fKeylen);
+         fBuffer = mapped;
+         goto AfterBuffer;
+      }
+      rawCompressedBuffer = mapped;
+      goto Unzip;
+   }
+
    // Determine which buffer to use, so that we can avoid a memcpy in case of
    // the basket was not compressed.
    TBuffer* readBufferRef;
@@ -470,6 +611,10 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
 
    if (pf) {
       Int_t st = pf->ReadBuffer(readBufferRef->Buffer(),pos,len);
+      if (R__unlikely(gPerfStats) && st >= 0) {
+         gPerfStats->BasketReadEvent(fBranch,pos,len,st ? TVirtualPerfStats::kBasketFromCache
+                                                        : TVirtualPerfStats::kBasketCacheMiss);
+      }
       if (st < 0) {
          return 1;
       } else if (st == 0) {
@@ -491,6 +636,9 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       if (file->ReadBuffer(readBufferRef->Buffer(),pos,len)) {
          return 1;
       }
+      if (R__unlikely(gPerfStats)) {
+         gPerfStats->BasketReadEvent(fBranch,pos,len,TVirtualPerfStats::kBasketNoCache);
+      }
    }
    Streamer(*readBufferRef);
    if (IsZombie()) {
@@ -519,6 +667,7 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       }
    }
 
+Unzip:
    // Initialize buffer to hold the uncompressed data
    // Note that in previous versions we didn't allocate buffers until we verified
    // the zip headers; this is no longer beforehand as the buffer lifetime is scoped
@@ -578,6 +727,7 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       len = fObjlen+fKeylen;
       if (R__unlikely(gPerfStats)) {
          gPerfStats->UnzipEvent(fBranch->GetTree(),pos,start,nintot,fObjlen);
+         gPerfStats->BasketUnzipEvent(fBranch,pos,start,nintot,fObjlen);
       }
    } else {
       // Nothing is compressed - copy over wholesale.
@@ -890,45 +1040,20 @@ void TBasket::Update(Int_t offset, Int_t skipped)
 }
 
 //_______________________________________________________________________
-Int_t TBasket::WriteBuffer()
+Int_t TBasket::CompressBuffer(TFile *file, Bool_t privateBuffer)
 {
-   // Write buffer of this basket on the current file.
+   // Close the basket for writing: transfer the fEntryOffset table at the
+   // end of the buffer and compress the buffer in fCompressedBufferRef.
+   // This is the first part of WriteBuffer; it does not access the file and
+   // can be run for several baskets in parallel, in which case each basket
+   // must use a privateBuffer (instead of the compressed buffer shared by all
+   // the baskets of the TTree). The next call to WriteBuffer then only
+   // writes the compressed data.
    //
-   // The function returns the number of bytes committed to the memory.
-   // If a write error occurs, the number of bytes returned is -1.
-   // If no data are written, the number of bytes returned is 0.
-   //
-
-   const Int_t kWrite = 1;
-
-   TFile *file = fBranch->GetFile(kWrite);
-   if (!file) return 0;
-   if (!file->IsWritable()) {
-      return -1;
-   }
-   fMotherDir = file; // fBranch->GetDirectory();
-
-   if (R__unlikely(fBufferRef->TestBit(TBufferFile::kNotDecompressed))) {
-      // Read the basket information that was saved inside the buffer.
-      Bool_t writing = fBufferRef->IsWriting();
-      fBufferRef->SetReadMode();
-      fBufferRef->SetBufferOffset(0);
-
-      Streamer(*fBufferRef);
-      if (writing) fBufferRef->SetWriteMode();
-      Int_t nout = fNbytes - fKeylen;
-
-      fBuffer = fBufferRef->Buffer();
-
-      Create(nout,file);
-      fBufferRef->SetBufferOffset(0);
-      fHeaderOnly = kTRUE;
-
-      Streamer(*fBufferRef);         //write key itself again
-      int nBytes = WriteFileKeepBuffer();
-      fHeaderOnly = kFALSE;
-      return nBytes>0 ? fKeylen+nout : -1;
-   }
+   // Returns the size of the compressed data, 0 if the data is not
+   // compressed (compression level 0 or compression not reducing the size)
+   // and -1 in case of error. With privateBuffer the result is also kept
+   // for WriteBuffer (-2 for an error).
 
    // Transfer fEntryOffset table at the end of fBuffer.
    fLast = fBufferRef->Length();
@@ -951,23 +1076,27 @@ Int_t TBasket::WriteBuffer()
    lbuf       = fBufferRef->Length();
    fObjlen    = lbuf - fKeylen;
 
-   fHeaderOnly = kTRUE;
-   fCycle = fBranch->GetWriteBasket();
    Int_t cxlevel = fBranch->GetCompressionLevel();
    Int_t cxAlgorithm = fBranch->GetCompressionAlgorithm();
+   noutot = 0;
    if (cxlevel > 0) {
+      if (privateBuffer && !fOwnsCompressedBuffer) {
+         fSharedCompressedBufferRef = fCompressedBufferRef;
+         fCompressedBufferRef = 0;
+      }
       Int_t nbuffers = 1 + (fObjlen - 1) / kMAXZIPBUF;
       Int_t buflen = fKeylen + fObjlen + 9 * nbuffers + 28; //add 28 bytes in case object is placed in a deleted gap
       InitializeCompressedBuffer(buflen, file);
       if (!fCompressedBufferRef) {
          Warning("WriteBuffer", "Unable to allocate the compressed buffer");
+         fCompressedBufferRef = fSharedCompressedBufferRef;
+         fSharedCompressedBufferRef = 0;
+         if (privateBuffer) fCompressedSize = -2;
          return -1;
       }
       fCompressedBufferRef->SetWriteMode();
-      fBuffer = fCompressedBufferRef->Buffer();
       char *objbuf = fBufferRef->Buffer() + fKeylen;
-      char *bufcur = &fBuffer[fKeylen];
-      noutot = 0;
+      char *bufcur = fCompressedBufferRef->Buffer() + fKeylen;
       nzip   = 0;
       for (Int_t i = 0; i < nbuffers; ++i) {
          if (i == nbuffers - 1) bufmax = fObjlen - nzip;
@@ -979,43 +1108,105 @@ Int_t TBasket::WriteBuffer()
          // when the buffer contains random data, it may happen that the compressed
          // buffer is larger than the input. In this case, we write the original uncompressed buffer
          if (nout == 0 || nout >= fObjlen) {
-            nout = fObjlen;
-            // We used to delete fBuffer here, we no longer want to since
-            // the buffer (held by fCompressedBufferRef) might be re-used later.
-            fBuffer = fBufferRef->Buffer();
-            Create(fObjlen,file);
-            fBufferRef->SetBufferOffset(0);
-
-            Streamer(*fBufferRef);         //write key itself again
-            if ((nout+fKeylen)>buflen) {
-               Warning("WriteBuffer","Possible memory corruption due to compression algorithm, wrote %d bytes past the end of a block of %d bytes. fNbytes=%d, fObjLen=%d, fKeylen=%d",
-                  (nout+fKeylen-buflen),buflen,fNbytes,fObjlen,fKeylen);
-            }
-            goto WriteFile;
+            noutot = 0;
+            break;
          }
          bufcur += nout;
          noutot += nout;
          objbuf += kMAXZIPBUF;
          nzip   += kMAXZIPBUF;
       }
-      nout = noutot;
-      Create(noutot,file);
+   }
+   if (privateBuffer) fCompressedSize = noutot;
+   return noutot;
+}
+
+//_______________________________________________________________________
+Int_t TBasket::WriteBuffer()
+{
+   // Write buffer of this basket on the current file.
+   //
+   // The function returns the number of bytes committed to the memory.
+   // If a write error occurs, the number of bytes returned is -1.
+   // If no data are written, the number of bytes returned is 0.
+   //
+
+   const Int_t kWrite = 1;
+
+   TFile *file = fBranch->GetFile(kWrite);
+   if (!file) return 0;
+   if (!file->IsWritable()) {
+      return -1;
+   }
+   fMotherDir = file; // fBranch->GetDirectory();
+
+   if (R__unlikely(fBufferRef->TestBit(TBufferFile::kNotDecompressed))) {
+      // Read the basket information that was saved inside the buffer.
+      Bool_t writing = fBufferRef->IsWriting();
+      fBufferRef->SetReadMode();
+      fBufferRef->SetBufferOffset(0);
+
+      Streamer(*fBufferRef);
+      if (writing) fBufferRef->SetWriteMode();
+      Int_t nout = fNbytes - fKeylen;
+
+      fBuffer = fBufferRef->Buffer();
+
+      Create(nout,file);
+      fBufferRef->SetBufferOffset(0);
+      fHeaderOnly = kTRUE;
+
+      Streamer(*fBufferRef);         //write key itself again
+      int nBytes = WriteFileKeepBuffer();
+      fHeaderOnly = kFALSE;
+      return nBytes>0 ? fKeylen+nout : -1;
+   }
+
+   Int_t nout;
+   if (fCompressedSize >= 0) {
+      // The buffer was already compressed (see TTree::SetParallelCompression)
+      nout = fCompressedSize;
+   } else if (fCompressedSize == -2) {
+      // The compression done ahead failed
+      fCompressedSize = -1;
+      return -1;
+   } else {
+      nout = CompressBuffer(file);
+      if (nout < 0) return -1;
+   }
+   fCompressedSize = -1;
+
+   fHeaderOnly = kTRUE;
+   fCycle = fBranch->GetWriteBasket();
+   if (nout > 0) {
+      fBuffer = fCompressedBufferRef->Buffer();
+      Create(nout,file);
       fBufferRef->SetBufferOffset(0);
 
       Streamer(*fBufferRef);         //write key itself again
       memcpy(fBuffer,fBufferRef->Buffer(),fKeylen);
    } else {
+      // The buffer is not compressed or compressing it did not reduce its size:
+      // we write the original uncompressed buffer
+      nout = fObjlen;
+      // We used to delete fBuffer here, we no longer want to since
+      // the buffer (held by fCompressedBufferRef) might be re-used later.
       fBuffer = fBufferRef->Buffer();
       Create(fObjlen,file);
       fBufferRef->SetBufferOffset(0);
 
       Streamer(*fBufferRef);         //write key itself again
-      nout = fObjlen;
    }
 
-WriteFile:
    Int_t nBytes = WriteFileKeepBuffer();
    fHeaderOnly = kFALSE;
+   if (fSharedCompressedBufferRef) {
+      // Release the private compressed buffer used by the compression pool
+      if (fOwnsCompressedBuffer) delete fCompressedBufferRef;
+      fCompressedBufferRef = fSharedCompressedBufferRef;
+      fSharedCompressedBufferRef = 0;
+      fOwnsCompressedBuffer = kFALSE;
+   }
    return nBytes>0 ? fKeylen+nout : -1;
 }
 
@@ -103,6 +103,10 @@ TBranch::TBranch()
 , fBasketBytes(0)
 , fBasketEntry(0)
 , fBasketSeek(0)
+, fBasketMin(0)
+, fBasketMax(0)
+, fStatMin(0)
+, fStatMax(0)
 , fTree(0)
 , fMother(0)
 , fParent(0)
@@ -149,6 +153,10 @@ TBranch::TBranch(TTree *tree, const char* name, void* address, const char* leafl
 , fBasketBytes(0)
 , fBasketEntry(0)
 , fBasketSeek(0)
+, fBasketMin(0)
+, fBasketMax(0)
+, fStatMin(0)
+, fStatMax(0)
 , fTree(tree)
 , fMother(0)
 , fParent(0)
@@ -251,6 +259,10 @@ TBranch::TBranch(TBranch *parent, const char* name, void* address, const char* l
 , fBasketBytes(0)
 , fBasketEntry(0)
 , fBasketSeek(0)
+, fBasketMin(0)
+, fBasketMax(0)
+, fStatMin(0)
+, fStatMax(0)
 , fTree(parent ? parent->GetTree() : 0)
 , fMother(parent ? parent->GetMother() : 0)
 , fParent(parent)
@@ -424,6 +436,11 @@ TBranch::~TBranch()
    delete [] fBasketBytes;
    fBasketBytes = 0;
 
+   delete [] fBasketMin;
+   fBasketMin = 0;
+   delete [] fBasketMax;
+   fBasketMax = 0;
+
    fBaskets.Delete();
    fNBaskets = 0;
    fCurrentBasket = 0;
@@ -517,6 +534,10 @@ void TBranch::AddBasket(TBasket& b, Bool_t ondisk, Long64_t startEntry)
             fBasketEntry[j] = fBasketEntry[j-1];
             fBasketBytes[j] = fBasketBytes[j-1];
             fBasketSeek[j]  = fBasketSeek[j-1];
+            if (fBasketMin) {
+               fBasketMin[j] = fBasketMin[j-1];
+               fBasketMax[j] = fBasketMax[j-1];
+            }
          }
       }
    }
@@ -525,12 +546,19 @@ void TBranch::AddBasket(TBasket& b, Bool_t ondisk, Long64_t startEntry)
    if (ondisk) {
       fBasketBytes[where] = basket->GetNbytes();  // not for in mem
       fBasketSeek[where] = basket->GetSeekKey();  // not for in mem
+      if (fBasketMin) {
+         // The values of the basket are unknown (see CopyBasketStatistics).
+         fBasketMin[where] = -TMath::Infinity();
+         fBasketMax[where] = TMath::Infinity();
+      }
       fBaskets.AddAtAndExpand(0,fWriteBasket);
       ++fWriteBasket;
    } else {
       ++fNBaskets;
       fBaskets.AddAtAndExpand(basket,fWriteBasket);
       fTree->IncrementTotalBuffers(basket->GetBufferSize());
+      // The values already in the write basket were not seen by Fill.
+      if (fBasketMin) ResetBasketStatistics(kTRUE);
    }
 
    fEntries += basket->GetNevBuf();
@@ -582,6 +610,23 @@ void TBranch::Browse(TBrowser* b)
    }
 }
 
+//______________________________________________________________________________
+void TBranch::CopyBasketStatistics(const TBranch *from, Int_t basket, Long64_t startEntry)
+{
+   // Copy the statistics of the values of the basket 'basket' of 'from' to
+   // the basket of this branch starting at 'startEntry', added by AddBasket.
+   // Used by TTreeCloner when it copies the baskets.
+
+   if (!fBasketMin || !from->fBasketMin || basket >= from->fWriteBasket) return;
+   for (Int_t i = fWriteBasket-1; i >= 0; --i) {
+      if (fBasketEntry[i] == startEntry) {
+         fBasketMin[i] = from->fBasketMin[basket];
+         fBasketMax[i] = from->fBasketMax[basket];
+         return;
+      }
+   }
+}
+
  //______________________________________________________________________________
 void TBranch::DeleteBaskets(Option_t* option)
 {
@@ -699,6 +744,12 @@ void TBranch::ExpandBasketArrays()
                                                 newsize*sizeof(Long64_t),fMaxBaskets*sizeof(Long64_t));
    fBasketSeek   = (Long64_t*)TStorage::ReAlloc(fBasketSeek,
                                                 newsize*sizeof(Long64_t),fMaxBaskets*sizeof(Long64_t));
+   if (fBasketMin) {
+      fBasketMin = (Double_t*)TStorage::ReAlloc(fBasketMin,
+                                                newsize*sizeof(Double_t),fMaxBaskets*sizeof(Double_t));
+      fBasketMax = (Double_t*)TStorage::ReAlloc(fBasketMax,
+                                                newsize*sizeof(Double_t),fMaxBaskets*sizeof(Double_t));
+   }
 
    fMaxBaskets   = newsize;
 
@@ -708,6 +759,10 @@ void TBranch::ExpandBasketArrays()
       fBasketBytes[i] = 0;
       fBasketEntry[i] = 0;
       fBasketSeek[i]  = 0;
+      if (fBasketMin) {
+         fBasketMin[i] = -TMath::Infinity();
+         fBasketMax[i] = TMath::Infinity();
+      }
    }
 }
 
@@ -756,6 +811,7 @@ Int_t TBranch::Fill()
       ++fEntries;
       ++fEntryNumber;
       (this->*fFillLeaves)(*buf);
+      if (fBasketMin) UpdateBasketStatistics();
       if (buf->GetMapCount()) {
          // The map is used.
          ResetBit(TBranch::kDoNotUseBufferMap);
@@ -782,6 +838,11 @@ Int_t TBranch::Fill()
       if (fTree->TestBit(TTree::kCircular)) {
          return nbytes;
       }
+      if (fTree->DeferBasketWrite(basket)) {
+         // The basket is written by the tree after its parallel compression.
+         StartNewBasket(basket);
+         return nbytes;
+      }
       Int_t nout = WriteBasket(basket,fWriteBasket);
       return (nout >= 0) ? nbytes : -1;
    }
@@ -1105,6 +1166,7 @@ TBasket* TBranch::GetBasket(Int_t basketnumber)
    TFileCacheRead *pf = file->GetCacheRead(fTree);
    if (pf){
       if (pf->IsLearning()) pf->AddBranch(this);
+      else pf->LearnBranch(this);
       if (fSkipZip) pf->SetSkipZip();
    }
 
@@ -1153,6 +1215,111 @@ TList* TBranch::GetBrowsables() {
    return fBrowsables;
 }
 
+//______________________________________________________________________________
+Int_t TBranch::GetBulkEntries(Long64_t entry, TBuffer &user_buf)
+{
+   // Read in one pass the values of the entries from 'entry' up to the end
+   // of the basket containing it.
+   //
+   // The values are decompressed and byte swapped directly into the buffer
+   // of 'user_buf' (expanded if needed), as a contiguous array of the leaf
+   // type in the machine representation starting at user_buf.Buffer(),
+   // without any header, i.e. for a branch "x[3]/F"
+   //
+   //     TBufferFile buf(TBuffer::kWrite, 32000);
+   //     Int_t len = branch->GetLeaf("x")->GetLenStatic();   // 3
+   //     Long64_t entry = 0;
+   //     while (entry < branch->GetEntries()) {
+   //        Int_t n = branch->GetBulkEntries(entry, buf);
+   //        if (n <= 0) break;
+   //        const Float_t *x = (const Float_t*)buf.Buffer();
+   //        ... use x[0] ... x[n*len-1], x[i*len+j] is x[j] of entry+i
+   //        entry += n;
+   //     }
+   //
+   // On return the offset of 'user_buf' is set to the number of bytes filled,
+   // i.e. n * GetLenStatic() * sizeof(type) bytes for n entries.
+   //
+   // Only branches with a single leaf of a fundamental type (TLeafB, TLeafS,
+   // TLeafI, TLeafL, TLeafF, TLeafD or TLeafO) and without a leaf count
+   // support this mode.
+   //
+   // The function returns the number of entries read, 0 if 'entry' does not
+   // exist and -1 if the branch does not support bulk reading or an I/O error
+   // occurs. The current basket and read entry of the branch are updated as
+   // by GetEntry, but the leaf addresses are not filled.
+
+   if (IsA() != TBranch::Class() || fNleaves != 1) {
+      return -1;
+   }
+   TLeaf *leaf = (TLeaf*)fLeaves.UncheckedAt(0);
+   TClass *leafcl = leaf->IsA();
+   if (leaf->GetLeafCount() ||
+       (leafcl != TLeafB::Class() && leafcl != TLeafS::Class() && leafcl != TLeafI::Class() &&
+        leafcl != TLeafL::Class() && leafcl != TLeafF::Class() && leafcl != TLeafD::Class() &&
+        leafcl != TLeafO::Class())) {
+      return -1;
+   }
+   if ((entry < fFirstEntry) || (entry >= fEntryNumber)) {
+      return 0;
+   }
+
+   fReadEntry = entry;
+   if (entry < fFirstBasketEntry || entry >= fNextBasketEntry || !fCurrentBasket) {
+      fReadBasket = TMath::BinarySearch(fWriteBasket + 1, fBasketEntry, entry);
+      if (fReadBasket < 0) {
+         fNextBasketEntry = -1;
+         Error("GetBulkEntries", "In the branch %s, no basket contains the entry %lld\n", GetName(), entry);
+         return -1;
+      }
+      if (fReadBasket == fWriteBasket) {
+         fNextBasketEntry = fEntryNumber;
+      } else {
+         fNextBasketEntry = fBasketEntry[fReadBasket+1];
+      }
+      fFirstBasketEntry = fBasketEntry[fReadBasket];
+      TBasket *basket = GetBasket(fReadBasket);
+      if (!basket) {
+         fCurrentBasket = 0;
+         fFirstBasketEntry = -1;
+         fNextBasketEntry = -1;
+         return -1;
+      }
+      fCurrentBasket = basket;
+   }
+   TBasket *basket = fCurrentBasket;
+   TBuffer *buf = basket->GetBufferRef();
+   if (!buf || basket->GetEntryOffset()) {
+      return -1;
+   }
+   if (R__unlikely(!buf->IsReading())) {
+      basket->SetReadMode();
+   }
+
+   Int_t lenType = leaf->GetLenType();
+   Int_t nvalues = leaf->GetLenStatic();
+   if (basket->GetNevBufSize() != lenType * nvalues) {
+      return -1;
+   }
+   Int_t nentries = (Int_t)(fNextBasketEntry - entry);
+   Int_t nbytes = nentries * basket->GetNevBufSize();
+   nvalues *= nentries;
+   buf->SetBufferOffset(basket->GetKeylen() + (Int_t)(entry - fFirstBasketEntry) * basket->GetNevBufSize());
+   if (user_buf.BufferSize() < nbytes) {
+      user_buf.Expand(nbytes, kFALSE);
+   }
+   char *dest = user_buf.Buffer();
+   switch (lenType) {
+      case 1: buf->ReadFastArray((Char_t*)dest, nvalues); break;
+      case 2: buf->ReadFastArray((Short_t*)dest, nvalues); break;
+      case 4: buf->ReadFastArray((Int_t*)dest, nvalues); break;
+      case 8: buf->ReadFastArray((Long64_t*)dest, nvalues); break;
+      default: return -1;
+   }
+   user_buf.SetBufferOffset(nbytes);
+   return nentries;
+}
+
 //______________________________________________________________________________
 const char * TBranch::GetClassName() const
 {
@@ -1892,6 +2059,20 @@ void TBranch::Refresh(TBranch* b)
       fBasketEntry[i] = b->fBasketEntry[i];
       fBasketSeek[i]  = b->fBasketSeek[i];
    }
+   delete [] fBasketMin;
+   delete [] fBasketMax;
+   fBasketMin = 0;
+   fBasketMax = 0;
+   if (b->fBasketMin) {
+      fBasketMin = new Double_t[fMaxBaskets];
+      fBasketMax = new Double_t[fMaxBaskets];
+      for (i=0;i<fMaxBaskets;i++) {
+         fBasketMin[i] = b->fBasketMin[i];
+         fBasketMax[i] = b->fBasketMax[i];
+      }
+      fStatMin = b->fStatMin;
+      fStatMax = b->fStatMax;
+   }
    fBaskets.Delete();
    Int_t nbaskets = b->fBaskets.GetSize();
    fBaskets.Expand(nbaskets);
@@ -1945,6 +2126,14 @@ void TBranch::Reset(Option_t*)
       }
    }
 
+   if (fBasketMin) {
+      for (Int_t i = 0; i < fMaxBaskets; ++i) {
+         fBasketMin[i] = -TMath::Infinity();
+         fBasketMax[i] = TMath::Infinity();
+      }
+      ResetBasketStatistics(kFALSE);
+   }
+
    fBaskets.Delete();
    fNBaskets = 0;
 }
@@ -1988,6 +2177,14 @@ void TBranch::ResetAfterMerge(TFileMergeInfo *)
       }
    }
 
+   if (fBasketMin) {
+      for (Int_t i = 0; i < fMaxBaskets; ++i) {
+         fBasketMin[i] = -TMath::Infinity();
+         fBasketMax[i] = TMath::Infinity();
+      }
+      ResetBasketStatistics(kFALSE);
+   }
+
    TBasket *reusebasket = (TBasket*)fBaskets[fWriteBasket];
    if (reusebasket) {
       fBaskets[fWriteBasket] = 0;
@@ -2007,6 +2204,17 @@ void TBranch::ResetAfterMerge(TFileMergeInfo *)
    }
 }
 
+//______________________________________________________________________________
+void TBranch::ResetBasketStatistics(Bool_t unknown)
+{
+   // Reset the statistics of the values filled in the current basket: to
+   // an empty basket, or to an unknown content (any value may be in the
+   // basket) if 'unknown' is true.
+
+   fStatMin = unknown ? -TMath::Infinity() : TMath::Infinity();
+   fStatMax = unknown ? TMath::Infinity() : -TMath::Infinity();
+}
+
 //______________________________________________________________________________
 void TBranch::ResetAddress()
 {
@@ -2099,6 +2307,50 @@ void TBranch::SetBasketSize(Int_t buffsize)
    }
 }
 
+//______________________________________________________________________________
+Bool_t TBranch::SetBasketStatistics(Bool_t enable)
+{
+   // Enable (or disable) the recording of the minimum and the maximum of
+   // the values (NaN values excepted) of each basket written from now on.
+   //
+   // The statistics are saved with the branch and used by TTree::Draw to
+   // skip the baskets which cannot pass a selection like "pt>500", without
+   // reading them (see TTreePlayer::Process). The baskets written before
+   // the call (or copied without statistics) are assumed to contain any value.
+   //
+   // Only branches with a single leaf of a fundamental type (TLeafB, TLeafS,
+   // TLeafI, TLeafF, TLeafD or TLeafO), possibly a variable size array,
+   // support the statistics. They are kept as doubles, which cannot hold
+   // every 64 bit integer: the Long64_t and ULong64_t leaves (TLeafL) are
+   // not supported. Returns kFALSE if the branch does not support them.
+
+   if (!enable) {
+      delete [] fBasketMin;
+      delete [] fBasketMax;
+      fBasketMin = 0;
+      fBasketMax = 0;
+      return kTRUE;
+   }
+   if (IsA() != TBranch::Class() || fNleaves != 1) {
+      return kFALSE;
+   }
+   TClass *leafcl = ((TLeaf*)fLeaves.UncheckedAt(0))->IsA();
+   if (leafcl != TLeafB::Class() && leafcl != TLeafS::Class() && leafcl != TLeafI::Class() &&
+       leafcl != TLeafF::Class() && leafcl != TLeafD::Class() && leafcl != TLeafO::Class()) {
+      return kFALSE;
+   }
+   if (fBasketMin) return kTRUE;
+   fBasketMin = new Double_t[fMaxBaskets];
+   fBasketMax = new Double_t[fMaxBaskets];
+   for (Int_t i = 0; i < fMaxBaskets; ++i) {
+      fBasketMin[i] = -TMath::Infinity();
+      fBasketMax[i] = TMath::Infinity();
+   }
+   // The entries already in the write basket were not seen by Fill.
+   ResetBasketStatistics(fEntryNumber > fBasketEntry[fWriteBasket]);
+   return kTRUE;
+}
+
 //______________________________________________________________________________
 void TBranch::SetBufferAddress(TBuffer* buf)
 {
@@ -2328,6 +2580,10 @@ void TBranch::Streamer(TBuffer& b)
       if (v > 9) {
          b.ReadClassBuffer(TBranch::Class(), this, v, R__s, R__c);
 
+         // The values of the write basket filled before the tree was
+         // written are not known.
+         if (fBasketMin) ResetBasketStatistics(kTRUE);
+
          if (fWriteBasket>=fBaskets.GetSize()) {
             fBaskets.Expand(fWriteBasket+1);
          }
@@ -2541,6 +2797,32 @@ void TBranch::Streamer(TBuffer& b)
    }
 }
 
+//______________________________________________________________________________
+void TBranch::StartNewBasket(TBasket* basket)
+{
+   // Leave the full write basket, whose writing is deferred by the tree
+   // (see TTree::DeferBasketWrite), in memory and direct the next entries
+   // to a new basket. The full basket is written later by WriteBasket.
+
+   Int_t nevbuf = basket->GetNevBuf();
+   if (fEntryOffsetLen > 10 &&  (4*nevbuf) < fEntryOffsetLen ) {
+      fEntryOffsetLen = nevbuf < 3 ? 10 : 4*nevbuf;
+   } else if (fEntryOffsetLen && nevbuf > fEntryOffsetLen) {
+      fEntryOffsetLen = 2*nevbuf;
+   }
+   if (fBasketMin) {
+      fBasketMin[fWriteBasket] = fStatMin;
+      fBasketMax[fWriteBasket] = fStatMax;
+      ResetBasketStatistics(kFALSE);
+   }
+   ++fWriteBasket;
+   if (fWriteBasket >= fMaxBaskets) {
+      ExpandBasketArrays();
+   }
+   fBaskets.AddAtAndExpand(0,fWriteBasket);
+   fBasketEntry[fWriteBasket] = fEntryNumber;
+}
+
 //_______________________________________________________________________
 Int_t TBranch::WriteBasket(TBasket* basket, Int_t where)
 {
@@ -2574,6 +2856,11 @@ Int_t TBranch::WriteBasket(TBasket* basket, Int_t where)
    fTree->AddZipBytes(nout);
 
    if (where==fWriteBasket) {
+      if (fBasketMin) {
+         fBasketMin[where] = fStatMin;
+         fBasketMax[where] = fStatMax;
+         ResetBasketStatistics(kFALSE);
+      }
       ++fWriteBasket;
       if (fWriteBasket >= fMaxBaskets) {
          ExpandBasketArrays();
@@ -2617,6 +2904,25 @@ void TBranch::SetupAddresses()
    // Nothing to do for regular branch, the TLeaf already did it.
 }
 
+//______________________________________________________________________________
+void TBranch::UpdateBasketStatistics()
+{
+   // Add the values of the entry just filled to the statistics of the
+   // current basket (see SetBasketStatistics).
+
+   TLeaf *leaf = (TLeaf*)fLeaves.UncheckedAt(0);
+   Int_t len = leaf->GetLen();
+   for (Int_t i = 0; i < len; ++i) {
+      Double_t value = leaf->GetValue(i);
+      // A NaN value fails any cut, it does not change the statistics.
+      if (TMath::IsNaN(value)) {
+         continue;
+      }
+      if (value < fStatMin) fStatMin = value;
+      if (value > fStatMax) fStatMax = value;
+   }
+}
+
 //______________________________________________________________________________
 void TBranch::UpdateFile()
 {
@@ -73,6 +73,7 @@ TChain::TChain()
 , fFiles(0)
 , fStatus(0)
 , fProofChain(0)
+, fCacheKept(0)
 {
    // -- Default constructor.
 
@@ -109,6 +110,7 @@ TChain::TChain(const char* name, const char* title)
 , fFiles(0)
 , fStatus(0)
 , fProofChain(0)
+, fCacheKept(0)
 {
    // -- Create a chain.
    //
@@ -186,6 +188,8 @@ TChain::~TChain()
       delete fFile->GetCacheRead(fTree);
       fFile->SetCacheRead(0, fTree);
    }
+   delete fCacheKept;
+   fCacheKept = 0;
 
    delete fFile;
    fFile = 0;
@@ -1501,7 +1505,12 @@ Long64_t TChain::LoadTree(Long64_t entry)
    // FIXME: We may set fDirectory to zero here!
    fDirectory = fFile;
 
-   // Reuse cache from previous file (if any).
+   // Reuse cache from previous file (if any), or from the file before
+   // the missing ones, so that what it has learnt is kept.
+   if (!tpf && fCacheKept && fFile) {
+      tpf = fCacheKept;
+      fCacheKept = 0;
+   }
    if (tpf) {
       if (fFile) {
          tpf->ResetCache();
@@ -1509,10 +1518,10 @@ Long64_t TChain::LoadTree(Long64_t entry)
          // FIXME: fTree may be zero here.
          tpf->UpdateBranches(fTree);
       } else {
-         // FIXME: One of the file in the chain is missing
-         // we have no place to hold the pointer to the
-         // TTreeCache.
-         delete tpf;
+         // One of the file in the chain is missing, keep the
+         // TTreeCache for the next file.
+         delete fCacheKept;
+         fCacheKept = tpf;
          tpf = 0;
       }
    } else {
@@ -2207,7 +2216,10 @@ void TChain::SetCacheSize(Long64_t cacheSize)
       fTree->SetCacheSize(cacheSize);
    } else {
       // If we don't have a TTree yet, do not
-      // allocate the cache.
+      // allocate the cache, and do not reuse the one
+      // kept from a previous file.
+      delete fCacheKept;
+      fCacheKept = 0;
    }
    fCacheSize = cacheSize; // Record requested size.
 }
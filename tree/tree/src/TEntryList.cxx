@@ -59,6 +59,9 @@ Begin_Html
 <li> <b>Subtract</b>() - if the lists are for the same TTree, removes the entries of the second
                list from the first list. If the lists are for TChains, loops over all
                sub-lists
+<li> <b>Intersect</b>() - if the lists are for the same TTree, keeps only the entries of the
+               first list which are also in the second list. If the lists are for
+               TChains, loops over all sub-lists
 <li> <b>GetEntry(n)</b> - returns the n-th entry number
 <li> <b>Next</b>()      - returns next entry number. Note, that this function is
                 much faster than GetEntry, and it's called when GetEntry() is called
@@ -1233,13 +1236,17 @@ void TEntryList::Subtract(const TEntryList *elist)
          //second list is also only for 1 tree
          if (!strcmp(elist->fTreeName.Data(),fTreeName.Data()) &&
              !strcmp(elist->fFileName.Data(),fFileName.Data())){
-            //same tree
-            Long64_t n2 = elist->GetN();
-            Long64_t entry;
-            for (Int_t i=0; i<n2; i++){
-               entry = (const_cast<TEntryList*>(elist))->GetEntry(i);
-               Remove(entry);
+            //same tree, subtract block by block
+            if (!elist->fBlocks) return;
+            Int_t nmin = TMath::Min(fNBlocks, elist->fNBlocks);
+            for (Int_t i=0; i<nmin; i++){
+               TEntryListBlock *block1 = (TEntryListBlock*)fBlocks->UncheckedAt(i);
+               TEntryListBlock *block2 = (TEntryListBlock*)elist->fBlocks->UncheckedAt(i);
+               Long64_t nold = block1->GetNPassed();
+               fN = fN - nold + block1->Subtract(block2);
             }
+            fLastIndexQueried = -1;
+            fLastIndexReturned = 0;
          } else {
             //different trees
             return;
@@ -1276,6 +1283,56 @@ void TEntryList::Subtract(const TEntryList *elist)
 
 }
 
+//______________________________________________________________________________
+void TEntryList::Intersect(const TEntryList *elist)
+{
+   //keep only the entries of this entry list, that are also contained in elist
+   //If the lists are for TChains, the sub-lists for the trees which are not
+   //in elist become empty
+
+   TEntryList *templist = 0;
+   if (!fLists){
+      if (!fBlocks) return;
+      const TEntryList *other = 0;
+      if (!elist->fLists){
+         if (!strcmp(elist->fTreeName.Data(),fTreeName.Data()) &&
+             !strcmp(elist->fFileName.Data(),fFileName.Data()))
+            other = elist;
+      } else {
+         //second list has sublists, try to find one for the same tree as this list
+         TIter next1(elist->GetLists());
+         while ((templist = (TEntryList*)next1())){
+            if (!strcmp(templist->fTreeName.Data(),fTreeName.Data()) &&
+                !strcmp(templist->fFileName.Data(),fFileName.Data())){
+               other = templist;
+               break;
+            }
+         }
+      }
+      //intersect block by block, the blocks which are not in the other list
+      //are intersected with an empty block
+      TEntryListBlock empty;
+      Int_t nother = (other && other->fBlocks) ? other->fNBlocks : 0;
+      for (Int_t i=0; i<fNBlocks; i++){
+         TEntryListBlock *block1 = (TEntryListBlock*)fBlocks->UncheckedAt(i);
+         TEntryListBlock *block2 = i<nother ? (TEntryListBlock*)other->fBlocks->UncheckedAt(i) : &empty;
+         Long64_t nold = block1->GetNPassed();
+         fN = fN - nold + block1->Intersect(block2);
+      }
+      fLastIndexQueried = -1;
+      fLastIndexReturned = 0;
+   } else {
+      //this list has sublists
+      TIter next2(fLists);
+      Long64_t oldn=0;
+      while ((templist = (TEntryList*)next2())){
+         oldn = templist->GetN();
+         templist->Intersect(elist);
+         fN = fN - oldn + templist->GetN();
+      }
+   }
+}
+
 //______________________________________________________________________________
 TEntryList operator||(TEntryList &elist1, TEntryList &elist2)
 {
@@ -12,7 +12,7 @@
 //______________________________________________________________________________
 /* Begin_Html
 <center><h2>TEntryListBlock: Used by TEntryList to store the entry numbers</h2></center>
- There are 2 ways to represent entry numbers in a TEntryListBlock:
+ There are 3 ways to represent entry numbers in a TEntryListBlock:
 <ol>
  <li> as bits, where passing entry numbers are assigned 1, not passing - 0
  <li> as a simple array of entry numbers
@@ -20,10 +20,15 @@
 <li> storing the numbers of entries that pass
 <li> storing the numbers of entries that don't pass
 </ul>
+ <li> as runs, i.e. pairs (first, last) of the ranges of consecutive entries that pass
  </ol>
- In both cases, a UShort_t* is used. The second option is better in case
- less than 1/16 or more than 15/16 of entries pass the selection, and the representation can be
- changed by calling OptimizeStorage() function.
+ In all cases, a UShort_t* is used. The second option is better in case
+ less than 1/16 or more than 15/16 of entries pass the selection, the third one
+ when the passing entries come in long ranges (e.g. a selection on the run number).
+ The representation can be changed by calling OptimizeStorage() function, which
+ chooses the smallest one.
+ The runs are only used in memory: a block stored as runs is written to the file
+ as bits or as a list, so that the files can be read by the previous versions.
  When the block is being filled, it's always stored as bits, and the OptimizeStorage()
  function is called by TEntryList when it starts filling the next block. If
  Enter() or Remove() is called after OptimizeStorage(), representation is
@@ -36,9 +41,12 @@ End_Macro
 Begin_Html
  <h4>Operations on blocks (see also function comments)</h4>
 <ul>
- <li> <b>Merge</b>() - adds all entries from one block to the other. If the first block
-             uses array representation, it's changed to bits representation only
-             if the total number of passing entries is still less than kBlockSize
+ <li> <b>Merge</b>() - adds all entries from one block to the other. If both blocks
+             store the passing entries as arrays and the total number of passing
+             entries is less than kBlockSize, the arrays are merged, otherwise the
+             union is computed on the bits, 64 entries at a time.
+ <li> <b>Intersect</b>() - keeps only the entries that are also in the other block.
+ <li> <b>Subtract</b>() - removes the entries that are in the other block.
  <li> <b>GetEntry(n)</b> - returns n-th non-zero entry.
  <li> <b>Next</b>()      - return next non-zero entry. In case of representation 1), Next()
                  is faster than GetEntry()
@@ -47,10 +55,93 @@ End_Html */
 
 
 #include "TEntryListBlock.h"
+#include "TBuffer.h"
 #include "TString.h"
 
 ClassImp(TEntryListBlock)
 
+namespace {
+
+   // The bits of a block are handled as 64 bit words: the bit (entry & 63)
+   // of the word (entry >> 6) is the bit (entry & 15) of the UShort_t
+   // (entry >> 4). The loops on the words are simple enough to be vectorized
+   // by the compiler.
+   const Int_t kNWords = TEntryListBlock::kBlockSize / 4;
+   const Int_t kNEntries = TEntryListBlock::kBlockSize * 16;
+   const ULong64_t kAllBits = ~ULong64_t(0);
+
+   inline Int_t CountBits(ULong64_t w)
+   {
+      // Number of bits set in w.
+#if defined(__GNUC__) || defined(__clang__)
+      return __builtin_popcountll(w);
+#else
+      w = w - ((w >> 1) & 0x5555555555555555ULL);
+      w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+      w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+      return (Int_t)((w * 0x0101010101010101ULL) >> 56);
+#endif
+   }
+
+   inline Int_t FirstBit(ULong64_t w)
+   {
+      // Position of the lowest bit set in w, w must not be 0.
+#if defined(__GNUC__) || defined(__clang__)
+      return __builtin_ctzll(w);
+#else
+      Int_t n = 0;
+      while (!(w & 1)) { w >>= 1; n++; }
+      return n;
+#endif
+   }
+
+   void BitsToWords(const UShort_t *bits, ULong64_t *words)
+   {
+      for (Int_t i = 0; i < kNWords; i++) {
+         words[i] = ULong64_t(bits[4*i]) | (ULong64_t(bits[4*i+1]) << 16) |
+                    (ULong64_t(bits[4*i+2]) << 32) | (ULong64_t(bits[4*i+3]) << 48);
+      }
+   }
+
+   void WordsToBits(const ULong64_t *words, UShort_t *bits)
+   {
+      for (Int_t i = 0; i < kNWords; i++) {
+         bits[4*i]   = UShort_t(words[i]);
+         bits[4*i+1] = UShort_t(words[i] >> 16);
+         bits[4*i+2] = UShort_t(words[i] >> 32);
+         bits[4*i+3] = UShort_t(words[i] >> 48);
+      }
+   }
+
+   void SetRange(ULong64_t *words, Int_t first, Int_t last)
+   {
+      // Set the bits of the entries first to last (included).
+      Int_t w1 = first >> 6;
+      Int_t w2 = last >> 6;
+      ULong64_t m1 = kAllBits << (first & 63);
+      ULong64_t m2 = kAllBits >> (63 - (last & 63));
+      if (w1 == w2) {
+         words[w1] |= m1 & m2;
+         return;
+      }
+      words[w1] |= m1;
+      for (Int_t i = w1 + 1; i < w2; i++) words[i] = kAllBits;
+      words[w2] |= m2;
+   }
+
+   Int_t CountRuns(const ULong64_t *words)
+   {
+      // Number of ranges of consecutive bits set.
+      Int_t nruns = 0;
+      ULong64_t carry = 0;
+      for (Int_t i = 0; i < kNWords; i++) {
+         nruns += CountBits(words[i] & ~((words[i] << 1) | carry));
+         carry = words[i] >> 63;
+      }
+      return nruns;
+   }
+}
+
 //______________________________________________________________________________
 TEntryListBlock::TEntryListBlock()
 {
@@ -127,7 +218,7 @@ TEntryListBlock &TEntryListBlock::operator=(const TEntryListBlock &eblock)
 Bool_t TEntryListBlock::Enter(Int_t entry)
 {
    //If the block has already been optimized and the entries
-   //are stored as a list and not as bits, trying to enter a new entry
+   //are stored as a list or as runs and not as bits, trying to enter a new entry
    //will make the block switch to bits representation
 
    if (entry > kBlockSize*16) {
@@ -165,7 +256,7 @@ Bool_t TEntryListBlock::Remove(Int_t entry)
 {
 //Remove entry #entry
 //If the block has already been optimized and the entries
-//are stored as a list and not as bits, trying to remove a new entry
+//are stored as a list or as runs and not as bits, trying to remove a new entry
 //will make the block switch to bits representation
 
    if (entry > kBlockSize*16) {
@@ -208,6 +299,11 @@ Int_t TEntryListBlock::Contains(Int_t entry)
       Bool_t result = (fIndices[i] & (1<<j))!=0;
       return result;
    }
+   if (fType==2){
+      //runs
+      Int_t irun = FindRun(entry);
+      return irun >= 0 && entry <= fIndices[2*irun+1];
+   }
    //list
    if (entry < fCurrent) fCurrent = 0;
    if (fPassing && fIndices){
@@ -238,130 +334,204 @@ Int_t TEntryListBlock::Contains(Int_t entry)
    return 0;
 }
 
+//______________________________________________________________________________
+Int_t TEntryListBlock::FindRun(Int_t entry) const
+{
+   //Return the index of the last run starting before or at entry, -1 if none
+   //(runs representation only)
+
+   Int_t lo = 0;
+   Int_t hi = fN/2;
+   while (lo < hi) {
+      Int_t mid = (lo + hi) / 2;
+      if (fIndices[2*mid] <= entry) lo = mid + 1;
+      else hi = mid;
+   }
+   return lo - 1;
+}
+
+//______________________________________________________________________________
+void TEntryListBlock::GetWords(ULong64_t *words) const
+{
+   //Fill the kBlockSize/4 words with the bits of the entries of this block,
+   //whatever its representation
+
+   Int_t i;
+   if (!fIndices) {
+      //an empty block, or all entries pass
+      for (i=0; i<kNWords; i++) words[i] = fPassing ? 0 : kAllBits;
+      return;
+   }
+   if (fType==0) {
+      BitsToWords(fIndices, words);
+   } else if (fType==2) {
+      for (i=0; i<kNWords; i++) words[i] = 0;
+      for (i=0; i<fN; i+=2) SetRange(words, fIndices[i], fIndices[i+1]);
+   } else if (fPassing) {
+      for (i=0; i<kNWords; i++) words[i] = 0;
+      for (i=0; i<fNPassed; i++) words[fIndices[i]>>6] |= ULong64_t(1) << (fIndices[i] & 63);
+   } else {
+      for (i=0; i<kNWords; i++) words[i] = kAllBits;
+      for (i=0; i<fNPassed; i++) words[fIndices[i]>>6] &= ~(ULong64_t(1) << (fIndices[i] & 63));
+   }
+}
+
+//______________________________________________________________________________
+void TEntryListBlock::SetWords(const ULong64_t *words)
+{
+   //Store the entries given by the bits of the kBlockSize/4 words and
+   //optimize the storage
+
+   if (!fIndices || fType!=0) {
+      if (fIndices) delete [] fIndices;
+      fIndices = new UShort_t[kBlockSize];
+   }
+   WordsToBits(words, fIndices);
+   Int_t npassed = 0;
+   for (Int_t i=0; i<kNWords; i++) npassed += CountBits(words[i]);
+   fNPassed = npassed;
+   fN = kBlockSize;
+   fType = 0;
+   fPassing = 1;
+   fCurrent = 0;
+   fLastIndexQueried = -1;
+   fLastIndexReturned = -1;
+   OptimizeStorage();
+}
+
+//______________________________________________________________________________
+void TEntryListBlock::SetList(UShort_t *list, Int_t n)
+{
+   //Store the n passing entries of the sorted array list, which is adopted
+
+   if (fIndices) delete [] fIndices;
+   fIndices = list;
+   fNPassed = n;
+   fN = n;
+   fType = 1;
+   fPassing = 1;
+   fCurrent = 0;
+   fLastIndexQueried = -1;
+   fLastIndexReturned = -1;
+}
+
+//______________________________________________________________________________
+void TEntryListBlock::Filter(TEntryListBlock *block, Bool_t keep)
+{
+   //Keep the entries of this block, stored as a list of passing entries,
+   //which are (keep=kTRUE) or are not (keep=kFALSE) in block.
+   //The entries are queried in increasing order: the two lists are walked
+   //together if block is also a list of passing entries.
+
+   Int_t i, n = 0;
+   if (block->fType==1 && block->fPassing) {
+      Int_t j = 0;
+      for (i=0; i<fNPassed; i++) {
+         while (j < block->fNPassed && block->fIndices[j] < fIndices[i]) j++;
+         Bool_t found = j < block->fNPassed && block->fIndices[j] == fIndices[i];
+         if (found == keep)
+            fIndices[n++] = fIndices[i];
+      }
+   } else {
+      block->fCurrent = 0;
+      for (i=0; i<fNPassed; i++) {
+         if ((block->Contains(fIndices[i]) != 0) == keep)
+            fIndices[n++] = fIndices[i];
+      }
+   }
+   fNPassed = n;
+   fN = n;
+   fCurrent = 0;
+   fLastIndexQueried = -1;
+   fLastIndexReturned = -1;
+}
+
 //______________________________________________________________________________
 Int_t TEntryListBlock::Merge(TEntryListBlock *block)
 {
    //Merge with the other block
    //Returns the resulting number of entries in the block
+   //If both blocks store the passing entries as lists and the result has
+   //less than kBlockSize entries, the two lists are merged; otherwise the
+   //union is computed on the bits of the two blocks, 64 entries at a time.
 
-   Int_t i, j;
    if (block->GetNPassed() == 0) return GetNPassed();
    if (GetNPassed() == 0){
       //this block is empty
-      fN = block->fN;
-      fIndices = new UShort_t[fN];
-      for (i=0; i<fN; i++)
-         fIndices[i] = block->fIndices[i];
-      fNPassed = block->fNPassed;
-      fType = block->fType;
-      fPassing = block->fPassing;
-      fCurrent = block->fCurrent;
-      fLastIndexReturned = -1;
-      fLastIndexQueried = -1;
-      return fNPassed;
+      *this = *block;
+      return GetNPassed();
    }
-   if (fType==0){
-      //stored as bits
-      if (block->fType == 0){
-         for (i=0; i<kBlockSize*16; i++){
-            if (block->Contains(i))
-               Enter(i);
-         }
-      } else {
-         if (block->fPassing){
-            //the other block stores entries that pass
-            for (i=0; i<block->fNPassed; i++){
-               Enter(block->fIndices[i]);
-            }
-         } else {
-            //the other block stores entries that don't pass
-            if (block->fNPassed==0){
-               for (i=0; i<kBlockSize*16; i++){
-                  Enter(i);
-               }
-            }
-            for (j=0; j<block->fIndices[0]; j++)
-               Enter(j);
-            for (i=0; i<block->fNPassed-1; i++){
-               for (j=block->fIndices[i]+1; j<block->fIndices[i+1]; j++){
-                  Enter(j);
-               }
-            }
-            for (j=block->fIndices[block->fNPassed-1]+1; j<kBlockSize*16; j++)
-               Enter(j);
-         }
+   if (fType==1 && fPassing && block->fType==1 && block->fPassing &&
+       fNPassed + block->fNPassed <= kBlockSize) {
+      //make a bigger list
+      Int_t en = block->fNPassed;
+      UShort_t *newlist = new UShort_t[fNPassed + en];
+      UShort_t *elst = block->fIndices;
+      Int_t newpos = 0, pos = 0, elpos = 0;
+      while (pos < fNPassed && elpos < en) {
+         if (fIndices[pos] < elst[elpos]) newlist[newpos++] = fIndices[pos++];
+         else if (fIndices[pos] > elst[elpos]) newlist[newpos++] = elst[elpos++];
+         else { newlist[newpos++] = fIndices[pos++]; elpos++; }
       }
-   } else {
-      //stored as a list
-      if (GetNPassed() + block->GetNPassed() > kBlockSize){
-         //change to bits
-         UShort_t *bits = new UShort_t[kBlockSize];
-         Transform(1, bits);
-         Merge(block);
-      } else {
-         //this is only possible if fPassing=1 in both blocks
-         if (block->fType==1){
-            //second block stored as a list
-            //make a bigger list
-            Int_t en = block->fNPassed;
-            Int_t newsize = fNPassed + en;
-            UShort_t *newlist = new UShort_t[newsize];
-            UShort_t *elst = block->fIndices;
-            Int_t newpos, elpos;
-            newpos = elpos = 0;
-            for (i=0; i<fNPassed; i++) {
-               while (elpos < en && fIndices[i] > elst[elpos]) {
-                  newlist[newpos] = elst[elpos];
-                  newpos++;
-                  elpos++;
-               }
-               if (fIndices[i] == elst[elpos]) elpos++;
-               newlist[newpos] = fIndices[i];
-               newpos++;
-            }
-            while (elpos < en) {
-               newlist[newpos] = elst[elpos];
-               newpos++;
-               elpos++;
-            }
-            delete [] fIndices;
-            fIndices = newlist;
-            fNPassed = newpos;
-            fN = fNPassed;
-         } else {
-            //second block is stored as bits
-
-            Int_t en = block->fNPassed;
-            Int_t newsize = fNPassed + en;
-            UShort_t *newlist = new UShort_t[newsize];
-            Int_t newpos, current;
-            newpos = current = 0;
-            for (i=0; i<kBlockSize*16; i++){
-               if (!block->Contains(i)) continue;
-               while(current < fNPassed && fIndices[current]<i){
-                  newlist[newpos] = fIndices[current];
-                  current++;
-                  newpos++;
-               }
-               if (fIndices[current]==i) current++;
-               newlist[newpos] = i;
-               newpos++;
-            }
-            while(current<fNPassed){
-               newlist[newpos] = fIndices[current];
-               newpos++;
-               current++;
-            }
-            delete [] fIndices;
-            fIndices = newlist;
-            fNPassed = newpos;
-            fN = fNPassed;
-         }
+      while (pos < fNPassed) newlist[newpos++] = fIndices[pos++];
+      while (elpos < en) newlist[newpos++] = elst[elpos++];
+      SetList(newlist, newpos);
+      return GetNPassed();
+   }
+   ULong64_t words[kNWords], other[kNWords];
+   GetWords(words);
+   block->GetWords(other);
+   for (Int_t i=0; i<kNWords; i++) words[i] |= other[i];
+   SetWords(words);
+   return GetNPassed();
+}
+
+//______________________________________________________________________________
+Int_t TEntryListBlock::Intersect(TEntryListBlock *block)
+{
+   //Keep only the entries which are also in the other block
+   //Returns the resulting number of entries in the block
+
+   if (GetNPassed() == 0) return 0;
+   if (fType==1 && fPassing) {
+      Filter(block, kTRUE);
+      return GetNPassed();
+   }
+   if (block->fType==1 && block->fPassing) {
+      //the result is a subset of the list of the other block
+      UShort_t *newlist = new UShort_t[block->fNPassed];
+      Int_t n = 0;
+      fCurrent = 0;
+      for (Int_t i=0; i<block->fNPassed; i++) {
+         if (Contains(block->fIndices[i])) newlist[n++] = block->fIndices[i];
       }
+      SetList(newlist, n);
+      return GetNPassed();
    }
-   fLastIndexQueried = -1;
-   fLastIndexReturned = -1;
-   OptimizeStorage();
+   ULong64_t words[kNWords], other[kNWords];
+   GetWords(words);
+   block->GetWords(other);
+   for (Int_t i=0; i<kNWords; i++) words[i] &= other[i];
+   SetWords(words);
+   return GetNPassed();
+}
+
+//______________________________________________________________________________
+Int_t TEntryListBlock::Subtract(TEntryListBlock *block)
+{
+   //Remove the entries which are in the other block
+   //Returns the resulting number of entries in the block
+
+   if (GetNPassed() == 0 || block->GetNPassed() == 0) return GetNPassed();
+   if (fType==1 && fPassing) {
+      Filter(block, kFALSE);
+      return GetNPassed();
+   }
+   ULong64_t words[kNWords], other[kNWords];
+   GetWords(words);
+   block->GetWords(other);
+   for (Int_t i=0; i<kNWords; i++) words[i] &= ~other[i];
+   SetWords(words);
    return GetNPassed();
 }
 
@@ -389,18 +559,36 @@ Int_t TEntryListBlock::GetEntry(Int_t entry)
    else {
       Int_t i=0; Int_t j=0; Int_t entries_found=0;
       if (fType==0){
-         if ((fIndices[i] & (1<<j))!=0)
-            entries_found++;
-         while (entries_found<entry+1){
-            if (j==15){i++; j=0;}
-            else j++;
-            if ((fIndices[i] & (1<<j))!=0)
-               entries_found++;
+         //skip the groups of 16 bits which don't contain the entry
+         Int_t nleft = entry+1;
+         Int_t nbits;
+         while (i<kBlockSize && (nbits = CountBits(fIndices[i]))<nleft){
+            nleft -= nbits;
+            i++;
+         }
+         if (i==kBlockSize) return -1;
+         for (j=0; j<16; j++){
+            if ((fIndices[i] & (1<<j))!=0 && --nleft==0) break;
          }
          fLastIndexQueried = entry;
          fLastIndexReturned = i*16+j;
          return fLastIndexReturned;
       }
+      if (fType==2){
+         //runs
+         Int_t nleft = entry;
+         for (i=0; i<fN; i+=2){
+            Int_t length = fIndices[i+1]-fIndices[i]+1;
+            if (nleft<length){
+               fCurrent = i/2;
+               fLastIndexQueried = entry;
+               fLastIndexReturned = fIndices[i]+nleft;
+               return fLastIndexReturned;
+            }
+            nleft -= length;
+         }
+         return -1;
+      }
       if (fType==1){
          if (fPassing){
             fLastIndexQueried = entry;
@@ -455,23 +643,32 @@ Int_t TEntryListBlock::Next()
    }
 
    if (fType==0) {
-      //bits
-      Int_t i=0;
-      Int_t j=0;
-      fLastIndexReturned++;
-      i = fLastIndexReturned>>4;
-      j = fLastIndexReturned & 15;
-      Bool_t result=(fIndices[i] & (1<<j))!=0;
-      while (result==0){
-         if (j==15) {j=0; i++;}
-         else j++;
-         result = (fIndices[i] & (1<<j))!=0;
-      }
-      fLastIndexReturned = i*16+j;
+      //bits, skip the groups of 16 bits which are not set
+      Int_t first = fLastIndexReturned+1;
+      Int_t i = first>>4;
+      UInt_t bits = fIndices[i] & (0xFFFF << (first & 15));
+      while (!bits)
+         bits = fIndices[++i];
+      fLastIndexReturned = i*16+FirstBit(bits);
       fLastIndexQueried++;
       return fLastIndexReturned;
 
    }
+   if (fType==2) {
+      //runs, fCurrent is the run of the last entry returned
+      Int_t first = fLastIndexReturned+1;
+      Int_t irun = fCurrent;
+      if (fLastIndexReturned<0 || 2*irun>=fN || fIndices[2*irun]>first) {
+         irun = FindRun(first);
+         if (irun<0) irun = 0;
+      }
+      if (first>fIndices[2*irun+1]) irun++;
+      if (first<fIndices[2*irun]) first = fIndices[2*irun];
+      fCurrent = irun;
+      fLastIndexReturned = first;
+      fLastIndexQueried++;
+      return fLastIndexReturned;
+   }
    if (fType==1) {
       fLastIndexQueried++;
       if (fPassing){
@@ -506,6 +703,13 @@ void TEntryListBlock::PrintWithShift(Int_t shift) const
    //print the corrent values
 
    Int_t i;
+   if (fType==2){
+      for (i=0; i<fN; i+=2){
+         for (Int_t j=fIndices[i]; j<=fIndices[i+1]; j++)
+            printf("%d\n", j+shift);
+      }
+      return;
+   }
    if (fType==0){
       Int_t ibit, ibite;
       Bool_t result;
@@ -544,11 +748,42 @@ void TEntryListBlock::PrintWithShift(Int_t shift) const
 
 
 //______________________________________________________________________________
-void TEntryListBlock::OptimizeStorage()
+void TEntryListBlock::OptimizeStorage(Bool_t runs)
 {
    //if there are < kBlockSize or >kBlockSize*15 entries, change to an array representation
+   //if runs is true and the passing entries form ranges which take less space than
+   //the bits and the array, change to the runs representation
 
    if (fType!=0) return;
+   if (runs){
+      ULong64_t words[kNWords];
+      BitsToWords(fIndices, words);
+      Int_t nruns = CountRuns(words);
+      Int_t nlist = fNPassed > kBlockSize*15 ? kBlockSize*16-fNPassed : fNPassed;
+      if (2*nruns<kBlockSize && 2*nruns<nlist){
+         UShort_t *indexnew = new UShort_t[2*nruns];
+         Int_t n = 0;
+         Bool_t inrun = kFALSE;
+         for (Int_t i=0; i<kNWords; i++){
+            //skip the words which don't start or end a run
+            if (words[i]==(inrun ? kAllBits : ULong64_t(0))) continue;
+            for (Int_t j=0; j<64; j++){
+               Bool_t bit = (words[i]>>j) & 1;
+               if (bit==inrun) continue;
+               indexnew[n++] = bit ? i*64+j : i*64+j-1;
+               inrun = bit;
+            }
+         }
+         if (inrun) indexnew[n++] = kNEntries-1;
+         delete [] fIndices;
+         fIndices = indexnew;
+         fN = n;
+         fType = 2;
+         fPassing = 1;
+         fCurrent = 0;
+         return;
+      }
+   }
    if (fNPassed > kBlockSize*15)
       fPassing = 0;
    if (fNPassed<kBlockSize || !fPassing){
@@ -564,27 +799,23 @@ void TEntryListBlock::Transform(Bool_t dir, UShort_t *indexnew)
 {
    //Transform the existing fIndices
    //dir=0 - transform from bits to a list
-   //dir=1 - tranform from a list to bits
+   //dir=1 - tranform from a list or from runs to bits
 
    Int_t i=0;
    Int_t ilist = 0;
    Int_t ibite, ibit;
    if (!dir) {
-         for (i=0; i<kBlockSize*16; i++){
-            ibite = i >> 4;
-            ibit = i & 15;
-            Bool_t result = (fIndices[ibite] & (1<<ibit))!=0;
-            if (result && fPassing){
-               //fill with the entries that pass
-               indexnew[ilist] = i;
-               ilist++;
-            }
-            else if (!result && !fPassing){
-               //fill with the entries that don't pass
-               indexnew[ilist] = i;
-               ilist++;
-            }
+      ULong64_t words[kNWords];
+      BitsToWords(fIndices, words);
+      for (i=0; i<kNWords; i++){
+         //fill with the entries that pass, or with the entries that don't pass
+         ULong64_t w = fPassing ? words[i] : ~words[i];
+         while (w){
+            indexnew[ilist] = i*64+FirstBit(w);
+            ilist++;
+            w &= w-1;
          }
+      }
       if (fIndices)
          delete [] fIndices;
       fIndices = indexnew;
@@ -595,8 +826,11 @@ void TEntryListBlock::Transform(Bool_t dir, UShort_t *indexnew)
       return;
    }
 
-
-   if (fPassing){
+   if (fType==2){
+      ULong64_t words[kNWords];
+      GetWords(words);
+      WordsToBits(words, indexnew);
+   } else if (fPassing){
       for (i=0; i<kBlockSize; i++)
          indexnew[i] = 0;
       for (i=0; i<fNPassed; i++){
@@ -622,3 +856,27 @@ void TEntryListBlock::Transform(Bool_t dir, UShort_t *indexnew)
    fPassing = 1;
    return;
 }
+
+//______________________________________________________________________________
+void TEntryListBlock::Streamer(TBuffer &b)
+{
+   // Stream an object of class TEntryListBlock.
+   // A block stored as runs is written as bits or as a list, the only
+   // representations known by the previous versions.
+
+   if (b.IsReading()) {
+      b.ReadClassBuffer(TEntryListBlock::Class(), this);
+      fCurrent = 0;
+      fLastIndexQueried = -1;
+      fLastIndexReturned = -1;
+   } else {
+      if (fType==2) {
+         TEntryListBlock block(*this);
+         block.Transform(1, new UShort_t[kBlockSize]);
+         block.OptimizeStorage(kFALSE);
+         b.WriteClassBuffer(TEntryListBlock::Class(), &block);
+      } else {
+         b.WriteClassBuffer(TEntryListBlock::Class(), this);
+      }
+   }
+}
@@ -366,6 +366,10 @@
 #include "TBranchSTL.h"
 #include "TSchemaRuleSet.h"
 #include "TFileMergeInfo.h"
+#include "TThread.h"
+#include "TMutex.h"
+#include "TCondition.h"
+#include "TVirtualMutex.h"
 
 #include <cstddef>
 #include <fstream>
@@ -373,9 +377,13 @@
 #include <string>
 #include <stdio.h>
 #include <limits.h>
+#include <vector>
+#include <deque>
+#include <set>
 
 Int_t    TTree::fgBranchStyle = 1;  // Use new TBranch style with TBranchElement.
 Long64_t TTree::fgMaxTreeSize = 100000000000LL;
+Int_t    TTree::fgImplicitMT  = 0;  // Process runs sequentially.
 
 ClassImp(TTree)
 
@@ -656,6 +664,9 @@ TTree::TTree()
 , fTransientBuffer(0)
 , fCacheDoAutoInit(kTRUE)
 , fCacheUserSet(kFALSE)
+, fParallelCompress(0)
+, fCollectBaskets(kFALSE)
+, fBasketsToWrite(0)
 {
    // Default constructor and I/O constructor.
    //
@@ -727,6 +738,9 @@ TTree::TTree(const char* name, const char* title, Int_t splitlevel /* = 99 */)
 , fTransientBuffer(0)
 , fCacheDoAutoInit(kTRUE)
 , fCacheUserSet(kFALSE)
+, fParallelCompress(0)
+, fCollectBaskets(kFALSE)
+, fBasketsToWrite(0)
 {
    // Normal tree constructor.
    //
@@ -781,6 +795,8 @@ TTree::~TTree()
 {
    // Destructor.
 
+   // The queued baskets must not be compressed while their branch is deleted.
+   WaitQueuedBaskets();
    if (fDirectory) {
       // We are in a directory, which may possibly be a file.
       if (fDirectory->GetList()) {
@@ -863,6 +879,8 @@ TTree::~TTree()
       delete fTransientBuffer;
       fTransientBuffer = 0;
    }
+   delete fBasketsToWrite;
+   fBasketsToWrite = 0;
 }
 
 //______________________________________________________________________________
@@ -2371,7 +2389,9 @@ Int_t TTree::BuildIndex(const char* majorname, const char* minorname /* = "0" */
    //
    // The return value is the number of entries in the Index (< 0 indicates failure).
    //
-   // A TTreeIndex object pointed by fTreeIndex is created.
+   // A TTreeIndex object pointed by fTreeIndex is created, or a
+   // TTreeCompactIndex if the resource TTreeIndex.Compact is set to 1 (see
+   // TTreePlayer::BuildIndex).
    // This object will be automatically deleted by the TTree destructor.
    // See also comments in TTree::SetTreeIndex().
 
@@ -2783,10 +2803,11 @@ TTree* TTree::CloneTree(Long64_t nentries /* = -1 */, Option_t* option /* = "" *
    // When 'fast' is specified, 'option' can also contain a sorting
    // order for the baskets in the output file.
    //
-   // There are currently 3 supported sorting order:
+   // There are currently 4 supported sorting order:
    //    SortBasketsByOffset (the default)
    //    SortBasketsByBranch
    //    SortBasketsByEntry
+   //    SortBasketsByCluster
    //
    // When using SortBasketsByOffset the baskets are written in the
    // output file in the same order as in the original file (i.e. the
@@ -2807,6 +2828,19 @@ TTree* TTree::CloneTree(Long64_t nentries /* = -1 */, Option_t* option /* = "" *
    // the file the baskets will be in the order in which they will be
    // needed when reading the whole tree sequentially.
    //
+   // When using SortBasketsByCluster the baskets of each cluster (see
+   // SetAutoFlush) are stored contiguously, sorted by branch and then by
+   // starting entry within the cluster. A TTreeCache then reads a cluster
+   // with one contiguous read (or one per branch when reading only some of
+   // the branches) instead of many scattered ones. This is the layout to
+   // use to rewrite a file for faster reading, e.g. with hadd -c.
+   //
+   // When 'fast' is specified, 'option' can also contain Recompress: the
+   // baskets are then written with the compression settings of the new
+   // tree (i.e. of its file) instead of being copied as they are. They are
+   // unzipped and zipped again in parallel, without being unstreamed, which
+   // is much faster than a copy entry by entry.
+   //
    // For examples of CloneTree, see tutorials:
    //
    //  -- copytree
@@ -3169,12 +3203,14 @@ Long64_t TTree::CopyEntries(TTree* tree, Long64_t nentries /* = -1 */, Option_t*
    // When 'fast' is specified, 'option' can also contains a sorting order for the
    // baskets in the output file.
    //
-   // There are currently 3 supported sorting order:
+   // There are currently 4 supported sorting order:
    //    SortBasketsByOffset (the default)
    //    SortBasketsByBranch
    //    SortBasketsByEntry
+   //    SortBasketsByCluster
    //
-   // See TTree::CloneTree for a detailed explanation of the semantics of these 3 options.
+   // See TTree::CloneTree for a detailed explanation of the semantics of these 4 options.
+   // 'option' can also contain Recompress, see TTree::CloneTree.
    //
    // If the tree or any of the underlying tree of the chain has an index, that index and any
    // index in the subsequent underlying TTree objects will be merged.
@@ -3362,6 +3398,22 @@ TBasket* TTree::CreateBasket(TBranch* branch)
    return new TBasket(branch->GetName(), GetName(), branch);
 }
 
+//______________________________________________________________________________
+Bool_t TTree::DeferBasketWrite(TBasket *basket)
+{
+   // Called by TBranch::Fill when basket is full. While Fill loops on the
+   // branches in parallel compression mode, the basket is queued to be
+   // compressed by the compression threads and written later, in order
+   // (see SetParallelCompression); the branch continues with a new basket.
+   // Returns kFALSE if the basket must be written right away.
+
+   if (!fCollectBaskets) return kFALSE;
+   if (QueueBasket(basket) < 0) {
+      Error("Fill", "Failed writing the baskets of the tree %s, entry=%lld", GetName(), fEntries+1);
+   }
+   return kTRUE;
+}
+
 //______________________________________________________________________________
 void TTree::Delete(Option_t* option /* = "" */)
 {
@@ -4136,6 +4188,12 @@ Int_t TTree::Fill()
    if (fBranchRef) {
       fBranchRef->Clear();
    }
+   // In parallel compression mode the baskets filled up by this entry are
+   // queued to be compressed in parallel (see SetParallelCompression)
+   Bool_t collect = fParallelCompress > 1 && fDirectory && !TestBit(kCircular);
+   if (collect) {
+      fCollectBaskets = kTRUE;
+   }
    for (Int_t i = 0; i < nb; ++i) {
       // Loop over all branches, filling and accumulating bytes written and error counts.
       TBranch* branch = (TBranch*) fBranches.UncheckedAt(i);
@@ -4165,6 +4223,17 @@ Int_t TTree::Fill()
    if (fBranchRef) {
       fBranchRef->Fill();
    }
+   if (collect) {
+      fCollectBaskets = kFALSE;
+      // Write the queued baskets already compressed, without waiting,
+      // except before the first AutoFlush when it depends on the number
+      // of bytes written: all the queued baskets are written then.
+      Int_t nwait = (fFlushedBytes == 0 && (fAutoFlush < 0 || fAutoSave < 0)) ? kMaxInt : 0;
+      if (WriteQueuedBaskets(nwait) < 0) {
+         Error("Fill", "Failed writing the baskets of the tree %s, entry=%lld", GetName(), fEntries+1);
+         ++nerror;
+      }
+   }
    ++fEntries;
    if (fEntries > fMaxEntries) {
       KeepCircular();
@@ -4540,6 +4609,297 @@ Int_t TTree::Fit(const char* funcname, const char* varexp, const char* selection
    return -1;
 }
 
+//______________________________________________________________________________
+static void R__CollectBasketsToFlush(TBranch *branch, TObjArray &baskets)
+{
+   // Add to baskets the baskets of branch and of its sub-branches which
+   // TBranch::FlushBaskets would write, in the same order.
+
+   if (branch->GetDirectory()) {
+      TObjArray *list = branch->GetListOfBaskets();
+      Int_t maxbasket = branch->GetWriteBasket() + 1;
+      for (Int_t i = 0; i < maxbasket; ++i) {
+         TBasket *basket = (TBasket*)list->UncheckedAt(i);
+         if (basket && basket->GetNevBuf() && branch->GetBasketSeek(i) == 0) {
+            baskets.Add(basket);
+         }
+      }
+   }
+   TObjArray *sub = branch->GetListOfBranches();
+   Int_t len = sub->GetEntriesFast();
+   for (Int_t i = 0; i < len; ++i) {
+      TBranch *b = (TBranch*)sub->UncheckedAt(i);
+      if (b) R__CollectBasketsToFlush(b, baskets);
+   }
+}
+
+//______________________________________________________________________________
+//
+// TTreeCompressPool
+//
+// Threads compressing the baskets queued by TTree::QueueBasket (or
+// recompressing those of TTree::RecompressBaskets). The baskets are
+// compressed in the order of their submission; the thread which needs
+// a basket compressed (see Wait) compresses it itself if no thread has
+// started it yet.
+//______________________________________________________________________________
+
+class TTreeCompressPool {
+private:
+   struct TJob {
+      TBasket *fBasket;      // basket to compress
+      Bool_t   fRecompress;  // kTRUE if the basket is recompressed
+   };
+
+   std::vector<TThread*> fThreads;
+   TMutex      fMutex;          // protects the members below
+   TCondition  fWorkCondition;  // signaled when a basket is queued and at shutdown
+   TCondition  fDoneCondition;  // signaled when a basket is compressed
+   std::deque<TJob>   fQueue;   // baskets waiting for a thread
+   std::set<TBasket*> fBusy;    // baskets being compressed by a thread
+   Bool_t      fShutdown;       // kTRUE when the threads must stop
+
+   TTreeCompressPool(Int_t nthreads);
+   ~TTreeCompressPool();
+
+   static void  Compress(const TJob &job);
+   static void *WorkerLoop(void *arg);
+
+public:
+   Bool_t IsDone(TBasket *basket);
+   void   Submit(TBasket *basket, Bool_t recompress = kFALSE);
+   void   Wait(TBasket *basket);
+
+   static TTreeCompressPool *Instance();
+};
+
+//______________________________________________________________________________
+static Int_t R__CompressThreads()
+{
+   // Number of compression threads: one less than the number of cores,
+   // the thread filling the tree works too.
+
+   TThread::Initialize();
+   SysInfo_t info;
+   Int_t ncpus = (gSystem->GetSysInfo(&info) == 0 && info.fCpus > 0) ? info.fCpus : 2;
+   return TMath::Max(1, ncpus - 1);
+}
+
+//______________________________________________________________________________
+TTreeCompressPool::TTreeCompressPool(Int_t nthreads) :
+   fMutex(kTRUE), fWorkCondition(&fMutex), fDoneCondition(&fMutex), fShutdown(kFALSE)
+{
+   // Start nthreads compression threads.
+
+   for (Int_t i = 0; i < nthreads; i++) {
+      TThread *thread = new TThread(TString::Format("BasketZip%d", i), WorkerLoop, (void*)this);
+      fThreads.push_back(thread);
+      thread->Run();
+   }
+}
+
+//______________________________________________________________________________
+TTreeCompressPool::~TTreeCompressPool()
+{
+   // Stop the threads, once the queued baskets are compressed, and join them.
+
+   {
+      R__LOCKGUARD(&fMutex);
+      fShutdown = kTRUE;
+      fWorkCondition.Broadcast();
+   }
+   for (UInt_t i = 0; i < fThreads.size(); i++) {
+      fThreads[i]->Join();
+      delete fThreads[i];
+   }
+}
+
+//______________________________________________________________________________
+TTreeCompressPool *TTreeCompressPool::Instance()
+{
+   // Return the process wide pool, started at the first call (the
+   // initialization of the static is thread safe) and stopped at the
+   // end of the program. Its threads sleep while no basket is queued.
+
+   static TTreeCompressPool pool(R__CompressThreads());
+   return &pool;
+}
+
+//______________________________________________________________________________
+void TTreeCompressPool::Compress(const TJob &job)
+{
+   // Compress the basket of job, in a private compressed buffer (see
+   // TBasket::CompressBuffer), or change the compression of the basket
+   // loaded from a file to the one of its branch (see TBasket::Recompress).
+
+   TBasket *basket = job.fBasket;
+   if (job.fRecompress) {
+      basket->Recompress(basket->GetBranch()->GetCompressionSettings());
+   } else {
+      TDirectory *dir = basket->GetBranch()->GetDirectory();
+      basket->CompressBuffer(dir ? dir->GetFile() : 0, kTRUE);
+   }
+}
+
+//______________________________________________________________________________
+void *TTreeCompressPool::WorkerLoop(void *arg)
+{
+   // Function executed by the compression threads, until the shutdown
+   // of the pool.
+
+   TTreeCompressPool *pool = (TTreeCompressPool*)arg;
+   while (1) {
+      TJob job;
+      {
+         R__LOCKGUARD(&pool->fMutex);
+         while (pool->fQueue.empty() && !pool->fShutdown) pool->fWorkCondition.Wait();
+         if (pool->fQueue.empty()) break;
+         job = pool->fQueue.front();
+         pool->fQueue.pop_front();
+         pool->fBusy.insert(job.fBasket);
+      }
+      Compress(job);
+
+      R__LOCKGUARD(&pool->fMutex);
+      pool->fBusy.erase(job.fBasket);
+      pool->fDoneCondition.Broadcast();
+   }
+   return 0;
+}
+
+//______________________________________________________________________________
+Bool_t TTreeCompressPool::IsDone(TBasket *basket)
+{
+   // Return kTRUE if the basket is neither queued nor being compressed.
+
+   R__LOCKGUARD(&fMutex);
+   if (fBusy.count(basket)) return kFALSE;
+   for (std::deque<TJob>::const_iterator it = fQueue.begin(); it != fQueue.end(); ++it) {
+      if (it->fBasket == basket) return kFALSE;
+   }
+   return kTRUE;
+}
+
+//______________________________________________________________________________
+void TTreeCompressPool::Submit(TBasket *basket, Bool_t recompress)
+{
+   // Queue the basket for its compression (or its recompression).
+   // The basket must not be modified until Wait returns for it.
+
+   TJob job;
+   job.fBasket = basket;
+   job.fRecompress = recompress;
+   R__LOCKGUARD(&fMutex);
+   fQueue.push_back(job);
+   fWorkCondition.Signal();
+}
+
+//______________________________________________________________________________
+void TTreeCompressPool::Wait(TBasket *basket)
+{
+   // Return when the basket is compressed. The calling thread compresses
+   // the basket if it is still queued.
+
+   TJob job;
+   {
+      R__LOCKGUARD(&fMutex);
+      std::deque<TJob>::iterator it = fQueue.begin();
+      while (it != fQueue.end() && it->fBasket != basket) ++it;
+      if (it == fQueue.end()) {
+         while (fBusy.count(basket)) fDoneCondition.Wait();
+         return;
+      }
+      job = *it;
+      fQueue.erase(it);
+   }
+   Compress(job);
+}
+
+//______________________________________________________________________________
+Int_t TTree::QueueBasket(TBasket *basket) const
+{
+   // Append the full basket to the baskets written in order in parallel
+   // compression mode and hand it to the compression threads. At most
+   // fParallelCompress baskets are queued: when the queue is full, its
+   // first baskets are written beforehand (waiting for their compression
+   // if needed). The basket must be the write basket of its branch or a
+   // basket not yet written (see TBranch::FlushOneBasket).
+   //
+   // Return the number of bytes written or -1 in case of write error.
+
+   if (!fBasketsToWrite) const_cast<TTree*>(this)->fBasketsToWrite = new TList();
+   Int_t nbytes = 0;
+   Int_t nwait = fBasketsToWrite->GetSize() - TMath::Max(1, fParallelCompress) + 1;
+   if (nwait > 0) nbytes = WriteQueuedBaskets(nwait);
+
+   TBranch *branch = basket->GetBranch();
+   if (basket->GetBufferRef()->IsReading()) {
+      basket->SetWriteMode();
+   }
+   TFile *file = branch->GetFile(1);
+   if (file && file->IsWritable() && branch->GetCompressionLevel() > 0 &&
+       !basket->GetBufferRef()->TestBit(TBufferFile::kNotDecompressed)) {
+      TTreeCompressPool::Instance()->Submit(basket);
+   }
+   fBasketsToWrite->Add(basket);
+   return nbytes;
+}
+
+//______________________________________________________________________________
+void TTree::WaitQueuedBaskets()
+{
+   // Wait for the compression of the queued baskets and forget them,
+   // without writing them (they are deleted with their branch).
+
+   if (!fBasketsToWrite) return;
+   TIter next(fBasketsToWrite);
+   while (TBasket *basket = (TBasket*)next()) {
+      TTreeCompressPool::Instance()->Wait(basket);
+   }
+   fBasketsToWrite->Clear();
+}
+
+//______________________________________________________________________________
+Int_t TTree::WriteQueuedBaskets(Int_t nwait) const
+{
+   // Write in order the baskets queued by QueueBasket: the nwait first
+   // ones, waiting for their compression if needed, then the following
+   // ones as long as their compression is over.
+   //
+   // Return the number of bytes written or -1 in case of write error.
+
+   if (!fBasketsToWrite) return 0;
+   Int_t nbytes = 0;
+   Int_t nerror = 0;
+   TTreeCompressPool *pool = 0;
+   while (TBasket *basket = (TBasket*)fBasketsToWrite->First()) {
+      if (!pool) pool = TTreeCompressPool::Instance();
+      if (nwait > 0) {
+         pool->Wait(basket);
+         --nwait;
+      } else if (!pool->IsDone(basket)) {
+         break;
+      }
+      fBasketsToWrite->RemoveFirst();
+      TBranch *branch = basket->GetBranch();
+      TObjArray *list = branch->GetListOfBaskets();
+      Int_t where = branch->GetWriteBasket();
+      while (where >= 0 && list->UncheckedAt(where) != basket) --where;
+      if (where < 0) continue;
+      Int_t nwrite = branch->WriteBasket(basket, where);
+      if (nwrite < 0) {
+         ++nerror;
+      } else {
+         nbytes += nwrite;
+      }
+   }
+   if (nerror) {
+      return -1;
+   } else {
+      return nbytes;
+   }
+}
+
 //______________________________________________________________________________
 Int_t TTree::FlushBaskets() const
 {
@@ -4552,6 +4912,29 @@ Int_t TTree::FlushBaskets() const
    Int_t nerror = 0;
    TObjArray *lb = const_cast<TTree*>(this)->GetListOfBranches();
    Int_t nb = lb->GetEntriesFast();
+   if (fParallelCompress > 1) {
+      // Compress in parallel the baskets which are going to be written
+      // below and write them in the same order.
+      TObjArray baskets;
+      for (Int_t j = 0; j < nb; j++) {
+         TBranch* branch = (TBranch*) lb->UncheckedAt(j);
+         if (branch) R__CollectBasketsToFlush(branch, baskets);
+      }
+      if (baskets.GetEntriesFast() > 1) {
+         for (Int_t j = 0; j < baskets.GetEntriesFast(); j++) {
+            if (QueueBasket((TBasket*)baskets.UncheckedAt(j)) < 0) ++nerror;
+         }
+      }
+   }
+   if (fBasketsToWrite && fBasketsToWrite->GetSize()) {
+      // Write all the queued baskets, those filled up by Fill first.
+      Int_t nwrite = WriteQueuedBaskets(kMaxInt);
+      if (nwrite<0) {
+         ++nerror;
+      } else {
+         nbytes += nwrite;
+      }
+   }
    for (Int_t j = 0; j < nb; j++) {
       TBranch* branch = (TBranch*) lb->UncheckedAt(j);
       if (branch) {
@@ -5204,6 +5587,16 @@ const char* TTree::GetFriendAlias(TTree* tree) const
    return 0;
 }
 
+//______________________________________________________________________________
+Int_t TTree::GetImplicitMT()
+{
+   // Static function returning the number of threads used by TTree::Process
+   // (see SetImplicitMT). A value <= 1 means that the entries are processed
+   // sequentially.
+
+   return fgImplicitMT;
+}
+
 //______________________________________________________________________________
 TIterator* TTree::GetIteratorOnAllLeaves(Bool_t dir)
 {
@@ -6462,6 +6855,9 @@ Long64_t TTree::Process(TSelector* selector, Option_t* option, Long64_t nentries
    //  If the Tree (Chain) has an associated EventList, the loop is on the nentries
    //  of the EventList, starting at firstentry, otherwise the loop is on the
    //  specified Tree entries.
+   //
+   //  The entries can be processed by several threads, with one instance
+   //  of the selector per thread, see TTree::SetImplicitMT.
 
    GetPlayer();
    if (fPlayer) {
@@ -6832,6 +7228,23 @@ Long64_t TTree::ReadStream(std::istream& inputStream, const char *branchDescript
    return nGoodLines;
 }
 
+//______________________________________________________________________________
+void TTree::RecompressBaskets(TBasket **baskets, Int_t n)
+{
+   // Change, in parallel, the compression of the n baskets loaded by
+   // TBasket::LoadBasketBuffers to the compression settings of their
+   // branch (see TBasket::Recompress). This is used by TTreeCloner
+   // for the option "Recompress".
+
+   if (n > 1) {
+      TTreeCompressPool *pool = TTreeCompressPool::Instance();
+      for (Int_t i = 0; i < n; ++i) pool->Submit(baskets[i], kTRUE);
+      for (Int_t i = 0; i < n; ++i) pool->Wait(baskets[i]);
+   } else if (n == 1) {
+      baskets[0]->Recompress(baskets[0]->GetBranch()->GetCompressionSettings());
+   }
+}
+
 //______________________________________________________________________________
 void TTree::RecursiveRemove(TObject *obj)
 {
@@ -6934,6 +7347,7 @@ void TTree::Reset(Option_t* option)
 {
    // Reset baskets, buffers and entries count in all branches and leaves.
 
+   WaitQueuedBaskets();
    fNotify        = 0;
    fEntries       = 0;
    fNClusterRange = 0;
@@ -6964,6 +7378,7 @@ void TTree::ResetAfterMerge(TFileMergeInfo *info)
    // Resets the state of this TTree after a merge (keep the customization but
    // forget the data).
 
+   WaitQueuedBaskets();
    fEntries       = 0;
    fNClusterRange = 0;
    fTotBytes      = 0;
@@ -7234,6 +7649,43 @@ void TTree::SetBasketSize(const char* bname, Int_t buffsize)
    }
 }
 
+//_______________________________________________________________________
+void TTree::SetBasketStatistics(const char* bname, Bool_t enable)
+{
+   // Enable (or disable) the recording of the minimum and the maximum of
+   // the values of each basket of the branches matching bname
+   // (see TBranch::SetBasketStatistics).
+   //
+   // if bname="*", apply to all branches.
+   // if bname="xxx*", apply to all branches with name starting with xxx
+   // see TRegexp for wildcarding options
+   //
+   // The branches which do not support the statistics are ignored.
+   // With the statistics, TTree::Draw skips the baskets (or the clusters)
+   // which cannot pass the cuts of the selection on these branches, e.g.
+   //
+   //    tree->SetBasketStatistics("*");
+   //    ... fill and write the tree
+   //    tree->Draw("eta", "pt>500 && abs(eta)<2");  // skips the baskets of pt with max(pt)<=500
+
+   Int_t nleaves = fLeaves.GetEntriesFast();
+   TRegexp re(bname, kTRUE);
+   Int_t nb = 0;
+   for (Int_t i = 0; i < nleaves; i++)  {
+      TLeaf* leaf = (TLeaf*) fLeaves.UncheckedAt(i);
+      TBranch* branch = (TBranch*) leaf->GetBranch();
+      TString s = branch->GetName();
+      if (strcmp(bname, branch->GetName()) && (s.Index(re) == kNPOS)) {
+         continue;
+      }
+      nb++;
+      branch->SetBasketStatistics(enable);
+   }
+   if (!nb) {
+      Error("SetBasketStatistics", "unknown branch -> '%s'", bname);
+   }
+}
+
 //_______________________________________________________________________
 Int_t TTree::SetBranchAddress(const char* bname, void* addr, TBranch** ptr)
 {
@@ -7898,6 +8350,38 @@ void TTree::SetFileNumber(Int_t number)
    fFileNumber = number;
 }
 
+//______________________________________________________________________________
+void TTree::SetImplicitMT(Int_t nthreads)
+{
+   // Static function setting the number of threads used by TTree::Process
+   // and TChain::Process when called with a TSelector.
+   // If nthreads < 0 (default) the number of cores of the machine is used,
+   // nthreads = 0 or 1 restores the sequential processing.
+   //
+   // In the multithreaded mode the clusters of the requested entry range are
+   // distributed among the threads. Each thread opens its own copy of the
+   // tree (or chain) and runs its own instance of the selector, created
+   // with the default constructor of the selector class. As with PROOF,
+   // Begin and Terminate are called on the original selector while
+   // SlaveBegin, Init, Notify, Process and SlaveTerminate are called on the
+   // instances; the objects added to their fOutput lists are merged
+   // (via their Merge function) into the output list of the original
+   // selector before Terminate is called.
+   //
+   // The entries are processed sequentially if the selector is not
+   // compiled, has no default constructor or uses the old ProcessCut/
+   // ProcessFill interface, or if the tree has friends, an entry or event
+   // list, or is not attached to a file.
+   //
+   // The same number of threads is used to build a TTreeCompactIndex.
+
+   if (nthreads < 0) {
+      SysInfo_t info;
+      nthreads = (gSystem->GetSysInfo(&info) == 0 && info.fCpus > 0) ? info.fCpus : 1;
+   }
+   fgImplicitMT = nthreads;
+}
+
 //______________________________________________________________________________
 void TTree::SetMakeClass(Int_t make)
 {
@@ -7988,6 +8472,46 @@ void TTree::SetObject(const char* name, const char* title)
    }
 }
 
+//______________________________________________________________________________
+void TTree::SetParallelCompression(Bool_t opt, Int_t maxBaskets)
+{
+   // Enable or disable the parallel compression of the baskets written by
+   // Fill and FlushBaskets.
+   //
+   // The baskets filled up by one entry in Fill, and the baskets written
+   // by FlushBaskets (i.e. at each AutoFlush and AutoSave), are compressed
+   // by a pool of threads shared by all the trees, and then written by the
+   // calling thread in the same order as in the sequential mode. For a file
+   // holding only the tree, the result is identical to the file written
+   // sequentially.
+   //
+   // Fill does not wait for the compression of the baskets: they are
+   // queued, and written as soon as they and the baskets queued before
+   // them are compressed. maxBaskets is the maximum number of baskets in
+   // the queue (compressed or not, over all the entries filled), each of
+   // them keeping its data and a private buffer of the size of its
+   // compressed data in memory; Fill waits only when the queue is full.
+   // The default (maxBaskets < 0) is twice the number of cores.
+   // FlushBaskets (hence AutoSave and Write) writes all the queued baskets.
+   //
+   // Note that baskets written by a direct call to TBranch::Fill or
+   // TBranch::FlushBaskets are still compressed sequentially.
+
+   if (fBasketsToWrite && fBasketsToWrite->GetSize()) {
+      WriteQueuedBaskets(kMaxInt);
+   }
+   if (!opt) {
+      fParallelCompress = 0;
+      return;
+   }
+   if (maxBaskets < 0) {
+      SysInfo_t info;
+      Int_t ncpus = (gSystem->GetSysInfo(&info) == 0 && info.fCpus > 0) ? info.fCpus : 1;
+      maxBaskets = 2*ncpus;
+   }
+   fParallelCompress = maxBaskets;
+}
+
 //______________________________________________________________________________
 void TTree::SetParallelUnzip(Bool_t opt, Float_t RelSize)
 {
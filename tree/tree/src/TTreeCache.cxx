@@ -36,6 +36,15 @@
 //   Once the training is done on the first Tree, the list of branches  //
 //   in the cache is kept for the following files.                      //
 //                                                                      //
+//  -Adaptive mode (see TTreeCache::SetAdaptive)                        //
+//   After the learning phase the cache keeps following the branches    //
+//   actually read: a branch read for the first time is added to the    //
+//   cache, a branch not read during the last two filled ranges is      //
+//   removed from it, and the read-ahead is doubled (up to a maximum)   //
+//   when the reading of the buffers takes a small fraction of the      //
+//   time, i.e. when the processing is CPU bound. The learnt branches   //
+//   and read-ahead are kept for the following files of a TChain.       //
+//                                                                      //
 //  -Special case of a TEventlist                                       //
 //   if the Tree or TChain has a TEventlist, only the buffers           //
 //   referenced by the list are put in the cache.                       //
@@ -246,10 +255,15 @@
 #include "TLeaf.h"
 #include "TFriendElement.h"
 #include "TFile.h"
+#include "TTimeStamp.h"
 #include <limits.h>
 
 Int_t TTreeCache::fgLearnEntries = 100;
 
+// In adaptive mode, the read-ahead is doubled when reading the last buffer
+// took less than this fraction of the time spent since the previous fill.
+static const Double_t kCPUBoundFraction = 0.1;
+
 ClassImp(TTreeCache)
 
 //______________________________________________________________________________
@@ -276,7 +290,15 @@ TTreeCache::TTreeCache() : TFileCacheRead(),
    fReadDirectionSet(kFALSE),
    fEnabled(kTRUE),
    fPrefillType(GetConfiguredPrefillType()),
-   fAutoSized(kFALSE)
+   fAutoSized(kFALSE),
+   fAdaptive(GetConfiguredAdaptive()),
+   fEntryPrev(-1),
+   fBufferSizeMax(0),
+   fFillTime(0),
+   fFillReadTime(0),
+   fNAdded(0),
+   fNPruned(0),
+   fBrPruned(0)
 {
    // Default Constructor.
 }
@@ -305,13 +327,22 @@ TTreeCache::TTreeCache(TTree *tree, Int_t buffersize) : TFileCacheRead(tree->Get
    fReadDirectionSet(kFALSE),
    fEnabled(kTRUE),
    fPrefillType(GetConfiguredPrefillType()),
-   fAutoSized(kFALSE)
+   fAutoSized(kFALSE),
+   fAdaptive(GetConfiguredAdaptive()),
+   fEntryPrev(-1),
+   fBufferSizeMax(0),
+   fFillTime(0),
+   fFillReadTime(0),
+   fNAdded(0),
+   fNPruned(0),
+   fBrPruned(0)
 {
    // Constructor.
 
    fEntryNext = fEntryMin + fgLearnEntries;
    Int_t nleaves = tree->GetListOfLeaves()->GetEntries();
    fBranches = new TObjArray(nleaves);
+   fBufferSizeMax = 4*fBufferSizeMin;
 }
 
 //______________________________________________________________________________
@@ -325,6 +356,7 @@ TTreeCache::~TTreeCache()
 
    delete fBranches;
    if (fBrNames) {fBrNames->Delete(); delete fBrNames; fBrNames=0;}
+   if (fBrPruned) {fBrPruned->Delete(); delete fBrPruned; fBrPruned=0;}
 }
 
 //_____________________________________________________________________________
@@ -659,6 +691,24 @@ Bool_t TTreeCache::FillBuffer()
    if (fEntryMax <= 0) fEntryMax = tree->GetEntries();
    if (fEntryNext > fEntryMax) fEntryNext = fEntryMax;
 
+   if (fAdaptive && !fIsLearning && !fIsManual && !fReverseRead) {
+      // Adaptive mode: when moving to the next range of entries, remove the
+      // branches no longer read and grow the read-ahead if the reading of the
+      // previous fill was short compared to the processing of its entries.
+      Double_t now = TTimeStamp().AsDouble();
+      if (fEntryCurrentMax >= 0 && fEntryCurrent > fEntryCurrentMax) {
+         PruneBranches();
+         fEntryPrev = fEntryCurrentMax;
+         if (!fEnablePrefetching && fFillTime > 0 && fBufferSizeMin < fBufferSizeMax &&
+             fFillReadTime < kCPUBoundFraction * (now - fFillTime)) {
+            Long64_t size = 2 * (Long64_t)fBufferSizeMin;
+            fBufferSizeMin = size < fBufferSizeMax ? (Int_t)size : fBufferSizeMax;
+            if (gDebug > 0) Info("FillBuffer", "read-ahead increased to %d bytes", fBufferSizeMin);
+         }
+      }
+      fFillTime = now;
+   }
+
    if ( fEnablePrefetching ) {
       if ( entry == fEntryMax ) {
          // We are at the end, no need to do anything else
@@ -866,6 +916,25 @@ Bool_t TTreeCache::FillBuffer()
    return kTRUE;
 }
 
+//_____________________________________________________________________________
+Bool_t TTreeCache::GetConfiguredAdaptive() const
+{
+   // Return whether the cache is adaptive (see SetAdaptive) from the
+   // environment variable ROOT_TTREECACHE_ADAPTIVE or the resource variable
+   // TTreeCache.Adaptive (0 by default).
+
+   const char *stcp;
+   Int_t s = 0;
+
+   if (!(stcp = gSystem->Getenv("ROOT_TTREECACHE_ADAPTIVE")) || !*stcp) {
+      s = gEnv->GetValue("TTreeCache.Adaptive", 0);
+   } else {
+      s = TString(stcp).Atoi();
+   }
+
+   return s != 0;
+}
+
 //______________________________________________________________________________
 TTreeCache::EPrefillType TTreeCache::GetConfiguredPrefillType() const
 {
@@ -949,6 +1018,10 @@ void TTreeCache::Print(Option_t *option) const
    printf("Cache Efficiency ..................: %f\n",GetEfficiency());
    printf("Cache Efficiency Rel...............: %f\n",GetEfficiencyRel());
    printf("Learn entries......................: %d\n",TTreeCache::GetLearnEntries());
+   if (fAdaptive) {
+      printf("Adaptive: branches added/removed..: %d / %d\n",fNAdded,fNPruned);
+      printf("Adaptive: read-ahead / maximum.....: %d / %d bytes\n",fBufferSizeMin,fBufferSizeMax);
+   }
    if ( opt.Contains("cachedbranches") ) {
       opt.ReplaceAll("cachedbranches","");
       printf("Cached branches....................:\n");
@@ -977,7 +1050,10 @@ Int_t TTreeCache::ReadBufferNormal(char *buf, Long64_t pos, Int_t len){
    //not found in cache. Do we need to fill the cache?
    Bool_t bufferFilled = FillBuffer();
    if (bufferFilled) {
+      // The first read after a fill transfers the whole buffer.
+      Double_t start = fAdaptive ? TTimeStamp().AsDouble() : 0;
       Int_t res = TFileCacheRead::ReadBuffer(buf,pos,len);
+      if (fAdaptive) fFillReadTime = TTimeStamp().AsDouble() - start;
 
       if (res == 1)
          fNReadOk++;
@@ -1060,6 +1136,34 @@ void TTreeCache::ResetCache()
    }
 }
 
+//_____________________________________________________________________________
+void TTreeCache::SetAdaptive(Bool_t adaptive, Int_t maxsize)
+{
+   // Set whether the cache keeps adapting after the learning phase:
+   //  - a branch read for the first time after the learning phase is
+   //    added to the cache (and the current cluster is filled again),
+   //  - a branch which has not been read during the last two ranges of
+   //    entries put in the cache is removed from the cache; if it is read
+   //    again, it is put back in the cache for the following fills, and
+   //    kept there from then on,
+   //  - the read-ahead, i.e. the amount of data read at each fill (initially
+   //    the cache size), is doubled when reading the previous fill took less
+   //    than 10% of the time between the two fills, up to maxsize bytes
+   //    (4 times the cache size if maxsize is 0).
+   // The adaptation is not done when the branches were set by the user
+   // (StopLearningPhase), for the reverse reading and, for the read-ahead,
+   // with the asynchronous prefetching.
+   // The set of branches and the read-ahead are kept when a TChain switches
+   // to the next file. The default can be set with TTreeCache.Adaptive or
+   // the environment variable ROOT_TTREECACHE_ADAPTIVE.
+
+   fAdaptive = adaptive;
+   if (maxsize > 0) fBufferSizeMax = maxsize;
+   else if (fBufferSizeMax < fBufferSizeMin) fBufferSizeMax = 4*fBufferSizeMin;
+   fFillTime = 0;
+   fFillReadTime = 0;
+}
+
 //_____________________________________________________________________________
 void TTreeCache::SetEntryRange(Long64_t emin, Long64_t emax)
 {
@@ -1175,6 +1279,8 @@ void TTreeCache::UpdateBranches(TTree *tree)
    fEntryMax  = fTree->GetEntries();
 
    fEntryCurrent = -1;
+   fEntryPrev = -1;
+   fFillTime = 0;
 
    if (fBrNames->GetEntries() == 0 && fIsLearning) {
       // We still need to learn.
@@ -1198,6 +1304,77 @@ void TTreeCache::UpdateBranches(TTree *tree)
    }
 }
 
+//_____________________________________________________________________________
+void TTreeCache::LearnBranch(TBranch *b, Bool_t subbranches /*= kFALSE*/)
+{
+   // Add to the cache a branch read after the end of the learning phase,
+   // in adaptive mode (see SetAdaptive). This function is called by
+   // TBranch::GetBasket.
+
+   if (!fAdaptive || fIsLearning || fIsManual) return;
+
+   // Reject branch that are not from the cached tree.
+   if (!b || !fTree || fTree->GetTree() != b->GetTree()) return;
+
+   for (Int_t i = 0; i < fNbranches; ++i) {
+      if (fBranches->UncheckedAt(i) == b) return;
+   }
+   fBranches->AddAtAndExpand(b, fNbranches);
+   fBrNames->Add(new TObjString(b->GetName()));
+   fNbranches++;
+   fNAdded++;
+   if (gDebug > 0) printf("Entry: %lld, adding branch: %s\n",b->GetTree()->GetReadEntry(),b->GetName());
+
+   // Fill again the current cluster, including the new branch, at the next
+   // miss. A branch removed by PruneBranches and read again is instead read
+   // directly until the next fill: its baskets were read with the others
+   // until recently and refilling the whole cluster for them would read the
+   // other branches twice. Such a branch is not removed again (see
+   // PruneBranches), so that a branch read at long intervals does not keep
+   // being removed and added.
+   if (!fEnablePrefetching && !(fBrPruned && fBrPruned->FindObject(b->GetName()))) fEntryNext = -1;
+
+   if (subbranches) {
+      TObjArray *lb = b->GetListOfBranches();
+      Int_t nb = lb->GetEntriesFast();
+      for (Int_t j = 0; j < nb; j++) {
+         TBranch* branch = (TBranch*) lb->UncheckedAt(j);
+         if (!branch) continue;
+         LearnBranch(branch, subbranches);
+      }
+   }
+}
+
+//_____________________________________________________________________________
+void TTreeCache::PruneBranches()
+{
+   // Remove from the cache the branches which have not been read since
+   // fEntryPrev, i.e. during the last two ranges of entries put in the
+   // cache (adaptive mode, see SetAdaptive). A branch is removed only once:
+   // if it is read again, it stays in the cache (see LearnBranch).
+
+   if (fEntryPrev < 0) return;
+   Int_t nkept = 0;
+   for (Int_t i = 0; i < fNbranches; ++i) {
+      TBranch *b = (TBranch*)fBranches->UncheckedAt(i);
+      if (b->GetReadEntry() < fEntryPrev && !(fBrPruned && fBrPruned->FindObject(b->GetName()))) {
+         if (gDebug > 0) printf("Entry: %lld, removing branch: %s\n",b->GetTree()->GetReadEntry(),b->GetName());
+         TObject *name = fBrNames->FindObject(b->GetName());
+         if (name) {
+            fBrNames->Remove(name);
+            delete name;
+         }
+         if (!fBrPruned) fBrPruned = new TList;
+         fBrPruned->Add(new TObjString(b->GetName()));
+         fNPruned++;
+         continue;
+      }
+      fBranches->AddAt(b, nkept++);
+   }
+   for (Int_t i = nkept; i < fNbranches; ++i) fBranches->AddAt(0, i);
+   fNbranches = nkept;
+}
+
 //_____________________________________________________________________________
 void TTreeCache::LearnPrefill()
 {
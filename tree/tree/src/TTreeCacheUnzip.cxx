@@ -24,17 +24,27 @@
 // Parallel Unzipping                                                   //
 //                                                                      //
 // TTreeCache has been specialised in order to let additional threads   //
-//  free to unzip in advance its content. In this implementation we     //
-//  support up to 10 threads, but right now it makes more sense to      //
-//  limit their number to 1-2                                           //
+//  free to unzip in advance its content. Every basket of the current   //
+//  cluster is an independent unzip task. The tasks are executed by a   //
+//  pool of worker threads shared by all the TTreeCacheUnzip instances  //
+//  of the process. Each worker owns a queue of tasks and, when its own //
+//  queue is empty, steals tasks from the queues of the other workers.  //
+//  The size of the pool is set with                                    //
+//    TTreeCacheUnzip::SetUnzipThreads(Int_t nthreads)                  //
+//  and defaults to the number of cores of the machine.                 //
 //                                                                      //
 // The application reading data is carefully synchronized, in order to: //
 //  - if the block it wants is not unzipped, it self-unzips it without  //
 //     waiting                                                          //
+//  - if the block is queued but no worker started on it yet, it takes  //
+//    the block back from the pool and unzips it itself                 //
 //  - if the block is being unzipped in parallel, it waits only         //
 //    for that unzip to finish                                          //
 //  - if the block has already been unzipped, it takes it               //
 //                                                                      //
+// New tasks are only handed to the pool while the estimated size of    //
+//  the unzipped blocks stays below fUnzipBufferSize.                   //
+//                                                                      //
 // This is supposed to cancel a part of the unzipping latency, at the   //
 //  expenses of cpu time.                                               //
 //                                                                      //
@@ -57,12 +67,18 @@
 #include "Bytes.h"
 
 #include "TEnv.h"
+#include "TTimeStamp.h"
+#include "TVirtualPerfStats.h"
+
+#include <atomic>
+#include <deque>
+#include <vector>
 
-#define THREADCNT 2
 extern "C" void R__unzip(Int_t *nin, UChar_t *bufin, Int_t *lout, char *bufout, Int_t *nout);
 extern "C" int R__unzip_header(Int_t *nin, UChar_t *bufin, Int_t *lout);
 
 TTreeCacheUnzip::EParUnzipMode TTreeCacheUnzip::fgParallel = TTreeCacheUnzip::kDisable;
+Int_t TTreeCacheUnzip::fgNThreads = 0;
 
 // The unzip cache does not consume memory by itself, it just allocates in advance
 // mem blocks which are then picked as they are by the baskets.
@@ -73,15 +89,18 @@ ClassImp(TTreeCacheUnzip)
 
 //______________________________________________________________________________
 TTreeCacheUnzip::TTreeCacheUnzip() : TTreeCache(),
-
    fActiveThread(kFALSE),
    fAsyncReading(kFALSE),
    fCycle(0),
    fLastReadPos(0),
-   fBlocksToGo(0),
+   fNextToSchedule(0),
+   fNTasksInFlight(0),
+   fPendingUnzipBytes(0),
+   fUnzipRatio(1),
    fUnzipLen(0),
    fUnzipChunks(0),
    fUnzipStatus(0),
+   fUnzipTimes(0),
    fTotalUnzipBytes(0),
    fNseekMax(0),
    fUnzipBufferSize(0),
@@ -102,10 +121,14 @@ TTreeCacheUnzip::TTreeCacheUnzip(TTree *tree, Int_t buffersize) : TTreeCache(tre
    fAsyncReading(kFALSE),
    fCycle(0),
    fLastReadPos(0),
-   fBlocksToGo(0),
+   fNextToSchedule(0),
+   fNTasksInFlight(0),
+   fPendingUnzipBytes(0),
+   fUnzipRatio(1),
    fUnzipLen(0),
    fUnzipChunks(0),
    fUnzipStatus(0),
+   fUnzipTimes(0),
    fTotalUnzipBytes(0),
    fNseekMax(0),
    fUnzipBufferSize(0),
@@ -127,7 +150,6 @@ void TTreeCacheUnzip::Init()
    fMutexList        = new TMutex(kTRUE);
    fIOMutex          = new TMutex(kTRUE);
 
-   fUnzipStartCondition   = new TCondition(fMutexList);
    fUnzipDoneCondition   = new TCondition(fMutexList);
 
    fTotalUnzipBytes = 0;
@@ -149,9 +171,7 @@ void TTreeCacheUnzip::Init()
 
       fParallel = kTRUE;
 
-      for (Int_t i = 0; i < 10; i++) fUnzipThread[i] = 0;
-
-      StartThreadUnzip(THREADCNT);
+      StartThreadUnzip();
 
    }
    else {
@@ -169,18 +189,17 @@ void TTreeCacheUnzip::Init()
 //______________________________________________________________________________
 TTreeCacheUnzip::~TTreeCacheUnzip()
 {
-   // destructor. (in general called by the TFile destructor
    // destructor. (in general called by the TFile destructor)
-
-   ResetCache();
+   // The workers are stopped first, so that ResetCache does not hand
+   // new blocks to the pool.
 
    if (IsActiveThread())
       StopThreadUnzip();
 
+   ResetCache();
 
    delete [] fUnzipLen;
 
-   delete fUnzipStartCondition;
    delete fUnzipDoneCondition;
 
 
@@ -188,6 +207,7 @@ TTreeCacheUnzip::~TTreeCacheUnzip()
    delete fIOMutex;
 
    delete [] fUnzipStatus;
+   delete [] fUnzipTimes;
    delete [] fUnzipChunks;
 }
 
@@ -385,25 +405,17 @@ Bool_t TTreeCacheUnzip::IsQueueEmpty()
    return kFALSE;
 }
 
-void TTreeCacheUnzip::WaitUnzipStartSignal()
-{
-   // Here the threads sleep waiting for some blocks to unzip
-
-   fUnzipStartCondition->TimedWaitRelative(2000);
-
-}
 //_____________________________________________________________________________
-void TTreeCacheUnzip::SendUnzipStartSignal(Bool_t broadcast)
+void TTreeCacheUnzip::SendUnzipStartSignal(Bool_t /* broadcast */)
 {
-   // This will send the signal corresponfing to the queue... normally used
-   // when we want to start processing the list of buffers.
+   // This will hand new blocks to the unzip pool... normally used
+   // when we want to start processing the list of buffers or when some
+   // room has been freed in the unzip buffer.
 
-   if (gDebug > 0) Info("SendSignal", " fUnzipCondition->Signal()");
+   if (gDebug > 0) Info("SendSignal", " ScheduleUnzip()");
 
-   if (broadcast)
-      fUnzipStartCondition->Broadcast();
-   else
-      fUnzipStartCondition->Signal();
+   R__LOCKGUARD(fMutexList);
+   ScheduleUnzip();
 }
 
 //_____________________________________________________________________________
@@ -425,134 +437,461 @@ Int_t TTreeCacheUnzip::SetParallelUnzip(TTreeCacheUnzip::EParUnzipMode option)
    return 0;
 }
 
+//______________________________________________________________________________
+//
+// TTreeCacheUnzipPool
+//
+// Pool of worker threads shared by all the TTreeCacheUnzip instances.
+// Each task is the unzipping of one basket of one cache. A task is pushed
+// on the queue of one worker (round robin); a worker takes the oldest task
+// of its own queue and, when it is empty, steals the newest task of the
+// queue of another worker.
+//______________________________________________________________________________
 
-class TTreeCacheUnzipData {
+class TTreeCacheUnzipPool {
 public:
-   TTreeCacheUnzip *fInstance;
-   Int_t            fCount;
+   struct Task_t {
+      TTreeCacheUnzip *fCache;     // cache owning the block
+      Int_t            fIndex;     // index of the block in the cache requests
+      Int_t            fCycle;     // cache cycle at submission time
+      Long64_t         fEstimate;  // estimated unzipped size of the block
+   };
+
+   struct Worker_t {
+      TThread            *fThread;
+      TMutex              fMutex;     // protects the members below
+      std::deque<Task_t>  fQueue;     // tasks assigned to this worker
+      Double_t            fBusyTime;  // seconds spent executing tasks
+      Long64_t            fNTasks;    // number of tasks executed
+      Long64_t            fNStolen;   // number of tasks stolen from other workers
+      Worker_t() : fThread(0), fBusyTime(0), fNTasks(0), fNStolen(0) {}
+   };
+
+private:
+   struct WorkerArg_t {
+      TTreeCacheUnzipPool *fPool;
+      Worker_t            *fWorker;
+      Int_t                fIndex;
+   };
+
+   // fMutex protects all the members below, including the set of workers;
+   // it is always taken before the mutex of a worker.
+   std::vector<Worker_t*> fWorkers;
+   std::vector<Task_t>    fPending;  // tasks submitted while the pool is resized
+   TMutex      fMutex;
+   TCondition  fWorkCondition;
+   TMutex      fResizeMutex;  // serializes the calls to Resize
+   Int_t       fNQueued;      // total number of queued tasks
+   Bool_t      fStop;
+   UInt_t      fNext;         // next worker receiving a task
+
+   Bool_t      PopTask(Worker_t *me, Int_t worker, Task_t &task);
+   void        QueueTask(const Task_t &task);
+   static void *WorkerLoop(void *arg);
+
+public:
+   TTreeCacheUnzipPool() : fMutex(kTRUE), fWorkCondition(&fMutex), fNQueued(0), fStop(kFALSE), fNext(0) {}
+
+   Int_t    GetNWorkers() { R__LOCKGUARD(&fMutex); return fWorkers.size(); }
+   Bool_t   GetWorkerStats(Int_t i, Double_t &busytime, Long64_t &ntasks, Long64_t &nstolen);
+   Int_t    RemoveTasks(TTreeCacheUnzip *cache);
+   void     Resize(Int_t nworkers);
+   void     Submit(const Task_t &task);
+
+   static TTreeCacheUnzipPool *Instance(Bool_t create = kTRUE);
 };
 
 //_____________________________________________________________________________
-Int_t TTreeCacheUnzip::StartThreadUnzip(Int_t nthreads)
+TTreeCacheUnzipPool *TTreeCacheUnzipPool::Instance(Bool_t create)
 {
-   // The Thread is only a part of the TTreeCache but it is the part that
-   // waits for info in the queue and process it... unfortunatly, a Thread is
-   // not an object an we have to deal with it in the old C-Style way
-   // Returns 0 if the thread was initialized or 1 if it was already running
-   Int_t nt = nthreads;
-   if (nt > 10) nt = 10;
+   // Return the process wide pool, create it with the requested number of
+   // workers if needed. The pool is never deleted, its workers sleep while
+   // there is nothing to unzip.
+
+   static std::atomic<TTreeCacheUnzipPool*> pool(0);
+   TTreeCacheUnzipPool *p = pool.load(std::memory_order_acquire);
+   if (!p && create) {
+      R__LOCKGUARD(gGlobalMutex);
+      p = pool.load(std::memory_order_relaxed);
+      if (!p) {
+         p = new TTreeCacheUnzipPool;
+         p->Resize(TTreeCacheUnzip::GetUnzipThreads());
+         pool.store(p, std::memory_order_release);
+      }
+   }
+   return p;
+}
 
-   if (gDebug > 0)
-      Info("StartThreadUnzip", "Going to start %d threads.", nt);
+//_____________________________________________________________________________
+void TTreeCacheUnzipPool::Resize(Int_t nworkers)
+{
+   // Stop the current workers and start nworkers new ones. Queued tasks
+   // are handed over to the new workers.
+   // The set of workers is swapped under the pool lock, so that Submit,
+   // PopTask and RemoveTasks never see a deleted worker; the old workers
+   // are joined outside of the lock. Tasks submitted meanwhile are kept
+   // aside and queued on the new workers.
 
-   for (Int_t i = 0; i < nt; i++) {
-      if (!fUnzipThread[i]) {
-         TString nm("UnzipLoop");
-         nm += i;
+   R__LOCKGUARD(&fResizeMutex);
 
-         if (gDebug > 0)
-            Info("StartThreadUnzip", "Going to start thread '%s'", nm.Data());
+   if (nworkers < 1) nworkers = 1;
+   std::vector<Worker_t*> old;
+   {
+      R__LOCKGUARD(&fMutex);
+      if (nworkers == (Int_t)fWorkers.size()) return;
+      fStop = kTRUE;
+      old.swap(fWorkers);
+      fWorkCondition.Broadcast();
+   }
 
-         TTreeCacheUnzipData *d = new TTreeCacheUnzipData;
-         d->fInstance = this;
-         d->fCount = i;
+   // The old workers are no longer reachable from the pool: once they
+   // are joined their queues can be read without locking
+   std::vector<Task_t> pending;
+   for (UInt_t i = 0; i < old.size(); i++) {
+      old[i]->fThread->Join();
+      delete old[i]->fThread;
+      pending.insert(pending.end(), old[i]->fQueue.begin(), old[i]->fQueue.end());
+      delete old[i];
+   }
 
-         fUnzipThread[i] = new TThread(nm.Data(), UnzipLoop, (void*)d);
-         if (!fUnzipThread[i])
-            Error("TTreeCacheUnzip::StartThreadUnzip", " Unable to create new thread.");
+   std::vector<Worker_t*> workers;
+   std::vector<TThread*> threads;
+   for (Int_t i = 0; i < nworkers; i++) {
+      Worker_t *w = new Worker_t;
+      WorkerArg_t *arg = new WorkerArg_t;
+      arg->fPool = this;
+      arg->fWorker = w;
+      arg->fIndex = i;
+      w->fThread = new TThread(TString::Format("UnzipWorker%d", i), WorkerLoop, (void*)arg);
+      workers.push_back(w);
+      threads.push_back(w->fThread);
+   }
 
-         fUnzipThread[i]->Run();
+   {
+      R__LOCKGUARD(&fMutex);
+      fWorkers.swap(workers);
+      fStop = kFALSE;
+      fNQueued = 0;
+      pending.insert(pending.end(), fPending.begin(), fPending.end());
+      fPending.clear();
+      for (UInt_t i = 0; i < pending.size(); i++) QueueTask(pending[i]);
+   }
+   for (UInt_t i = 0; i < threads.size(); i++) threads[i]->Run();
+}
+
+//_____________________________________________________________________________
+void TTreeCacheUnzipPool::QueueTask(const Task_t &task)
+{
+   // Queue a task on the next worker and wake up a sleeping worker.
+   // Must be called with the pool lock held.
+
+   if (fWorkers.empty()) {
+      // The pool is being resized
+      fPending.push_back(task);
+      return;
+   }
+   UInt_t iw = fNext++ % fWorkers.size();
+   {
+      R__LOCKGUARD(&fWorkers[iw]->fMutex);
+      fWorkers[iw]->fQueue.push_back(task);
+   }
+   fNQueued++;
+   fWorkCondition.Signal();
+}
+
+//_____________________________________________________________________________
+void TTreeCacheUnzipPool::Submit(const Task_t &task)
+{
+   // Queue a task on the next worker and wake up a sleeping worker.
 
-         // There is at least one active thread
-         fActiveThread=kTRUE;
+   R__LOCKGUARD(&fMutex);
+   QueueTask(task);
+}
 
+//_____________________________________________________________________________
+Int_t TTreeCacheUnzipPool::RemoveTasks(TTreeCacheUnzip *cache)
+{
+   // Remove from the queues all the tasks of cache which have not been
+   // started yet. Returns the number of removed tasks.
+
+   R__LOCKGUARD(&fMutex);
+   Int_t nremoved = 0;
+   for (UInt_t i = 0; i < fWorkers.size(); i++) {
+      R__LOCKGUARD(&fWorkers[i]->fMutex);
+      std::deque<Task_t> &q = fWorkers[i]->fQueue;
+      for (std::deque<Task_t>::iterator it = q.begin(); it != q.end(); ) {
+         if (it->fCache == cache) {
+            it = q.erase(it);
+            nremoved++;
+         } else {
+            ++it;
+         }
+      }
+   }
+   fNQueued -= nremoved;
+   for (std::vector<Task_t>::iterator it = fPending.begin(); it != fPending.end(); ) {
+      if (it->fCache == cache) {
+         it = fPending.erase(it);
+         nremoved++;
+      } else {
+         ++it;
       }
    }
+   return nremoved;
+}
 
-   return (fActiveThread == kTRUE);
+//_____________________________________________________________________________
+Bool_t TTreeCacheUnzipPool::PopTask(Worker_t *me, Int_t worker, Task_t &task)
+{
+   // Take the oldest task of the queue of this worker or, if it is empty,
+   // steal the newest task of another worker. Returns kFALSE if all the
+   // queues are empty or if the worker no longer belongs to the pool.
+
+   R__LOCKGUARD(&fMutex);
+   Int_t nw = fWorkers.size();
+   if (worker >= nw || fWorkers[worker] != me) return kFALSE;
+   for (Int_t k = 0; k < nw; k++) {
+      Worker_t *w = fWorkers[(worker + k) % nw];
+      R__LOCKGUARD(&w->fMutex);
+      if (w->fQueue.empty()) continue;
+      if (k == 0) {
+         task = w->fQueue.front();
+         w->fQueue.pop_front();
+      } else {
+         task = w->fQueue.back();
+         w->fQueue.pop_back();
+      }
+      fNQueued--;
+      if (k > 0) {
+         R__LOCKGUARD(&me->fMutex);
+         me->fNStolen++;
+      }
+      return kTRUE;
+   }
+   return kFALSE;
 }
 
 //_____________________________________________________________________________
-Int_t TTreeCacheUnzip::StopThreadUnzip()
+Bool_t TTreeCacheUnzipPool::GetWorkerStats(Int_t i, Double_t &busytime, Long64_t &ntasks, Long64_t &nstolen)
 {
-   // To stop the thread we only need to change the value of the variable
-   // fActiveThread to false and the loop will stop (of course, we will have)
-   // to do the cleaning after that.
-   // Note: The syncronization part is important here or we will try to delete
-   //       teh object while it's still processing the queue
-   fActiveThread = kFALSE;
+   // Copy the statistics of worker i. Returns kFALSE for an invalid index.
+
+   R__LOCKGUARD(&fMutex);
+   if (i < 0 || i >= (Int_t)fWorkers.size()) return kFALSE;
+   Worker_t *w = fWorkers[i];
+   R__LOCKGUARD(&w->fMutex);
+   busytime = w->fBusyTime;
+   ntasks   = w->fNTasks;
+   nstolen  = w->fNStolen;
+   return kTRUE;
+}
 
-   for (Int_t i = 0; i < 1; i++) {
-      if(fUnzipThread[i]){
+//_____________________________________________________________________________
+void *TTreeCacheUnzipPool::WorkerLoop(void *arg)
+{
+   // This is the function executed by each worker thread: execute tasks
+   // until the pool is stopped, sleep while there is nothing to do.
+   // Returns 0 when it finishes
 
-         SendUnzipStartSignal(kTRUE);
+   WorkerArg_t *a = (WorkerArg_t *)arg;
+   TTreeCacheUnzipPool *pool = a->fPool;
+   Worker_t *me = a->fWorker;
+   Int_t iw = a->fIndex;
+   delete a;
 
-         if (fUnzipThread[i]->Exists()) {
-            fUnzipThread[i]->Join();
-            delete fUnzipThread[i];
-         }
+   Int_t locbuffsz = 16384;
+   char *locbuff = new char[locbuffsz];
+
+   while (1) {
+      Task_t task;
+      if (pool->PopTask(me, iw, task)) {
+         Double_t start = TTimeStamp();
+         task.fCache->UnzipCache(task.fIndex, task.fCycle, task.fEstimate, locbuffsz, locbuff);
+         Double_t busy = Double_t(TTimeStamp()) - start;
+         R__LOCKGUARD(&me->fMutex);
+         me->fBusyTime += busy;
+         me->fNTasks++;
+         continue;
       }
-
+      R__LOCKGUARD(&pool->fMutex);
+      if (pool->fStop) break;
+      if (pool->fNQueued <= 0) pool->fWorkCondition.TimedWaitRelative(2000);
    }
 
+   delete [] locbuff;
+   return (void *)0;
+}
+
+//_____________________________________________________________________________
+Int_t TTreeCacheUnzip::GetUnzipThreads()
+{
+   // Static function returning the number of threads of the unzip pool
+   // shared by all the TTreeCacheUnzip instances. Unless set with
+   // SetUnzipThreads, this is the number of cores of the machine.
+
+   if (fgNThreads > 0) return fgNThreads;
+   TTreeCacheUnzipPool *pool = TTreeCacheUnzipPool::Instance(kFALSE);
+   if (pool) return pool->GetNWorkers();
+   SysInfo_t info;
+   if (gSystem->GetSysInfo(&info) == 0 && info.fCpus > 0) return info.fCpus;
    return 1;
 }
 
+//_____________________________________________________________________________
+void TTreeCacheUnzip::SetUnzipThreads(Int_t nthreads)
+{
+   // Static function setting the number of threads of the unzip pool
+   // shared by all the TTreeCacheUnzip instances. If nthreads <= 0 the
+   // number of cores of the machine is used. If the pool is already
+   // running it is resized, queued work is preserved.
+
+   fgNThreads = nthreads > 0 ? nthreads : 0;
+   TTreeCacheUnzipPool *pool = TTreeCacheUnzipPool::Instance(kFALSE);
+   if (pool) pool->Resize(GetUnzipThreads());
+}
 
+//_____________________________________________________________________________
+Int_t TTreeCacheUnzip::GetUnzipWorkerStats(Int_t worker, Double_t &busytime, Long64_t &ntasks, Long64_t &nstolen)
+{
+   // Static function returning the statistics of one worker of the unzip
+   // pool since it was started: the time spent unzipping (in seconds), the
+   // number of blocks unzipped and how many of them were stolen from the
+   // queue of another worker.
+   // Returns the number of workers of the pool (0 if the pool has not been
+   // started); the output arguments are only set for a valid worker index.
+
+   TTreeCacheUnzipPool *pool = TTreeCacheUnzipPool::Instance(kFALSE);
+   if (!pool) return 0;
+   pool->GetWorkerStats(worker, busytime, ntasks, nstolen);
+   return pool->GetNWorkers();
+}
 
 //_____________________________________________________________________________
-void* TTreeCacheUnzip::UnzipLoop(void *arg)
+Int_t TTreeCacheUnzip::StartThreadUnzip()
 {
-   // This is a static function.
-   // This is the call that will be executed in the Thread generated by
-   // StartThreadTreeCacheUnzip... what we want to do is to inflate the next
-   // series of buffers leaving them in the second cache.
-   // Returns 0 when it finishes
-   TTreeCacheUnzipData *d = (TTreeCacheUnzipData *)arg;
-   TTreeCacheUnzip *unzipMng = d->fInstance;
+   // Attach this cache to the shared unzip pool, starting the pool if
+   // it is not running yet.
+   // Returns 1 if the pool is available.
 
-   TThread::SetCancelOn();
-   TThread::SetCancelDeferred();
+   if (gDebug > 0)
+      Info("StartThreadUnzip", "Using a pool of %d unzip threads.", GetUnzipThreads());
 
-   Int_t thrnum = d->fCount;
-   Int_t startindex = thrnum;
-   Int_t locbuffsz = 16384;
-   char *locbuff = new char[16384];
-   Int_t res = 0;
-   Int_t myCycle = 0;
+   TTreeCacheUnzipPool::Instance();
+   fActiveThread = kTRUE;
 
-   while( unzipMng->IsActiveThread() ) {
-      res = 1;
+   return (fActiveThread == kTRUE);
+}
 
-      {
-         R__LOCKGUARD(unzipMng->fMutexList);
-         if (myCycle != unzipMng->fCycle) startindex = thrnum;
-         myCycle = unzipMng->fCycle;
-         if (unzipMng->fNseek) startindex = startindex % unzipMng->fNseek;
-         else startindex = -1;
-      }
+//_____________________________________________________________________________
+Int_t TTreeCacheUnzip::StopThreadUnzip()
+{
+   // Detach this cache from the unzip pool: the tasks which were not
+   // started yet are dropped and we wait for the running ones to finish.
+   // Note: The syncronization part is important here or we will try to delete
+   //       the object while it's still being processed by a worker
+   {
+      R__LOCKGUARD(fMutexList);
+      fActiveThread = kFALSE;
+   }
+
+   TTreeCacheUnzipPool *pool = TTreeCacheUnzipPool::Instance(kFALSE);
+   Int_t nremoved = pool ? pool->RemoveTasks(this) : 0;
+
+   R__LOCKGUARD(fMutexList);
+   fNTasksInFlight -= nremoved;
+   while (fNTasksInFlight > 0)
+      fUnzipDoneCondition->TimedWaitRelative(200);
+   fPendingUnzipBytes = 0;
 
+   return 1;
+}
 
-      if (startindex >= 0)
-         res = unzipMng->UnzipCache(startindex, locbuffsz, locbuff);
+//_____________________________________________________________________________
+void TTreeCacheUnzip::ResizeUnzipArrays()
+{
+   // Make sure the unzip status arrays can hold fNseek blocks, keeping
+   // the current content. Must be called with fMutexList locked.
 
-      {
-         R__LOCKGUARD(unzipMng->fMutexList);
+   if (fNseekMax >= fNseek) return;
 
-         if(!unzipMng->IsActiveThread()) break;
+   if (gDebug > 0)
+      Info("ResizeUnzipArrays", "Changing fNseekMax from:%d to:%d", fNseekMax, fNseek);
 
-         if ((res == 1) || (!unzipMng->fIsTransferred)) {
-            unzipMng->WaitUnzipStartSignal();
-            startindex = unzipMng->fLastReadPos+3+thrnum;
-         }
-      }
+   Byte_t *aUnzipStatus = new Byte_t[fNseek];
+   memset(aUnzipStatus, 0, fNseek*sizeof(Byte_t));
 
+   Int_t *aUnzipLen = new Int_t[fNseek];
+   memset(aUnzipLen, 0, fNseek*sizeof(Int_t));
 
+   char **aUnzipChunks = new char *[fNseek];
+   memset(aUnzipChunks, 0, fNseek*sizeof(char *));
+
+   Double_t *aUnzipTimes = new Double_t[fNseek];
+   memset(aUnzipTimes, 0, fNseek*sizeof(Double_t));
+
+   for (Int_t i = 0; i < fNseekMax; i++) {
+      aUnzipStatus[i] = fUnzipStatus[i];
+      aUnzipLen[i] = fUnzipLen[i];
+      aUnzipChunks[i] = fUnzipChunks[i];
+      aUnzipTimes[i] = fUnzipTimes[i];
    }
 
-   delete d;
-   delete [] locbuff;
-   return (void *)0;
+   if (fUnzipStatus) delete [] fUnzipStatus;
+   if (fUnzipLen) delete [] fUnzipLen;
+   if (fUnzipChunks) delete [] fUnzipChunks;
+   if (fUnzipTimes) delete [] fUnzipTimes;
+
+   fUnzipStatus  = aUnzipStatus;
+   fUnzipLen  = aUnzipLen;
+   fUnzipChunks = aUnzipChunks;
+   fUnzipTimes = aUnzipTimes;
+
+   fNseekMax  = fNseek;
+}
+
+//_____________________________________________________________________________
+void TTreeCacheUnzip::ReportUnzip(Int_t seekidx, Long64_t pos, Int_t len)
+{
+   // Report to gPerfStats the unzipping of the block seekidx, of len
+   // compressed bytes at pos, done by a worker of the unzip pool. It is
+   // recorded when the main thread takes the block, as if it was unzipped
+   // there, so that the unzip time of the monitored tree is the same with
+   // and without the unzip pool. Must be called with fMutexList locked.
+
+   if (!gPerfStats) return;
+   Double_t start = Double_t(TTimeStamp()) - fUnzipTimes[seekidx];
+   gPerfStats->UnzipEvent(fTree, pos, start, len, fUnzipLen[seekidx]);
+}
+
+//_____________________________________________________________________________
+void TTreeCacheUnzip::ScheduleUnzip()
+{
+   // Hand to the unzip pool the next blocks of the current cycle, as long as
+   // the unzipped blocks waiting to be read plus the estimated size of the
+   // queued ones fit in fUnzipBufferSize. Must be called with fMutexList
+   // locked.
+
+   if (!fParallel || !fActiveThread || fIsLearning || !fIsTransferred || !fNseek) return;
+
+   ResizeUnzipArrays();
+
+   TTreeCacheUnzipPool *pool = TTreeCacheUnzipPool::Instance();
+   while (fNextToSchedule < fNseek &&
+          fTotalUnzipBytes + fPendingUnzipBytes < fUnzipBufferSize) {
+      Int_t reqi = fNextToSchedule++;
+      if (fUnzipStatus[reqi] || fSeekLen[reqi] <= 256) continue;
+
+      TTreeCacheUnzipPool::Task_t task;
+      task.fCache    = this;
+      task.fIndex    = reqi;
+      task.fCycle    = fCycle;
+      task.fEstimate = Long64_t(fUnzipRatio * fSeekLen[reqi]);
+
+      fUnzipStatus[reqi] = 1; // Set it as queued
+      fPendingUnzipBytes += task.fEstimate;
+      fNTasksInFlight++;
+      pool->Submit(task);
+   }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -625,40 +964,16 @@ void TTreeCacheUnzip::ResetCache()
          fUnzipChunks[i] = 0;
       }
       if (fUnzipStatus) fUnzipStatus[i] = 0;
+      if (fUnzipTimes) fUnzipTimes[i] = 0;
 
    }
 
-   while (fActiveBlks.size()) fActiveBlks.pop();
-
-   if(fNseekMax < fNseek){
-      if (gDebug > 0)
-         Info("ResetCache", "Changing fNseekMax from:%d to:%d", fNseekMax, fNseek);
-
-      Byte_t *aUnzipStatus = new Byte_t[fNseek];
-      memset(aUnzipStatus, 0, fNseek*sizeof(Byte_t));
-
-      Int_t *aUnzipLen = new Int_t[fNseek];
-      memset(aUnzipLen, 0, fNseek*sizeof(Int_t));
-
-      char **aUnzipChunks = new char *[fNseek];
-      memset(aUnzipChunks, 0, fNseek*sizeof(char *));
-
-      if (fUnzipStatus) delete [] fUnzipStatus;
-      if (fUnzipLen) delete [] fUnzipLen;
-      if (fUnzipChunks) delete [] fUnzipChunks;
-
-      fUnzipStatus  = aUnzipStatus;
-      fUnzipLen  = aUnzipLen;
-      fUnzipChunks = aUnzipChunks;
-
-      fNseekMax  = fNseek;
-   }
-
-
+   ResizeUnzipArrays();
 
    fLastReadPos = 0;
+   fNextToSchedule = 0;
    fTotalUnzipBytes = 0;
-   fBlocksToGo = fNseek;
+   fPendingUnzipBytes = 0;
    }
 
 
@@ -700,45 +1015,13 @@ Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_
 
       if (fParallel && !fIsLearning) {
 
+         ResizeUnzipArrays();
 
-         if(fNseekMax < fNseek){
-            if (gDebug > 0)
-               Info("GetUnzipBuffer", "Changing fNseekMax from:%d to:%d", fNseekMax, fNseek);
-
-            Byte_t *aUnzipStatus = new Byte_t[fNseek];
-            memset(aUnzipStatus, 0, fNseek*sizeof(Byte_t));
-
-            Int_t *aUnzipLen = new Int_t[fNseek];
-            memset(aUnzipLen, 0, fNseek*sizeof(Int_t));
-
-            char **aUnzipChunks = new char *[fNseek];
-            memset(aUnzipChunks, 0, fNseek*sizeof(char *));
-
-            for (Int_t i = 0; i < fNseekMax; i++) {
-               aUnzipStatus[i] = fUnzipStatus[i];
-               aUnzipLen[i] = fUnzipLen[i];
-               aUnzipChunks[i] = fUnzipChunks[i];
-            }
-
-            if (fUnzipStatus) delete [] fUnzipStatus;
-            if (fUnzipLen) delete [] fUnzipLen;
-            if (fUnzipChunks) delete [] fUnzipChunks;
-
-            fUnzipStatus  = aUnzipStatus;
-            fUnzipLen  = aUnzipLen;
-            fUnzipChunks = aUnzipChunks;
-
-            fNseekMax  = fNseek;
-         }
-
-
-
-
-
-
+         // Keep the pool busy, the cache content may just have been transferred
+         ScheduleUnzip();
 
          loc = (Int_t)TMath::BinarySearch(fNseek,fSeekSort,pos);
-         if ( (fCycle == myCycle) && (loc >= 0) && (loc < fNseek) && (pos == fSeekSort[loc]) ) {
+         if ( (loc >= 0) && (loc < fNseek) && (pos == fSeekSort[loc]) ) {
 
             // The buffer is, at minimum, in the file cache. We must know its index in the requests list
             // In order to get its info
@@ -759,19 +1042,21 @@ Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_
                   //if (gDebug > 0)
                   //   Info("GetUnzipBuffer", "++++++++++++++++++++ CacheHIT Block wanted: %d  len:%d req_len:%d fNseek:%d", seekidx, fUnzipLen[seekidx], len,  fNseek);
 
+                  ReportUnzip(seekidx, pos, len);
+
                   if(!(*buf)) {
                      *buf = fUnzipChunks[seekidx];
                      fUnzipChunks[seekidx] = 0;
                      fTotalUnzipBytes -= fUnzipLen[seekidx];
-                     SendUnzipStartSignal(kFALSE);
+                     ScheduleUnzip();
                      *free = kTRUE;
                   }
                   else {
                      memcpy(*buf, fUnzipChunks[seekidx], fUnzipLen[seekidx]);
-                     delete fUnzipChunks[seekidx];
+                     delete [] fUnzipChunks[seekidx];
                      fTotalUnzipBytes -= fUnzipLen[seekidx];
                      fUnzipChunks[seekidx] = 0;
-                     SendUnzipStartSignal(kFALSE);
+                     ScheduleUnzip();
                      *free = kFALSE;
                   }
 
@@ -780,9 +1065,13 @@ Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_
                   return fUnzipLen[seekidx];
                }
 
+               // If the block is still queued, no worker started on it: we take
+               // it back and unzip it ourselves rather than waiting
+               if ( fUnzipStatus[seekidx] == 1 ) break;
+
                // If the status of the unzipped chunk is pending
                // we wait on the condvar, hoping that the next signal is the good one
-               if ( fUnzipStatus[seekidx] == 1 ) {
+               if ( fUnzipStatus[seekidx] == 3 ) {
                   //fMutexList->UnLock();
                   fUnzipDoneCondition->TimedWaitRelative(200);
                   //fMutexList->Lock();
@@ -800,7 +1089,7 @@ Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_
 
                }
 
-            } while ( fUnzipStatus[seekidx] == 1 );
+            } while ( fUnzipStatus[seekidx] == 3 );
 
             //if (gDebug > 0)
             //   Info("GetUnzipBuffer", "------- Block wanted: %d  status: %d len: %d chunk: %llx ", seekidx, fUnzipStatus[seekidx], fUnzipLen[seekidx], fUnzipChunks[seekidx]);
@@ -811,19 +1100,21 @@ Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_
                //if (gDebug > 0)
                //   Info("GetUnzipBuffer", "++++++++++++++++++++ CacheLateHIT Block wanted: %d  len:%d fNseek:%d", seekidx, fUnzipLen[seekidx], fNseek);
 
+               ReportUnzip(seekidx, pos, len);
+
                if(!(*buf)) {
                   *buf = fUnzipChunks[seekidx];
                   fUnzipChunks[seekidx] = 0;
                   fTotalUnzipBytes -= fUnzipLen[seekidx];
-                  SendUnzipStartSignal(kFALSE);
+                  ScheduleUnzip();
                   *free = kTRUE;
                }
                else {
                   memcpy(*buf, fUnzipChunks[seekidx], fUnzipLen[seekidx]);
-                  delete fUnzipChunks[seekidx];
+                  delete [] fUnzipChunks[seekidx];
                   fTotalUnzipBytes -= fUnzipLen[seekidx];
                   fUnzipChunks[seekidx] = 0;
-                  SendUnzipStartSignal(kFALSE);
+                  ScheduleUnzip();
                   *free = kFALSE;
                }
 
@@ -835,11 +1126,12 @@ Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_
             else {
                // This is a complete miss. We want to avoid the threads
                // to try unzipping this block in the future.
-               fUnzipStatus[seekidx] = 2;
-               fUnzipChunks[seekidx] = 0;
+               if (seekidx >= 0) {
+                  fUnzipStatus[seekidx] = 2;
+                  fUnzipChunks[seekidx] = 0;
+               }
 
-               if ((fTotalUnzipBytes < fUnzipBufferSize) && fBlocksToGo)
-                  SendUnzipStartSignal(kFALSE);
+               ScheduleUnzip();
 
                //if (gDebug > 0)
                //   Info("GetUnzipBuffer", "++++++++++++++++++++ CacheMISS Block wanted: %d  len:%d fNseek:%d", seekidx, len, fNseek);
@@ -1029,220 +1321,122 @@ Int_t TTreeCacheUnzip::UnzipBuffer(char **dest, char *src)
 }
 
 //_____________________________________________________________________________
-Int_t TTreeCacheUnzip::UnzipCache(Int_t &startindex, Int_t &locbuffsz, char *&locbuff)
+Int_t TTreeCacheUnzip::UnzipCache(Int_t index, Int_t cycle, Long64_t estimate, Int_t &locbuffsz, char *&locbuff)
 {
-   // This inflates all the buffers in the cache.. passing the data to a new
-   // buffer that will only wait there to be read...
-   // We can not inflate all the buffers in the cache so we will try to do
-   // it until the cache gets full... there is a member called fUnzipBufferSize which will
-   // tell us the max size we can allocate for this cache.
+   // Called by a worker of the unzip pool to inflate the block 'index' of the
+   // cache, as it was scheduled during 'cycle'. The inflated block is kept
+   // in fUnzipChunks until the main thread asks for it; the sum of the
+   // pending chunks does not exceed fUnzipBufferSize since the scheduler
+   // accounts for the 'estimate' of every queued block.
    //
-   // note that we will  unzip in the order they were put into the cache not
-   // the order of the transference so it has to be read in that order or the
-   // pre-unzipping will be useless.
+   // If in the meantime the cache was paged, stopped or the main thread took
+   // the block back, nothing is done.
    //
-   // startindex is used as start index to check for blks to be unzipped
+   // locbuff/locbuffsz is the scratch buffer owned by the calling worker.
    //
-   // returns 0 in normal conditions or -1 if error, 1 if it would like to sleep
-   //
-   // This func is supposed to compete among an indefinite number of threads to get a chunk to inflate
-   // in order to accommodate multiple unzippers
-   // Since everything is so async, we cannot use a fixed buffer, we are forced to keep
-   // the individual chunks as separate blocks, whose summed size does not exceed the maximum
-   // allowed. The pointers are kept globally in the array fUnzipChunks
-   Int_t myCycle;
+   // returns 0 in normal conditions or -1 if error, 1 if the task was dropped
    const Int_t hlen=128;
    Int_t objlen=0, keylen=0;
    Int_t nbytes=0;
    Int_t readbuf = 0;
 
-   Int_t idxtounzip = -1;
    Long64_t rdoffs = 0;
    Int_t rdlen = 0;
    {
       R__LOCKGUARD(fMutexList);
 
-      if (!IsActiveThread() || !fNseek || fIsLearning || !fIsTransferred) {
+      if (cycle == fCycle) fPendingUnzipBytes -= estimate;
+
+      if (cycle != fCycle || !IsActiveThread() || !fIsTransferred ||
+          index >= fNseek || fUnzipStatus[index] != 1) {
          if (gDebug > 0)
-            Info("UnzipCache", "Sudden Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-                 IsActiveThread(), fNseek, fIsLearning);
+            Info("UnzipCache", "Dropping block %d, cycle:%d fCycle:%d IsActiveThread(): %d",
+                 index, cycle, fCycle, IsActiveThread());
+         fNTasksInFlight--;
+         fUnzipDoneCondition->Broadcast();
          return 1;
       }
 
-      // To synchronize with the 'paging'
-      myCycle = fCycle;
-
-      // Try to look for a blk to unzip
-      idxtounzip = -1;
-      rdoffs = 0;
-      rdlen = 0;
-      if (fTotalUnzipBytes < fUnzipBufferSize) {
-
-
-         if (fBlocksToGo > 0) {
-            for (Int_t ii=0; ii < fNseek; ii++) {
-               Int_t reqi = (startindex+ii) % fNseek;
-               if (!fUnzipStatus[reqi] && (fSeekLen[reqi] > 256)   ) {
-                  // We found a chunk which is not unzipped nor pending
-                  fUnzipStatus[reqi] = 1; // Set it as pending
-                  idxtounzip = reqi;
-
-                  rdoffs = fSeek[idxtounzip];
-                  rdlen = fSeekLen[idxtounzip];
-                  break;
-               }
-            }
-            if (idxtounzip < 0) fBlocksToGo = 0;
-         }
-      }
-
+      fUnzipStatus[index] = 3; // Being unzipped
+      rdoffs = fSeek[index];
+      rdlen = fSeekLen[index];
    } // lock scope
 
-
-
-   if (idxtounzip < 0) {
-      if (gDebug > 0)
-         Info("UnzipCache", "Nothing to do... startindex:%d fTotalUnzipBytes:%lld fUnzipBufferSize:%lld fNseek:%d",
-              startindex, fTotalUnzipBytes, fUnzipBufferSize, fNseek );
-      return 1;
-   }
-
-
-   // And here we have a new blk to unzip
-   startindex = idxtounzip+THREADCNT;
-
-
-   if (!IsActiveThread() || !fNseek || fIsLearning ) {
-      if (gDebug > 0)
-         Info("UnzipCache", "Sudden Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-              IsActiveThread(), fNseek, fIsLearning);
-      return 1;
-   }
-
    Int_t loc = -1;
 
-   // Prepare a static tmp buf of adequate size
+   // Prepare a tmp buf of adequate size
    if(locbuffsz < rdlen) {
       if (locbuff) delete [] locbuff;
       locbuffsz = rdlen;
       locbuff = new char[locbuffsz];
-      //memset(locbuff, 0, locbuffsz);
    } else
       if(locbuffsz > rdlen*3) {
          if (locbuff) delete [] locbuff;
          locbuffsz = rdlen*2;
          locbuff = new char[locbuffsz];
-         //memset(locbuff, 0, locbuffsz);
       }
 
+   if (gDebug > 0)
+      Info("UnzipCache", "Going to unzip block %d", index);
 
-      if (gDebug > 0)
-      Info("UnzipCache", "Going to unzip block %d", idxtounzip);
-
-      readbuf = ReadBufferExt(locbuff, rdoffs, rdlen, loc);
-
-   {
-      R__LOCKGUARD(fMutexList);
-
-      if ( (myCycle != fCycle) || !fIsTransferred )  {
-         if (gDebug > 0)
-            Info("UnzipCache", "Sudden paging Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-                 IsActiveThread(), fNseek, fIsLearning);
-
-         fUnzipStatus[idxtounzip] = 2; // Set it as not done
-         fUnzipChunks[idxtounzip] = 0;
-         fUnzipLen[idxtounzip] = 0;
-         fUnzipDoneCondition->Signal();
-
-         startindex = 0;
-         return 1;
-      }
-
-
-      if (readbuf <= 0) {
-         fUnzipStatus[idxtounzip] = 2; // Set it as not done
-         fUnzipChunks[idxtounzip] = 0;
-         fUnzipLen[idxtounzip] = 0;
-         if (gDebug > 0)
-            Info("UnzipCache", "Block %d not done. rdoffs=%lld rdlen=%d readbuf=%d", idxtounzip, rdoffs, rdlen, readbuf);
-         return -1;
-      }
-
-
-      GetRecordHeader(locbuff, hlen, nbytes, objlen, keylen);
-
-      Int_t len = (objlen > nbytes-keylen)? keylen+objlen : nbytes;
-
-      // If the single unzipped chunk is really too big, reset it to not processable
-      // I.e. mark it as done but set the pointer to 0
-      // This block will be unzipped synchronously in the main thread
-      if (len > 4*fUnzipBufferSize) {
-
-         //if (gDebug > 0)
-            Info("UnzipCache", "Block %d is too big, skipping.", idxtounzip);
-
-         fUnzipStatus[idxtounzip] = 2; // Set it as done
-         fUnzipChunks[idxtounzip] = 0;
-         fUnzipLen[idxtounzip] = 0;
-
-         fUnzipDoneCondition->Signal();
-         return 0;
-      }
-
-   } // Scope of the lock
+   Double_t start = TTimeStamp();
+   readbuf = ReadBufferExt(locbuff, rdoffs, rdlen, loc);
 
-   // Unzip it into a new blk
    char *ptr = 0;
    Int_t loclen = 0;
+   Int_t len = 0;
+   if (readbuf > 0) {
+      GetRecordHeader(locbuff, hlen, nbytes, objlen, keylen);
+      len = (objlen > nbytes-keylen)? keylen+objlen : nbytes;
+
+      // If the single unzipped chunk is really too big, leave it to the
+      // main thread, which will unzip it synchronously
+      if (len <= 4*fUnzipBufferSize)
+         loclen = UnzipBuffer(&ptr, locbuff);
+      else if (gDebug > 0)
+         Info("UnzipCache", "Block %d is too big, skipping.", index);
+   }
 
-   loclen = UnzipBuffer(&ptr, locbuff);
-
-   if ((loclen > 0) && (loclen == objlen+keylen)) {
-      R__LOCKGUARD(fMutexList);
-
-      if ( (myCycle != fCycle)  || !fIsTransferred) {
-         if (gDebug > 0)
-            Info("UnzipCache", "Sudden paging Break!!! IsActiveThread(): %d, fNseek: %d, fIsLearning:%d",
-                 IsActiveThread(), fNseek, fIsLearning);
-         delete [] ptr;
-
-         fUnzipStatus[idxtounzip] = 2; // Set it as not done
-         fUnzipChunks[idxtounzip] = 0;
-         fUnzipLen[idxtounzip] = 0;
-
-         startindex = 0;
-         fUnzipDoneCondition->Signal();
-         return 1;
-      }
+   R__LOCKGUARD(fMutexList);
 
-      fUnzipStatus[idxtounzip] = 2; // Set it as done
-      fUnzipChunks[idxtounzip] = ptr;
-      fUnzipLen[idxtounzip] = loclen;
+   Int_t res = 0;
+   if (cycle == fCycle && fIsTransferred && (loclen > 0) && (loclen == objlen+keylen)) {
+      fUnzipStatus[index] = 2; // Set it as done
+      fUnzipChunks[index] = ptr;
+      fUnzipLen[index] = loclen;
+      fUnzipTimes[index] = Double_t(TTimeStamp()) - start;
       fTotalUnzipBytes += loclen;
 
-      fActiveBlks.push(idxtounzip);
+      // Keep track of the compression factor, to better estimate the
+      // memory needed by the next blocks
+      fUnzipRatio = 0.75*fUnzipRatio + 0.25*(Double_t(loclen)/rdlen);
 
       if (gDebug > 0)
          Info("UnzipCache", "reqi:%d, rdoffs:%lld, rdlen: %d, loclen:%d",
-              idxtounzip, rdoffs, rdlen, loclen);
+              index, rdoffs, rdlen, loclen);
 
       fNUnzip++;
+   } else {
+      if (gDebug > 0)
+         Info("UnzipCache", "Block %d not done. rdoffs=%lld rdlen=%d readbuf=%d loclen:%d",
+              index, rdoffs, rdlen, readbuf, loclen);
+      delete [] ptr;
+      // The main thread will take care of it, unless the cache was paged
+      if (cycle == fCycle) {
+         fUnzipStatus[index] = 2; // Set it as done, with no data
+         fUnzipChunks[index] = 0;
+         fUnzipLen[index] = 0;
+      }
+      res = (readbuf <= 0) ? -1 : 0;
    }
-   else {
-      R__LOCKGUARD(fMutexList);
-      Info("argh", "loclen:%d objlen:%d loc:%d readbuf:%d", loclen, objlen, loc, readbuf);
-      fUnzipStatus[idxtounzip] = 2; // Set it as done
-      fUnzipChunks[idxtounzip] = 0;
-      fUnzipLen[idxtounzip] = 0;
-   }
-
 
-   fUnzipDoneCondition->Signal();
+   fNTasksInFlight--;
+   fUnzipDoneCondition->Broadcast();
 
-   delete [] ptr;
-   return 0;
+   return res;
 }
 
+//_____________________________________________________________________________
 void  TTreeCacheUnzip::Print(Option_t* option) const {
 
    printf("******TreeCacheUnzip statistics for file: %s ******\n",fFile->GetName());
@@ -1252,6 +1446,14 @@ void  TTreeCacheUnzip::Print(Option_t* option) const {
    printf("Number of stalls: %d\n", fNStalls);
    printf("Number of misses: %d\n", fNMissed);
 
+   Int_t nworkers = GetUnzipThreads();
+   for (Int_t i = 0; i < nworkers; i++) {
+      Double_t busy = 0;
+      Long64_t ntasks = 0, nstolen = 0;
+      if (!GetUnzipWorkerStats(i, busy, ntasks, nstolen)) break;
+      printf("Unzip worker %d: %lld blocks (%lld stolen), busy %.3f s\n", i, ntasks, nstolen, busy);
+   }
+
    TTreeCache::Print(option);
 }
 
@@ -37,6 +37,7 @@
 #include "TLeafC.h"
 
 #include <algorithm>
+#include <vector>
 
 //______________________________________________________________________________
 Bool_t TTreeCloner::CompareSeek::operator()(UInt_t i1, UInt_t i2)
@@ -59,6 +60,21 @@ Bool_t TTreeCloner::CompareEntry::operator()(UInt_t i1, UInt_t i2)
    return  fObject->fBasketEntry[i1] <  fObject->fBasketEntry[i2];
 }
 
+//______________________________________________________________________________
+Bool_t TTreeCloner::CompareCluster::operator()(UInt_t i1, UInt_t i2)
+{
+   if (fObject->fBasketCluster[i1] != fObject->fBasketCluster[i2]) {
+      return fObject->fBasketCluster[i1] < fObject->fBasketCluster[i2];
+   }
+   if (fObject->fBasketBranchNum[i1] != fObject->fBasketBranchNum[i2]) {
+      return fObject->fBasketBranchNum[i1] < fObject->fBasketBranchNum[i2];
+   }
+   if (fObject->fBasketEntry[i1] ==  fObject->fBasketEntry[i2]) {
+      return i1 < i2;
+   }
+   return  fObject->fBasketEntry[i1] <  fObject->fBasketEntry[i2];
+}
+
 //______________________________________________________________________________
 TTreeCloner::TTreeCloner(TTree *from, TTree *to, Option_t *method, UInt_t options) :
    fWarningMsg(),
@@ -76,8 +92,10 @@ TTreeCloner::TTreeCloner(TTree *from, TTree *to, Option_t *method, UInt_t option
    fBasketSeek(new Long64_t[fMaxBaskets]),
    fBasketEntry(new Long64_t[fMaxBaskets]),
    fBasketIndex(new UInt_t[fMaxBaskets]),
+   fBasketCluster(0),
    fPidOffset(0),
    fCloneMethod(TTreeCloner::kDefault),
+   fRecompress(kFALSE),
    fToStartEntries(0)
 {
    // Constructor.  This object would transfer the data from
@@ -92,10 +110,11 @@ TTreeCloner::TTreeCloner(TTree *from, TTree *to, Option_t *method, UInt_t option
    // of branches that contain 'large' data chunk are written to
    // the disk more often.
    //
-   // There is currently 3 supported sorting order:
+   // There is currently 4 supported sorting order:
    //    SortBasketsByOffset (the default)
    //    SortBasketsByBranch
    //    SortBasketsByEntry
+   //    SortBasketsByCluster
    //
    // When using SortBasketsByOffset the baskets are written in
    // the output file in the same order as in the original file
@@ -118,12 +137,28 @@ TTreeCloner::TTreeCloner(TTree *from, TTree *to, Option_t *method, UInt_t option
    // in which they will be needed when reading the whole tree
    // sequentially.
    //
+   // When using SortBasketsByCluster the baskets of each cluster
+   // (see TTree::SetAutoFlush) are stored contiguously and, within
+   // a cluster, sorted by branch and by starting entry.  A cluster
+   // is then read by one contiguous read (or, when reading only some
+   // branches, one read per branch) instead of many scattered ones.
+   //
+   // When 'method' also contains Recompress the baskets are not copied
+   // as they are but written with the compression settings of the output
+   // branches (i.e. of the output file): each basket is unzipped and zipped
+   // again, in parallel, without being unstreamed.  This changes the
+   // compression of a tree much faster than copying it entry by entry.
+   //
 
    TString opt(method);
    opt.ToLower();
+   fRecompress = opt.Contains("recompress");
    if (opt.Contains("sortbasketsbybranch")) {
       //::Info("TTreeCloner::TTreeCloner","use: kSortBasketsByBranch");
       fCloneMethod = TTreeCloner::kSortBasketsByBranch;
+   } else if (opt.Contains("sortbasketsbycluster")) {
+      //::Info("TTreeCloner::TTreeCloner","use: kSortBasketsByCluster");
+      fCloneMethod = TTreeCloner::kSortBasketsByCluster;
    } else if (opt.Contains("sortbasketsbyentry")) {
       //::Info("TTreeCloner::TTreeCloner","use: kSortBasketsByEntry");
       fCloneMethod = TTreeCloner::kSortBasketsByEntry;
@@ -199,6 +234,7 @@ TTreeCloner::~TTreeCloner()
    delete [] fBasketSeek;
    delete [] fBasketEntry;
    delete [] fBasketIndex;
+   delete [] fBasketCluster;
 }
 
 //______________________________________________________________________________
@@ -607,6 +643,28 @@ void TTreeCloner::SortBaskets()
          std::sort(fBasketIndex, fBasketIndex+fMaxBaskets, CompareEntry( this) );
          break;
       }
+      case kSortBasketsByCluster: {
+         // Find the cluster containing the first entry of each basket.
+         TTree *tree = fFromTree->GetTree();
+         Long64_t nentries = tree->GetEntries();
+         std::vector<Long64_t> starts;
+         TTree::TClusterIterator clusterIter = tree->GetClusterIterator(0);
+         Long64_t start;
+         while ((start = clusterIter()) < nentries) {
+            starts.push_back(start);
+            if (clusterIter.GetNextEntry() <= start) break;
+         }
+         if (starts.empty()) starts.push_back(0);
+         delete [] fBasketCluster;
+         fBasketCluster = new UInt_t[fMaxBaskets];
+         for(UInt_t i = 0; i < fMaxBaskets; ++i) {
+            fBasketIndex[i] = i;
+            Long64_t c = TMath::BinarySearch((Long64_t)starts.size(), &starts[0], fBasketEntry[i]);
+            fBasketCluster[i] = c < 0 ? 0 : (UInt_t)c;
+         }
+         std::sort(fBasketIndex, fBasketIndex+fMaxBaskets, CompareCluster( this) );
+         break;
+      }
       case kSortBasketsByOffset:
       default: {
          for(UInt_t i = 0; i < fMaxBaskets; ++i) { fBasketIndex[i] = i; }
@@ -621,6 +679,18 @@ void TTreeCloner::WriteBaskets()
 {
    // Transfer the basket from the input file to the output file
 
+   if (fRecompress) {
+      // Recompress only the inputs whose compression differs from the output.
+      for (Int_t i = 0; i < fFromBranches.GetEntriesFast(); ++i) {
+         TBranch *from = (TBranch*)fFromBranches.UncheckedAt(i);
+         TBranch *to   = (TBranch*)fToBranches.UncheckedAt(i);
+         if (from->GetCompressionSettings() != to->GetCompressionSettings()) {
+            WriteBasketsRecompressed();
+            return;
+         }
+      }
+   }
+
    TBasket *basket = new TBasket();
    for(UInt_t j=0; j<fMaxBaskets; ++j) {
       TBranch *from = (TBranch*)fFromBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
@@ -642,6 +712,7 @@ void TTreeCloner::WriteBaskets()
          basket->IncrementPidOffset(fPidOffset);
          basket->CopyTo(tofile);
          to->AddBasket(*basket,kTRUE,fToStartEntries + from->GetBasketEntry()[index]);
+         to->CopyBasketStatistics(from, index, fToStartEntries + from->GetBasketEntry()[index]);
       } else {
          TBasket *frombasket = from->GetBasket( index );
          if (frombasket && frombasket->GetNevBuf()>0) {
@@ -654,3 +725,84 @@ void TTreeCloner::WriteBaskets()
    }
    delete basket;
 }
+
+//______________________________________________________________________________
+void TTreeCloner::WriteBasketsRecompressed()
+{
+   // Transfer the baskets from the input file to the output file, changing
+   // their compression to the one of the output branches (see the option
+   // Recompress of the constructor).
+   //
+   // The baskets are processed by batches: the raw baskets of a batch are
+   // read in order, recompressed in parallel by the threads of the TTree
+   // basket compression (see TBasket::Recompress) and written in order,
+   // so that the file layout is the same as with WriteBaskets. The baskets
+   // of the branches which already have the compression of the output
+   // branch, and a basket which cannot be recompressed, are copied as
+   // they are.
+
+   const UInt_t   kBatchBaskets = 256;              // maximum number of baskets in a batch
+   const Long64_t kBatchBytes   = 32*1024*1024;     // maximum number of bytes read for a batch
+
+   std::vector<TBasket*> slots;
+   std::vector<TBasket*> batch;
+   UInt_t first = 0;
+   while (first < fMaxBaskets) {
+      // Read the raw baskets of the batch.
+      batch.clear();
+      Long64_t nbytes = 0;
+      UInt_t last = first;
+      for (; last < fMaxBaskets && last - first < kBatchBaskets && nbytes < kBatchBytes; ++last) {
+         if (slots.size() <= last - first) slots.push_back(new TBasket());
+         TBasket *basket = slots[last - first];
+         TBranch *from = (TBranch*)fFromBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[last] ] );
+         TBranch *to   = (TBranch*)fToBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[last] ] );
+         Int_t index = fBasketNum[ fBasketIndex[last] ];
+         Long64_t pos = from->GetBasketSeek(index);
+         if (pos == 0) continue;
+         TFile *fromfile = from->GetFile(0);
+         if (from->GetBasketBytes()[index] == 0) {
+            from->GetBasketBytes()[index] = basket->ReadBasketBytes(pos, fromfile);
+         }
+         Int_t len = from->GetBasketBytes()[index];
+         if (basket->LoadBasketBuffers(pos,len,fromfile,fFromTree)) {
+            Error("WriteBasketsRecompressed","Cannot read the basket %d of the branch %s at %lld",index,from->GetName(),pos);
+            fIsValid = kFALSE;
+            break;
+         }
+         basket->SetBranch(to);
+         if (from->GetCompressionSettings() != to->GetCompressionSettings()) batch.push_back(basket);
+         nbytes += len;
+      }
+
+      // Recompress them in parallel.
+      if (!batch.empty()) {
+         TTree::RecompressBaskets(&batch[0], batch.size());
+      }
+
+      // Write the baskets in order.
+      for (UInt_t j = first; j < last; ++j) {
+         TBranch *from = (TBranch*)fFromBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
+         TBranch *to   = (TBranch*)fToBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
+         Int_t index = fBasketNum[ fBasketIndex[j] ];
+         if (from->GetBasketSeek(index) != 0) {
+            TBasket *basket = slots[j - first];
+            basket->IncrementPidOffset(fPidOffset);
+            basket->CopyTo(to->GetFile(0));
+            to->AddBasket(*basket,kTRUE,fToStartEntries + from->GetBasketEntry()[index]);
+            to->CopyBasketStatistics(from, index, fToStartEntries + from->GetBasketEntry()[index]);
+         } else {
+            TBasket *frombasket = from->GetBasket( index );
+            if (frombasket && frombasket->GetNevBuf()>0) {
+               TBasket *tobasket = (TBasket*)frombasket->Clone();
+               tobasket->SetBranch(to);
+               to->AddBasket(*tobasket, kFALSE, fToStartEntries+from->GetBasketEntry()[index]);
+               to->FlushOneBasket(to->GetWriteBasket());
+            }
+         }
+      }
+      if (!fIsValid) break;
+      first = last;
+   }
+   for (size_t i = 0; i < slots.size(); ++i) delete slots[i];
+}
@@ -36,6 +36,7 @@
 
 class TTreeFormula;
 class TTreeIndex;
+class TTreeCompactIndex;
 class TChain;
 
 class TChainIndex : public TVirtualIndex {
@@ -53,6 +54,7 @@ public:
       IndexValPair_t GetMinIndexValPair() const { return IndexValPair_t(fMinIndexValue, fMinIndexValMinor); }
       IndexValPair_t GetMaxIndexValPair() const { return IndexValPair_t(fMaxIndexValue, fMaxIndexValMinor); }
       void           SetMinMaxFrom(const TTreeIndex *index );
+      void           SetMinMaxFrom(const TTreeCompactIndex *index );
 
       Long64_t    fMinIndexValue;           // the minimum value of the index (upper bits)
       Long64_t    fMinIndexValMinor;        // the minimum value of the index (lower bits)
@@ -0,0 +1,127 @@
+// @(#)root/treeplayer:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TTreeCompactIndex
+#define ROOT_TTreeCompactIndex
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TTreeCompactIndex                                                    //
+//                                                                      //
+// A Tree Index with majorname and minorname, stored by pages of        //
+// delta-encoded values which are read from the file on demand.         //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROOT_TVirtualIndex
+#include "TVirtualIndex.h"
+#endif
+#ifndef ROOT_TTreeFormula
+#include "TTreeFormula.h"
+#endif
+#ifndef ROOT_TUUID
+#include "TUUID.h"
+#endif
+
+#include <map>
+#include <vector>
+
+class TFile;
+
+class TTreeCompactIndex : public TVirtualIndex {
+
+public:
+   struct IndexEntry_t {
+      Long64_t fMajor;   // major value
+      Long64_t fMinor;   // minor value
+      Long64_t fEntry;   // entry number in the tree
+
+      bool operator<(const IndexEntry_t &other) const {
+         if (fMajor != other.fMajor) return fMajor < other.fMajor;
+         if (fMinor != other.fMinor) return fMinor < other.fMinor;
+         return fEntry < other.fEntry;
+      }
+   };
+
+   enum { kDefaultPageSize = 4096 };
+
+protected:
+   TString        fMajorName;           // Index major name
+   TString        fMinorName;           // Index minor name
+   Long64_t       fN;                   // Number of entries
+   Int_t          fPageSize;            // Number of entries per page
+   Int_t          fNpages;              // Number of pages
+   Long64_t      *fPageMajor;           //[fNpages] Major value of the first entry of each page
+   Long64_t      *fPageMinor;           //[fNpages] Minor value of the first entry of each page
+   Long64_t      *fPageSeek;            //[fNpages] Position of each page in the file
+   Int_t         *fPageBytes;           //[fNpages] Size of each encoded page
+   Long64_t       fMaxMajor;            // Major value of the last entry
+   Long64_t       fMaxMinor;            // Minor value of the last entry
+   std::vector<char>     fPages;        //! Encoded pages, when they are in memory
+   std::vector<Long64_t> fPageOffset;   //! Offset of each page in fPages
+   Int_t          fPageKeylen;          // Length of the keys of the records of the pages in the file
+   TFile         *fFile;                //! File holding the pages not in memory
+   TUUID          fFileUUID;            //! UUID of fFile
+   TFile         *fRecordFile;          //! File holding the records of the pages last written or read
+   TUUID          fRecordUUID;          //! UUID of fRecordFile
+   std::vector<Long64_t> fRecordSeek;   //! Position of the records in fRecordFile
+   std::vector<Int_t>    fRecordBytes;  //! Size of the records in fRecordFile
+   std::vector<IndexEntry_t> fPending;  //! Entries appended with delaySort, not yet encoded
+   mutable std::map<Int_t, std::vector<char> > fCache;      //! Pages read from fFile
+   mutable std::vector<Int_t>                  fCacheOrder; //! Pages of fCache, oldest first
+   TTreeFormula  *fMajorFormula;        //! Pointer to major TreeFormula
+   TTreeFormula  *fMinorFormula;        //! Pointer to minor TreeFormula
+   TTreeFormula  *fMajorFormulaParent;  //! Pointer to major TreeFormula in Parent tree (if any)
+   TTreeFormula  *fMinorFormulaParent;  //! Pointer to minor TreeFormula in Parent tree (if any)
+
+   Bool_t         Evaluate(std::vector<IndexEntry_t> &values);
+   Bool_t         EvaluateMT(std::vector<IndexEntry_t> &values, Int_t nthreads);
+   Long64_t       FindEntry(Long64_t major, Long64_t minor, Bool_t best) const;
+   const char    *GetPage(Int_t page) const;
+   void           SetEntries(const std::vector<IndexEntry_t> &values);
+   void           WritePages(TFile *file);
+
+private:
+   TTreeCompactIndex(const TTreeCompactIndex&);            // Not implemented.
+   TTreeCompactIndex &operator=(const TTreeCompactIndex&); // Not implemented.
+
+public:
+   TTreeCompactIndex();
+   TTreeCompactIndex(const TTree *T, const char *majorname, const char *minorname, Int_t pagesize = kDefaultPageSize);
+   virtual               ~TTreeCompactIndex();
+   virtual void           Append(const TVirtualIndex *,Bool_t delaySort = kFALSE);
+   void                   GetEntries(std::vector<IndexEntry_t> &values) const;
+   virtual Long64_t       GetEntryNumberFriend(const TTree *parent);
+   virtual Long64_t       GetEntryNumberWithIndex(Long64_t major, Long64_t minor) const;
+   virtual Long64_t       GetEntryNumberWithBestIndex(Long64_t major, Long64_t minor) const;
+   const char            *GetMajorName()    const {return fMajorName.Data();}
+   const char            *GetMinorName()    const {return fMinorName.Data();}
+   Long64_t               GetMaxMajor()     const {return fMaxMajor;}
+   Long64_t               GetMaxMinor()     const {return fMaxMinor;}
+   Long64_t               GetMinMajor()     const {return fNpages ? fPageMajor[0] : 0;}
+   Long64_t               GetMinMinor()     const {return fNpages ? fPageMinor[0] : 0;}
+   virtual Long64_t       GetN()            const {return fN;}
+   Int_t                  GetNpages()       const {return fNpages;}
+   Int_t                  GetPageSize()     const {return fPageSize;}
+   virtual TTreeFormula  *GetMajorFormula();
+   virtual TTreeFormula  *GetMinorFormula();
+   virtual TTreeFormula  *GetMajorFormulaParent(const TTree *parent);
+   virtual TTreeFormula  *GetMinorFormulaParent(const TTree *parent);
+   virtual void           Print(Option_t *option="") const;
+   virtual void           UpdateFormulaLeaves(const TTree *parent);
+   virtual void           SetTree(const TTree *T);
+
+   ClassDef(TTreeCompactIndex,2);  //A compact Tree Index with majorname and minorname, read by pages.
+};
+
+#endif
+
@@ -126,6 +126,16 @@ protected:
 
    LongDouble_t*        fConstLD;   // local version of fConsts able to store bigger numbers
 
+   typedef Double_t (*JitVar_t)(void *formula, Int_t code, Bool_t *missing);
+   typedef Double_t (*JitFunc_t)(void *formula, JitVar_t var);
+   JitFunc_t                 fJitFunc;        //! compiled version of the operations (see JitCompile), 0 if not compiled
+   Int_t                     fJitCount;       //! number of interpreted evaluations, -1 if the operations can not be compiled
+   std::vector<Int_t>        fJitCodes;       //! codes of the variables used by fJitFunc
+   Bool_t                    fJitShortCircuit;//! kTRUE if fJitFunc may skip variables (&& or ||)
+   Int_t                     fJitInstance;    //! instance being evaluated by fJitFunc
+   Bool_t                    fJitWillLoad;    //! kTRUE if the branches are loaded during the current evaluation
+   static Int_t              fgJitThreshold;  //  number of evaluations after which the operations are compiled, 0 to never compile
+
    TTreeFormula(const char *name, const char *formula, TTree *tree, const std::vector<std::string>& aliases);
    void Init(const char *name, const char *formula);
    Bool_t      BranchHasMethod(TLeaf* leaf, TBranch* branch, const char* method,const char* params, Long64_t readentry) const;
@@ -143,6 +153,10 @@ protected:
    virtual Double_t  GetValueFromMethod(Int_t i, TLeaf *leaf) const;
    virtual void*     GetValuePointerFromMethod(Int_t i, TLeaf *leaf) const;
    Int_t             GetRealInstance(Int_t instance, Int_t codeindex);
+   Bool_t            EvalJit(Int_t instance, Double_t &result);
+   Double_t          EvalJitVariable(Int_t code, Int_t instance, Bool_t willLoad, Bool_t &missing);
+   static Double_t   JitVariable(void *formula, Int_t code, Bool_t *missing);
+   Bool_t            JitCompile();
 
    void              LoadBranches();
    Bool_t            LoadCurrentDim();
@@ -186,6 +200,7 @@ public:
    virtual Int_t       GetMultiplicity() const {return fMultiplicity;}
    virtual TLeaf      *GetLeaf(Int_t n) const;
    virtual Int_t       GetNcodes() const {return fNcodes;}
+   static  Int_t       GetJitThreshold();
    virtual Int_t       GetNdata();
    //GetNdata should probably be const.  However it need to cache some information about the actual dimension
    //of arrays, so if GetNdata is const, the variables fUsedSizes and fCumulUsedSizes need to be declared
@@ -193,12 +208,14 @@ public:
    //the mutable keyword.
    //NOTE: Also modify the code in PrintValue which current goes around this limitation :(
    virtual Bool_t      IsInteger(Bool_t fast=kTRUE) const;
+           Bool_t      IsJitted() const { return fJitFunc != 0; }
            Bool_t      IsQuickLoad() const { return fQuickLoad; }
    virtual Bool_t      IsString() const;
    virtual Bool_t      Notify() { UpdateFormulaLeaves(); return kTRUE; }
    virtual char       *PrintValue(Int_t mode=0) const;
    virtual char       *PrintValue(Int_t mode, Int_t instance, const char *decform = "9.9") const;
    virtual void        SetAxis(TAxis *axis=0);
+   static  void        SetJitThreshold(Int_t nevals = 1000);
            void        SetQuickLoad(Bool_t quick) { fQuickLoad = quick; }
    virtual void        SetTree(TTree *tree) {fTree = tree;}
    virtual void        ResetLoading();
@@ -27,6 +27,22 @@
 #ifndef ROOT_TString
 #include "TString.h"
 #endif
+#ifndef ROOT_TArrayD
+#include "TArrayD.h"
+#endif
+#ifndef ROOT_TArrayI
+#include "TArrayI.h"
+#endif
+#ifndef ROOT_TArrayL64
+#include "TArrayL64.h"
+#endif
+#ifndef ROOT_TObjArray
+#include "TObjArray.h"
+#endif
+
+#include <map>
+#include <set>
+#include <utility>
 
 
 class TBrowser;
@@ -62,6 +78,25 @@ protected:
    TStopwatch   *fWatch;         //TStopwatch pointer
    TGaxis       *fRealTimeAxis;  //pointer to TGaxis object showing real-time
    TText        *fHostInfoText;  //Graphics Text object with the fHostInfo data
+   TArrayD       fUnzipWorkerTime;  //Busy time of each worker of the TTreeCacheUnzip pool
+   TArrayD       fUnzipWorkerStart; //!Busy time of each unzip worker when the monitoring started
+   Long64_t      fSuggestedCacheSize;  //Cache size holding one cluster of the branches read
+   TObjArray     fBranchNames;         //Names (TObjString) of the branches read, the index in the arrays below
+   TArrayL64     fBranchBytesRead;     //Compressed bytes of the baskets read, per branch
+   TArrayL64     fBranchBytesNoCache;  //Compressed bytes of the baskets read without the cache, per branch
+   TArrayL64     fBranchUnzipBytes;    //Uncompressed bytes of the baskets unzipped, per branch
+   TArrayI       fBranchBaskets;       //Number of baskets read, per branch
+   TArrayI       fBranchUnzipped;      //Number of baskets unzipped, per branch
+   TArrayI       fBranchCacheHits;     //Number of baskets found in the cache, per branch
+   TArrayI       fBranchCacheMisses;   //Number of baskets not found in the cache, per branch
+   TArrayI       fBranchRereads;       //Number of reads of baskets already read before, per branch
+   TArrayD       fBranchUnzipTime;     //Time spent uncompressing the baskets, per branch
+   std::map<TObject*,Int_t>             fBranchIndex;  //!Index of each branch object of the current tree in the arrays
+   Int_t                                fBranchIndexTree; //!Tree number of the branches in fBranchIndex
+   std::set<std::pair<Int_t,Long64_t> > fBasketsRead;  //!Tree number and position of the baskets read
+
+   Int_t         GetBranchIndex(TObject *branch);
+   void          SaveBranchStats(const char *filename, Bool_t json) const;
 
 public:
    TTreePerfStats();
@@ -89,6 +124,17 @@ public:
    TStopwatch      *GetStopwatch() const {return fWatch;}
    virtual Int_t    GetTreeCacheSize() const {return fTreeCacheSize;}
    virtual Double_t GetUnzipTime() const {return fUnzipTime; }
+   Int_t            GetNbranches() const {return fBranchNames.GetEntriesFast();}
+   const char      *GetBranchName(Int_t i) const {return fBranchNames.At(i) ? fBranchNames.At(i)->GetName() : "";}
+   Long64_t         GetBranchBytesRead(Int_t i) const {return fBranchBytesRead[i];}
+   Long64_t         GetBranchBytesNoCache(Int_t i) const {return fBranchBytesNoCache[i];}
+   Int_t            GetBranchBaskets(Int_t i) const {return fBranchBaskets[i];}
+   Int_t            GetBranchCacheHits(Int_t i) const {return fBranchCacheHits[i];}
+   Int_t            GetBranchCacheMisses(Int_t i) const {return fBranchCacheMisses[i];}
+   Int_t            GetBranchRereads(Int_t i) const {return fBranchRereads[i];}
+   Double_t         GetBranchUnzipTime(Int_t i) const {return fBranchUnzipTime[i];}
+   Long64_t         GetSuggestedCacheSize() const {return fSuggestedCacheSize;}
+   const TArrayD   &GetUnzipWorkerTime() const {return fUnzipWorkerTime;}
    virtual void     Paint(Option_t *chopt="");
    virtual void     Print(Option_t *option="") const;
 
@@ -99,6 +145,8 @@ public:
    virtual void     FileOpenEvent(TFile *, const char *, Double_t) {}
    virtual void     FileReadEvent(TFile *file, Int_t len, Double_t start);
    virtual void     UnzipEvent(TObject *tree, Long64_t pos, Double_t start, Int_t complen, Int_t objlen);
+   virtual void     BasketReadEvent(TObject *branch, Long64_t pos, Int_t len, EBasketRead source);
+   virtual void     BasketUnzipEvent(TObject *branch, Long64_t pos, Double_t start, Int_t complen, Int_t objlen);
    virtual void     RateEvent(Double_t , Double_t , Long64_t , Long64_t) {}
 
    virtual void     SaveAs(const char *filename="",Option_t *option="") const;
@@ -121,7 +169,7 @@ public:
    virtual void     SetTreeCacheSize(Int_t nbytes) {fTreeCacheSize = nbytes;}
    virtual void     SetUnzipTime(Double_t uztime) {fUnzipTime = uztime;}
 
-   ClassDef(TTreePerfStats,1)  // TTree I/O performance measurement
+   ClassDef(TTreePerfStats,3)  // TTree I/O performance measurement
 };
 
 #endif
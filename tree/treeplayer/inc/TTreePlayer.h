@@ -65,6 +65,7 @@ protected:
    void           TakeAction(Int_t nfill, Int_t &npoints, Int_t &action, TObject *obj, Option_t *option);
    void           TakeEstimate(Int_t nfill, Int_t &npoints, Int_t action, TObject *obj, Option_t *option);
    void           DeleteSelectorFromFile();
+   Bool_t         ProcessMT(TSelector *selector, Option_t *option, Long64_t nentries, Long64_t firstentry, Long64_t &result);
 
 public:
    TTreePlayer();
@@ -115,6 +116,7 @@ public:
    virtual Int_t     MakeProxy(const char *classname,
                                const char *macrofilename = 0, const char *cutfilename = 0,
                                const char *option = 0, Int_t maxUnrolling = 3);
+   static  TTree    *OpenTreeCopy(TTree *tree, TFile *&file);
    TPrincipal       *Principal(const char *varexp, const char *selection, Option_t *option
                                ,Long64_t nentries, Long64_t firstentry);
    virtual Long64_t  Process(const char *filename,Option_t *option, Long64_t nentries, Long64_t firstentry);
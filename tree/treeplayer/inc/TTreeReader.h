@@ -91,6 +91,7 @@ protected:
 
    void RegisterValueReader(ROOT::TTreeReaderValueBase* reader);
    void DeregisterValueReader(ROOT::TTreeReaderValueBase* reader);
+   void ResetColumns();
 
    EEntryStatus SetEntryBase(Long64_t entry, Bool_t local);
 
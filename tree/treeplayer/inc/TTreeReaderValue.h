@@ -34,6 +34,7 @@
 
 class TBranch;
 class TBranchElement;
+class TBuffer;
 class TLeaf;
 class TTreeReader;
 
@@ -78,6 +79,16 @@ namespace ROOT {
 
       void* GetAddress();
 
+      void* GetColumnAddress() {
+         // Return the address of the value of the current entry in the
+         // column of its basket, 0 if the branch is not read by columns.
+         if (fColumnData && fColumnDirector->GetTree() == fColumnTree) {
+            Long64_t idx = fColumnDirector->GetReadEntry() - fColumnFirst;
+            if (idx >= 0 && idx < fColumnN) return fColumnData + idx * fColumnSize;
+         }
+         return LoadColumn();
+      }
+
       const char* GetBranchName() const { return fBranchName; }
 
    protected:
@@ -93,7 +104,9 @@ namespace ROOT {
 
       ROOT::TBranchProxy* GetProxy() const { return fProxy; }
 
-      void MarkTreeReaderUnavailable() { fTreeReader = 0; }
+      void* LoadColumn();
+      void MarkTreeReaderUnavailable() { fTreeReader = 0; ResetColumn(); }
+      void ResetColumn();
 
       TString      fBranchName; // name of the branch to read data from.
       TString      fLeafName;
@@ -105,6 +118,14 @@ namespace ROOT {
       ESetupStatus fSetupStatus; // setup status of this data access
       EReadStatus  fReadStatus; // read status of this data access
       std::vector<Long64_t> fStaticClassOffsets;
+      ROOT::TBranchProxyDirector* fColumnDirector; // director of the reader, when reading by columns
+      TTree*       fColumnTree; // tree of fColumnDirector for which the column was set up
+      TBranch*     fColumnBranch; // branch read by baskets, 0 if not possible
+      TBuffer*     fColumn; // values of the entries [fColumnFirst, fColumnFirst + fColumnN), owned
+      char*        fColumnData; // start of the values in fColumn, 0 if the column is not used
+      Long64_t     fColumnFirst; // first entry of the column
+      Int_t        fColumnN; // number of entries in the column
+      Int_t        fColumnSize; // size in bytes of the value of one entry
 
       // FIXME: re-introduce once we have ClassDefInline!
       //ClassDef(TTreeReaderValueBase, 0);//Base class for accessors to data via TTreeReader
@@ -127,6 +148,7 @@ public:
          Error("Get()", "Value reader not properly initialized, did you remember to call TTreeReader.Set(Next)Entry()?");
          return 0;
       }
+      if (void *column = GetColumnAddress()) return (T*)column;
       void *address = GetAddress(); // Needed to figure out if it's a pointer
       return fProxy->IsaPointer() ? *(T**)address : (T*)address; }
    T* operator->() { return Get(); }
@@ -19,6 +19,7 @@
 #include "TChain.h"
 #include "TTreeFormula.h"
 #include "TTreeIndex.h"
+#include "TTreeCompactIndex.h"
 #include "TFile.h"
 #include "TError.h"
 
@@ -33,6 +34,15 @@ void TChainIndex::TChainIndexEntry::SetMinMaxFrom(const TTreeIndex *index )
    fMaxIndexValMinor = index->GetIndexValuesMinor()[index->GetN() - 1];
 }
 
+//______________________________________________________________________________
+void TChainIndex::TChainIndexEntry::SetMinMaxFrom(const TTreeCompactIndex *index )
+{
+   fMinIndexValue    = index->GetMinMajor();
+   fMinIndexValMinor = index->GetMinMinor();
+   fMaxIndexValue    = index->GetMaxMajor();
+   fMaxIndexValMinor = index->GetMaxMinor();
+}
+
 
 
 ClassImp(TChainIndex)
@@ -106,13 +116,15 @@ TChainIndex::TChainIndex(const TTree *T, const char *majorname, const char *mino
       }
 
       TTreeIndex *ti_index = dynamic_cast<TTreeIndex*>(index);
-      if (ti_index == 0) {
-         Error("TChainIndex", "The underlying TTree must have a TTreeIndex but has a %s.",
+      TTreeCompactIndex *ci_index = dynamic_cast<TTreeCompactIndex*>(index);
+      if (ti_index == 0 && ci_index == 0) {
+         Error("TChainIndex", "The underlying TTree must have a TTreeIndex or a TTreeCompactIndex but has a %s.",
                index->IsA()->GetName());
          return;
       }
 
-      entry.SetMinMaxFrom(ti_index);
+      if (ti_index) entry.SetMinMaxFrom(ti_index);
+      else          entry.SetMinMaxFrom(ci_index);
       fEntries.push_back(entry);
    }
 
@@ -134,14 +146,17 @@ void TChainIndex::Append(const TVirtualIndex *index, Bool_t delaySort )
 
    if (index) {
       const TTreeIndex *ti_index = dynamic_cast<const TTreeIndex*>(index);
-      if (ti_index == 0) {
-         Error("Append", "The given index is not a TTreeIndex but a %s",
+      const TTreeCompactIndex *ci_index = dynamic_cast<const TTreeCompactIndex*>(index);
+      if (ti_index == 0 && ci_index == 0) {
+         Error("Append", "The given index is not a TTreeIndex or a TTreeCompactIndex but a %s",
                index->IsA()->GetName());
+         return;
       }
 
       TChainIndexEntry entry;
       entry.fTreeIndex = 0;
-      entry.SetMinMaxFrom(ti_index);
+      if (ti_index) entry.SetMinMaxFrom(ti_index);
+      else          entry.SetMinMaxFrom(ci_index);
       fEntries.push_back(entry);
    }
 
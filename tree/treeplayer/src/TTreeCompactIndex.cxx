@@ -0,0 +1,907 @@
+// @(#)root/treeplayer:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2014, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TTreeCompactIndex                                                    //
+//                                                                      //
+// A Tree Index with majorname and minorname, like TTreeIndex, for      //
+// trees with many entries.                                             //
+//                                                                      //
+// The (major, minor, entry) triplets sorted by major and minor values  //
+// are stored by pages of GetPageSize() entries. In a page each value   //
+// is stored as a variable length integer, as the difference with the   //
+// previous one: an entry typically takes 3 to 6 bytes instead of the   //
+// 24 bytes of TTreeIndex. Only the directory of the pages (the values  //
+// of the first entry of each page and the position of the page) is     //
+// streamed with the tree; each page is written in the file in its own  //
+// record and read when a lookup needs it, so that a lookup reads one   //
+// page instead of the whole index. When the file is opened with the    //
+// option MMAP the pages are decoded in place from the mapping.         //
+//                                                                      //
+// The index is built as TTreeIndex, with TTree::GetImplicitMT()        //
+// threads when it is greater than 1: each thread evaluates the major   //
+// and minor values of a range of clusters on its own copy of the tree  //
+// and sorts them.                                                      //
+//                                                                      //
+// TTree::BuildIndex creates a TTreeCompactIndex instead of a           //
+// TTreeIndex when the resource TTreeIndex.Compact (or the environment  //
+// variable ROOT_TTREEINDEX_COMPACT) is set to 1. It can also be        //
+// created explicitly:                                                  //
+//                                                                      //
+//    tree->SetTreeIndex(new TTreeCompactIndex(tree, "Run", "Event"));  //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "TTreeCompactIndex.h"
+#include "TTreeIndex.h"
+#include "TTreePlayer.h"
+#include "TTree.h"
+#include "TFile.h"
+#include "TKey.h"
+#include "TThread.h"
+#include "TDirectory.h"
+
+#include <algorithm>
+
+ClassImp(TTreeCompactIndex)
+
+namespace {
+
+   const UInt_t kMaxCachedPages = 64;  // pages read from the file kept in memory
+
+   //______________________________________________________________________________
+   inline ULong64_t R__ZigZag(Long64_t v)
+   {
+      return ((ULong64_t)v << 1) ^ (ULong64_t)(v >> 63);
+   }
+
+   //______________________________________________________________________________
+   inline Long64_t R__UnZigZag(ULong64_t v)
+   {
+      return (Long64_t)(v >> 1) ^ -(Long64_t)(v & 1);
+   }
+
+   //______________________________________________________________________________
+   inline void R__WriteVarint(std::vector<char> &out, ULong64_t v)
+   {
+      while (v >= 0x80) {
+         out.push_back((char)(v | 0x80));
+         v >>= 7;
+      }
+      out.push_back((char)v);
+   }
+
+   //______________________________________________________________________________
+   inline ULong64_t R__ReadVarint(const char *&p)
+   {
+      ULong64_t v = 0;
+      Int_t shift = 0;
+      UChar_t c;
+      do {
+         c = (UChar_t)*p++;
+         v |= (ULong64_t)(c & 0x7f) << shift;
+         shift += 7;
+      } while (c & 0x80);
+      return v;
+   }
+
+   //______________________________________________________________________________
+   //
+   // Sequential decoder of the entries of a page. The first entry of a
+   // page holds its values, the next ones the increase of the major value,
+   // then the increase of the minor value if the major value is the same or
+   // the minor value otherwise, and the difference of the entry numbers.
+
+   struct TPageReader_t {
+      const char *fCur;
+      Long64_t    fMajor;
+      Long64_t    fMinor;
+      Long64_t    fEntry;
+
+      TPageReader_t(const char *page) : fCur(page), fMajor(0), fMinor(0), fEntry(0) {
+         fMajor = R__UnZigZag(R__ReadVarint(fCur));
+         fMinor = R__UnZigZag(R__ReadVarint(fCur));
+         fEntry = (Long64_t)R__ReadVarint(fCur);
+      }
+      void Next() {
+         ULong64_t dmajor = R__ReadVarint(fCur);
+         if (dmajor) {
+            fMajor = (Long64_t)((ULong64_t)fMajor + dmajor);
+            fMinor = R__UnZigZag(R__ReadVarint(fCur));
+         } else {
+            fMinor = (Long64_t)((ULong64_t)fMinor + R__ReadVarint(fCur));
+         }
+         fEntry += R__UnZigZag(R__ReadVarint(fCur));
+      }
+   };
+
+   //______________________________________________________________________________
+   //
+   // Work of a thread building the index: evaluate the values of the
+   // entries [fFirst, fLast) on its own copy of the tree, and sort them.
+
+   struct TBuildWorker_t {
+      TTree                             *fTree;
+      TFile                             *fFile;
+      TTreeFormula                      *fMajor;
+      TTreeFormula                      *fMinor;
+      Long64_t                           fFirst;
+      Long64_t                           fLast;
+      TTreeCompactIndex::IndexEntry_t   *fOut;
+      Bool_t                             fOk;
+      TThread                           *fThread;
+   };
+
+   //______________________________________________________________________________
+   void *R__BuildLoop(void *arg)
+   {
+      TBuildWorker_t *w = (TBuildWorker_t *)arg;
+      Int_t current = -1;
+      for (Long64_t i = w->fFirst; i < w->fLast; i++) {
+         Long64_t centry = w->fTree->LoadTree(i);
+         if (centry < 0) {
+            w->fOk = kFALSE;
+            return 0;
+         }
+         if (w->fTree->GetTreeNumber() != current) {
+            current = w->fTree->GetTreeNumber();
+            w->fMajor->UpdateFormulaLeaves();
+            w->fMinor->UpdateFormulaLeaves();
+         }
+         TTreeCompactIndex::IndexEntry_t &v = w->fOut[i - w->fFirst];
+         v.fMajor = (Long64_t) w->fMajor->EvalInstance<LongDouble_t>();
+         v.fMinor = (Long64_t) w->fMinor->EvalInstance<LongDouble_t>();
+         v.fEntry = i;
+      }
+      std::sort(w->fOut, w->fOut + (w->fLast - w->fFirst));
+      w->fOk = kTRUE;
+      return 0;
+   }
+}
+
+//______________________________________________________________________________
+TTreeCompactIndex::TTreeCompactIndex(): TVirtualIndex()
+{
+   // Default constructor for TTreeCompactIndex
+
+   fTree               = 0;
+   fN                  = 0;
+   fPageSize           = kDefaultPageSize;
+   fNpages             = 0;
+   fPageMajor          = 0;
+   fPageMinor          = 0;
+   fPageSeek           = 0;
+   fPageBytes          = 0;
+   fMaxMajor           = 0;
+   fMaxMinor           = 0;
+   fPageKeylen         = 0;
+   fFile               = 0;
+   fRecordFile         = 0;
+   fMajorFormula       = 0;
+   fMinorFormula       = 0;
+   fMajorFormulaParent = 0;
+   fMinorFormulaParent = 0;
+}
+
+//______________________________________________________________________________
+TTreeCompactIndex::TTreeCompactIndex(const TTree *T, const char *majorname, const char *minorname, Int_t pagesize)
+           : TVirtualIndex()
+{
+   // Normal constructor for TTreeCompactIndex.
+   //
+   // Build an index of the tree T with the expressions majorname and
+   // minorname, see TTreeIndex::TTreeIndex for their description and for
+   // the use of the index. The entries are stored by pages of pagesize
+   // entries: larger pages make a smaller directory (the part of the index
+   // read with the tree), smaller pages make faster lookups.
+
+   fTree               = (TTree*)T;
+   fN                  = 0;
+   fPageSize           = pagesize > 0 ? pagesize : (Int_t)kDefaultPageSize;
+   fNpages             = 0;
+   fPageMajor          = 0;
+   fPageMinor          = 0;
+   fPageSeek           = 0;
+   fPageBytes          = 0;
+   fMaxMajor           = 0;
+   fMaxMinor           = 0;
+   fPageKeylen         = 0;
+   fFile               = 0;
+   fRecordFile         = 0;
+   fMajorFormula       = 0;
+   fMinorFormula       = 0;
+   fMajorFormulaParent = 0;
+   fMinorFormulaParent = 0;
+   fMajorName          = majorname;
+   fMinorName          = minorname;
+   if (!T) return;
+   // take over the records of the index being replaced, they are freed
+   // when this one is written in the same file (see WritePages)
+   TTreeCompactIndex *previous = dynamic_cast<TTreeCompactIndex*>(T->GetTreeIndex());
+   if (previous && previous->fRecordFile) {
+      fRecordFile = previous->fRecordFile;
+      fRecordUUID = previous->fRecordUUID;
+      fRecordSeek.swap(previous->fRecordSeek);
+      fRecordBytes.swap(previous->fRecordBytes);
+      previous->fRecordFile = 0;
+   }
+   fN = T->GetEntries();
+   if (fN <= 0) {
+      MakeZombie();
+      Error("TreeCompactIndex","Cannot build a TreeIndex with a Tree having no entries");
+      return;
+   }
+
+   GetMajorFormula();
+   GetMinorFormula();
+   if (!fMajorFormula || !fMinorFormula ||
+       (fMajorFormula->GetNdim() != 1) || (fMinorFormula->GetNdim() != 1)) {
+      MakeZombie();
+      Error("TreeCompactIndex","Cannot build the index with major=%s, minor=%s",fMajorName.Data(), fMinorName.Data());
+      return;
+   }
+
+   std::vector<IndexEntry_t> values;
+   Int_t nthreads = TTree::GetImplicitMT();
+   if (nthreads < 2 || fN < 2*fPageSize || !EvaluateMT(values, nthreads)) {
+      Evaluate(values);
+      std::sort(values.begin(), values.end());
+   }
+   SetEntries(values);
+}
+
+//______________________________________________________________________________
+TTreeCompactIndex::~TTreeCompactIndex()
+{
+   // Destructor.
+
+   if (fTree && fTree->GetTreeIndex() == this) fTree->SetTreeIndex(0);
+   delete [] fPageMajor;        fPageMajor = 0;
+   delete [] fPageMinor;        fPageMinor = 0;
+   delete [] fPageSeek;         fPageSeek = 0;
+   delete [] fPageBytes;        fPageBytes = 0;
+   delete fMajorFormula;        fMajorFormula  = 0;
+   delete fMinorFormula;        fMinorFormula  = 0;
+   delete fMajorFormulaParent;  fMajorFormulaParent = 0;
+   delete fMinorFormulaParent;  fMinorFormulaParent = 0;
+}
+
+//______________________________________________________________________________
+void TTreeCompactIndex::Append(const TVirtualIndex *add, Bool_t delaySort )
+{
+   // Append 'add' (a TTreeCompactIndex or a TTreeIndex) to this index.
+   // Entry 0 in add will become entry n+1 in this.
+   // If delaySort is true, the entries are not encoded yet, then you must
+   // call Append(0,kFALSE) before using the index.
+
+   if (add && add->GetN()) {
+      const TTreeCompactIndex *ci_add = dynamic_cast<const TTreeCompactIndex*>(add);
+      const TTreeIndex *ti_add = dynamic_cast<const TTreeIndex*>(add);
+      if (ci_add == 0 && ti_add == 0) {
+         Error("Append","Can only Append a TTreeCompactIndex or a TTreeIndex to a TTreeCompactIndex but got a %s",
+               add->IsA()->GetName());
+         return;
+      }
+
+      if (fPending.empty()) GetEntries(fPending);
+      Long64_t oldn = fN;
+      size_t first = fPending.size();
+      if (ci_add) {
+         ci_add->GetEntries(fPending);
+      } else {
+         for (Long64_t i = 0; i < ti_add->GetN(); i++) {
+            IndexEntry_t v;
+            v.fMajor = ti_add->GetIndexValues()[i];
+            v.fMinor = ti_add->GetIndexValuesMinor()[i];
+            v.fEntry = ti_add->GetIndex()[i];
+            fPending.push_back(v);
+         }
+      }
+      for (size_t i = first; i < fPending.size(); i++) {
+         fPending[i].fEntry += oldn;
+      }
+      fN += add->GetN();
+   }
+
+   if (!delaySort && !fPending.empty()) {
+      std::sort(fPending.begin(), fPending.end());
+      SetEntries(fPending);
+      std::vector<IndexEntry_t>().swap(fPending);
+   }
+}
+
+//______________________________________________________________________________
+Bool_t TTreeCompactIndex::Evaluate(std::vector<IndexEntry_t> &values)
+{
+   // Fill values with the major and minor values of all the entries of the
+   // tree, in the order of the entries.
+
+   values.resize(fN);
+   Long64_t oldEntry = fTree->GetReadEntry();
+   Int_t current = -1;
+   for (Long64_t i = 0; i < fN; i++) {
+      Long64_t centry = fTree->LoadTree(i);
+      if (centry < 0) {
+         values.resize(i);
+         fN = i;
+         break;
+      }
+      if (fTree->GetTreeNumber() != current) {
+         current = fTree->GetTreeNumber();
+         fMajorFormula->UpdateFormulaLeaves();
+         fMinorFormula->UpdateFormulaLeaves();
+      }
+      values[i].fMajor = (Long64_t) fMajorFormula->EvalInstance<LongDouble_t>();
+      values[i].fMinor = (Long64_t) fMinorFormula->EvalInstance<LongDouble_t>();
+      values[i].fEntry = i;
+   }
+   fTree->LoadTree(oldEntry);
+   return kTRUE;
+}
+
+//______________________________________________________________________________
+Bool_t TTreeCompactIndex::EvaluateMT(std::vector<IndexEntry_t> &values, Int_t nthreads)
+{
+   // Fill values with the sorted major and minor values of all the entries
+   // of the tree, with nthreads threads. Each thread reads a range of
+   // clusters (files for a TChain) with its own copy of the tree (see
+   // TTreePlayer::OpenTreeCopy) and sorts its values, the sorted ranges are
+   // then merged.
+   // Returns kFALSE, leaving values empty, if the copies of the tree cannot
+   // be opened or an entry cannot be read.
+
+   // Split the entries at the cluster boundaries in nthreads ranges
+   std::vector<Long64_t> bounds;
+   bounds.push_back(0);
+   Long64_t target = fN / nthreads;
+   TTree::TClusterIterator clusterIter = fTree->GetClusterIterator(0);
+   Long64_t start;
+   while ((start = clusterIter()) < fN) {
+      if (start - bounds.back() >= target) bounds.push_back(start);
+   }
+   bounds.push_back(fN);
+   nthreads = bounds.size() - 1;
+   if (nthreads < 2) return kFALSE;
+
+   TDirectory::TContext ctxt(0);
+   std::vector<TBuildWorker_t> workers(nthreads);
+   values.resize(fN);
+   Int_t nopen = 0;
+   for (; nopen < nthreads; nopen++) {
+      TBuildWorker_t &w = workers[nopen];
+      w.fTree = TTreePlayer::OpenTreeCopy(fTree, w.fFile);
+      if (!w.fTree) break;
+      w.fMajor = new TTreeFormula("Major",fMajorName.Data(),w.fTree);
+      w.fMajor->SetQuickLoad(kTRUE);
+      w.fMinor = new TTreeFormula("Minor",fMinorName.Data(),w.fTree);
+      w.fMinor->SetQuickLoad(kTRUE);
+      w.fFirst = bounds[nopen];
+      w.fLast  = bounds[nopen+1];
+      w.fOut   = &values[0] + w.fFirst;
+      w.fOk    = kFALSE;
+      w.fThread = 0;
+   }
+
+   Bool_t ok = (nopen == nthreads);
+   if (ok) {
+      TThread::Initialize();
+      for (Int_t i = 0; i < nthreads; i++) {
+         workers[i].fThread = new TThread(Form("BuildIndex%d", i), R__BuildLoop, (void*)&workers[i]);
+         workers[i].fThread->Run();
+      }
+      for (Int_t i = 0; i < nthreads; i++) {
+         workers[i].fThread->Join();
+         delete workers[i].fThread;
+         ok = ok && workers[i].fOk;
+      }
+   }
+
+   for (Int_t i = 0; i < nopen; i++) {
+      TBuildWorker_t &w = workers[i];
+      delete w.fMajor;
+      delete w.fMinor;
+      if (w.fFile) delete w.fFile; // also deletes the tree
+      else delete w.fTree;
+   }
+   if (!ok) {
+      values.clear();
+      return kFALSE;
+   }
+
+   for (Int_t i = 1; i < nthreads; i++) {
+      std::inplace_merge(values.begin(), values.begin() + bounds[i], values.begin() + bounds[i+1]);
+   }
+   return kTRUE;
+}
+
+//______________________________________________________________________________
+Long64_t TTreeCompactIndex::FindEntry(Long64_t major, Long64_t minor, Bool_t best) const
+{
+   // Return the entry number of the first pair equal to major,minor, or,
+   // if there is none and best is true, of the last pair lower than
+   // major,minor. Return -1 if no entry is found.
+   // The directory gives the page; at most two pages are decoded.
+
+   if (fNpages == 0) return -1;
+
+   // first page whose first pair is not lower than major,minor
+   Int_t lo = 0, count = fNpages;
+   while (count > 0) {
+      Int_t step = count / 2;
+      Int_t mid = lo + step;
+      if (fPageMajor[mid] < major || (fPageMajor[mid] == major && fPageMinor[mid] < minor)) {
+         lo = mid + 1;
+         count -= step + 1;
+      } else
+         count = step;
+   }
+
+   Long64_t below = -1;
+   if (lo > 0) {
+      // the pair, or the last pair lower than it, is in the previous page
+      const char *page = GetPage(lo - 1);
+      if (!page) return -1;
+      Long64_t nentries = (lo == fNpages) ? fN - (Long64_t)(lo - 1) * fPageSize : fPageSize;
+      TPageReader_t reader(page);
+      for (Long64_t i = 0; ; ) {
+         if (reader.fMajor == major && reader.fMinor == minor) return reader.fEntry;
+         if (reader.fMajor > major || (reader.fMajor == major && reader.fMinor > minor)) break;
+         below = reader.fEntry;
+         if (++i >= nentries) break;
+         reader.Next();
+      }
+   }
+   if (lo < fNpages && fPageMajor[lo] == major && fPageMinor[lo] == minor) {
+      const char *page = GetPage(lo);
+      if (!page) return -1;
+      return TPageReader_t(page).fEntry;
+   }
+   return best ? below : -1;
+}
+
+//______________________________________________________________________________
+void TTreeCompactIndex::GetEntries(std::vector<IndexEntry_t> &values) const
+{
+   // Append to values all the entries of the index, sorted by major and
+   // minor values. All the pages are read.
+
+   values.reserve(values.size() + fN);
+   for (Int_t p = 0; p < fNpages; p++) {
+      const char *page = GetPage(p);
+      if (!page) return;
+      Long64_t nentries = (p == fNpages - 1) ? fN - (Long64_t)p * fPageSize : fPageSize;
+      TPageReader_t reader(page);
+      for (Long64_t i = 0; i < nentries; i++) {
+         if (i) reader.Next();
+         IndexEntry_t v;
+         v.fMajor = reader.fMajor;
+         v.fMinor = reader.fMinor;
+         v.fEntry = reader.fEntry;
+         values.push_back(v);
+      }
+   }
+}
+
+//______________________________________________________________________________
+Long64_t TTreeCompactIndex::GetEntryNumberFriend(const TTree *parent)
+{
+   // Returns the entry number in this (friend) Tree corresponding to entry in
+   // the master Tree 'parent', see TTreeIndex::GetEntryNumberFriend.
+
+   if (!parent) return -3;
+   GetMajorFormulaParent(parent);
+   GetMinorFormulaParent(parent);
+   if (!fMajorFormulaParent || !fMinorFormulaParent) return -1;
+   if (!fMajorFormulaParent->GetNdim() || !fMinorFormulaParent->GetNdim()) {
+      // The Tree Index in the friend has a pair majorname,minorname
+      // not available in the parent Tree T.
+      // if the friend Tree has less entries than the parent, this is an error
+      Long64_t pentry = parent->GetReadEntry();
+      if (pentry >= fTree->GetEntries()) return -2;
+      // otherwise we ignore the Tree Index and return the entry number
+      // in the parent Tree.
+      return pentry;
+   }
+
+   // majorname, minorname exist in the parent Tree
+   // we find the current values pair majorv,minorv in the parent Tree
+   Double_t majord = fMajorFormulaParent->EvalInstance();
+   Double_t minord = fMinorFormulaParent->EvalInstance();
+   Long64_t majorv = (Long64_t)majord;
+   Long64_t minorv = (Long64_t)minord;
+   // we check if this pair exist in the index.
+   // if yes, we return the corresponding entry number
+   // if not the function returns -1
+   return fTree->GetEntryNumberWithIndex(majorv,minorv);
+}
+
+//______________________________________________________________________________
+Long64_t TTreeCompactIndex::GetEntryNumberWithBestIndex(Long64_t major, Long64_t minor) const
+{
+   // Return entry number corresponding to major and minor number.
+   // If an entry corresponding to major and minor is not found, the function
+   // returns the entry of the major,minor pair immediatly lower than the
+   // requested value, ie it will return -1 if the pair is lower than
+   // the first entry in the index.
+   //
+   // See also GetEntryNumberWithIndex and TTreeIndex::GetEntryNumberWithBestIndex
+
+   return FindEntry(major, minor, kTRUE);
+}
+
+//______________________________________________________________________________
+Long64_t TTreeCompactIndex::GetEntryNumberWithIndex(Long64_t major, Long64_t minor) const
+{
+   // Return entry number corresponding to major and minor number, or -1
+   // if the pair is not in the index. If several entries have the same
+   // pair, the lowest entry number is returned.
+   // Note that this function returns only the entry number, not the data
+   // To read the data corresponding to an entry number, use TTree::GetEntryWithIndex
+   //
+   // See also GetEntryNumberWithBestIndex
+
+   return FindEntry(major, minor, kFALSE);
+}
+
+//______________________________________________________________________________
+TTreeFormula *TTreeCompactIndex::GetMajorFormula()
+{
+   // Return a pointer to the TreeFormula corresponding to the majorname.
+
+   if (!fMajorFormula) {
+      fMajorFormula = new TTreeFormula("Major",fMajorName.Data(),fTree);
+      fMajorFormula->SetQuickLoad(kTRUE);
+   }
+   return fMajorFormula;
+}
+
+//______________________________________________________________________________
+TTreeFormula *TTreeCompactIndex::GetMinorFormula()
+{
+   // Return a pointer to the TreeFormula corresponding to the minorname.
+
+   if (!fMinorFormula) {
+      fMinorFormula = new TTreeFormula("Minor",fMinorName.Data(),fTree);
+      fMinorFormula->SetQuickLoad(kTRUE);
+   }
+   return fMinorFormula;
+}
+
+//______________________________________________________________________________
+TTreeFormula *TTreeCompactIndex::GetMajorFormulaParent(const TTree *parent)
+{
+   // Return a pointer to the TreeFormula corresponding to the majorname in parent tree.
+
+   if (!fMajorFormulaParent) {
+      // Prevent TTreeFormula from finding any of the branches in our TTree even if it
+      // is a friend of the parent TTree.
+      TTree::TFriendLock friendlock(fTree, TTree::kFindLeaf | TTree::kFindBranch | TTree::kGetBranch | TTree::kGetLeaf);
+      fMajorFormulaParent = new TTreeFormula("MajorP",fMajorName.Data(),const_cast<TTree*>(parent));
+      fMajorFormulaParent->SetQuickLoad(kTRUE);
+   }
+   if (fMajorFormulaParent->GetTree() != parent) {
+      fMajorFormulaParent->SetTree(const_cast<TTree*>(parent));
+      fMajorFormulaParent->UpdateFormulaLeaves();
+   }
+   return fMajorFormulaParent;
+}
+
+//______________________________________________________________________________
+TTreeFormula *TTreeCompactIndex::GetMinorFormulaParent(const TTree *parent)
+{
+   // Return a pointer to the TreeFormula corresponding to the minorname in parent tree.
+
+   if (!fMinorFormulaParent) {
+      // Prevent TTreeFormula from finding any of the branches in our TTree even if it
+      // is a friend of the parent TTree.
+      TTree::TFriendLock friendlock(fTree, TTree::kFindLeaf | TTree::kFindBranch | TTree::kGetBranch | TTree::kGetLeaf);
+      fMinorFormulaParent = new TTreeFormula("MinorP",fMinorName.Data(),const_cast<TTree*>(parent));
+      fMinorFormulaParent->SetQuickLoad(kTRUE);
+   }
+   if (fMinorFormulaParent->GetTree() != parent) {
+      fMinorFormulaParent->SetTree(const_cast<TTree*>(parent));
+      fMinorFormulaParent->UpdateFormulaLeaves();
+   }
+   return fMinorFormulaParent;
+}
+
+//______________________________________________________________________________
+const char *TTreeCompactIndex::GetPage(Int_t page) const
+{
+   // Return the address of the encoded page, or 0 if it cannot be read.
+   // The pages which are not in memory are read from the file: from the
+   // mapping if the file is opened with the option MMAP, otherwise in a
+   // cache of the last pages read. The address is valid until the next
+   // call.
+
+   if (page < 0 || page >= fNpages) return 0;
+   if (!fPageOffset.empty()) return &fPages[0] + fPageOffset[page];
+   if (!fFile) return 0;
+
+   if (fFile->IsMapped()) {
+      const char *mapped = fFile->GetMappedBuffer(fPageSeek[page], fPageBytes[page]);
+      if (mapped) return mapped;
+   }
+
+   std::map<Int_t, std::vector<char> >::iterator it = fCache.find(page);
+   if (it != fCache.end()) return &(it->second)[0];
+
+   if (fCacheOrder.size() >= kMaxCachedPages) {
+      fCache.erase(fCacheOrder.front());
+      fCacheOrder.erase(fCacheOrder.begin());
+   }
+   std::vector<char> &buffer = fCache[page];
+   buffer.resize(fPageBytes[page]);
+   if (fFile->ReadBuffer(&buffer[0], fPageSeek[page], fPageBytes[page])) {
+      Error("GetPage", "Cannot read the page %d of the index at %lld in %s",
+            page, fPageSeek[page], fFile->GetName());
+      fCache.erase(page);
+      return 0;
+   }
+   fCacheOrder.push_back(page);
+   return &buffer[0];
+}
+
+//______________________________________________________________________________
+void TTreeCompactIndex::Print(Option_t * option) const
+{
+   // Print the size of the index and the table with : serial number,
+   // majorname, minorname, entry number.
+   // if option = "10" print only the first 10 entries
+   // if option = "100" print only the first 100 entries
+   // if option = "1000" print only the first 1000 entries
+   // if option = "all" print all the entries
+
+   TString opt = option;
+   Long64_t n = 0;
+   if (opt.Contains("10"))   n = 10;
+   if (opt.Contains("100"))  n = 100;
+   if (opt.Contains("1000")) n = 1000;
+   if (opt.Contains("all"))  n = fN;
+
+   Long64_t nbytes = 0;
+   for (Int_t p = 0; p < fNpages; p++) nbytes += fPageBytes[p];
+   Printf("\n*****************************************************************");
+   Printf("*    Compact index of Tree: %s/%s",fTree ? fTree->GetName() : "",fTree ? fTree->GetTitle() : "");
+   Printf("*    %lld entries in %d pages of %d entries, %lld bytes (%.2f bytes per entry)",
+          fN, fNpages, fPageSize, nbytes, fN ? Double_t(nbytes)/fN : 0.);
+   Printf("*    pages %s", !fPageOffset.empty() ? "in memory" : (fFile ? fFile->GetName() : "not available"));
+   Printf("*****************************************************************");
+   if (n <= 0) return;
+   Printf("%8s : %16s : %16s : %16s","serial",fMajorName.Data(),fMinorName.Data(),"entry number");
+   Printf("*****************************************************************");
+   std::vector<IndexEntry_t> values;
+   GetEntries(values);
+   if (n > (Long64_t)values.size()) n = values.size();
+   for (Long64_t i=0;i<n;i++) {
+      Printf("%8lld :         %8lld :         %8lld :         %8lld",
+             i, values[i].fMajor, values[i].fMinor, values[i].fEntry);
+   }
+}
+
+//______________________________________________________________________________
+void TTreeCompactIndex::SetEntries(const std::vector<IndexEntry_t> &values)
+{
+   // Encode the sorted values in pages held in memory.
+
+   fN = values.size();
+   fNpages = (Int_t)((fN + fPageSize - 1) / fPageSize);
+   delete [] fPageMajor;  fPageMajor = new Long64_t[fNpages];
+   delete [] fPageMinor;  fPageMinor = new Long64_t[fNpages];
+   delete [] fPageSeek;   fPageSeek  = new Long64_t[fNpages];
+   delete [] fPageBytes;  fPageBytes = new Int_t[fNpages];
+   fPages.clear();
+   fPages.reserve(4*fN);
+   fPageOffset.resize(fNpages);
+   fFile = 0;
+   fCache.clear();
+   fCacheOrder.clear();
+
+   for (Int_t p = 0; p < fNpages; p++) {
+      Long64_t first = (Long64_t)p * fPageSize;
+      Long64_t last  = TMath::Min(first + fPageSize, fN);
+      fPageOffset[p] = fPages.size();
+      fPageMajor[p]  = values[first].fMajor;
+      fPageMinor[p]  = values[first].fMinor;
+      fPageSeek[p]   = 0;
+      R__WriteVarint(fPages, R__ZigZag(values[first].fMajor));
+      R__WriteVarint(fPages, R__ZigZag(values[first].fMinor));
+      R__WriteVarint(fPages, (ULong64_t)values[first].fEntry);
+      for (Long64_t i = first + 1; i < last; i++) {
+         const IndexEntry_t &prev = values[i-1];
+         const IndexEntry_t &cur  = values[i];
+         ULong64_t dmajor = (ULong64_t)cur.fMajor - (ULong64_t)prev.fMajor;
+         R__WriteVarint(fPages, dmajor);
+         if (dmajor) R__WriteVarint(fPages, R__ZigZag(cur.fMinor));
+         else        R__WriteVarint(fPages, (ULong64_t)cur.fMinor - (ULong64_t)prev.fMinor);
+         R__WriteVarint(fPages, R__ZigZag(cur.fEntry - prev.fEntry));
+      }
+      fPageBytes[p] = (Int_t)(fPages.size() - fPageOffset[p]);
+   }
+   if (fN) {
+      fMaxMajor = values[fN-1].fMajor;
+      fMaxMinor = values[fN-1].fMinor;
+   }
+}
+
+//______________________________________________________________________________
+void TTreeCompactIndex::Streamer(TBuffer &R__b)
+{
+   // Stream an object of class TTreeCompactIndex.
+   // Only the directory of the pages is streamed when the buffer belongs to
+   // a file (i.e. when the tree is written): the pages are then written in
+   // their own records of the file, once per file. Otherwise (e.g. for
+   // Clone) the pages are streamed with the directory.
+
+   UInt_t R__s, R__c;
+   if (R__b.IsReading()) {
+      Version_t R__v = R__b.ReadVersion(&R__s, &R__c); if (R__v) { }
+      TVirtualIndex::Streamer(R__b);
+      fMajorName.Streamer(R__b);
+      fMinorName.Streamer(R__b);
+      R__b >> fN;
+      R__b >> fPageSize;
+      R__b >> fNpages;
+      R__b >> fMaxMajor;
+      R__b >> fMaxMinor;
+      Char_t inpages;
+      R__b >> inpages;
+      delete [] fPageMajor;  fPageMajor = new Long64_t[fNpages];
+      delete [] fPageMinor;  fPageMinor = new Long64_t[fNpages];
+      delete [] fPageSeek;   fPageSeek  = new Long64_t[fNpages];
+      delete [] fPageBytes;  fPageBytes = new Int_t[fNpages];
+      R__b.ReadFastArray(fPageMajor,fNpages);
+      R__b.ReadFastArray(fPageMinor,fNpages);
+      R__b.ReadFastArray(fPageBytes,fNpages);
+      fPages.clear();
+      fPageOffset.clear();
+      fCache.clear();
+      fCacheOrder.clear();
+      fFile = 0;
+      if (inpages) {
+         fPageOffset.resize(fNpages);
+         Long64_t nbytes = 0;
+         for (Int_t p = 0; p < fNpages; p++) {
+            fPageOffset[p] = nbytes;
+            fPageSeek[p] = 0;
+            nbytes += fPageBytes[p];
+         }
+         fPages.resize(nbytes);
+         if (nbytes) R__b.ReadFastArray(&fPages[0], (Int_t)nbytes);
+      } else {
+         R__b.ReadFastArray(fPageSeek,fNpages);
+         fPageKeylen = 0;
+         if (R__v > 1) R__b >> fPageKeylen;
+         fFile = dynamic_cast<TFile*>(R__b.GetParent());
+         if (fFile) fFileUUID = fFile->GetUUID();
+         // remember the records of the pages, to free them if the pages are
+         // written again in this file (see WritePages)
+         fRecordFile = 0;
+         fRecordSeek.clear();
+         fRecordBytes.clear();
+         if (fFile && fPageKeylen > 0) {
+            fRecordFile = fFile;
+            fRecordUUID = fFileUUID;
+            for (Int_t p = 0; p < fNpages; p++) {
+               fRecordSeek.push_back(fPageSeek[p] - fPageKeylen);
+               fRecordBytes.push_back(fPageKeylen + fPageBytes[p]);
+            }
+         }
+      }
+      R__b.CheckByteCount(R__s, R__c, TTreeCompactIndex::IsA());
+   } else {
+      if (!fPending.empty()) Append(0, kFALSE);
+      TFile *file = dynamic_cast<TFile*>(R__b.GetParent());
+      if (file && file->IsWritable() && (file != fFile || !(file->GetUUID() == fFileUUID))) {
+         WritePages(file);
+      }
+      Char_t inpages = !(file && file == fFile);
+      R__c = R__b.WriteVersion(TTreeCompactIndex::IsA(), kTRUE);
+      TVirtualIndex::Streamer(R__b);
+      fMajorName.Streamer(R__b);
+      fMinorName.Streamer(R__b);
+      R__b << fN;
+      R__b << fPageSize;
+      R__b << fNpages;
+      R__b << fMaxMajor;
+      R__b << fMaxMinor;
+      R__b << inpages;
+      R__b.WriteFastArray(fPageMajor, fNpages);
+      R__b.WriteFastArray(fPageMinor, fNpages);
+      R__b.WriteFastArray(fPageBytes, fNpages);
+      if (inpages) {
+         for (Int_t p = 0; p < fNpages; p++) {
+            const char *page = GetPage(p);
+            if (page) R__b.WriteFastArray(page, fPageBytes[p]);
+            else {
+               std::vector<char> empty(fPageBytes[p]);
+               R__b.WriteFastArray(&empty[0], fPageBytes[p]);
+            }
+         }
+      } else {
+         R__b.WriteFastArray(fPageSeek, fNpages);
+         R__b << fPageKeylen;
+      }
+      R__b.SetByteCount(R__c, kTRUE);
+   }
+}
+
+//______________________________________________________________________________
+void TTreeCompactIndex::UpdateFormulaLeaves(const TTree *parent)
+{
+   // Called by TChain::LoadTree when the parent chain changes it's tree.
+
+   if (fMajorFormula)       { fMajorFormula->UpdateFormulaLeaves();}
+   if (fMinorFormula)       { fMinorFormula->UpdateFormulaLeaves();}
+   if (fMajorFormulaParent) {
+      if (parent) fMajorFormulaParent->SetTree(const_cast<TTree*>(parent));
+      fMajorFormulaParent->UpdateFormulaLeaves();
+   }
+   if (fMinorFormulaParent) {
+      if (parent) fMinorFormulaParent->SetTree(const_cast<TTree*>(parent));
+      fMinorFormulaParent->UpdateFormulaLeaves();
+   }
+}
+
+//______________________________________________________________________________
+void TTreeCompactIndex::SetTree(const TTree *T)
+{
+   // this function is called by TChain::LoadTree and TTreePlayer::UpdateFormulaLeaves
+   // when a new Tree is loaded.
+
+   fTree = (TTree*)T;
+}
+
+//______________________________________________________________________________
+void TTreeCompactIndex::WritePages(TFile *file)
+{
+   // Write each page in its own record of file, like the baskets the
+   // records are not in the list of keys of the directory. The pages are
+   // kept in memory if they were.
+   // The records of the pages previously written in (or read from) the same
+   // file are freed once the new ones are written: the index changed since
+   // then, and only the last written version of the tree (e.g. by AutoSave
+   // or with the option TObject::kOverwrite) can use its index.
+
+   std::vector<Long64_t> seeks;
+   std::vector<Int_t> bytes;
+   for (Int_t p = 0; p < fNpages; p++) {
+      const char *page = GetPage(p);
+      if (!page) {
+         Error("WritePages", "Cannot read the page %d of the index of %s", p, fTree ? fTree->GetName() : "");
+         return;
+      }
+      TKey *key = new TKey(fTree ? fTree->GetName() : GetName(), "TTreeCompactIndex page", IsA(), fPageBytes[p], file);
+      memcpy(key->GetBuffer(), page, fPageBytes[p]);
+      fPageSeek[p] = key->GetSeekKey() + key->GetKeylen();
+      fPageKeylen = key->GetKeylen();
+      seeks.push_back(key->GetSeekKey());
+      bytes.push_back(key->GetNbytes());
+      key->WriteFile(1, file);
+      delete key;
+   }
+   if (fRecordFile == file && fRecordUUID == file->GetUUID()) {
+      for (size_t i = 0; i < fRecordSeek.size(); i++) {
+         file->MakeFree(fRecordSeek[i], fRecordSeek[i] + fRecordBytes[i] - 1);
+      }
+   }
+   fRecordFile = file;
+   fRecordUUID = file->GetUUID();
+   fRecordSeek.swap(seeks);
+   fRecordBytes.swap(bytes);
+   // the pages read from another file are now read from this one
+   if (fPageOffset.empty()) {
+      fCache.clear();
+      fCacheOrder.clear();
+   }
+   fFile = file;
+   fFileUUID = file->GetUUID();
+}
@@ -45,6 +45,8 @@
 #include "TFormLeafInfoReference.h"
 
 #include "TEntryList.h"
+#include "TEnv.h"
+#include "TVirtualMutex.h"
 
 #include <ctype.h>
 #include <stdio.h>
@@ -52,9 +54,12 @@
 #include <stdlib.h>
 #include <typeinfo>
 #include <algorithm>
+#include <map>
 
 const Int_t kMaxLen     = 1024;
 
+Int_t TTreeFormula::fgJitThreshold = -1;  // read from TTreeFormula.JitThreshold when first needed
+
 ClassImp(TTreeFormula)
 
 //______________________________________________________________________________
@@ -125,7 +130,8 @@ public:
 
 //______________________________________________________________________________
 TTreeFormula::TTreeFormula(): TFormula(), fQuickLoad(kFALSE), fNeedLoading(kTRUE),
-   fDidBooleanOptimization(kFALSE), fDimensionSetup(0)
+   fDidBooleanOptimization(kFALSE), fDimensionSetup(0), fJitFunc(0), fJitCount(0),
+   fJitShortCircuit(kFALSE), fJitInstance(0), fJitWillLoad(kFALSE)
 
 {
    // Tree Formula default constructor
@@ -157,7 +163,8 @@ TTreeFormula::TTreeFormula(): TFormula(), fQuickLoad(kFALSE), fNeedLoading(kTRUE
 //______________________________________________________________________________
 TTreeFormula::TTreeFormula(const char *name,const char *expression, TTree *tree)
    :TFormula(), fTree(tree), fQuickLoad(kFALSE), fNeedLoading(kTRUE),
-    fDidBooleanOptimization(kFALSE), fDimensionSetup(0)
+    fDidBooleanOptimization(kFALSE), fDimensionSetup(0), fJitFunc(0), fJitCount(0),
+    fJitShortCircuit(kFALSE), fJitInstance(0), fJitWillLoad(kFALSE)
 {
    // Normal TTree Formula Constuctor
 
@@ -168,7 +175,9 @@ TTreeFormula::TTreeFormula(const char *name,const char *expression, TTree *tree)
 TTreeFormula::TTreeFormula(const char *name,const char *expression, TTree *tree,
                            const std::vector<std::string>& aliases)
    :TFormula(), fTree(tree), fQuickLoad(kFALSE), fNeedLoading(kTRUE),
-    fDidBooleanOptimization(kFALSE), fDimensionSetup(0), fAliasesUsed(aliases)
+    fDidBooleanOptimization(kFALSE), fDimensionSetup(0), fAliasesUsed(aliases),
+    fJitFunc(0), fJitCount(0),
+    fJitShortCircuit(kFALSE), fJitInstance(0), fJitWillLoad(kFALSE)
 {
    // Constructor used during the expansion of an alias
    Init(name,expression);
@@ -3897,6 +3906,327 @@ template<> inline LongDouble_t TTreeFormula::GetConstant(Int_t k) {
 template<> inline Long64_t TTreeFormula::GetConstant(Int_t k) { return (Long64_t)GetConstant<LongDouble_t>(k); }
 
 //______________________________________________________________________________
+//______________________________________________________________________________
+//
+// Compilation of the operations.
+//
+// After GetJitThreshold() evaluations, EvalInstance<Double_t> translates the
+// operations of the formula into a C++ function, compiled by the interpreter,
+// returning the value of the formula. The function reads each variable when
+// its value is needed through a callback to the formula (see JitVariable),
+// so the right side of && and || is not read when it is skipped. The
+// interpretation of the operations is used for the formulas with
+// operations which are not translated (strings, aliases, function calls,
+// conditional expressions, random numbers, TCutG, ...) and for the
+// evaluation as Long64_t or LongDouble_t.
+//
+// The function of a given list of operations is compiled only once per
+// process, the formulas created for the successive trees of a TChain or by
+// the successive calls to TTree::Draw reuse it.
+
+static TVirtualMutex *gTTreeFormulaJitMutex = 0;
+
+template<typename T> struct R__IsDoubleType { enum { kValue = 0 }; };
+template<> struct R__IsDoubleType<Double_t> { enum { kValue = 1 }; };
+
+//______________________________________________________________________________
+static Bool_t R__JitDeclareHelpers()
+{
+   // Declare to the interpreter the functions used by the compiled formulas,
+   // they reproduce the protections of TTreeFormula::EvalInstance.
+
+   static Int_t declared = -1;
+   if (declared >= 0) return declared;
+   declared = 0;
+   TInterpreter::EErrorCode err = TInterpreter::kNoError;
+   gInterpreter->ProcessLine("#include <cmath>", &err);
+   if (err != TInterpreter::kNoError) return kFALSE;
+   gInterpreter->ProcessLine("#include \"TMath.h\"", &err);
+   if (err != TInterpreter::kNoError) return kFALSE;
+   gInterpreter->ProcessLine(
+      "namespace R__TTreeFormulaJit {\n"
+      "inline double Div(double a, double b) { return b == 0 ? 0 : a / b; }\n"
+      "inline double Mod(double a, double b) { return double(Long64_t(a) % Long64_t(b)); }\n"
+      "inline double Tan(double a) { return TMath::Cos(a) == 0 ? 0 : TMath::Tan(a); }\n"
+      "inline double ACos(double a) { return TMath::Abs(a) > 1 ? 0 : TMath::ACos(a); }\n"
+      "inline double ASin(double a) { return TMath::Abs(a) > 1 ? 0 : TMath::ASin(a); }\n"
+      "inline double TanH(double a) { return TMath::CosH(a) == 0 ? 0 : TMath::TanH(a); }\n"
+      "inline double ACosH(double a) { return a < 1 ? 0 : TMath::ACosH(a); }\n"
+      "inline double ATanH(double a) { return TMath::Abs(a) > 1 ? 0 : TMath::ATanH(a); }\n"
+      "inline double Sq(double a) { return a * a; }\n"
+      "inline double Sqrt(double a) { return TMath::Sqrt(TMath::Abs(a)); }\n"
+      "inline double Min(double a, double b) { return b < a ? b : a; }\n"
+      "inline double Max(double a, double b) { return a < b ? b : a; }\n"
+      "inline double Log(double a) { return a > 0 ? TMath::Log(a) : 0; }\n"
+      "inline double Log10(double a) { return a > 0 ? TMath::Log10(a) : 0; }\n"
+      "inline double Exp(double a) { return a < -700 ? 0 : TMath::Exp(a > 700 ? 700 : a); }\n"
+      "inline double Sign(double a) { return a < 0 ? -1 : 1; }\n"
+      "inline double Int(double a) { return double(Long64_t(a)); }\n"
+      "inline double BitAnd(double a, double b) { return double(ULong64_t(a) & ULong64_t(b)); }\n"
+      "inline double BitOr(double a, double b) { return double(ULong64_t(a) | ULong64_t(b)); }\n"
+      "inline double LeftShift(double a, double b) { return double(ULong64_t(a) << ULong64_t(b)); }\n"
+      "inline double RightShift(double a, double b) { return double(ULong64_t(a) >> ULong64_t(b)); }\n"
+      "}", &err);
+   if (err != TInterpreter::kNoError) return kFALSE;
+   declared = 1;
+   return kTRUE;
+}
+
+//______________________________________________________________________________
+Int_t TTreeFormula::GetJitThreshold()
+{
+   // Return the number of evaluations of a formula after which its operations
+   // are compiled, 0 if they are never compiled (see SetJitThreshold).
+
+   if (fgJitThreshold < 0) {
+      fgJitThreshold = TMath::Max(0, gEnv->GetValue("TTreeFormula.JitThreshold", 1000));
+   }
+   return fgJitThreshold;
+}
+
+//______________________________________________________________________________
+void TTreeFormula::SetJitThreshold(Int_t nevals)
+{
+   // Set the number of evaluations (EvalInstance) of a formula after which
+   // its operations are compiled with the interpreter, instead of being
+   // interpreted at each evaluation. The compilation takes some tens of
+   // milliseconds and the compiled formula is several times faster, the
+   // default (1000, or the value of TTreeFormula.JitThreshold in .rootrc)
+   // avoids compiling the formulas evaluated only a few times.
+   // Use 0 to never compile the formulas created afterwards.
+
+   fgJitThreshold = TMath::Max(0, nevals);
+}
+
+//______________________________________________________________________________
+Bool_t TTreeFormula::JitCompile()
+{
+   // Translate the operations into a C++ function and compile it with the
+   // interpreter. On success, EvalInstance<Double_t> calls the function via
+   // EvalJit instead of interpreting the operations.
+   // Returns kFALSE if some of the operations can not be translated or if
+   // the compilation failed.
+
+   if (!gInterpreter || fNoper < 2) return kFALSE;
+
+   std::vector<TString> stack;
+   std::vector<Int_t> codes;
+   Bool_t shortCircuit = kFALSE;
+   for (Int_t i = 0; i < fNoper; ++i) {
+      const Int_t action = GetAction(i);
+      const Int_t param  = GetActionParam(i);
+
+      const char *func  = 0;   // helper function or TMath function
+      const char *infix = 0;   // arithmetic operator
+      const char *cmp   = 0;   // operator whose result is 0 or 1
+      Int_t nargs = 0;
+      switch (action) {
+         case kEnd: i = fNoper; continue;
+         case kConstant: {
+            if (!TMath::Finite(fConst[param])) return kFALSE;
+            stack.push_back(TString::Format("(%.17g)", fConst[param]));
+            continue;
+         }
+         case kpi: stack.push_back(TString::Format("(%.17g)", TMath::ACos(-1))); continue;
+         case kDefinedVariable: {
+            switch (fLookupType[param]) {
+               case kDirect: case kMethod: case kDataMember: case kTreeMember:
+               case kIndexOfEntry: case kIndexOfLocalEntry: case kEntries:
+               case kLength: case kIteration:
+                  break;
+               default: return kFALSE;
+            }
+            if (std::find(codes.begin(), codes.end(), param) == codes.end()) codes.push_back(param);
+            stack.push_back(TString::Format("g(f, %d, &oor)", param));
+            continue;
+         }
+         // The operations && and || are preceded by a kBoolOptimize, the C++
+         // operators skip the right side in the same way.
+         case kBoolOptimize: shortCircuit = kTRUE; continue;
+
+         case kAdd:       infix = "+"; nargs = 2; break;
+         case kSubstract: infix = "-"; nargs = 2; break;
+         case kMultiply:  infix = "*"; nargs = 2; break;
+         case kSignInv:   infix = "-"; nargs = 1; break;
+
+         case kAnd:         cmp = "&&"; nargs = 2; break;
+         case kOr:          cmp = "||"; nargs = 2; break;
+         case kEqual:       cmp = "=="; nargs = 2; break;
+         case kNotEqual:    cmp = "!="; nargs = 2; break;
+         case kLess:        cmp = "<";  nargs = 2; break;
+         case kGreater:     cmp = ">";  nargs = 2; break;
+         case kLessThan:    cmp = "<="; nargs = 2; break;
+         case kGreaterThan: cmp = ">="; nargs = 2; break;
+         case kNot:         cmp = "!";  nargs = 1; break;
+
+         case kDivide:     func = "Div";        nargs = 2; break;
+         case kModulo:     func = "Mod";        nargs = 2; break;
+         case kcos:        func = "TMath::Cos";   nargs = 1; break;
+         case ksin:        func = "TMath::Sin";   nargs = 1; break;
+         case ktan:        func = "Tan";        nargs = 1; break;
+         case kacos:       func = "ACos";       nargs = 1; break;
+         case kasin:       func = "ASin";       nargs = 1; break;
+         case katan:       func = "TMath::ATan";  nargs = 1; break;
+         case kcosh:       func = "TMath::CosH";  nargs = 1; break;
+         case ksinh:       func = "TMath::SinH";  nargs = 1; break;
+         case ktanh:       func = "TanH";       nargs = 1; break;
+         case kacosh:      func = "ACosH";      nargs = 1; break;
+         case kasinh:      func = "TMath::ASinH"; nargs = 1; break;
+         case katanh:      func = "ATanH";      nargs = 1; break;
+         case katan2:      func = "TMath::ATan2"; nargs = 2; break;
+         case kfmod:       func = "fmod";       nargs = 2; break;
+         case kpow:        func = "TMath::Power"; nargs = 2; break;
+         case ksq:         func = "Sq";         nargs = 1; break;
+         case ksqrt:       func = "Sqrt";       nargs = 1; break;
+         case kmin:        func = "Min";        nargs = 2; break;
+         case kmax:        func = "Max";        nargs = 2; break;
+         case klog:        func = "Log";        nargs = 1; break;
+         case kexp:        func = "Exp";        nargs = 1; break;
+         case klog10:      func = "Log10";      nargs = 1; break;
+         case kabs:        func = "TMath::Abs";   nargs = 1; break;
+         case ksign:       func = "Sign";       nargs = 1; break;
+         case kint:        func = "Int";        nargs = 1; break;
+         case kBitAnd:     func = "BitAnd";     nargs = 2; break;
+         case kBitOr:      func = "BitOr";      nargs = 2; break;
+         case kLeftShift:  func = "LeftShift";  nargs = 2; break;
+         case kRightShift: func = "RightShift"; nargs = 2; break;
+
+         default: return kFALSE;
+      }
+      if ((Int_t)stack.size() < nargs) return kFALSE;
+      TString a = stack[stack.size() - nargs];
+      TString b = nargs == 2 ? stack.back() : TString();
+      stack.resize(stack.size() - nargs);
+      TString expr;
+      if (infix && nargs == 1) {
+         expr.Form("(%s%s)", infix, a.Data());
+      } else if (infix) {
+         expr.Form("(%s %s %s)", a.Data(), infix, b.Data());
+      } else if (cmp && nargs == 1) {
+         expr.Form("(%s(%s != 0) ? 1. : 0.)", cmp, a.Data());
+      } else if (cmp && (action == kAnd || action == kOr)) {
+         expr.Form("((%s != 0) %s (%s != 0) ? 1. : 0.)", a.Data(), cmp, b.Data());
+      } else if (cmp) {
+         expr.Form("(%s %s %s ? 1. : 0.)", a.Data(), cmp, b.Data());
+      } else if (nargs == 1) {
+         expr.Form("%s(%s)", func, a.Data());
+      } else {
+         expr.Form("%s(%s, %s)", func, a.Data(), b.Data());
+      }
+      stack.push_back(expr);
+   }
+   if (stack.size() != 1 || codes.empty()) return kFALSE;
+
+   // The evaluation of a variable out of range makes the value of the
+   // formula 0 (see TT_EVAL_INIT_LOOP), unless the variable is skipped by
+   // && or ||.
+   std::string body = TString::Format("(void *f, double (*g)(void *, int, bool *))\n"
+                                      "{\n"
+                                      "   bool oor = false;\n"
+                                      "   const double r = %s;\n"
+                                      "   return oor ? 0. : r;\n"
+                                      "}\n", stack[0].Data()).Data();
+
+   R__LOCKGUARD2(gTTreeFormulaJitMutex);
+   static std::map<std::string, JitFunc_t> compiled;
+   std::map<std::string, JitFunc_t>::iterator it = compiled.find(body);
+   if (it == compiled.end()) {
+      JitFunc_t func = 0;
+      if (R__JitDeclareHelpers()) {
+         TString name = TString::Format("TTreeFormula_%d", (Int_t)compiled.size());
+         TInterpreter::EErrorCode err = TInterpreter::kNoError;
+         gInterpreter->ProcessLine(TString::Format("namespace R__TTreeFormulaJit {\ndouble %s%s}",
+                                                   name.Data(), body.c_str()), &err);
+         if (err == TInterpreter::kNoError) {
+            Long_t addr = gInterpreter->Calc(TString::Format("(long)&R__TTreeFormulaJit::%s", name.Data()), &err);
+            if (err == TInterpreter::kNoError) func = (JitFunc_t)addr;
+         }
+         if (!func) Warning("JitCompile", "the compilation of %s failed", GetTitle());
+      }
+      it = compiled.insert(std::make_pair(body, func)).first;
+   }
+   if (!it->second) return kFALSE;
+   fJitCodes = codes;
+   fJitShortCircuit = shortCircuit;
+   fJitFunc = it->second;
+   return kTRUE;
+}
+
+//______________________________________________________________________________
+Double_t TTreeFormula::EvalJitVariable(Int_t code, Int_t instance, Bool_t willLoad, Bool_t &missing)
+{
+   // Return the value of the variable code for the given instance, as read by
+   // EvalInstance. missing is set to kTRUE if the instance is out of range.
+
+   missing = kTRUE;
+   switch (fLookupType[code]) {
+      case kDirect:     { TT_EVAL_INIT_LOOP; missing = kFALSE; return leaf->GetTypedValue<Double_t>(real_instance); }
+      case kMethod:     { TT_EVAL_INIT_LOOP; missing = kFALSE; return GetValueFromMethod(code,leaf); }
+      case kDataMember: { TT_EVAL_INIT_LOOP; missing = kFALSE; return ((TFormLeafInfo*)fDataMembers.UncheckedAt(code))->
+                                 GetTypedValue<Double_t>(leaf,real_instance); }
+      case kTreeMember: { TREE_EVAL_INIT_LOOP; missing = kFALSE; return ((TFormLeafInfo*)fDataMembers.UncheckedAt(code))->
+                                 GetTypedValue<Double_t>((TLeaf*)0x0,real_instance); }
+   }
+   missing = kFALSE;
+   switch (fLookupType[code]) {
+      case kIndexOfEntry:      return fTree->GetReadEntry();
+      case kIndexOfLocalEntry: return fTree->GetTree()->GetReadEntry();
+      case kEntries:           return fTree->GetEntries();
+      case kLength:            return fManager->fNdata;
+      case kIteration:         return instance;
+   }
+   return 0;
+}
+
+//______________________________________________________________________________
+Double_t TTreeFormula::JitVariable(void *formula, Int_t code, Bool_t *missing)
+{
+   // Callback of the compiled operations (see JitCompile): read the variable
+   // code for the instance being evaluated by EvalJit. *missing is set to
+   // kTRUE if the instance is out of range and left unchanged otherwise.
+
+   TTreeFormula *form = (TTreeFormula*)formula;
+   Bool_t out = kFALSE;
+   Double_t value = form->EvalJitVariable(code, form->fJitInstance, form->fJitWillLoad, out);
+   if (out) *missing = kTRUE;
+   return value;
+}
+
+//______________________________________________________________________________
+Bool_t TTreeFormula::EvalJit(Int_t instance, Double_t &result)
+{
+   // Evaluate the compiled operations (see JitCompile) for the given instance.
+   // The variables are read by the compiled function only when their value
+   // is used, as by the interpreter.
+   // Returns kFALSE, and stops using the compiled operations, if the way
+   // a variable is read changed to one which is not supported by JitCompile
+   // (see SwitchToFormLeafInfo).
+
+   const Int_t nvars = fJitCodes.size();
+   for (Int_t j = 0; j < nvars; ++j) {
+      switch (fLookupType[fJitCodes[j]]) {
+         case kDirect: case kMethod: case kDataMember: case kTreeMember:
+         case kIndexOfEntry: case kIndexOfLocalEntry: case kEntries:
+         case kLength: case kIteration:
+            continue;
+         default:
+            fJitFunc = 0;
+            fJitCount = -1;
+            return kFALSE;
+      }
+   }
+
+   const Bool_t willLoad = (instance==0 || fNeedLoading); fNeedLoading = kFALSE;
+   // A branch is loaded only by the first of its variables (see fBranches),
+   // which may be skipped by && or ||: let the others load it if needed.
+   if (willLoad) fDidBooleanOptimization = fJitShortCircuit;
+
+   fJitInstance = instance;
+   fJitWillLoad = willLoad;
+   result = fJitFunc(this, &TTreeFormula::JitVariable);
+   return kTRUE;
+}
+
 template<typename T>
 T TTreeFormula::EvalInstance(Int_t instance, const char *stringStackArg[])
 {
@@ -3961,6 +4291,17 @@ T TTreeFormula::EvalInstance(Int_t instance, const char *stringStackArg[])
       }
    }
 
+   // Use the compiled operations when available (see JitCompile).
+   if (R__IsDoubleType<T>::kValue && fJitCount >= 0) {
+      if (!fJitFunc) {
+         const Int_t threshold = GetJitThreshold();
+         if (threshold == 0) fJitCount = -1;
+         else if (++fJitCount >= threshold && !JitCompile()) fJitCount = -1;
+      }
+      Double_t result;
+      if (fJitFunc && EvalJit(instance, result)) return (T)result;
+   }
+
    T tab[kMAXFOUND];
    const Int_t kMAXSTRINGFOUND = 10;
    const char *stringStackLocal[kMAXSTRINGFOUND];
@@ -67,6 +67,21 @@
 //   ReadRT    = Zipped MBytes per RT second
 //   ReadCP    = Zipped MBytes per CP second
 //
+// With the "unzip" option, Print also shows the busy time of each worker
+// of the TTreeCacheUnzip pool during the monitoring, when the parallel
+// unzipping is used. The baskets unzipped by the workers are counted in
+// UnzipTime when they are read.
+//
+// The reads and unzipping of the baskets are also counted per branch
+// (see BasketReadEvent and BasketUnzipEvent): number of baskets read and
+// unzipped, compressed and uncompressed bytes, unzip time, baskets found
+// in the TTreeCache or not (cache misses), bytes read without the cache and
+// baskets read more than once. With the "branches" option, Print shows these
+// counters and with the "advice" option it suggests the branches to add to
+// the TTreeCache and the cache size needed to hold one cluster of all the
+// branches read (GetSuggestedCacheSize). The counters can be exported with
+//    ps->SaveAs("ioperf.json");   // or "ioperf.csv"
+//
 //   NOTE1 : The ReadTotal value indicates the effective number of zipped bytes
 //           returned to the application. The physical number of bytes read
 //           from the device (as measured for example with strace) is
@@ -85,6 +100,7 @@
 #include "Riostream.h"
 #include "TFile.h"
 #include "TTree.h"
+#include "TTreeCacheUnzip.h"
 #include "TAxis.h"
 #include "TBrowser.h"
 #include "TVirtualPad.h"
@@ -95,6 +111,10 @@
 #include "TTimeStamp.h"
 #include "TDatime.h"
 #include "TMath.h"
+#include "TObjString.h"
+#include "TBranch.h"
+
+#include <fstream>
 
 ClassImp(TTreePerfStats)
 
@@ -125,6 +145,9 @@ TTreePerfStats::TTreePerfStats() : TVirtualPerfStats()
    fCompress      = 0;
    fRealTimeAxis  = 0;
    fHostInfoText  = 0;
+   fSuggestedCacheSize = 0;
+   fBranchIndexTree = -1;
+   fBranchNames.SetOwner(kTRUE);
 }
 
 //______________________________________________________________________________
@@ -159,6 +182,9 @@ TTreePerfStats::TTreePerfStats(const char *name, TTree *T) : TVirtualPerfStats()
    fUnzipTime     = 0;
    fRealTimeAxis  = 0;
    fCompress      = (T->GetTotBytes()+0.00001)/T->GetZipBytes();
+   fSuggestedCacheSize = 0;
+   fBranchIndexTree = -1;
+   fBranchNames.SetOwner(kTRUE);
 
    Bool_t isUNIX = strcmp(gSystem->GetName(), "Unix") == 0;
    if (isUNIX)
@@ -171,6 +197,15 @@ TTreePerfStats::TTreePerfStats(const char *name, TTree *T) : TVirtualPerfStats()
    fHostInfo += TString::Format(" %s",dt.AsString());
    fHostInfoText   = 0;
 
+   // remember the state of the unzip pool to only account for this run
+   Double_t busy = 0;
+   Long64_t ntasks = 0, nstolen = 0;
+   Int_t nworkers = TTreeCacheUnzip::GetUnzipWorkerStats(-1, busy, ntasks, nstolen);
+   fUnzipWorkerStart.Set(nworkers);
+   for (Int_t i=0;i<nworkers;i++) {
+      TTreeCacheUnzip::GetUnzipWorkerStats(i, fUnzipWorkerStart[i], ntasks, nstolen);
+   }
+
    gPerfStats = this;
 }
 
@@ -310,6 +345,83 @@ void TTreePerfStats::UnzipEvent(TObject * tree, Long64_t /* pos */, Double_t sta
    }
 }
 
+//______________________________________________________________________________
+Int_t TTreePerfStats::GetBranchIndex(TObject *branch)
+{
+   // Return the index of branch in the per branch counters, adding it if
+   // needed, or -1 if branch is not a branch of the monitored tree.
+
+   // The branch objects are deleted when a TChain moves to its next tree and
+   // their addresses may be reused by the branches of another tree.
+   Int_t treenumber = fTree ? fTree->GetTreeNumber() : -1;
+   if (treenumber != fBranchIndexTree) {
+      fBranchIndex.clear();
+      fBranchIndexTree = treenumber;
+   }
+   std::map<TObject*,Int_t>::const_iterator it = fBranchIndex.find(branch);
+   if (it != fBranchIndex.end()) return it->second;
+
+   TBranch *br = dynamic_cast<TBranch*>(branch);
+   if (!br || !fTree || (br->GetTree() != fTree && br->GetTree() != fTree->GetTree())) return -1;
+   // The branches of the successive trees of a TChain share their counters.
+   TString name = br->GetName();
+   TObject *obj = fBranchNames.FindObject(name);
+   Int_t index = obj ? fBranchNames.IndexOf(obj) : -1;
+   if (index < 0) {
+      index = fBranchNames.GetEntriesFast();
+      fBranchNames.Add(new TObjString(name));
+      Int_t n = index + 1;
+      fBranchBytesRead.Set(n);
+      fBranchBytesNoCache.Set(n);
+      fBranchUnzipBytes.Set(n);
+      fBranchBaskets.Set(n);
+      fBranchUnzipped.Set(n);
+      fBranchCacheHits.Set(n);
+      fBranchCacheMisses.Set(n);
+      fBranchRereads.Set(n);
+      fBranchUnzipTime.Set(n);
+   }
+   fBranchIndex[branch] = index;
+   return index;
+}
+
+//______________________________________________________________________________
+void TTreePerfStats::BasketReadEvent(TObject *branch, Long64_t pos, Int_t len, EBasketRead source)
+{
+   // Record the read of the basket at pos, of len compressed bytes,
+   // by branch from the cache, from the file or from the memory mapped
+   // file (see EBasketRead). The baskets not found in the cache are counted
+   // in the bytes read without the cache.
+
+   Int_t i = GetBranchIndex(branch);
+   if (i < 0) return;
+   fBranchBaskets[i]++;
+   fBranchBytesRead[i] += len;
+   if (source == kBasketFromCache) {
+      fBranchCacheHits[i]++;
+   } else {
+      if (source == kBasketCacheMiss) fBranchCacheMisses[i]++;
+      fBranchBytesNoCache[i] += len;
+   }
+   if (!fBasketsRead.insert(std::make_pair(fTree->GetTreeNumber(), pos)).second) {
+      fBranchRereads[i]++;
+   }
+}
+
+//______________________________________________________________________________
+void TTreePerfStats::BasketUnzipEvent(TObject *branch, Long64_t /* pos */, Double_t start, Int_t /* complen */, Int_t objlen)
+{
+   // Record the unzipping by branch of a basket of objlen bytes started at
+   // the TimeStamp start.
+
+   Int_t i = GetBranchIndex(branch);
+   if (i < 0) return;
+   Double_t tnow = TTimeStamp();
+   fBranchUnzipTime[i] += tnow - start;
+   fBranchUnzipped[i]++;
+   fBranchUnzipBytes[i] += objlen;
+}
+
 //______________________________________________________________________________
 void TTreePerfStats::Finish()
 {
@@ -325,6 +437,31 @@ void TTreePerfStats::Finish()
    fBytesReadExtra= fFile->GetBytesReadExtra();
    fRealTime      = fWatch->RealTime();
    fCpuTime       = fWatch->CpuTime();
+   Double_t busy = 0;
+   Long64_t ntasks = 0, nstolen = 0;
+   Int_t nworkers = TTreeCacheUnzip::GetUnzipWorkerStats(-1, busy, ntasks, nstolen);
+   fUnzipWorkerTime.Set(nworkers);
+   for (Int_t i=0;i<nworkers;i++) {
+      TTreeCacheUnzip::GetUnzipWorkerStats(i, busy, ntasks, nstolen);
+      // workers (re)started after the creation of this object start from 0
+      Double_t start = i < fUnzipWorkerStart.GetSize() ? fUnzipWorkerStart[i] : 0;
+      fUnzipWorkerTime[i] = busy >= start ? busy - start : busy;
+   }
+
+   // cache size holding one cluster of all the branches read
+   TTree *tree = fTree->GetTree();
+   if (tree && tree->GetEntries() > 0) {
+      TTree::TClusterIterator clusters = tree->GetClusterIterator(0);
+      clusters.Next();
+      Long64_t nclus = TMath::Min(clusters.Next(), tree->GetEntries());
+      Double_t bytes = 0;
+      for (Int_t i=0;i<fBranchNames.GetEntriesFast();i++) {
+         TBranch *br = tree->GetBranch(GetBranchName(i));
+         if (br) bytes += br->GetZipBytes("*");
+      }
+      fSuggestedCacheSize = (Long64_t)(bytes*nclus/tree->GetEntries());
+   }
+
    Int_t npoints  = fGraphIO->GetN();
    if (!npoints) return;
    Double_t iomax = TMath::MaxElement(npoints,fGraphIO->GetY());
@@ -428,6 +565,8 @@ void TTreePerfStats::Print(Option_t * option) const
    TString opts(option);
    opts.ToLower();
    Bool_t unzip = opts.Contains("unzip");
+   Bool_t branches = opts.Contains("branches");
+   Bool_t advice = opts.Contains("advice");
    TTreePerfStats *ps = (TTreePerfStats*)this;
    ps->Finish();
 
@@ -455,17 +594,138 @@ void TTreePerfStats::Print(Option_t * option) const
    if (unzip) {
       printf("ReadStrCP = %7.3f MBytes/s\n",1e-6*fCompress*fBytesRead/(fCpuTime-fUnzipTime));
       printf("ReadZipCP = %7.3f MBytes/s\n",1e-6*fCompress*fBytesRead/fUnzipTime);
+      for (Int_t i=0;i<fUnzipWorkerTime.GetSize();i++) {
+         printf("UnzipWk%-2d = %7.3f seconds, %5.1f per cent busy\n",i,fUnzipWorkerTime[i],
+                fRealTime > 0 ? 100.*fUnzipWorkerTime[i]/fRealTime : 0.);
+      }
+   }
+   Int_t nbranches = fBranchNames.GetEntriesFast();
+   if (branches && nbranches) {
+      printf("%-30s %10s %8s %8s %8s %8s %12s %10s\n","Branch","ReadKB","Baskets","Hits",
+             "Misses","Rereads","NoCacheKB","UnzipMs");
+      for (Int_t i=0;i<nbranches;i++) {
+         printf("%-30s %10.1f %8d %8d %8d %8d %12.1f %10.3f\n",GetBranchName(i),
+                0.001*fBranchBytesRead[i],fBranchBaskets[i],fBranchCacheHits[i],fBranchCacheMisses[i],
+                fBranchRereads[i],0.001*fBranchBytesNoCache[i],1e3*fBranchUnzipTime[i]);
+      }
+   }
+   if (advice && nbranches) {
+      // fNleaves counts the leaves of all the branches, count those of the branches read
+      Int_t nleaves = 0;
+      TTree *tree = fTree ? fTree->GetTree() : 0;
+      for (Int_t i=0;i<nbranches;i++) {
+         TBranch *br = tree ? tree->GetBranch(GetBranchName(i)) : 0;
+         nleaves += br ? br->GetListOfLeaves()->GetEntriesFast() : 1;
+      }
+      printf("Leaves read: %d of %d\n",nleaves,fNleaves);
+      Int_t nmissed = 0;
+      for (Int_t i=0;i<nbranches;i++) {
+         if (fBranchCacheMisses[i] || (fBranchBaskets[i] && !fBranchCacheHits[i])) {
+            if (!nmissed) printf("Add to the TTreeCache the branches read outside of it:\n");
+            printf("   tree->AddBranchToCache(\"%s\");\n",GetBranchName(i));
+            nmissed++;
+         }
+      }
+      if (fSuggestedCacheSize > 0) {
+         printf("Cache size holding one cluster of the branches read: %lld bytes",fSuggestedCacheSize);
+         if (fTreeCacheSize < fSuggestedCacheSize) printf(" (current %d)",fTreeCacheSize);
+         printf("\n   tree->SetCacheSize(%lld);\n",fSuggestedCacheSize);
+      }
+      Int_t nreread = 0;
+      for (Int_t i=0;i<nbranches;i++) nreread += fBranchRereads[i];
+      if (nreread) {
+         printf("%d baskets were read more than once: increase the cache size or "
+                "read the entries in order\n",nreread);
+      }
    }
 }
 
 //______________________________________________________________________________
 void TTreePerfStats::SaveAs(const char *filename, Option_t * /*option*/) const
 {
-   // Save this object to filename
+   // Save this object to filename.
+   // If filename ends with ".json" or ".csv", the global and per branch
+   // counters are written in this format instead (see SaveBranchStats).
 
    TTreePerfStats *ps = (TTreePerfStats*)this;
    ps->Finish();
-   ps->TObject::SaveAs(filename);
+   TString fname(filename);
+   if (fname.EndsWith(".json")) {
+      SaveBranchStats(filename, kTRUE);
+   } else if (fname.EndsWith(".csv")) {
+      SaveBranchStats(filename, kFALSE);
+   } else {
+      ps->TObject::SaveAs(filename);
+   }
+}
+
+//______________________________________________________________________________
+static TString R__JsonString(const char *str)
+{
+   // Return str as a quoted JSON string.
+
+   TString out("\"");
+   for (const char *c = str; *c; ++c) {
+      if (*c == '"' || *c == '\\') out += '\\';
+      if ((unsigned char)*c < 0x20) out += TString::Format("\\u%04x", (unsigned char)*c);
+      else out += *c;
+   }
+   out += '"';
+   return out;
+}
+
+//______________________________________________________________________________
+void TTreePerfStats::SaveBranchStats(const char *filename, Bool_t json) const
+{
+   // Write the counters to filename, in JSON (one object with the global
+   // counters and an array "branches" with the counters of each branch)
+   // or in CSV (one line per branch). The times are in nanoseconds.
+
+   std::ofstream out(filename);
+   if (!out.good()) {
+      Error("SaveAs", "cannot open %s", filename);
+      return;
+   }
+   Int_t nbranches = fBranchNames.GetEntriesFast();
+   if (json) {
+      out << "{" << std::endl;
+      out << "  \"name\": " << R__JsonString(fName) << "," << std::endl;
+      out << "  \"host\": " << R__JsonString(fHostInfo) << "," << std::endl;
+      out << "  \"tree_cache_size\": " << fTreeCacheSize << "," << std::endl;
+      out << "  \"suggested_cache_size\": " << fSuggestedCacheSize << "," << std::endl;
+      out << "  \"read_calls\": " << fReadCalls << "," << std::endl;
+      out << "  \"bytes_read\": " << fBytesRead << "," << std::endl;
+      out << "  \"bytes_read_extra\": " << fBytesReadExtra << "," << std::endl;
+      out << "  \"real_ns\": " << (Long64_t)(1e9*fRealTime) << "," << std::endl;
+      out << "  \"cpu_ns\": " << (Long64_t)(1e9*fCpuTime) << "," << std::endl;
+      out << "  \"disk_ns\": " << (Long64_t)(1e9*fDiskTime) << "," << std::endl;
+      out << "  \"unzip_ns\": " << (Long64_t)(1e9*fUnzipTime) << "," << std::endl;
+      out << "  \"branches\": [";
+      for (Int_t i=0;i<nbranches;i++) {
+         out << (i ? "," : "") << std::endl;
+         out << "    {\"name\": " << R__JsonString(GetBranchName(i))
+             << ", \"bytes_read\": " << fBranchBytesRead[i]
+             << ", \"baskets_read\": " << fBranchBaskets[i]
+             << ", \"baskets_unzipped\": " << fBranchUnzipped[i]
+             << ", \"bytes_unzipped\": " << fBranchUnzipBytes[i]
+             << ", \"unzip_ns\": " << (Long64_t)(1e9*fBranchUnzipTime[i])
+             << ", \"cache_hits\": " << fBranchCacheHits[i]
+             << ", \"cache_misses\": " << fBranchCacheMisses[i]
+             << ", \"bytes_read_no_cache\": " << fBranchBytesNoCache[i]
+             << ", \"baskets_reread\": " << fBranchRereads[i] << "}";
+      }
+      out << std::endl << "  ]" << std::endl << "}" << std::endl;
+   } else {
+      out << "branch,bytes_read,baskets_read,baskets_unzipped,bytes_unzipped,unzip_ns,"
+             "cache_hits,cache_misses,bytes_read_no_cache,baskets_reread" << std::endl;
+      for (Int_t i=0;i<nbranches;i++) {
+         out << GetBranchName(i) << "," << fBranchBytesRead[i] << "," << fBranchBaskets[i]
+             << "," << fBranchUnzipped[i] << "," << fBranchUnzipBytes[i]
+             << "," << (Long64_t)(1e9*fBranchUnzipTime[i]) << "," << fBranchCacheHits[i]
+             << "," << fBranchCacheMisses[i] << "," << fBranchBytesNoCache[i]
+             << "," << fBranchRereads[i] << std::endl;
+      }
+   }
 }
 
 //______________________________________________________________________________
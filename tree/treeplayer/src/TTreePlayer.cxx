@@ -71,12 +71,22 @@
 #include "TObjString.h"
 #include "TTreeProxyGenerator.h"
 #include "TTreeIndex.h"
+#include "TTreeCompactIndex.h"
 #include "TChainIndex.h"
 #include "TRefProxy.h"
 #include "TRefArrayProxy.h"
 #include "TVirtualMonitoring.h"
 #include "TTreeCache.h"
 #include "TStyle.h"
+#include "TThread.h"
+#include "TMutex.h"
+#include "TVirtualMutex.h"
+
+#include <algorithm>
+#include <limits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
 
 #include "HFitInterface.h"
 #include "Foption.h"
@@ -134,7 +144,10 @@ TTreePlayer::~TTreePlayer()
 //______________________________________________________________________________
 TVirtualIndex *TTreePlayer::BuildIndex(const TTree *T, const char *majorname, const char *minorname)
 {
-   // Build the index for the tree (see TTree::BuildIndex)
+   // Build the index for the tree (see TTree::BuildIndex).
+   // A TTreeCompactIndex is built instead of a TTreeIndex when the
+   // environment variable ROOT_TTREEINDEX_COMPACT or the resource variable
+   // TTreeIndex.Compact is set to 1 (for a TChain, the indices of its trees).
 
    TVirtualIndex *index;
    if (dynamic_cast<const TChain*>(T)) {
@@ -146,6 +159,15 @@ TVirtualIndex *TTreePlayer::BuildIndex(const TTree *T, const char *majorname, co
       else
          return index;
    }
+
+   const char *stcp;
+   Int_t compact = 0;
+   if (!(stcp = gSystem->Getenv("ROOT_TTREEINDEX_COMPACT")) || !*stcp) {
+      compact = gEnv->GetValue("TTreeIndex.Compact", 0);
+   } else {
+      compact = TString(stcp).Atoi();
+   }
+   if (compact) return new TTreeCompactIndex(T,majorname,minorname);
    return new TTreeIndex(T,majorname,minorname);
 }
 
@@ -2104,6 +2126,191 @@ Long64_t TTreePlayer::Process(const char *filename,Option_t *option, Long64_t ne
    return nsel;
 }
 
+namespace {
+
+   //______________________________________________________________________________
+   //
+   // Helpers of TTreePlayer::Process: the selection of TTree::Draw is
+   // analysed to find the cuts "name op constant" (op is <, <=, >, >= or ==)
+   // of its top level conjunction. The baskets of the branch 'name' whose
+   // statistics (see TBranch::SetBasketStatistics) show that no value can
+   // pass the cut cannot pass the selection and their entries are skipped.
+
+   struct TRangeCut_t {
+      TString  fName;    // name of the branch or of the leaf
+      Int_t    fOp;      // kLess, kLessEqual, kGreater, kGreaterEqual or kEqual
+      Double_t fValue;   // constant of the cut
+   };
+
+   enum { kLess, kLessEqual, kGreater, kGreaterEqual, kEqual };
+
+   typedef std::vector<std::pair<Long64_t,Long64_t> > EntryRanges_t;
+
+   //______________________________________________________________________________
+   TString StripParentheses(const TString &expr)
+   {
+      // Remove the parentheses enclosing the whole expression.
+
+      TString result = expr;
+      while (result.Length() > 1 && result[0] == '(' && result[result.Length()-1] == ')') {
+         Int_t depth = 0;
+         Bool_t enclosing = kTRUE;
+         for (Int_t i = 0; i < result.Length()-1; ++i) {
+            if (result[i] == '(') ++depth;
+            else if (result[i] == ')') --depth;
+            if (depth == 0) { enclosing = kFALSE; break; }
+         }
+         if (!enclosing) break;
+         result = result(1, result.Length()-2);
+      }
+      return result;
+   }
+
+   //______________________________________________________________________________
+   Bool_t ParseRangeCut(const TString &expr, TRangeCut_t &cut)
+   {
+      // Parse expr as "name op constant" or "constant op name".
+
+      Int_t pos = -1, len = 0;
+      for (Int_t i = 0; i < expr.Length(); ++i) {
+         char c = expr[i];
+         if (c != '<' && c != '>' && c != '=') continue;
+         if (pos >= 0) return kFALSE;   // more than one operator
+         pos = i;
+         len = (i+1 < expr.Length() && expr[i+1] == '=') ? 2 : 1;
+         if (c == '=' && len == 1) return kFALSE;   // assignment
+         if (i+len < expr.Length() && (expr[i+len] == '<' || expr[i+len] == '>')) return kFALSE;
+         if (i > 0 && expr[i-1] == '-' && c == '>') return kFALSE;   // ->
+         i += len - 1;
+      }
+      if (pos <= 0 || pos+len >= expr.Length()) return kFALSE;
+      TString op = expr(pos, len);
+      TString lhs = StripParentheses(expr(0, pos));
+      TString rhs = StripParentheses(expr(pos+len, expr.Length()-pos-len));
+
+      Bool_t reversed = kFALSE;
+      char *end = 0;
+      Double_t value = strtod(rhs.Data(), &end);
+      TString name = lhs;
+      if (rhs.Length() == 0 || *end) {
+         value = strtod(lhs.Data(), &end);
+         if (lhs.Length() == 0 || *end) return kFALSE;
+         name = rhs;
+         reversed = kTRUE;
+      }
+      if (name.Length() == 0 || (!isalpha(name[0]) && name[0] != '_')) return kFALSE;
+      for (Int_t i = 0; i < name.Length(); ++i) {
+         if (!isalnum(name[i]) && name[i] != '_' && name[i] != '.') return kFALSE;
+      }
+      if      (op == "==") cut.fOp = kEqual;
+      else if (op == "<")  cut.fOp = reversed ? kGreater      : kLess;
+      else if (op == "<=") cut.fOp = reversed ? kGreaterEqual : kLessEqual;
+      else if (op == ">")  cut.fOp = reversed ? kLess         : kGreater;
+      else if (op == ">=") cut.fOp = reversed ? kLessEqual    : kGreaterEqual;
+      else return kFALSE;
+      cut.fName = name;
+      cut.fValue = value;
+      return kTRUE;
+   }
+
+   //______________________________________________________________________________
+   Bool_t ParseRangeCuts(const TString &selection, std::vector<TRangeCut_t> &cuts)
+   {
+      // Fill cuts with the range cuts of the top level conjunction of the
+      // selection. The other terms of the conjunction are ignored: an entry
+      // which fails one of the cuts fails the selection. Returns kFALSE if
+      // the selection is not a conjunction.
+
+      TString expr = selection;
+      expr.ReplaceAll(" ", "");
+      expr = StripParentheses(expr);
+      std::vector<TRangeCut_t> found;
+      Int_t depth = 0;
+      Int_t start = 0;
+      for (Int_t i = 0; i <= expr.Length(); ++i) {
+         if (i < expr.Length()) {
+            char c = expr[i];
+            if (c == '(' || c == '[') { ++depth; continue; }
+            if (c == ')' || c == ']') { --depth; continue; }
+            if (depth) continue;
+            if (c == '|' && i+1 < expr.Length() && expr[i+1] == '|') return kFALSE;
+            if (c == '?') return kFALSE;
+            if (!(c == '&' && i+1 < expr.Length() && expr[i+1] == '&')) continue;
+         }
+         TString term = StripParentheses(expr(start, i-start));
+         TRangeCut_t cut;
+         if (term.Length() < expr.Length() && term.Contains("&&")) {
+            // a parenthesized conjunction
+            ParseRangeCuts(term, found);
+         } else if (ParseRangeCut(term, cut)) {
+            found.push_back(cut);
+         }
+         start = i+2;
+         ++i;
+      }
+      cuts.insert(cuts.end(), found.begin(), found.end());
+      return !found.empty();
+   }
+
+   //______________________________________________________________________________
+   void GetSkipRanges(TTree *tree, const std::vector<TRangeCut_t> &cuts, EntryRanges_t &ranges)
+   {
+      // Fill ranges with the sorted and disjoint ranges [first, last) of the
+      // entries of tree which fail one of the cuts according to the basket
+      // statistics of the branches.
+
+      ranges.clear();
+      if (!tree) return;
+      for (UInt_t c = 0; c < cuts.size(); ++c) {
+         const TRangeCut_t &cut = cuts[c];
+         if (tree->GetAlias(cut.fName)) continue;
+         TBranch *branch = tree->GetBranch(cut.fName);
+         if (!branch) {
+            TLeaf *leaf = tree->GetLeaf(cut.fName);
+            if (leaf) branch = leaf->GetBranch();
+         }
+         // Friend trees have their own entry numbers.
+         if (!branch || branch->GetTree() != tree || !branch->GetBasketMin()) continue;
+         const Double_t *bmin = branch->GetBasketMin();
+         const Double_t *bmax = branch->GetBasketMax();
+         const Long64_t *bentry = branch->GetBasketEntry();
+         for (Int_t i = 0; i < branch->GetWriteBasket(); ++i) {
+            Bool_t skip = kFALSE;
+            switch (cut.fOp) {
+               case kLess:         skip = bmin[i] >= cut.fValue; break;
+               case kLessEqual:    skip = bmin[i] >  cut.fValue; break;
+               case kGreater:      skip = bmax[i] <= cut.fValue; break;
+               case kGreaterEqual: skip = bmax[i] <  cut.fValue; break;
+               case kEqual:        skip = bmin[i] > cut.fValue || bmax[i] < cut.fValue; break;
+            }
+            if (skip && bentry[i+1] > bentry[i]) ranges.push_back(std::make_pair(bentry[i], bentry[i+1]));
+         }
+      }
+      std::sort(ranges.begin(), ranges.end());
+      UInt_t n = 0;
+      for (UInt_t i = 0; i < ranges.size(); ++i) {
+         if (n && ranges[i].first <= ranges[n-1].second) {
+            ranges[n-1].second = TMath::Max(ranges[n-1].second, ranges[i].second);
+         } else {
+            ranges[n++] = ranges[i];
+         }
+      }
+      ranges.resize(n);
+   }
+
+   //______________________________________________________________________________
+   Long64_t GetSkipEnd(const EntryRanges_t &ranges, Long64_t entry)
+   {
+      // Return the end of the range of ranges containing entry, or entry.
+
+      EntryRanges_t::const_iterator it =
+         std::upper_bound(ranges.begin(), ranges.end(), std::make_pair(entry, std::numeric_limits<Long64_t>::max()));
+      if (it == ranges.begin()) return entry;
+      --it;
+      return entry < it->second ? it->second : entry;
+   }
+}
+
 //______________________________________________________________________________
 Long64_t TTreePlayer::Process(TSelector *selector,Option_t *option, Long64_t nentries, Long64_t firstentry)
 {
@@ -2127,9 +2334,27 @@ Long64_t TTreePlayer::Process(TSelector *selector,Option_t *option, Long64_t nen
    //  If the Tree (Chain) has an associated EventList, the loop is on the nentries
    //  of the EventList, starting at firstentry, otherwise the loop is on the
    //  specified Tree entries.
+   //
+   //  If TTree::SetImplicitMT was called, the entries are processed by
+   //  several threads (see ProcessMT). This includes the selectors loaded by
+   //  Process(filename) when their class has a dictionary or is known to the
+   //  interpreter (e.g. "sel.C+" or "sel.C"). The selectors of TTree::Draw
+   //  and TTree::GetEntries(selection), whose results are not kept in their
+   //  output list, are always run sequentially.
+   //
+   //  For TTree::Draw, the entries of the baskets which cannot pass the cuts
+   //  "name op constant" of the selection (e.g. "pt>500 && abs(eta)<2") are
+   //  skipped without being read, if the branch of the cut has the basket
+   //  statistics (see TBranch::SetBasketStatistics).
 
    nentries = GetEntriesToProcess(firstentry, nentries);
 
+   if (TTree::GetImplicitMT() > 1 && selector != fSelector &&
+       !selector->InheritsFrom(TSelectorEntries::Class())) {
+      Long64_t result = -1;
+      if (ProcessMT(selector, option, nentries, firstentry, result)) return result;
+   }
+
    TDirectory::TContext ctxt(0);
 
    fTree->SetNotify(selector);
@@ -2186,6 +2411,15 @@ Long64_t TTreePlayer::Process(TSelector *selector,Option_t *option, Long64_t nen
       fSelectorUpdate = selector;
       UpdateFormulaLeaves();
 
+      // The cuts of the selection of TTree::Draw which may allow to skip
+      // baskets. The entry numbers must be those of the trees.
+      std::vector<TRangeCut_t> cuts;
+      EntryRanges_t skipRanges;
+      Int_t skipTree = -1;
+      Bool_t skipping = selector == fSelector && fSelector->GetSelect() &&
+                        !fTree->GetEntryList() && !fTree->GetEventList() &&
+                        ParseRangeCuts(fSelector->GetSelect()->GetTitle(), cuts);
+
       for (entry=firstentry;entry<firstentry+nentries;entry++) {
          entryNumber = fTree->GetEntryNumber(entry);
          if (entryNumber < 0) break;
@@ -2193,6 +2427,17 @@ Long64_t TTreePlayer::Process(TSelector *selector,Option_t *option, Long64_t nen
          if (gROOT->IsInterrupted()) break;
          localEntry = fTree->LoadTree(entryNumber);
          if (localEntry < 0) break;
+         if (skipping) {
+            if (fTree->GetTreeNumber() != skipTree) {
+               skipTree = fTree->GetTreeNumber();
+               GetSkipRanges(fTree->GetTree(), cuts, skipRanges);
+            }
+            Long64_t skipEnd = GetSkipEnd(skipRanges, localEntry);
+            if (skipEnd > localEntry) {
+               entry += skipEnd - localEntry - 1;
+               continue;
+            }
+         }
          if(useCutFill) {
             if (selector->ProcessCut(localEntry))
                selector->ProcessFill(localEntry); //<==call user analysis function
@@ -2232,6 +2477,296 @@ Long64_t TTreePlayer::Process(TSelector *selector,Option_t *option, Long64_t nen
    return selector->GetStatus();
 }
 
+namespace {
+
+   //______________________________________________________________________________
+   //
+   // Helpers of TTreePlayer::ProcessMT: the entry ranges to process are kept
+   // in a queue shared by the workers, each worker owns a copy of the tree
+   // and an instance of the selector.
+
+   struct TProcessMTShared_t {
+      TMutex                fMutex;
+      std::vector<Long64_t> fBounds;  // range i is [fBounds[i], fBounds[i+1])
+      UInt_t                fNext;    // next range to process
+      Bool_t                fAbort;   // a worker requested TSelector::kAbortProcess
+
+      TProcessMTShared_t() : fNext(0), fAbort(kFALSE) {}
+
+      Bool_t NextRange(Long64_t &first, Long64_t &last) {
+         R__LOCKGUARD(&fMutex);
+         if (fAbort || fNext+1 >= fBounds.size()) return kFALSE;
+         first = fBounds[fNext];
+         last  = fBounds[fNext+1];
+         fNext++;
+         return kTRUE;
+      }
+   };
+
+   struct TProcessMTWorker_t {
+      TProcessMTShared_t *fShared;
+      TTree              *fTree;      // copy of the tree owned by this worker
+      TFile              *fFile;      // file opened for fTree (0 for a chain)
+      TSelector          *fSelector;  // instance of the selector owned by this worker
+      TThread            *fThread;
+   };
+
+   //______________________________________________________________________________
+   void *ProcessMTLoop(void *arg)
+   {
+      // Function executed by each worker thread: process the ranges of the
+      // shared queue with the worker's selector until the queue is empty.
+
+      TProcessMTWorker_t *w = (TProcessMTWorker_t *)arg;
+      TTree *tree = w->fTree;
+      TSelector *selector = w->fSelector;
+
+      Long64_t first, last;
+      while (w->fShared->NextRange(first, last)) {
+         if (tree->GetCacheSize() > 0) tree->SetCacheEntryRange(first, last);
+         for (Long64_t entry = first; entry < last; entry++) {
+            if (gROOT->IsInterrupted()) break;
+            Long64_t localEntry = tree->LoadTree(entry);
+            if (localEntry < 0) break;
+            selector->Process(localEntry);        //<==call user analysis function
+            if (selector->GetAbort() == TSelector::kAbortProcess) {
+               R__LOCKGUARD(&w->fShared->fMutex);
+               w->fShared->fAbort = kTRUE;
+               break;
+            }
+            if (selector->GetAbort() == TSelector::kAbortFile) {
+               // Skip to the next file.
+               entry += tree->GetTree()->GetEntries() - localEntry;
+               // Reset the abort status.
+               selector->ResetAbort();
+            }
+         }
+      }
+      return 0;
+   }
+}
+
+//______________________________________________________________________________
+TTree *TTreePlayer::OpenTreeCopy(TTree *tree, TFile *&file)
+{
+   // Return a new handle on tree, reading from its own TFile, e.g. to read
+   // the tree in another thread. For a TChain, a new chain with the same
+   // files is returned and file is 0. Deleting file deletes the copy.
+   // Returns 0 if the copy cannot be opened.
+
+   file = 0;
+   if (tree->InheritsFrom(TChain::Class())) {
+      TChain *chain = (TChain*)tree;
+      TChain *copy = new TChain(chain->GetName(), chain->GetTitle());
+      copy->Add(chain);
+      return copy;
+   }
+   TDirectory *dir = tree->GetDirectory();
+   TFile *cur = tree->GetCurrentFile();
+   if (!dir || !cur) return 0;
+
+   file = TFile::Open(cur->GetName());
+   if (!file || file->IsZombie()) {
+      delete file;
+      file = 0;
+      return 0;
+   }
+   // The path of the tree directory is of the form file.root:/dir1/dir2
+   TString path(dir->GetPath());
+   Ssiz_t idx = path.Index(":/");
+   path = (idx >= 0) ? TString(path(idx+2, path.Length())) : TString("");
+   if (path.Length()) path += "/";
+   path += tree->GetName();
+   TTree *copy = 0;
+   file->GetObject(path, copy);
+   if (!copy) {
+      delete file;
+      file = 0;
+   }
+   return copy;
+}
+
+//______________________________________________________________________________
+Bool_t TTreePlayer::ProcessMT(TSelector *selector, Option_t *option, Long64_t nentries, Long64_t firstentry, Long64_t &result)
+{
+   // Process the entries [firstentry, firstentry+nentries) with
+   // TTree::GetImplicitMT() threads (see TTree::SetImplicitMT).
+   // The ranges of entries given to the threads are made of whole clusters
+   // for a TTree and of whole files for a TChain.
+   // Returns kFALSE, without calling any method of the selector, if the
+   // tree or the selector cannot be processed in parallel; in that case
+   // the caller processes them sequentially.
+   // Otherwise result is set to the return value of Process.
+   // The selectors of the workers are new instances of the class of the
+   // selector, which must be compiled with a dictionary (e.g. with ACLiC)
+   // and must have ClassDef: without it IsA() returns one of its base
+   // classes. An interpreted selector is processed sequentially, the
+   // interpreter cannot run its methods in several threads at once.
+
+   Int_t nthreads = TTree::GetImplicitMT();
+   if (nentries < 2 || selector->Version() == 0) return kFALSE;
+   TClass *cl = selector->IsA();
+   if (!cl || cl->GetState() < TClass::kHasTClassInit) {
+      Info("ProcessMT", "the selector %s is not compiled, it is processed sequentially",
+           cl ? cl->GetName() : selector->ClassName());
+      return kFALSE;
+   }
+   if (!cl->HasDefaultConstructor()) return kFALSE;
+   const type_info *clType = cl->GetTypeInfo();
+   if (!clType || *clType != typeid(*selector)) return kFALSE;
+   if (fTree->GetEntryList() || fTree->GetEventList() ||
+       (fTree->GetListOfFriends() && fTree->GetListOfFriends()->GetSize())) return kFALSE;
+   Bool_t isChain = fTree->InheritsFrom(TChain::Class());
+   if (!isChain && !fTree->GetCurrentFile()) return kFALSE;
+
+   // Split the range at the cluster (file for a chain) boundaries
+   Long64_t lastentry = firstentry + nentries;
+   std::vector<Long64_t> bounds;
+   bounds.push_back(firstentry);
+   if (isChain) {
+      TChain *chain = (TChain*)fTree;
+      chain->GetEntries(); // to compute the tree offsets
+      for (Int_t i = 1; i < chain->GetNtrees(); i++) {
+         Long64_t offset = chain->GetTreeOffset()[i];
+         if (offset > firstentry && offset < lastentry) bounds.push_back(offset);
+      }
+   } else {
+      Long64_t start;
+      TTree::TClusterIterator clusterIter = fTree->GetClusterIterator(firstentry);
+      while ((start = clusterIter()) < lastentry) {
+         if (start > firstentry) bounds.push_back(start);
+      }
+   }
+   bounds.push_back(lastentry);
+
+   TProcessMTShared_t shared;
+   // Merge the small clusters, aiming at a few ranges per thread to
+   // balance the load
+   Long64_t target = nentries / (8*nthreads);
+   shared.fBounds.push_back(firstentry);
+   for (UInt_t i = 1; i < bounds.size(); i++) {
+      if (bounds[i] - shared.fBounds.back() >= target || i == bounds.size()-1)
+         shared.fBounds.push_back(bounds[i]);
+   }
+   if (nthreads > (Int_t)shared.fBounds.size()-1) nthreads = shared.fBounds.size()-1;
+   if (nthreads < 2) return kFALSE;
+
+   TDirectory::TContext ctxt(0);
+
+   // Open the copies of the tree before calling any method of the selector
+   std::vector<TProcessMTWorker_t> workers(nthreads);
+   for (Int_t i = 0; i < nthreads; i++) {
+      TProcessMTWorker_t &w = workers[i];
+      w.fShared = &shared;
+      w.fSelector = 0;
+      w.fThread = 0;
+      w.fTree = OpenTreeCopy(fTree, w.fFile);
+      if (!w.fTree) {
+         Warning("ProcessMT", "cannot open a copy of the tree %s: processing sequentially", fTree->GetName());
+         for (Int_t j = 0; j < i; j++) {
+            if (workers[j].fFile) delete workers[j].fFile;
+            else delete workers[j].fTree;
+         }
+         return kFALSE;
+      }
+      if (fTree->GetCacheSize() > 0) w.fTree->SetCacheSize(fTree->GetCacheSize());
+   }
+
+   TThread::Initialize();
+   Bool_t addDirectory = TH1::AddDirectoryStatus();
+   TH1::AddDirectory(kFALSE);
+
+   fTree->SetNotify(selector);
+   selector->SetOption(option);
+   selector->Begin(fTree);       //<===call user initialization function
+
+   if (gMonitoringWriter)
+      gMonitoringWriter->SendProcessingStatus("STARTED",kTRUE);
+
+   for (Int_t i = 0; i < nthreads; i++) {
+      TProcessMTWorker_t &w = workers[i];
+      w.fSelector = (TSelector*)cl->New();
+      w.fSelector->SetInputList(selector->GetInputList());
+      w.fSelector->SetOption(selector->GetOption());
+      w.fTree->SetNotify(w.fSelector);
+      w.fSelector->SlaveBegin(w.fTree);  //<===call user initialization function
+      w.fSelector->Init(w.fTree);
+      w.fSelector->Notify();
+   }
+
+   if (selector->GetAbort() != TSelector::kAbortProcess) {
+      for (Int_t i = 0; i < nthreads; i++) {
+         TProcessMTWorker_t &w = workers[i];
+         if (w.fSelector->GetAbort() == TSelector::kAbortProcess) continue;
+         w.fThread = new TThread(Form("ProcessMT%d", i), ProcessMTLoop, (void*)&w);
+         w.fThread->Run();
+      }
+      for (Int_t i = 0; i < nthreads; i++) {
+         if (!workers[i].fThread) continue;
+         workers[i].fThread->Join();
+         delete workers[i].fThread;
+         workers[i].fThread = 0;
+      }
+   }
+
+   for (Int_t i = 0; i < nthreads; i++) {
+      workers[i].fSelector->SlaveTerminate();   //<==call user termination function
+   }
+
+   // Merge the outputs of the workers into the output of the selector
+   TList *output = selector->GetOutputList();
+   for (Int_t i = 0; i < nthreads; i++) {
+      TList *wout = workers[i].fSelector->GetOutputList();
+      TList objects;
+      objects.AddAll(wout);
+      TIter next(&objects);
+      TObject *obj;
+      while ((obj = next())) {
+         if (output->FindObject(obj->GetName())) continue; // already merged
+         TList others;
+         for (Int_t j = i+1; j < nthreads; j++) {
+            TObject *o = workers[j].fSelector->GetOutputList()->FindObject(obj->GetName());
+            if (o && o->IsA() == obj->IsA()) others.Add(o);
+         }
+         if (others.GetSize()) {
+            ROOT::MergeFunc_t merge = obj->IsA()->GetMerge();
+            if (merge) {
+               merge(obj, &others, 0);
+            } else if (obj->IsA()->GetMethodWithPrototype("Merge", "TCollection*")) {
+               Int_t error = 0;
+               obj->Execute("Merge", Form("(TCollection*)0x%lx", (ULong_t)&others), &error);
+               if (error)
+                  Error("ProcessMT", "calling Merge() on %s", obj->GetName());
+            } else {
+               Warning("ProcessMT", "cannot merge the objects %s of class %s: only the first one is kept",
+                       obj->GetName(), obj->IsA()->GetName());
+            }
+         }
+         wout->Remove(obj);
+         output->Add(obj);
+      }
+   }
+
+   for (Int_t i = 0; i < nthreads; i++) {
+      TProcessMTWorker_t &w = workers[i];
+      w.fTree->SetNotify(0);
+      delete w.fSelector;
+      if (w.fFile) delete w.fFile; // also deletes the tree
+      else delete w.fTree;
+   }
+   TH1::AddDirectory(addDirectory);
+
+   if (selector->GetAbort() != TSelector::kAbortProcess && shared.fAbort)
+      selector->Abort("aborted by a worker thread");
+   selector->Terminate();        //<==call user termination function
+   fTree->SetNotify(0); // Detach the selector from the tree.
+   if (gMonitoringWriter)
+      gMonitoringWriter->SendProcessingStatus("DONE");
+
+   result = selector->GetStatus();
+   return kTRUE;
+}
+
 //______________________________________________________________________________
 void TTreePlayer::RecursiveRemove(TObject *obj)
 {
@@ -286,6 +286,9 @@ TTreeReader::EEntryStatus TTreeReader::SetEntryBase(Long64_t entry, Bool_t local
       Int_t currentTreeNumInChain = fTree->GetTreeNumber();
       if (treeNumInChain != currentTreeNumInChain) {
             fDirector->SetTree(fTree->GetTree());
+            // The columns belong to the previous tree, which is deleted by
+            // the chain: its address can be reused by the new tree.
+            ResetColumns();
       }
    }
    else {
@@ -327,6 +330,19 @@ void TTreeReader::SetTree(TTree* tree)
    else {
       fDirector->SetTree(fTree);
       fDirector->SetReadEntry(-1);
+      ResetColumns();
+   }
+}
+
+//______________________________________________________________________________
+void TTreeReader::ResetColumns()
+{
+   // Forget the columns read by the value readers (see
+   // TTreeReaderValueBase::GetColumnAddress), when the tree changes.
+
+   for (std::deque<ROOT::TTreeReaderValueBase*>::const_iterator
+           i = fValues.begin(); i != fValues.end(); ++i) {
+      (*i)->ResetColumn();
    }
 }
 
@@ -230,6 +230,26 @@ namespace {
       virtual size_t GetSize(ROOT::TBranchProxy* /*proxy*/) { return size; }
    };
 
+   // Reader interface for fixed size arrays of a fundamental type, read by
+   // columns when possible (see TTreeReaderValueBase::GetColumnAddress)
+   class TArrayColumnReader : public TArrayFixedSizeReader {
+   private:
+      ROOT::TTreeReaderValueBase *valueReader;
+      Int_t elementSize;
+
+   public:
+      TArrayColumnReader(ROOT::TTreeReaderValueBase *valueReaderArg, Int_t sizeArg, Int_t elementSizeArg) :
+         TArrayFixedSizeReader(sizeArg), valueReader(valueReaderArg), elementSize(elementSizeArg) {}
+
+      virtual void* At(ROOT::TBranchProxy* proxy, size_t idx) {
+         if (Byte_t *column = (Byte_t*)valueReader->GetColumnAddress()) {
+            fReadStatus = ROOT::TTreeReaderValueBase::kReadSuccess;
+            return column + elementSize * idx;
+         }
+         return TArrayFixedSizeReader::At(proxy, idx);
+      }
+   };
+
    class TBasicTypeArrayReader : public ROOT::TVirtualCollectionReader {
    public:
       ~TBasicTypeArrayReader() {}
@@ -548,7 +568,7 @@ void ROOT::TTreeReaderArrayBase::CreateProxy()
       Int_t size = 0;
       TLeaf *sizeLeaf = topLeaf->GetLeafCounter(size);
       if (!sizeLeaf) {
-         fImpl = new TArrayFixedSizeReader(size);
+         fImpl = new TArrayColumnReader(this, size, ((TDataType*)fDict)->Size());
       }
       else {
          fImpl = new TArrayParameterSizeReader(fTreeReader, sizeLeaf->GetName());
@@ -12,6 +12,7 @@
 #include "TTreeReaderValue.h"
 
 #include "TTreeReader.h"
+#include "TBufferFile.h"
 #include "TBranchClones.h"
 #include "TBranchElement.h"
 #include "TBranchRef.h"
@@ -24,6 +25,8 @@
 #include "TStreamerInfo.h"
 #include "TStreamerElement.h"
 #include "TNtuple.h"
+#include "TEnv.h"
+#include "TSystem.h"
 #include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -32,8 +35,11 @@
 //                                                                            //
 // Extracts data from a TTree.                                                //
 //                                                                            //
-//                                                                            //
-//                                                                            //
+// The branches with a single leaf of a fundamental type and without a leaf   //
+// count are read by columns: the values of all the entries of a basket are  //
+// unpacked at once into a contiguous array (see TBranch::GetBulkEntries),    //
+// and the value of an entry is then a pointer into this array. This can be   //
+// disabled by setting TTreeReader.Columns to 0 in .rootrc.                   //
 //                                                                            //
 //                                                                            //
 //                                                                            //
@@ -55,7 +61,15 @@ ROOT::TTreeReaderValueBase::TTreeReaderValueBase(TTreeReader* reader /*= 0*/,
    fLeaf(NULL),
    fTreeLastOffset(-1),
    fSetupStatus(kSetupNotSetup),
-   fReadStatus(kReadNothingYet)
+   fReadStatus(kReadNothingYet),
+   fColumnDirector(0),
+   fColumnTree(0),
+   fColumnBranch(0),
+   fColumn(0),
+   fColumnData(0),
+   fColumnFirst(-1),
+   fColumnN(0),
+   fColumnSize(0)
 {
    // Construct a tree value reader and register it with the reader object.
    if (fTreeReader) fTreeReader->RegisterValueReader(this);
@@ -66,6 +80,7 @@ ROOT::TTreeReaderValueBase::~TTreeReaderValueBase()
 {
    // Unregister from tree reader, cleanup.
    if (fTreeReader) fTreeReader->DeregisterValueReader(this);
+   delete fColumn;
 }
 
 //______________________________________________________________________________
@@ -83,6 +98,85 @@ ROOT::TTreeReaderValueBase::ProxyRead() {
    return fReadStatus;
 }
 
+//______________________________________________________________________________
+void* ROOT::TTreeReaderValueBase::LoadColumn()
+{
+   // Read the basket containing the current entry into the column, setting
+   // up the column first if the tree changed. Return the address of the value
+   // of the current entry, or 0 if the branch cannot be read by columns, in
+   // which case the value is read through the proxy.
+
+   if (!fProxy || !fTreeReader || !fTreeReader->fDirector) return 0;
+   ROOT::TBranchProxyDirector *director = fTreeReader->fDirector;
+   TTree *tree = director->GetTree();
+   if (director != fColumnDirector || tree != fColumnTree) {
+      ResetColumn();
+      fColumnDirector = director;
+      fColumnTree = tree;
+
+      // Only a top level TBranch with a single leaf of type T: the others
+      // (leaf lists, leaf counts, objects) go through the proxy. A TChain
+      // is read by columns once the director is set to one of its trees.
+      if (!tree || tree->GetTree() != tree || fLeafName.Length() || !fStaticClassOffsets.empty()) return 0;
+
+      const char *env = gSystem->Getenv("ROOT_TTREEREADER_COLUMNS");
+      Int_t columns;
+      if (!env || !*env) {
+         columns = gEnv->GetValue("TTreeReader.Columns", 1);
+      } else {
+         columns = TString(env).Atoi();
+      }
+      if (!columns) return 0;
+
+      // The branches of the friend trees are read through the proxy: their
+      // entry is not the one of the director (TTreeIndex, TChain of friends).
+      TBranch *branch = tree->GetBranch(fBranchName);
+      if (!branch || branch->GetTree() != tree) return 0;
+      if (branch->IsA() != TBranch::Class() || branch->GetNleaves() != 1) return 0;
+      TLeaf *leaf = (TLeaf*)branch->GetListOfLeaves()->UncheckedAt(0);
+      if (leaf->GetLeafCount()) return 0;
+      TDictionary *leafDict = TDictionary::GetDictionary(leaf->GetTypeName());
+      if (!leafDict || leafDict->IsA() != TDataType::Class() ||
+          TDictionary::GetDictionary(((TDataType*)leafDict)->GetTypeName()) != fDict) return 0;
+
+      if (!fColumn) fColumn = new TBufferFile(TBuffer::kWrite, 32000);
+      fColumnBranch = branch;
+      fColumnSize = leaf->GetLenType() * leaf->GetLenStatic();
+   }
+   if (!fColumnBranch) return 0;
+
+   Long64_t entry = director->GetReadEntry();
+   if (entry < 0) return 0;
+   Int_t n = fColumnBranch->GetBulkEntries(entry, *fColumn);
+   if (n <= 0) {
+      // A basket which cannot be read in bulk (e.g. with entry offsets) or an
+      // I/O error: the proxy reads this tree from now on.
+      if (n < 0) fColumnBranch = 0;
+      fColumnData = 0;
+      fColumnN = 0;
+      return 0;
+   }
+   fColumnData = fColumn->Buffer();
+   fColumnFirst = entry;
+   fColumnN = n;
+   fReadStatus = kReadSuccess;
+   return fColumnData;
+}
+
+//______________________________________________________________________________
+void ROOT::TTreeReaderValueBase::ResetColumn()
+{
+   // Forget the column and its tree; the buffer is kept for the next tree.
+
+   fColumnDirector = 0;
+   fColumnTree = 0;
+   fColumnBranch = 0;
+   fColumnData = 0;
+   fColumnFirst = -1;
+   fColumnN = 0;
+   fColumnSize = 0;
+}
+
 //______________________________________________________________________________
 TLeaf* ROOT::TTreeReaderValueBase::GetLeaf() {
    // If we are reading a leaf, return the corresponding TLeaf.